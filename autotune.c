@@ -0,0 +1,234 @@
+/*
+ * autotune.c
+ *
+ * Relay feedback auto-tune mode
+ *  A relay with hysteresis on the position error adds +/- AUTOTUNE_RELAY to a PD
+ *  hold on both axes. Once the limit cycles are steady their period and amplitude
+ *  give one point of each axis' frequency response (describing function), from
+ *  which new PID gains are calculated with the selected rule and applied.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "controller.h"
+#include "autotune.h"
+
+#define PI 3.14159265f
+
+uint8_t AutoTuneStatus = AUTOTUNE_IDLE;
+uint32_t AutoTunePeriodX = 0;
+uint32_t AutoTunePeriodY = 0;
+uint32_t AutoTuneAmplitudeX = 0;
+uint32_t AutoTuneAmplitudeY = 0;
+
+uint8_t autoTuneRule = AUTOTUNE_DEFAULT_RULE;
+uint32_t autoTuneSamples = 0;
+
+RelayDetector relayX;
+RelayDetector relayY;
+
+int32_t autoTuneLastX = 0;
+int32_t autoTuneLastY = 0;
+
+// Loop gain (%) and phase margin (degrees) each rule places at the measured frequency
+const uint8_t AutoTuneRuleGain[AUTOTUNE_RULE_COUNT] = {90, 105, 120};
+const uint8_t AutoTuneRuleMargin[AUTOTUNE_RULE_COUNT] = {20, 30, 40};
+
+void Relay_Reset(RelayDetector *d) {
+    d->high = true;
+    d->started = false;
+    d->lastInput = 0;
+    d->sample = 0;
+    d->lastRise = 0;
+    d->max = d->min = 0;
+    d->period = d->amplitude = 0;
+    d->consistent = 0;
+    d->periodSum = d->amplitudeSum = 0;
+}
+
+static _Bool Within(uint32_t value, uint32_t reference) {
+    uint32_t difference = (value > reference) ? value - reference : reference - value;
+    return difference * 100 <= reference * AUTOTUNE_TOLERANCE;
+}
+
+/* Relay step, call once per sample
+ *  <input> is what the relay switches on, <signal> is the oscillation that is measured.
+ *  Returns the relay output (+1 or -1). Cycles are timed between rising switches,
+ *  interpolated between samples.
+ */
+int32_t Relay_Update(RelayDetector *d, int32_t input, int32_t signal) {
+    if(d->sample == 0) d->lastInput = input;
+
+    if(signal > d->max) d->max = signal;
+    if(signal < d->min) d->min = signal;
+
+    if(d->high && input < -AUTOTUNE_HYSTERESIS) {
+        d->high = false;
+    } else if(!d->high && input > AUTOTUNE_HYSTERESIS) {
+        d->high = true;
+
+        // Fraction of the last sample since the input crossed the threshold
+        int32_t step = input - d->lastInput;
+        uint32_t frac = (step > 0) ? (uint32_t)((AUTOTUNE_HYSTERESIS - d->lastInput) * 256 / step) : 256;
+        if(frac > 256) frac = 256;
+        uint32_t rise = (d->sample - 1) * 256 + frac;
+
+        if(d->started) {
+            uint32_t period = rise - d->lastRise;
+            uint32_t amplitude = (uint32_t)(d->max - d->min) / 2;
+
+            if(d->consistent > 0 && Within(period, d->period) && Within(amplitude, d->amplitude)) {
+                d->consistent++;
+                d->periodSum += period;
+                d->amplitudeSum += amplitude;
+            } else {
+                d->consistent = 1;
+                d->periodSum = period;
+                d->amplitudeSum = amplitude;
+            }
+            d->period = period;
+            d->amplitude = amplitude;
+        }
+        d->started = true;
+        d->lastRise = rise;
+        d->max = d->min = signal;
+    }
+
+    d->lastInput = input;
+    d->sample++;
+    return d->high ? 1 : -1;
+}
+
+_Bool Relay_Converged(const RelayDetector *d) {
+    return d->consistent >= AUTOTUNE_CYCLES;
+}
+
+// Average period of the consistent cycles (1/256th of a sample)
+uint32_t Relay_Period(const RelayDetector *d) {
+    return d->consistent ? d->periodSum / d->consistent : 0;
+}
+
+// Average amplitude of the consistent cycles
+uint32_t Relay_Amplitude(const RelayDetector *d) {
+    return d->consistent ? d->amplitudeSum / d->consistent : 0;
+}
+
+void AutoTune_Start(uint8_t rule) {
+    autoTuneRule = (rule < AUTOTUNE_RULE_COUNT) ? rule : AUTOTUNE_DEFAULT_RULE;
+    autoTuneSamples = 0;
+    Relay_Reset(&relayX);
+    Relay_Reset(&relayY);
+    AutoTunePeriodX = AutoTunePeriodY = 0;
+    AutoTuneAmplitudeX = AutoTuneAmplitudeY = 0;
+    AutoTuneStatus = AUTOTUNE_RUNNING;
+}
+
+/* PID gains from a relay limit cycle of <period> ms and <amplitude> counts
+ *  The describing function of the relay (with hysteresis) gives the response H from
+ *  the relay output to the ball position at the oscillation frequency. The hold is
+ *  known, so the plant is G = H / (1 - C * H). The PID (Ti = RATIO * Td) then moves
+ *  G to the loop gain and phase margin of the rule.
+ */
+void AutoTune_Gains(uint32_t period, uint32_t amplitude, uint8_t rule, int32_t *p, int32_t *i, int32_t *d) {
+    float t = PID_UPDATE_RATE / 1000.0f;
+    float w = 2.0f * PI * 1000.0f / period;
+    float wt = w * t;
+
+    if(amplitude <= AUTOTUNE_HYSTERESIS) amplitude = AUTOTUNE_HYSTERESIS + 1;
+    float lag = asinf((float)AUTOTUNE_HYSTERESIS / amplitude);
+    float magnitude = PI * amplitude / (4.0f * AUTOTUNE_RELAY);
+    float hRe = -magnitude * cosf(lag);
+    float hIm = magnitude * sinf(lag);
+
+    // Hold C = P/1000 + D/200 * (1 - e^-jwT)
+    float cRe = AUTOTUNE_HOLD_P / 1000.0f + AUTOTUNE_HOLD_D / 200.0f * (1.0f - cosf(wt));
+    float cIm = AUTOTUNE_HOLD_D / 200.0f * sinf(wt);
+
+    // G = H / (1 - C * H)
+    float nRe = 1.0f - (cRe * hRe - cIm * hIm);
+    float nIm = -(cRe * hIm + cIm * hRe);
+    float nSq = nRe * nRe + nIm * nIm;
+    float gRe = (hRe * nRe + hIm * nIm) / nSq;
+    float gIm = (hIm * nRe - hRe * nIm) / nSq;
+    float plantGain = sqrtf(gRe * gRe + gIm * gIm);
+    float plantPhase = atan2f(gIm, gRe);
+    if(plantPhase > 0) plantPhase -= 2.0f * PI;
+
+    float controllerGain = AutoTuneRuleGain[rule] / 100.0f / plantGain;
+    float controllerPhase = -PI + AutoTuneRuleMargin[rule] * PI / 180.0f - plantPhase;
+    if(controllerPhase > 1.48f) controllerPhase = 1.48f;
+    if(controllerPhase < 0.0f) controllerPhase = 0.0f;
+
+    // w*Td - 1 / (w*Ti) = tan(phase), solved for Td with Ti = RATIO * Td
+    float a = AUTOTUNE_TI_RATIO;
+    float tangent = tanf(controllerPhase);
+    float wtd = (a * tangent + sqrtf(a * a * tangent * tangent + 4.0f * a)) / (2.0f * a);
+
+    float kp = controllerGain * cosf(controllerPhase);
+    float td = wtd / w;
+    float ti = a * td;
+
+    // UpdatePIDController() output is P*e/1000 + I*sum/5000 + D*dif/200 (10th of a degree)
+    *p = (int32_t)(1000.0f * kp + 0.5f);
+    *i = (int32_t)(5000.0f * kp * t / ti + 0.5f);
+    *d = (int32_t)(200.0f * kp * td / t + 0.5f);
+}
+
+static void AutoTune_Finish(uint8_t status) {
+    AutoTuneStatus = status;
+    Controller_ResetPID();
+}
+
+// Runs the relay experiment at the PID rate, then the PID with the new gains
+void UpdateAutoTuneController(void) {
+    if(AutoTuneStatus != AUTOTUNE_RUNNING) {
+        UpdatePIDController();
+        return;
+    }
+
+    uint32_t setX, setY, x, y;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+    SeqLock_ReadPair(&Ball, &x, &y);
+
+    int32_t errorX = (int32_t)setX - (int32_t)x;
+    int32_t errorY = (int32_t)setY - (int32_t)y;
+    if(autoTuneSamples == 0) {
+        autoTuneLastX = errorX;
+        autoTuneLastY = errorY;
+    }
+
+    int32_t holdX = (AUTOTUNE_HOLD_P * errorX) / 1000 + (AUTOTUNE_HOLD_D * (errorX - autoTuneLastX)) / 200;
+    int32_t holdY = (AUTOTUNE_HOLD_P * errorY) / 1000 + (AUTOTUNE_HOLD_D * (errorY - autoTuneLastY)) / 200;
+    int32_t outX = Relay_Update(&relayX, errorX, errorX);
+    int32_t outY = Relay_Update(&relayY, errorY, errorY);
+    autoTuneLastX = errorX;
+    autoTuneLastY = errorY;
+    autoTuneSamples++;
+
+    if(Abs(errorX) > AUTOTUNE_MAX_AMPLITUDE || Abs(errorY) > AUTOTUNE_MAX_AMPLITUDE || autoTuneSamples > AUTOTUNE_TIMEOUT) {
+        // Keep the old gains
+        AutoTune_Finish(AUTOTUNE_FAILED);
+        UpdatePIDController();
+        return;
+    }
+
+    if(Relay_Converged(&relayX) && Relay_Converged(&relayY)) {
+        AutoTunePeriodX = Relay_Period(&relayX) * PID_UPDATE_RATE / 256;
+        AutoTunePeriodY = Relay_Period(&relayY) * PID_UPDATE_RATE / 256;
+        AutoTuneAmplitudeX = Relay_Amplitude(&relayX);
+        AutoTuneAmplitudeY = Relay_Amplitude(&relayY);
+
+        AutoTune_Gains(AutoTunePeriodX, AutoTuneAmplitudeX, autoTuneRule, &Px, &Ix, &Dx);
+        AutoTune_Gains(AutoTunePeriodY, AutoTuneAmplitudeY, autoTuneRule, &Py, &Iy, &Dy);
+
+        AutoTune_Finish(AUTOTUNE_DONE);
+        UpdatePIDController();
+        return;
+    }
+
+    Controller_Output(holdX + outX * AUTOTUNE_RELAY, holdY + outY * AUTOTUNE_RELAY);
+}
@@ -0,0 +1,83 @@
+/*
+ * autotune.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+// Relay amplitude added to the hold output (in 10th of a degree)
+#define AUTOTUNE_RELAY 40
+
+// Relay switching hysteresis (counts)
+#define AUTOTUNE_HYSTERESIS 15
+
+// A relay alone can't make a double integrator oscillate steadily, so the relay is added on
+//  top of a PD hold (gains in UpdatePIDController() units, no integral)
+#define AUTOTUNE_HOLD_P 60
+#define AUTOTUNE_HOLD_D 240
+
+// Consecutive cycles whose period and amplitude agree within TOLERANCE % before the result is used
+#define AUTOTUNE_CYCLES 4
+#define AUTOTUNE_TOLERANCE 10
+
+// Give up after this many PID periods, or if the ball swings further than MAX_AMPLITUDE counts
+#define AUTOTUNE_TIMEOUT 1500
+#define AUTOTUNE_MAX_AMPLITUDE 1200
+
+// Tuning rules (loop gain and phase margin placed at the measured frequency, see AutoTune_Gains())
+#define AUTOTUNE_RULE_FAST 0        // 20 deg phase margin, fast with large overshoot
+#define AUTOTUNE_RULE_MODERATE 1    // 30 deg phase margin
+#define AUTOTUNE_RULE_ROBUST 2      // 40 deg phase margin, slower with little overshoot
+#define AUTOTUNE_RULE_COUNT 3
+
+#define AUTOTUNE_DEFAULT_RULE AUTOTUNE_RULE_MODERATE
+
+// Integral time as a multiple of the derivative time
+#define AUTOTUNE_TI_RATIO 4
+
+// Save the tuned gains (EEPROM) and load them at startup
+#define AUTOTUNE_PERSIST false
+
+// Auto-tune status
+#define AUTOTUNE_IDLE 0
+#define AUTOTUNE_RUNNING 1
+#define AUTOTUNE_DONE 2
+#define AUTOTUNE_FAILED 3
+
+// Relay with limit cycle period and amplitude detection, one per axis
+typedef struct {
+    _Bool high;             // Relay output state
+    _Bool started;          // A rising switch has been seen
+    int32_t lastInput;
+    uint32_t sample;
+    uint32_t lastRise;      // Time of the last rising switch (1/256th of a sample)
+    int32_t max, min;       // Extremes of the measured signal in the current cycle
+
+    uint32_t period;        // Last full cycle (1/256th of a sample)
+    uint32_t amplitude;     // Half the peak to peak of the last full cycle
+    uint8_t consistent;     // Consecutive cycles that agree with the one before
+    uint32_t periodSum;
+    uint32_t amplitudeSum;
+} RelayDetector;
+
+void Relay_Reset(RelayDetector *d);
+int32_t Relay_Update(RelayDetector *d, int32_t input, int32_t signal);
+_Bool Relay_Converged(const RelayDetector *d);
+uint32_t Relay_Period(const RelayDetector *d);
+uint32_t Relay_Amplitude(const RelayDetector *d);
+
+// Result of the last experiment (period in ms, amplitude in counts)
+extern uint8_t AutoTuneStatus;
+extern uint32_t AutoTunePeriodX;
+extern uint32_t AutoTunePeriodY;
+extern uint32_t AutoTuneAmplitudeX;
+extern uint32_t AutoTuneAmplitudeY;
+
+void AutoTune_Start(uint8_t rule);
+void AutoTune_Gains(uint32_t period, uint32_t amplitude, uint8_t rule, int32_t *p, int32_t *i, int32_t *d);
+void UpdateAutoTuneController(void);
+
+#endif /* AUTOTUNE_H_ */
@@ -0,0 +1,108 @@
+/*
+ * boot.c
+ *
+ * Boot sequencing and control readiness
+ *  Control used to start after fixed delays (PID_UPDATE_DELAY, MOTOR_UPDATE_DELAY)
+ *  whatever the state of the system. It now starts as soon as the gains are loaded,
+ *  the servos have had BOOT_SERVO_FRAMES frames to reach their zero positions and
+ *  BOOT_TOUCH_SAMPLES consistent touch samples arrived. Each condition is set by
+ *  one context (Setup(), the servo frame interrupt, the main loop), SysTick reads
+ *  them. Once control started it stays on, later ball losses are handled by loss.c.
+ *
+ *  Setup() reports the end of each stage, BootStageUs keeps the breakdown.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "boot.h"
+
+_Bool BootEnabled = BOOT_DEFAULT_ENABLE;
+
+uint32_t BootStageUs[BOOT_STAGE_COUNT];
+unsigned long BootControlMs = 0;
+
+// End of the last stage (us)
+uint32_t bootStageEnd = 0;
+
+// Readiness conditions, each written by one context
+volatile _Bool bootConfig = false;
+volatile _Bool bootServo = false;
+volatile _Bool bootTouch = false;
+volatile _Bool bootControl = false;
+
+// Servo frames since Setup(), touch samples of the current run and the first of them
+volatile uint8_t bootFrames = 0;
+uint8_t bootSamples = 0;
+uint32_t bootFirstX = 0;
+uint32_t bootFirstY = 0;
+
+void Boot_Init(void) {
+    uint8_t i;
+    for(i = 0; i < BOOT_STAGE_COUNT; i++) {
+        BootStageUs[i] = 0;
+    }
+    bootStageEnd = 0;
+    BootControlMs = 0;
+    bootConfig = bootServo = bootTouch = bootControl = false;
+    bootFrames = 0;
+    bootSamples = 0;
+}
+
+// <stage> of Setup() ended at <timeUs> (SysTick time)
+void Boot_Stage(uint8_t stage, uint32_t timeUs) {
+    BootStageUs[stage] = timeUs - bootStageEnd;
+    bootStageEnd = timeUs;
+}
+
+// Gains are final (saved ones loaded or the defaults kept)
+void Boot_ConfigLoaded(void) {
+    bootConfig = true;
+}
+
+// Called at every servo frame start, the first frames carry the zero command of Servo_Init()
+void Boot_ServoFrame(void) {
+    if(bootServo) return;
+    bootFrames++;
+    if(bootFrames >= BOOT_SERVO_FRAMES) {
+        bootServo = true;
+    }
+}
+
+// Called with every touch read, <valid> false for a failed one
+void Boot_TouchSample(_Bool valid, uint32_t x, uint32_t y) {
+    if(bootTouch) return;
+    if(!valid) {
+        bootSamples = 0;
+        return;
+    }
+
+    // A sample away from the first of the run (ball still rolling in, contact bounce) starts a new run
+    int32_t dx = (int32_t)x - (int32_t)bootFirstX;
+    int32_t dy = (int32_t)y - (int32_t)bootFirstY;
+    if(bootSamples == 0 || dx > BOOT_TOUCH_SPREAD || dx < -BOOT_TOUCH_SPREAD || dy > BOOT_TOUCH_SPREAD || dy < -BOOT_TOUCH_SPREAD) {
+        bootFirstX = x;
+        bootFirstY = y;
+        bootSamples = 0;
+    }
+    bootSamples++;
+    if(bootSamples >= BOOT_TOUCH_SAMPLES) {
+        bootTouch = true;
+    }
+}
+
+/* Control may run at <time> (ms), called from SysTick
+ *  With BootEnabled off the control starts after <fixedDelay> as before
+ */
+_Bool Boot_ControlReady(unsigned long time, unsigned long fixedDelay) {
+    if(!BootEnabled) {
+        return time > fixedDelay;
+    }
+    if(!bootControl && bootConfig && bootServo && bootTouch) {
+        bootControl = true;
+        BootControlMs = time;
+    }
+    return bootControl;
+}
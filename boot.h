@@ -0,0 +1,47 @@
+/*
+ * boot.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+// Control starts when the system is ready unless disabled here or at runtime (BootEnabled), without
+//  it the PID and motor updates start after the fixed PID_UPDATE_DELAY and MOTOR_UPDATE_DELAY
+#define BOOT_DEFAULT_ENABLE true
+
+// Servo frames with the zero command before the plate counts as level (20 ms each)
+#define BOOT_SERVO_FRAMES 4
+
+// Touch samples in a row, all within BOOT_TOUCH_SPREAD counts of the first, before the position is trusted
+#define BOOT_TOUCH_SAMPLES 3
+#define BOOT_TOUCH_SPREAD 40
+
+// Send the boot breakdown over UART once control starts ("BOOT,stage us...,ready ms")
+#define BOOT_REPORT true
+
+// Stages of Setup(), timed from the SysTick start
+#define BOOT_STAGE_PERIPHERALS 0    // Clocks of all peripherals enabled at once, until all are ready
+#define BOOT_STAGE_IO 1             // Buttons and UART
+#define BOOT_STAGE_STATE 2          // Controller, reference, loss and idle state
+#define BOOT_STAGE_STORAGE 3        // EEPROM and the saved gains
+#define BOOT_STAGE_SERVO 4
+#define BOOT_STAGE_TOUCH 5
+#define BOOT_STAGE_COUNT 6
+
+extern _Bool BootEnabled;
+
+// Duration of each stage (us) and the time control started (ms, 0 = not yet)
+extern uint32_t BootStageUs[BOOT_STAGE_COUNT];
+extern unsigned long BootControlMs;
+
+void Boot_Init(void);
+void Boot_Stage(uint8_t stage, uint32_t timeUs);
+void Boot_ConfigLoaded(void);
+void Boot_ServoFrame(void);
+void Boot_TouchSample(_Bool valid, uint32_t x, uint32_t y);
+_Bool Boot_ControlReady(unsigned long time, unsigned long fixedDelay);
+
+#endif /* BOOT_H_ */
@@ -53,6 +53,9 @@ void Button_Init(void (*callBackFunction)(_Bool, _Bool)) {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
     TimerConfigure(TIMER1_BASE, TIMER_CFG_ONE_SHOT);
 
+    // The callback moves the setpoint, the debounce interrupt has the priority of SysTick (2) so neither
+    //  preempts the other (the port interrupt only restarts the timer)
+    IntPrioritySet(INT_TIMER1A, 2 << 5);
     IntEnable(INT_TIMER1A);
     TimerIntEnable(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
     IntMasterEnable();
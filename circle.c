@@ -0,0 +1,15 @@
+/*
+ * circle.c
+ *
+ * Circle lookup tables followed by modes 3 and 4
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include "circle.h"
+
+// Lookup tables generated with Python script (CircleGenerator.py)
+const int16_t CirclePosition_X[CIRCLE_SIZE] = {250,250,250,250,249,249,249,248,248,247,246,245,245,244,243,241,240,239,238,236,235,233,232,230,228,227,225,223,221,219,217,214,212,210,207,205,202,200,197,194,192,189,186,183,180,177,174,170,167,164,161,157,154,150,147,143,140,136,132,129,125,121,117,113,110,106,102,98,94,90,86,81,77,73,69,65,60,56,52,48,43,39,35,30,26,22,17,13,9,4,0,-4,-9,-13,-17,-22,-26,-30,-35,-39,-43,-48,-52,-56,-60,-65,-69,-73,-77,-81,-86,-90,-94,-98,-102,-106,-110,-113,-117,-121,-125,-129,-132,-136,-140,-143,-147,-150,-154,-157,-161,-164,-167,-170,-174,-177,-180,-183,-186,-189,-192,-194,-197,-200,-202,-205,-207,-210,-212,-214,-217,-219,-221,-223,-225,-227,-228,-230,-232,-233,-235,-236,-238,-239,-240,-241,-243,-244,-245,-245,-246,-247,-248,-248,-249,-249,-249,-250,-250,-250,-250,-250,-250,-250,-249,-249,-249,-248,-248,-247,-246,-245,-245,-244,-243,-241,-240,-239,-238,-236,-235,-233,-232,-230,-228,-227,-225,-223,-221,-219,-217,-214,-212,-210,-207,-205,-202,-200,-197,-194,-192,-189,-186,-183,-180,-177,-174,-170,-167,-164,-161,-157,-154,-150,-147,-143,-140,-136,-132,-129,-125,-121,-117,-113,-110,-106,-102,-98,-94,-90,-86,-81,-77,-73,-69,-65,-60,-56,-52,-48,-43,-39,-35,-30,-26,-22,-17,-13,-9,-4,0,4,9,13,17,22,26,30,35,39,43,48,52,56,60,65,69,73,77,81,86,90,94,98,102,106,110,113,117,121,125,129,132,136,140,143,147,150,154,157,161,164,167,170,174,177,180,183,186,189,192,194,197,200,202,205,207,210,212,214,217,219,221,223,225,227,228,230,232,233,235,236,238,239,240,241,243,244,245,245,246,247,248,248,249,249,249,250,250,250};
+const int16_t CirclePosition_Y[CIRCLE_SIZE] = {0,4,9,13,17,22,26,30,35,39,43,48,52,56,60,65,69,73,77,81,86,90,94,98,102,106,110,113,117,121,125,129,132,136,140,143,147,150,154,157,161,164,167,170,174,177,180,183,186,189,192,194,197,200,202,205,207,210,212,214,217,219,221,223,225,227,228,230,232,233,235,236,238,239,240,241,243,244,245,245,246,247,248,248,249,249,249,250,250,250,250,250,250,250,249,249,249,248,248,247,246,245,245,244,243,241,240,239,238,236,235,233,232,230,228,227,225,223,221,219,217,214,212,210,207,205,202,200,197,194,192,189,186,183,180,177,174,170,167,164,161,157,154,150,147,143,140,136,132,129,125,121,117,113,110,106,102,98,94,90,86,81,77,73,69,65,60,56,52,48,43,39,35,30,26,22,17,13,9,4,0,-4,-9,-13,-17,-22,-26,-30,-35,-39,-43,-48,-52,-56,-60,-65,-69,-73,-77,-81,-86,-90,-94,-98,-102,-106,-110,-113,-117,-121,-125,-129,-132,-136,-140,-143,-147,-150,-154,-157,-161,-164,-167,-170,-174,-177,-180,-183,-186,-189,-192,-194,-197,-200,-202,-205,-207,-210,-212,-214,-217,-219,-221,-223,-225,-227,-228,-230,-232,-233,-235,-236,-238,-239,-240,-241,-243,-244,-245,-245,-246,-247,-248,-248,-249,-249,-249,-250,-250,-250,-250,-250,-250,-250,-249,-249,-249,-248,-248,-247,-246,-245,-245,-244,-243,-241,-240,-239,-238,-236,-235,-233,-232,-230,-228,-227,-225,-223,-221,-219,-217,-214,-212,-210,-207,-205,-202,-200,-197,-194,-192,-189,-186,-183,-180,-177,-174,-170,-167,-164,-161,-157,-154,-150,-147,-143,-140,-136,-132,-129,-125,-121,-117,-113,-110,-106,-102,-98,-94,-90,-86,-81,-77,-73,-69,-65,-60,-56,-52,-48,-43,-39,-35,-30,-26,-22,-17,-13,-9,-4};
@@ -0,0 +1,18 @@
+/*
+ * circle.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef CIRCLE_H_
+#define CIRCLE_H_
+
+// This depends on the python script used to generate the lookup table
+#define CIRCLE_SIZE 360
+#define CIRCLE_DEFAULT_RATE 5
+
+extern const int16_t CirclePosition_X[CIRCLE_SIZE];
+extern const int16_t CirclePosition_Y[CIRCLE_SIZE];
+
+#endif /* CIRCLE_H_ */
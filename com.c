@@ -21,6 +21,8 @@
 #include "driverlib/interrupt.h"
 #include "driverlib/uart.h"
 #include "com.h"
+#include "waypoint.h"
+#include "schedule.h"
 
 /*
  * Initializes the Comm Port
@@ -39,6 +41,8 @@ void COM_Init( void ) {
     UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), BAUD_RATE, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
 
     IntMasterEnable();
+    // Queues waypoints for SysTick, same priority (2) so neither preempts the other (waypoint.c)
+    IntPrioritySet(INT_UART0, 2 << 5);
     IntEnable(INT_UART0);
     UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT);
 }
@@ -56,6 +60,27 @@ void UARTIntSend(uint16_t integer) {
     UARTCharSend((integer%10) + '0');
 }
 
+// Used to send a signed integer of any length
+void UARTSignedIntSend(int32_t integer) {
+    char digits[10];
+    uint8_t count = 0;
+    uint32_t value = integer;
+
+    if(integer < 0) {
+        UARTCharSend('-');
+        value = -integer;
+    }
+
+    do {
+        digits[count++] = (value % 10) + '0';
+        value /= 10;
+    } while(value > 0);
+
+    while(count > 0) {
+        UARTCharSend(digits[--count]);
+    }
+}
+
 // Interrupt handler for UART
 void UARTIntHandler(void)
 {
@@ -65,7 +90,9 @@ void UARTIntHandler(void)
 
     while(UARTCharsAvail(UART0_BASE)) //loop while there are chars
     {
-        //echo character
-        UARTCharPutNonBlocking(UART0_BASE, UARTCharGetNonBlocking(UART0_BASE));
+        // Waypoint lines from the host (MODE_WAYPOINT) and gain table lines outside it, no longer echoed
+        char c = UARTCharGetNonBlocking(UART0_BASE);
+        Waypoint_Char(c);
+        Schedule_Char(c, !Waypoint_Active());
     }
 }
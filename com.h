@@ -12,6 +12,7 @@
 
 void UARTCharSend(char character);
 void UARTIntSend(uint16_t integer);
+void UARTSignedIntSend(int32_t integer);
 void COM_Init(void);
 
 #endif /* COM_H_ */
@@ -0,0 +1,303 @@
+/*
+ * controller.c
+ *
+ * Handles the PID controller and the motor set point shaping
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "predictor.h"
+#include "shaper.h"
+#include "notch.h"
+#include "disturbance.h"
+#include "schedule.h"
+
+// Touch screen center and servo level positions
+volatile uint32_t CenterX = CENTER_X;
+volatile uint32_t CenterY = CENTER_Y;
+volatile int32_t ServoZeroX = SERVO_X_ZERO;
+volatile int32_t ServoZeroY = SERVO_Y_ZERO;
+
+// Controller outputs
+volatile uint32_t currentXDegrees = SERVO_X_ZERO;
+volatile uint32_t currentYDegrees = SERVO_Y_ZERO;
+
+// PID Controller Variables
+SeqLockPair Setpoint = SEQLOCK_PAIR_INIT(CENTER_X, CENTER_Y);
+volatile _Bool SetpointMoving = false;
+
+// Servo command that makes the ball follow the setpoint transition (10th of a degree, reference.c)
+volatile int32_t SetpointFeedforwardX = 0;
+volatile int32_t SetpointFeedforwardY = 0;
+
+int32_t ErrorXLast = 0;
+int32_t ErrorXSum = 0;
+int32_t ErrorXDif = 0;
+
+int32_t ErrorYLast = 0;
+int32_t ErrorYSum = 0;
+int32_t ErrorYDif = 0;
+
+// Same PID state for the float path (UpdatePIDControllerFloat)
+float errorXLastF = 0.0f;
+float errorXSumF = 0.0f;
+float errorYLastF = 0.0f;
+float errorYSumF = 0.0f;
+
+// PID K Constants. (Good values: 120, 25, 240)
+int32_t Px = 120;
+int32_t Ix = 5;
+int32_t Dx = 240;
+
+int32_t Py = 120;
+int32_t Iy = 5;
+int32_t Dy = 220;
+
+// Command shaping of the motor set points
+ShaperAxis shaperX;
+ShaperAxis shaperY;
+
+// Resonance notch of the outputs
+NotchAxis notchX;
+NotchAxis notchY;
+
+// Variables to hold the current ball position
+SeqLockPair Ball = SEQLOCK_PAIR_INIT(0, 0);
+
+void Controller_Init(void) {
+    SeqLock_WritePair(&Setpoint, CenterX, CenterY);
+
+    ErrorXLast = ErrorXSum = ErrorXDif = 0;
+    ErrorYLast = ErrorYSum = ErrorYDif = 0;
+    errorXLastF = errorXSumF = errorYLastF = errorYSumF = 0.0f;
+
+    currentXDegrees = ServoZeroX;
+    currentYDegrees = ServoZeroY;
+
+    Predictor_Init();
+    Disturbance_Init();
+    Schedule_Init();
+
+    Shaper_Reset(&shaperX, 0);
+    Shaper_Reset(&shaperY, 0);
+    Notch_Reset(&notchX, 0);
+    Notch_Reset(&notchY, 0);
+}
+
+// Restarts the PID from the current ball position (no derivative kick, empty error sums)
+void Controller_ResetPID(void) {
+    uint32_t setX, setY, x, y;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+    SeqLock_ReadPair(&Ball, &x, &y);
+
+    ErrorXLast = (int32_t)setX - (int32_t)x;
+    ErrorYLast = (int32_t)setY - (int32_t)y;
+    ErrorXSum = ErrorYSum = 0;
+
+    errorXLastF = ErrorXLast;
+    errorYLastF = ErrorYLast;
+    errorXSumF = errorYSumF = 0.0f;
+}
+
+/* Restarts the controllers without a bump after the ball was lost, from the new ball position and the current servo command
+ *  <moveX>, <moveY> are the ball movement over the last PID period (counts), the derivative starts from it
+ */
+void Controller_Restart(int32_t moveX, int32_t moveY) {
+    Controller_ResetPID();
+    ErrorXLast += moveX;
+    ErrorYLast += moveY;
+    errorXLastF = ErrorXLast;
+    errorYLastF = ErrorYLast;
+    Predictor_Init();
+    Disturbance_Restart();
+    Schedule_Restart();
+
+    Shaper_Reset(&shaperX, (int32_t)currentXDegrees - ServoZeroX);
+    Shaper_Reset(&shaperY, (int32_t)currentYDegrees - ServoZeroY);
+    Notch_Reset(&notchX, (int32_t)currentXDegrees - ServoZeroX);
+    Notch_Reset(&notchY, (int32_t)currentYDegrees - ServoZeroY);
+}
+
+// Moves the derivative history by the error of a ball position the last update used (counts), no kick from it
+void Controller_Correct(int32_t x, int32_t y) {
+    ErrorXLast -= x;
+    ErrorYLast -= y;
+    errorXLastF -= x;
+    errorYLastF -= y;
+}
+
+/* Moves the servo zeros to a new level (10th of a degree), the shaping and notch states are rebased on it
+ *  so the command goes on from the current servo position instead of jumping by the change of the zeros
+ */
+void Controller_SetZero(int32_t zeroX, int32_t zeroY) {
+    ServoZeroX = zeroX;
+    ServoZeroY = zeroY;
+
+    Shaper_Reset(&shaperX, (int32_t)currentXDegrees - ServoZeroX);
+    Shaper_Reset(&shaperY, (int32_t)currentYDegrees - ServoZeroY);
+    Notch_Reset(&notchX, (int32_t)currentXDegrees - ServoZeroX);
+    Notch_Reset(&notchY, (int32_t)currentYDegrees - ServoZeroY);
+}
+
+int32_t Limit(int32_t value, int32_t min, int32_t max) {
+    if(value > max) return max;
+    if(value < min) return min;
+    return value;
+}
+
+int32_t Abs(int32_t value) {
+    if(value < 0) return -value;
+    return value;
+}
+
+float LimitFloat(float value, float min, float max) {
+    if(value > max) return max;
+    if(value < min) return min;
+    return value;
+}
+
+// Nearest integer, halves away from zero (no libm call on the target)
+int32_t RoundFloat(float value) {
+    return (int32_t)(value + ((value < 0.0f) ? -0.5f : 0.5f));
+}
+
+// PID update in the arithmetic selected by CONTROLLER_FLOAT
+void UpdatePIDController(void) {
+    if(CONTROLLER_FLOAT) {
+        UpdatePIDControllerFloat();
+    } else {
+        UpdatePIDControllerFixed();
+    }
+}
+
+void UpdatePIDControllerFixed(void) {
+    uint32_t setX, setY, x, y;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+    SeqLock_ReadPair(&Ball, &x, &y);
+
+    int32_t positionX = x;
+    int32_t positionY = y;
+
+    // Control on where the ball will be when this command takes effect
+    if(PredictorEnabled) {
+        Predictor_Predict(x, y, &positionX, &positionY);
+    }
+
+    // Bias, drag and deadband the commands don't explain are taken out of the output
+    int32_t disturbanceX = 0;
+    int32_t disturbanceY = 0;
+    if(DisturbanceEnabled) {
+        Disturbance_Update(x, y);
+        disturbanceX = DisturbanceX;
+        disturbanceY = DisturbanceY;
+    }
+
+    // Gains for the ball speed and distance from the center, the sums integrate the scaled error
+    int32_t px = Px, dx = Dx, py = Py, dy = Dy;
+    int32_t scaleI = 256;
+    if(ScheduleEnabled) {
+        Schedule_Update(x, y);
+        px = (Px * ScheduleP) >> 8;
+        dx = (Dx * ScheduleD) >> 8;
+        py = (Py * ScheduleP) >> 8;
+        dy = (Dy * ScheduleD) >> 8;
+        scaleI = ScheduleI;
+    }
+
+    int32_t ErrorX = setX - positionX; //Range of -4096 to 4096
+    int32_t ErrorY = setY - positionY; //Range of -4096 to 4096
+
+	// This should have code for resetting/handling wind-up
+    //  The error of a setpoint transition isn't integrated, the sums keep the plate trim
+    if(!SetpointMoving) {
+        ErrorXSum = Limit(ErrorXSum + ((ErrorX * scaleI) >> 8), -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE); //*dt
+        ErrorYSum = Limit(ErrorYSum + ((ErrorY * scaleI) >> 8), -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE); //*dt
+    }
+
+    ErrorXDif = Limit(ErrorX - ErrorXLast, -500, 500); //dt
+    ErrorYDif = Limit(ErrorY - ErrorYLast, -500, 500); //dt
+
+    // Calculate PID Control
+    int32_t xVal = ((px * ErrorX) + (Ix * ErrorXSum)/5 + (dx * ErrorXDif) * 5)/100;
+    int32_t yVal = ((py * ErrorY) + (Iy * ErrorYSum)/5 + (dy * ErrorYDif) * 5)/100;
+
+    // A setpoint transition adds the command that accelerates the ball along it
+    Controller_Output(xVal / 10 + SetpointFeedforwardX - disturbanceX, yVal / 10 + SetpointFeedforwardY - disturbanceY);
+
+    ErrorXLast = ErrorX;
+    ErrorYLast = ErrorY;
+}
+
+/* The PID of UpdatePIDControllerFixed() in single precision float, same gains and units
+ *  Nothing is truncated on the way (the integer path drops up to a 10th of a degree towards zero
+ *  in its /5, /100 and /10 steps) and the dead time prediction keeps its fraction of a count
+ */
+void UpdatePIDControllerFloat(void) {
+    uint32_t setX, setY, x, y;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+    SeqLock_ReadPair(&Ball, &x, &y);
+
+    float positionX = (float)x;
+    float positionY = (float)y;
+
+    if(PredictorEnabled) {
+        Predictor_PredictFloat(x, y, &positionX, &positionY);
+    }
+
+    int32_t disturbanceX = 0;
+    int32_t disturbanceY = 0;
+    if(DisturbanceEnabled) {
+        Disturbance_Update(x, y);
+        disturbanceX = DisturbanceX;
+        disturbanceY = DisturbanceY;
+    }
+
+    float scaleP = 1.0f, scaleI = 1.0f, scaleD = 1.0f;
+    if(ScheduleEnabled) {
+        Schedule_Update(x, y);
+        scaleP = (float)ScheduleP * (1.0f / 256.0f);
+        scaleI = (float)ScheduleI * (1.0f / 256.0f);
+        scaleD = (float)ScheduleD * (1.0f / 256.0f);
+    }
+
+    float errorX = (float)setX - positionX;
+    float errorY = (float)setY - positionY;
+
+    if(!SetpointMoving) {
+        errorXSumF = LimitFloat(errorXSumF + errorX * scaleI, -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE);
+        errorYSumF = LimitFloat(errorYSumF + errorY * scaleI, -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE);
+    }
+
+    float difX = LimitFloat(errorX - errorXLastF, -500.0f, 500.0f);
+    float difY = LimitFloat(errorY - errorYLastF, -500.0f, 500.0f);
+
+    // P*e/1000 + I*sum/5000 + D*dif/200 (10th of a degree)
+    float xVal = (float)Px * scaleP * errorX * 0.001f + (float)Ix * errorXSumF * 0.0002f + (float)Dx * scaleD * difX * 0.005f;
+    float yVal = (float)Py * scaleP * errorY * 0.001f + (float)Iy * errorYSumF * 0.0002f + (float)Dy * scaleD * difY * 0.005f;
+
+    Controller_Output(RoundFloat(xVal) + SetpointFeedforwardX - disturbanceX, RoundFloat(yVal) + SetpointFeedforwardY - disturbanceY);
+
+    errorXLastF = errorX;
+    errorYLastF = errorY;
+}
+
+// Notches, limits and shapes a controller output (10th of a degree from the servo zeros) for the motor update
+//  The predictor (and LQR) see the shaped command, which is what the servos get
+void Controller_Output(int32_t xOffset, int32_t yOffset) {
+    if(NotchEnabled) {
+        uint32_t setX, setY, x, y;
+        SeqLock_ReadPair(&Setpoint, &setX, &setY);
+        SeqLock_ReadPair(&Ball, &x, &y);
+        xOffset = Notch_Update(&notchX, (int32_t)setX - (int32_t)x, xOffset);
+        yOffset = Notch_Update(&notchY, (int32_t)setY - (int32_t)y, yOffset);
+    }
+
+    currentXDegrees = ServoZeroX + Shaper_Update(&shaperX, Limit(xOffset, -SERVO_X_RANGE, SERVO_X_RANGE));
+    currentYDegrees = ServoZeroY + Shaper_Update(&shaperY, Limit(yOffset, -SERVO_Y_RANGE, SERVO_Y_RANGE));
+
+    Predictor_Push(currentXDegrees - ServoZeroX, currentYDegrees - ServoZeroY);
+}
@@ -0,0 +1,101 @@
+/*
+ * controller.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef CONTROLLER_H_
+#define CONTROLLER_H_
+
+#include "seqlock.h"
+
+// Timer related defines, Change these to modify update times
+// All variables in milliseconds (ms)
+#define TOUCH_UPDATE_RATE 10
+
+#define UART_UPDATE_DELAY 100
+#define UART_UPDATE_RATE 100
+
+#define PID_UPDATE_DELAY 240
+#define PID_UPDATE_RATE 40
+
+#define MOTOR_UPDATE_DELAY 280
+#define MOTOR_UPDATE_RATE 40
+
+// Servo frame (PWM period). The touch, PID and motor updates are phase locked to the frame so
+//  they run SERVO_UPDATE_LEAD before the new pulse widths are latched at the start of a frame
+#define SERVO_FRAME_PERIOD 20
+#define SERVO_UPDATE_LEAD 2
+
+// PID arithmetic, false = integer, true = single precision float on the Cortex-M4F FPU (enabled in Setup()).
+//  Both versions are always built so they can be compared on a PC (sim/fpu.c), this selects the one
+//  UpdatePIDController() runs
+#define CONTROLLER_FLOAT false
+
+// Maximum PID ErrorSum before Ki saturates (Keep this low as Windup is not handled)
+#define PID_ERROR_SUM_RANGE 100000
+
+// Touch screen center positions, defaults of CenterX/CenterY until the levelling (level.c) measured them
+#define CENTER_X 2150
+#define CENTER_Y 2150
+
+// Servo center positions and range of movements (in 10th of a degrees, 900 = 90 deg), the center
+//  positions are the defaults of ServoZeroX/ServoZeroY
+#define SERVO_X_ZERO 867
+#define SERVO_Y_ZERO 867
+
+#define SERVO_X_RANGE 300
+#define SERVO_Y_RANGE 350
+
+// Button modes (0 = center, 1/2 = +/-600 steps, 3/4 = circles, 5 = center, 6 = identification, 7 = LQR center, 8 = auto-tune,
+//  9 = levelling, 10 = compiled trajectories, 11 = waypoints streamed over the UART)
+#define MODE_COUNT 12
+#define MODE_SYSID 6
+#define MODE_LQR 7
+#define MODE_AUTOTUNE 8
+#define MODE_LEVEL 9
+#define MODE_TRAJECTORY 10
+#define MODE_WAYPOINT 11
+
+// Touch screen center and servo level positions in use, written by the levelling when it is done
+extern volatile uint32_t CenterX;
+extern volatile uint32_t CenterY;
+extern volatile int32_t ServoZeroX;
+extern volatile int32_t ServoZeroY;
+
+// Controller outputs after the command shaping (shaper.h), read by the motor update
+extern volatile uint32_t currentXDegrees;
+extern volatile uint32_t currentYDegrees;
+
+// PID gains, can be changed at runtime
+extern int32_t Px, Ix, Dx;
+extern int32_t Py, Iy, Dy;
+
+// Setpoint (written by the button and SysTick interrupts) and the current ball position (touch update),
+//  each pair is published together, read both with SeqLock_ReadPair()
+extern SeqLockPair Setpoint;
+extern SeqLockPair Ball;
+
+// Set while the setpoint follows a transition profile (reference.c), the controllers don't integrate
+//  and add the feedforward command (10th of a degree) to their outputs
+extern volatile _Bool SetpointMoving;
+extern volatile int32_t SetpointFeedforwardX;
+extern volatile int32_t SetpointFeedforwardY;
+
+void Controller_Init(void);
+void UpdatePIDController(void);
+void UpdatePIDControllerFixed(void);
+void UpdatePIDControllerFloat(void);
+void Controller_Output(int32_t xOffset, int32_t yOffset);
+void Controller_ResetPID(void);
+void Controller_Restart(int32_t moveX, int32_t moveY);
+void Controller_Correct(int32_t x, int32_t y);
+void Controller_SetZero(int32_t zeroX, int32_t zeroY);
+
+int32_t Limit(int32_t value, int32_t min, int32_t max);
+int32_t Abs(int32_t value);
+float LimitFloat(float value, float min, float max);
+int32_t RoundFloat(float value);
+
+#endif /* CONTROLLER_H_ */
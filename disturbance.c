@@ -0,0 +1,80 @@
+/*
+ * disturbance.c
+ *
+ * Input disturbance observer for the PID controller
+ *  An off level mount, cable drag or the deadband of the servos act like an extra
+ *  servo command the PID only learns through its small integral term. The observer
+ *  runs the ball model of the predictor (a double integrator driven by the servo
+ *  command) with a third state, a constant disturbance added to the command, and
+ *  corrects all three from each touch sample. The disturbance that
+ *  explains the ball acceleration the commands don't is then subtracted from the
+ *  PID output, so a new bias is cancelled within a few PID periods.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "predictor.h"
+#include "disturbance.h"
+
+_Bool DisturbanceEnabled = DISTURBANCE_DEFAULT_ENABLE;
+
+volatile int32_t DisturbanceX = 0;
+volatile int32_t DisturbanceY = 0;
+
+// Observer estimate at the time of the touch sample (counts and counts/period scaled by 65536,
+//  disturbance in 10th of a degree scaled by 256)
+int32_t disturbancePosX = 0;
+int32_t disturbancePosY = 0;
+int32_t disturbanceVelX = 0;
+int32_t disturbanceVelY = 0;
+int32_t disturbanceEstimateX = 0;
+int32_t disturbanceEstimateY = 0;
+_Bool disturbanceStarted = false;
+
+void Disturbance_Init(void) {
+    disturbanceEstimateX = disturbanceEstimateY = 0;
+    DisturbanceX = DisturbanceY = 0;
+    disturbanceStarted = false;
+}
+
+// Starts the ball estimate over from the next sample (after a ball loss), the disturbance is kept
+void Disturbance_Restart(void) {
+    disturbanceStarted = false;
+}
+
+/* Advances the observer of one axis by a PID period with the command that was acting and corrects it
+ *  toward the touch sample <position>, returns the disturbance (10th of a degree)
+ */
+static int32_t UpdateAxis(int32_t position, int32_t command, int32_t *pos, int32_t *vel, int32_t *estimate, int32_t gain) {
+    *vel += gain * command + ((gain * *estimate) >> 8);
+    *pos += *vel;
+
+    int32_t innovation = ((position << 16) - *pos) / 256;
+    *pos += innovation * DISTURBANCE_OBSERVER_POS;
+    *vel += innovation * DISTURBANCE_OBSERVER_VEL;
+    *estimate += (innovation * DISTURBANCE_OBSERVER_DIST) >> 8;
+    *estimate = Limit(*estimate, -(DISTURBANCE_LIMIT << 8), DISTURBANCE_LIMIT << 8);
+
+    return (*estimate + 0x80) >> 8;
+}
+
+// Updates the disturbance estimates with a new touch sample, call once per PID period before the output
+void Disturbance_Update(int32_t x, int32_t y) {
+    if(!disturbanceStarted) {
+        disturbancePosX = x << 16;
+        disturbancePosY = y << 16;
+        disturbanceVelX = 0;
+        disturbanceVelY = 0;
+        disturbanceStarted = true;
+    }
+
+    int32_t commandX, commandY;
+    Predictor_Command(DISTURBANCE_DELAY + 1, &commandX, &commandY);
+
+    DisturbanceX = UpdateAxis(x, commandX, &disturbancePosX, &disturbanceVelX, &disturbanceEstimateX, PREDICTOR_GAIN_X);
+    DisturbanceY = UpdateAxis(y, commandY, &disturbancePosY, &disturbanceVelY, &disturbanceEstimateY, PREDICTOR_GAIN_Y);
+}
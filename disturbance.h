@@ -0,0 +1,36 @@
+/*
+ * disturbance.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef DISTURBANCE_H_
+#define DISTURBANCE_H_
+
+// Disturbance rejection is off unless enabled here or at runtime (DisturbanceEnabled)
+#define DISTURBANCE_DEFAULT_ENABLE false
+
+// PID periods between a command and the period it accelerates the ball over (0 = the next one)
+#define DISTURBANCE_DELAY 0
+
+// Observer correction of position, velocity and disturbance per touch sample error (256 = 1.0), three
+//  poles at 0.4 per PID period for the ball model of the predictor (PREDICTOR_GAIN_X)
+#define DISTURBANCE_OBSERVER_POS 240
+#define DISTURBANCE_OBSERVER_VEL 166
+#define DISTURBANCE_OBSERVER_DIST 449
+
+// Largest disturbance cancelled (10th of a degree)
+#define DISTURBANCE_LIMIT 150
+
+extern _Bool DisturbanceEnabled;
+
+// Estimated input disturbance of each axis (10th of a degree of servo command), the PID subtracts it
+extern volatile int32_t DisturbanceX;
+extern volatile int32_t DisturbanceY;
+
+void Disturbance_Init(void);
+void Disturbance_Restart(void);
+void Disturbance_Update(int32_t x, int32_t y);
+
+#endif /* DISTURBANCE_H_ */
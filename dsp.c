@@ -0,0 +1,250 @@
+/*
+ * dsp.c
+ *
+ * Dual-axis fixed point kernels
+ *  The X and Y axes run the same filter and controller steps, packed in one word
+ *  (DspPair) a Cortex-M4 SIMD instruction does the step for both: QADD16/QSUB16 add
+ *  and subtract both axes with saturation, SSUB16 + SEL clamp both, SMLAD does two
+ *  multiply-accumulates of one axis. Every kernel has a portable C version with the
+ *  same results to the bit, DSP_SIMD selects the one that runs.
+ *
+ *  The controllers don't use them (yet). The Cortex-M4 multiplies in one cycle, so
+ *  for the few terms of the PID a kernel call costs more than SIMD saves, the
+ *  kernels pay off in longer filter chains run on both axes.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsp.h"
+
+/* SIMD instructions
+ *  Compiler intrinsics on the target, off it the same operations in C (the GE flags
+ *  SSUB16 sets for SEL are kept in a variable) so the SIMD kernels can be checked on a PC
+ */
+#if defined(__TI_COMPILER_VERSION__) && defined(__TI_ARM_V7M4__)
+#define QADD16(a, b) ((uint32_t)_qadd16((a), (b)))
+#define QSUB16(a, b) ((uint32_t)_qsub16((a), (b)))
+#define SADD16(a, b) ((uint32_t)_sadd16((a), (b)))
+#define SSUB16(a, b) ((uint32_t)_ssub16((a), (b)))
+#define SEL(a, b) ((uint32_t)_sel((a), (b)))
+#define SMLAD(a, b, acc) _smlad((a), (b), (acc))
+#elif defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#define QADD16(a, b) ((uint32_t)__qadd16((a), (b)))
+#define QSUB16(a, b) ((uint32_t)__qsub16((a), (b)))
+#define SADD16(a, b) ((uint32_t)__sadd16((a), (b)))
+#define SSUB16(a, b) ((uint32_t)__ssub16((a), (b)))
+#define SEL(a, b) ((uint32_t)__sel((a), (b)))
+#define SMLAD(a, b, acc) __smlad((a), (b), (acc))
+#else
+#define DSP_EMULATE
+#endif
+
+static int32_t Low(DspPair value) {
+    return (int16_t)(value & 0xFFFF);
+}
+
+static int32_t High(DspPair value) {
+    return (int16_t)(value >> 16);
+}
+
+// Low 16 bits of each value (wraps)
+static DspPair Join(int32_t low, int32_t high) {
+    return ((uint32_t)low & 0xFFFF) | ((uint32_t)high << 16);
+}
+
+static int32_t Saturate16(int32_t value) {
+    if(value > INT16_MAX) return INT16_MAX;
+    if(value < INT16_MIN) return INT16_MIN;
+    return value;
+}
+
+// Sum of 32 bit values wrapping like the hardware (SMLAD, ADD)
+static int32_t Wrap(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+#ifdef DSP_EMULATE
+static uint8_t geFlags = 0;
+
+static DspPair QADD16(DspPair a, DspPair b) {
+    return Join(Saturate16(Low(a) + Low(b)), Saturate16(High(a) + High(b)));
+}
+
+static DspPair QSUB16(DspPair a, DspPair b) {
+    return Join(Saturate16(Low(a) - Low(b)), Saturate16(High(a) - High(b)));
+}
+
+static DspPair SADD16(DspPair a, DspPair b) {
+    int32_t low = Low(a) + Low(b);
+    int32_t high = High(a) + High(b);
+    geFlags = (low >= 0) | ((high >= 0) << 1);
+    return Join(low, high);
+}
+
+static DspPair SSUB16(DspPair a, DspPair b) {
+    int32_t low = Low(a) - Low(b);
+    int32_t high = High(a) - High(b);
+    geFlags = (low >= 0) | ((high >= 0) << 1);
+    return Join(low, high);
+}
+
+static DspPair SEL(DspPair a, DspPair b) {
+    return Join((geFlags & 1) ? Low(a) : Low(b), (geFlags & 2) ? High(a) : High(b));
+}
+
+static int32_t SMLAD(DspPair a, DspPair b, int32_t acc) {
+    return Wrap(Wrap(acc, Low(a) * Low(b)), High(a) * High(b));
+}
+#endif
+
+// Packs <x> and <y>, saturated to 16 bits
+DspPair Dsp_Pack(int32_t x, int32_t y) {
+    return Join(Saturate16(x), Saturate16(y));
+}
+
+// Starts both axes of a filter at rest at <value> (unity DC gain coefficients)
+void Dsp_BiquadInit(DspBiquad *f, int16_t b0, int16_t b1, int16_t b2, int16_t a1, int16_t a2, uint8_t shift, DspPair value) {
+    f->b0 = b0;
+    f->b12 = Join(b1, b2);
+    f->a12 = Join(-a1, -a2);
+    f->shift = shift;
+    f->x[0] = f->y[0] = Join(Low(value), Low(value));
+    f->x[1] = f->y[1] = Join(High(value), High(value));
+}
+
+void Dsp_AverageInit(DspAverage *a, DspPair value) {
+    uint8_t i;
+    for(i = 0; i < DSP_AVERAGE_SAMPLES; i++) {
+        a->window[i] = value;
+    }
+    a->sum = Join(Low(value) * DSP_AVERAGE_SAMPLES, High(value) * DSP_AVERAGE_SAMPLES);
+    a->index = 0;
+}
+
+/*
+ * Portable C kernels
+ */
+
+// Sums of both axes, saturated to 16 bits
+DspPair Dsp_AddC(DspPair a, DspPair b) {
+    return Join(Saturate16(Low(a) + Low(b)), Saturate16(High(a) + High(b)));
+}
+
+DspPair Dsp_SubC(DspPair a, DspPair b) {
+    return Join(Saturate16(Low(a) - Low(b)), Saturate16(High(a) - High(b)));
+}
+
+// Both axes limited to +/-<limit> of the axis (limits >= 0)
+DspPair Dsp_SaturateC(DspPair value, DspPair limit) {
+    int32_t x = Low(value);
+    int32_t y = High(value);
+    if(x > Low(limit)) x = Low(limit);
+    if(x < -Low(limit)) x = -Low(limit);
+    if(y > High(limit)) y = High(limit);
+    if(y < -High(limit)) y = -High(limit);
+    return Join(x, y);
+}
+
+/* Adds the proportional and derivative terms of both axes to <x> and <y>, gains packed as (P, D) for each axis
+ *  The derivative is the change from the <last> error limited to +/-<limit>, returns it
+ */
+DspPair Dsp_PidAccumulateC(DspPair error, DspPair last, DspPair limit, DspPair gainsX, DspPair gainsY, int32_t *x, int32_t *y) {
+    DspPair dif = Dsp_SaturateC(Dsp_SubC(error, last), limit);
+    *x = Wrap(Wrap(*x, Low(gainsX) * Low(error)), High(gainsX) * Low(dif));
+    *y = Wrap(Wrap(*y, Low(gainsY) * High(error)), High(gainsY) * High(dif));
+    return dif;
+}
+
+static int32_t BiquadAxisC(const DspBiquad *f, DspPair *x, DspPair *y, int32_t input) {
+    int32_t sum = f->shift ? 1 << (f->shift - 1) : 0;
+    sum = Wrap(sum, f->b0 * input);
+    sum = Wrap(sum, Low(f->b12) * Low(*x));
+    sum = Wrap(sum, High(f->b12) * High(*x));
+    sum = Wrap(sum, Low(f->a12) * Low(*y));
+    sum = Wrap(sum, High(f->a12) * High(*y));
+    int32_t output = Saturate16(sum >> f->shift);
+
+    *x = Join(input, Low(*x));
+    *y = Join(output, Low(*y));
+    return output;
+}
+
+DspPair Dsp_BiquadC(DspBiquad *f, DspPair input) {
+    int32_t x = BiquadAxisC(f, &f->x[0], &f->y[0], Low(input));
+    int32_t y = BiquadAxisC(f, &f->x[1], &f->y[1], High(input));
+    return Join(x, y);
+}
+
+// Rounded mean of the last DSP_AVERAGE_SAMPLES inputs of both axes
+DspPair Dsp_AverageC(DspAverage *a, DspPair input) {
+    DspPair old = a->window[a->index];
+    a->window[a->index] = input;
+    a->index = (a->index + 1) % DSP_AVERAGE_SAMPLES;
+
+    int32_t x = (int16_t)(Low(a->sum) - Low(old) + Low(input));
+    int32_t y = (int16_t)(High(a->sum) - High(old) + High(input));
+    a->sum = Join(x, y);
+    return Join((x + DSP_AVERAGE_SAMPLES / 2) >> DSP_AVERAGE_SHIFT, (y + DSP_AVERAGE_SAMPLES / 2) >> DSP_AVERAGE_SHIFT);
+}
+
+/*
+ * SIMD kernels
+ */
+DspPair Dsp_AddSimd(DspPair a, DspPair b) {
+    return QADD16(a, b);
+}
+
+DspPair Dsp_SubSimd(DspPair a, DspPair b) {
+    return QSUB16(a, b);
+}
+
+// min(value, limit) then max(value, -limit), each from the GE flags of a subtraction
+DspPair Dsp_SaturateSimd(DspPair value, DspPair limit) {
+    SSUB16(value, limit);
+    value = SEL(limit, value);
+    DspPair negative = QSUB16(0, limit);
+    SSUB16(value, negative);
+    return SEL(value, negative);
+}
+
+// The error and derivative of an axis are paired so one SMLAD does both of its terms
+DspPair Dsp_PidAccumulateSimd(DspPair error, DspPair last, DspPair limit, DspPair gainsX, DspPair gainsY, int32_t *x, int32_t *y) {
+    DspPair dif = Dsp_SaturateSimd(QSUB16(error, last), limit);
+    DspPair pairX = (error & 0xFFFF) | (dif << 16);
+    DspPair pairY = (error >> 16) | (dif & 0xFFFF0000);
+    *x = SMLAD(gainsX, pairX, *x);
+    *y = SMLAD(gainsY, pairY, *y);
+    return dif;
+}
+
+static int32_t BiquadAxisSimd(const DspBiquad *f, DspPair *x, DspPair *y, int32_t input) {
+    int32_t sum = (f->shift ? 1 << (f->shift - 1) : 0) + f->b0 * input;
+    sum = SMLAD(f->b12, *x, sum);
+    sum = SMLAD(f->a12, *y, sum);
+    int32_t output = Saturate16(sum >> f->shift);
+
+    *x = (*x << 16) | (input & 0xFFFF);
+    *y = (*y << 16) | (output & 0xFFFF);
+    return output;
+}
+
+DspPair Dsp_BiquadSimd(DspBiquad *f, DspPair input) {
+    int32_t x = BiquadAxisSimd(f, &f->x[0], &f->y[0], Low(input));
+    int32_t y = BiquadAxisSimd(f, &f->x[1], &f->y[1], High(input));
+    return Join(x, y);
+}
+
+// Both running sums in one SSUB16 + SADD16, they wrap like the C version
+DspPair Dsp_AverageSimd(DspAverage *a, DspPair input) {
+    DspPair old = a->window[a->index];
+    a->window[a->index] = input;
+    a->index = (a->index + 1) % DSP_AVERAGE_SAMPLES;
+
+    a->sum = SADD16(SSUB16(a->sum, old), input);
+    return Join((Low(a->sum) + DSP_AVERAGE_SAMPLES / 2) >> DSP_AVERAGE_SHIFT,
+                (High(a->sum) + DSP_AVERAGE_SAMPLES / 2) >> DSP_AVERAGE_SHIFT);
+}
@@ -0,0 +1,90 @@
+/*
+ * dsp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef DSP_H_
+#define DSP_H_
+
+/* Kernel implementation, true = Cortex-M4 SIMD instructions (both axes, or two taps of one, per
+ *  instruction), false = portable C. Both are always built, off the target the instructions are
+ *  emulated so sim/dsp.c can check the two are bit exact. Defaults to SIMD where the compiler
+ *  targets a core that has it, define DSP_SIMD to choose
+ */
+#ifndef DSP_SIMD
+#if defined(__TI_ARM_V7M4__) || defined(__ARM_FEATURE_SIMD32)
+#define DSP_SIMD true
+#else
+#define DSP_SIMD false
+#endif
+#endif
+
+// Samples of the moving average (power of 2), the sum of the samples has to fit 16 bits
+#define DSP_AVERAGE_SHIFT 2
+#define DSP_AVERAGE_SAMPLES (1 << DSP_AVERAGE_SHIFT)
+
+// X and Y value packed in one word (X in the low, Y in the high 16 bits, signed)
+typedef uint32_t DspPair;
+
+// Second order filter of both axes, same coefficients, y = (b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2) >> shift
+typedef struct {
+    int32_t b0;
+    DspPair b12;                    // b1, b2
+    DspPair a12;                    // -a1, -a2
+    uint8_t shift;
+    DspPair x[2];                   // Last two inputs and outputs of each axis (x1, x2)
+    DspPair y[2];
+} DspBiquad;
+
+// Moving average of both axes over DSP_AVERAGE_SAMPLES
+typedef struct {
+    DspPair window[DSP_AVERAGE_SAMPLES];
+    DspPair sum;
+    uint8_t index;
+} DspAverage;
+
+// Pair of values known to fit 16 bits and the values of a pair
+#define DSP_PAIR(x, y) (((uint32_t)(x) & 0xFFFF) | ((uint32_t)(y) << 16))
+#define DSP_X(value) ((int32_t)(int16_t)((value) & 0xFFFF))
+#define DSP_Y(value) ((int32_t)(int16_t)((value) >> 16))
+
+// Kernels in the implementation selected by DSP_SIMD
+#if DSP_SIMD
+#define Dsp_Add Dsp_AddSimd
+#define Dsp_Sub Dsp_SubSimd
+#define Dsp_Saturate Dsp_SaturateSimd
+#define Dsp_PidAccumulate Dsp_PidAccumulateSimd
+#define Dsp_Biquad Dsp_BiquadSimd
+#define Dsp_Average Dsp_AverageSimd
+#else
+#define Dsp_Add Dsp_AddC
+#define Dsp_Sub Dsp_SubC
+#define Dsp_Saturate Dsp_SaturateC
+#define Dsp_PidAccumulate Dsp_PidAccumulateC
+#define Dsp_Biquad Dsp_BiquadC
+#define Dsp_Average Dsp_AverageC
+#endif
+
+DspPair Dsp_Pack(int32_t x, int32_t y);
+void Dsp_BiquadInit(DspBiquad *f, int16_t b0, int16_t b1, int16_t b2, int16_t a1, int16_t a2, uint8_t shift, DspPair value);
+void Dsp_AverageInit(DspAverage *a, DspPair value);
+
+// Portable C kernels
+DspPair Dsp_AddC(DspPair a, DspPair b);
+DspPair Dsp_SubC(DspPair a, DspPair b);
+DspPair Dsp_SaturateC(DspPair value, DspPair limit);
+DspPair Dsp_PidAccumulateC(DspPair error, DspPair last, DspPair limit, DspPair gainsX, DspPair gainsY, int32_t *x, int32_t *y);
+DspPair Dsp_BiquadC(DspBiquad *f, DspPair input);
+DspPair Dsp_AverageC(DspAverage *a, DspPair input);
+
+// SIMD kernels
+DspPair Dsp_AddSimd(DspPair a, DspPair b);
+DspPair Dsp_SubSimd(DspPair a, DspPair b);
+DspPair Dsp_SaturateSimd(DspPair value, DspPair limit);
+DspPair Dsp_PidAccumulateSimd(DspPair error, DspPair last, DspPair limit, DspPair gainsX, DspPair gainsY, int32_t *x, int32_t *y);
+DspPair Dsp_BiquadSimd(DspBiquad *f, DspPair input);
+DspPair Dsp_AverageSimd(DspAverage *a, DspPair input);
+
+#endif /* DSP_H_ */
@@ -0,0 +1,61 @@
+/*
+ * idle.c
+ *
+ * Low power idle of the main loop
+ *  The main loop only has work after an interrupt set one of its task flags, so
+ *  when none of the tasks can run the core sleeps (WFI) until the next interrupt
+ *  (SysTick, UART, buttons or the servo frame). Sleep keeps every clock running,
+ *  the wake up is the normal interrupt entry so the control timing doesn't change.
+ *  Time spent asleep is counted for the idle percentage.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "idle.h"
+
+uint8_t IdlePolicy = IDLE_DEFAULT_POLICY;
+uint8_t IdlePercent = 0;
+
+uint32_t idleCycles = 0;
+uint16_t idleTicks = 0;
+
+void Idle_Init(void) {
+    IdlePercent = 0;
+    idleCycles = 0;
+    idleTicks = 0;
+}
+
+// True if a pass of the main loop would run a task, same conditions as main()
+_Bool Idle_TaskReady(const IdleTasks *tasks) {
+    if(tasks->touch && !tasks->touchRetry) return true;
+
+    // The control tasks wait for the ball or the loss handling (and are off during system identification)
+    if(tasks->sysid) return false;
+    if((tasks->touchPresent || tasks->lossControl) && (tasks->pid || tasks->motor)) return true;
+    return tasks->touchPresent && tasks->uart;
+}
+
+/* Sleep decision, call with interrupts disabled
+ *  An interrupt that sets a flag after the check stays pending and ends the sleep at once
+ */
+_Bool Idle_CanSleep(const IdleTasks *tasks) {
+    if(IdlePolicy == IDLE_SPIN) return false;
+    return !Idle_TaskReady(tasks);
+}
+
+// Adds a sleep of <cycles> core clock cycles, call with interrupts disabled
+void Idle_Slept(uint32_t cycles) {
+    idleCycles += cycles;
+}
+
+// Call from SysTick, closes the idle percentage window every IDLE_REPORT_PERIOD
+void Idle_Tick(void) {
+    if(++idleTicks < IDLE_REPORT_PERIOD) return;
+
+    IdlePercent = idleCycles / ((uint32_t)IDLE_REPORT_PERIOD * (IDLE_TICK_CYCLES / 100));
+    idleCycles = 0;
+    idleTicks = 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * idle.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+// Idle policies of the main loop
+#define IDLE_SPIN 0                 // Poll the task flags continuously
+#define IDLE_SLEEP 1                // Sleep (WFI) until the next interrupt when no task can run
+
+#define IDLE_DEFAULT_POLICY IDLE_SLEEP
+
+// Core clock cycles per SysTick (1 ms, SysTick_Init() in main.c)
+#define IDLE_TICK_CYCLES 80000
+
+// Window of the idle time percentage (ms)
+#define IDLE_REPORT_PERIOD 1000
+
+// Append the idle percentage to the UART position updates ("x,y,idle")
+#define IDLE_REPORT false
+
+// Task flags of the main loop, snapshot of the volatile flags in main.c
+typedef struct {
+    _Bool touch;                    // needTouchUpdate
+    _Bool touchRetry;               // Touch read failed since the last SysTick, retry after the next one
+    _Bool pid;                      // needPIDUpdate
+    _Bool motor;                    // needMotorUpdate
+    _Bool uart;                     // needUARTUpdate
+    _Bool touchPresent;
+    _Bool lossControl;              // Loss_Controlling(), the PID and motor updates run without a touch sample
+    _Bool sysid;                    // System identification mode, drives the servos from the touch update
+} IdleTasks;
+
+// Idle policy, can be changed at runtime
+extern uint8_t IdlePolicy;
+
+// Share of the last IDLE_REPORT_PERIOD the core was asleep (%)
+extern uint8_t IdlePercent;
+
+void Idle_Init(void);
+_Bool Idle_TaskReady(const IdleTasks *tasks);
+_Bool Idle_CanSleep(const IdleTasks *tasks);
+void Idle_Slept(uint32_t cycles);
+void Idle_Tick(void);
+
+#endif /* IDLE_H_ */
@@ -0,0 +1,201 @@
+/*
+ * latency.c
+ *
+ * Touch to servo latency tracer
+ *  Each touch sample is tagged with the time its read started. The tag moves with
+ *  the sample to the controller output computed from it, to the PWM write of that
+ *  output and to the servo frame start that latches it, and each stage adds the
+ *  age of the tag to its histogram. The main loop reports the percentiles of each
+ *  stage over UART every LATENCY_REPORT_RATE ms.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "latency.h"
+
+_Bool LatencyEnabled = LATENCY_DEFAULT_ENABLE;
+
+LatencyHistogram LatencyWindow[LATENCY_STAGE_COUNT];
+
+void (*latencyPinToggle)(uint8_t pin) = 0;
+
+// Capture time (us) of the read in progress, the last published sample and the last controller output
+uint32_t latencyCapture = 0;
+uint32_t latencySampleTag = 0;
+uint32_t latencyCommandTag = 0;
+_Bool latencyHaveSample = false;
+_Bool latencyHaveCommand = false;
+
+// Written tag waiting for the frame start and the age it latched at, handed over by the frame interrupt
+volatile uint32_t latencyWriteTag = 0;
+volatile _Bool latencyWritePending = false;
+volatile uint32_t latencyLatchAge = 0;
+volatile _Bool latencyLatched = false;
+
+// Next stage to report (LATENCY_STAGE_COUNT = all reported)
+unsigned long latencyReportTime = 0;
+uint8_t latencyReportStage = LATENCY_STAGE_COUNT;
+
+void Latency_Clear(LatencyHistogram *h) {
+    uint8_t i;
+    for(i = 0; i < LATENCY_BINS; i++) {
+        h->bins[i] = 0;
+    }
+    h->overflow = 0;
+    h->count = 0;
+    h->max = 0;
+}
+
+// Adds an <age> (us), ignored once the histogram holds 65535 ages
+void Latency_Add(LatencyHistogram *h, uint32_t age) {
+    if(h->count == UINT16_MAX) return;
+    h->count++;
+    if(age > h->max) h->max = age;
+
+    uint32_t bin = age / LATENCY_BIN_US;
+    if(bin < LATENCY_BINS) {
+        h->bins[bin]++;
+    } else {
+        h->overflow++;
+    }
+}
+
+/* Age (us) that <percent> of the ages are at or below, 0 without any
+ *  The upper edge of the bin holding it (at most the longest age), or the longest age if it is above the bins
+ */
+uint32_t Latency_Percentile(const LatencyHistogram *h, uint8_t percent) {
+    if(h->count == 0) return 0;
+
+    uint32_t rank = ((uint32_t)h->count * percent + 99) / 100;
+    if(rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    uint8_t i;
+    for(i = 0; i < LATENCY_BINS; i++) {
+        seen += h->bins[i];
+        if(seen >= rank) {
+            uint32_t edge = (uint32_t)(i + 1) * LATENCY_BIN_US;
+            return (edge < h->max) ? edge : h->max;
+        }
+    }
+    return h->max;
+}
+
+// Starts new windows, <pinToggle> toggles a debug pin (0 - LATENCY_PIN_CAPTURE) when LATENCY_GPIO is set
+void Latency_Init(void (*pinToggle)(uint8_t pin)) {
+    uint8_t stage;
+    for(stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        Latency_Clear(&LatencyWindow[stage]);
+    }
+    latencyPinToggle = pinToggle;
+    latencyHaveSample = false;
+    latencyHaveCommand = false;
+    latencyWritePending = false;
+    latencyLatched = false;
+    latencyReportTime = 0;
+    latencyReportStage = LATENCY_STAGE_COUNT;
+}
+
+static void Toggle(uint8_t pin) {
+    if(LATENCY_GPIO && latencyPinToggle) latencyPinToggle(pin);
+}
+
+// Touch read started at <now> (us), tags the sample it publishes
+void Latency_Capture(uint32_t now) {
+    if(!LatencyEnabled) return;
+    Toggle(LATENCY_PIN_CAPTURE);
+    latencyCapture = now;
+}
+
+// Sample published at <now> (us)
+void Latency_Sample(uint32_t now) {
+    if(!LatencyEnabled) return;
+    Toggle(LATENCY_STAGE_SAMPLE);
+    latencySampleTag = latencyCapture;
+    latencyHaveSample = true;
+    Latency_Add(&LatencyWindow[LATENCY_STAGE_SAMPLE], now - latencySampleTag);
+}
+
+// Controller output computed at <now> (us) from the last published sample (an old one while coasting through a loss)
+void Latency_Control(uint32_t now) {
+    if(!LatencyEnabled) return;
+    Toggle(LATENCY_STAGE_CONTROL);
+    if(!latencyHaveSample) return;
+    latencyCommandTag = latencySampleTag;
+    latencyHaveCommand = true;
+    Latency_Add(&LatencyWindow[LATENCY_STAGE_CONTROL], now - latencyCommandTag);
+}
+
+// PWM pulse widths written at <now> (us) with the last controller output
+void Latency_Write(uint32_t now) {
+    if(!LatencyEnabled) return;
+    Toggle(LATENCY_STAGE_WRITE);
+    if(!latencyHaveCommand) return;
+    Latency_Add(&LatencyWindow[LATENCY_STAGE_WRITE], now - latencyCommandTag);
+
+    // Tag before the flag, the frame interrupt may come in between
+    latencyWriteTag = latencyCommandTag;
+    latencyWritePending = true;
+}
+
+/* Servo frame start at <now> (us), called from the frame interrupt
+ *  Only hands the age over, the main loop adds it with the next report check
+ */
+void Latency_Latch(uint32_t now) {
+    if(!LatencyEnabled) return;
+    Toggle(LATENCY_STAGE_LATCH);
+    if(!latencyWritePending) return;
+    latencyWritePending = false;
+    latencyLatchAge = now - latencyWriteTag;
+    latencyLatched = true;
+}
+
+static char *Append(char *p, uint32_t value) {
+    char digits[10];
+    uint8_t count = 0;
+
+    *p++ = ',';
+    do {
+        digits[count++] = (value % 10) + '0';
+        value /= 10;
+    } while(value > 0);
+    while(count > 0) *p++ = digits[--count];
+    return p;
+}
+
+/* Report line (latency.h) into <line> (LATENCY_REPORT_SIZE) when one is due at <now> (ms), returns its length or 0
+ *  Call every main loop pass, it also collects the latch ages of the frame interrupt
+ */
+uint8_t Latency_Report(char *line, unsigned long now) {
+    if(!LatencyEnabled) return 0;
+
+    if(latencyLatched) {
+        Latency_Add(&LatencyWindow[LATENCY_STAGE_LATCH], latencyLatchAge);
+        latencyLatched = false;
+    }
+
+    if(latencyReportStage >= LATENCY_STAGE_COUNT) {
+        if((now - latencyReportTime) < LATENCY_REPORT_RATE) return 0;
+        latencyReportTime = now;
+        latencyReportStage = 0;
+    }
+
+    LatencyHistogram *h = &LatencyWindow[latencyReportStage];
+    char *p = line;
+    *p++ = 'L';
+    p = Append(p, latencyReportStage);
+    p = Append(p, h->count);
+    p = Append(p, Latency_Percentile(h, 50));
+    p = Append(p, Latency_Percentile(h, 90));
+    p = Append(p, Latency_Percentile(h, 99));
+    p = Append(p, h->max);
+    *p++ = '\r';
+    *p++ = '\n';
+
+    Latency_Clear(h);
+    latencyReportStage++;
+    return p - line;
+}
@@ -0,0 +1,66 @@
+/*
+ * latency.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+// Touch to servo latency tracing is off unless enabled here or at runtime (LatencyEnabled)
+#define LATENCY_DEFAULT_ENABLE false
+
+// Toggle a debug pin at each stage for a scope (OnLatencyPin() in main.c, PA2 capture, PA3 - PA6 the stages)
+#define LATENCY_GPIO false
+
+/* Stages of a touch sample, each timed from the capture (start of the touch read) of the sample it carries
+ *  The PWM latches at the frame start after the write, SERVO_UPDATE_LEAD ms later when the updates are
+ *  frame aligned, the write must not straddle a frame start or the latch is counted a frame late.
+ */
+#define LATENCY_STAGE_SAMPLE 0      // Both axes read and filtered, the sample published in Ball
+#define LATENCY_STAGE_CONTROL 1     // Controller output computed from the last published sample
+#define LATENCY_STAGE_WRITE 2       // PWM pulse widths written with the last output
+#define LATENCY_STAGE_LATCH 3       // Servo frame start, the pulse widths latched
+#define LATENCY_STAGE_COUNT 4
+
+// Debug pin toggled at the capture, the stages use pins 0 - 3
+#define LATENCY_PIN_CAPTURE LATENCY_STAGE_COUNT
+
+// Histogram bins (us) up to LATENCY_BINS * LATENCY_BIN_US, longer ages are counted above the last bin
+#define LATENCY_BIN_US 250
+#define LATENCY_BINS 128
+
+/* Report to the host every REPORT_RATE ms, one line per stage on consecutive main loop passes:
+ *      L,<stage>,<samples>,<p50 us>,<p90 us>,<p99 us>,<max us>
+ *  The percentiles are the upper edges of their bins (at most LATENCY_BIN_US above) or the longest age
+ *  if they are above the bins, a stage starts a new window once reported.
+ */
+#define LATENCY_REPORT_RATE 1000
+#define LATENCY_REPORT_SIZE 64
+
+typedef struct {
+    uint16_t bins[LATENCY_BINS];
+    uint16_t overflow;          // Ages from LATENCY_BINS * LATENCY_BIN_US on
+    uint16_t count;             // Samples, stops adding once full
+    uint32_t max;               // Longest age (us)
+} LatencyHistogram;
+
+extern _Bool LatencyEnabled;
+
+// Ages of the current window of each stage
+extern LatencyHistogram LatencyWindow[LATENCY_STAGE_COUNT];
+
+void Latency_Clear(LatencyHistogram *h);
+void Latency_Add(LatencyHistogram *h, uint32_t age);
+uint32_t Latency_Percentile(const LatencyHistogram *h, uint8_t percent);
+
+void Latency_Init(void (*pinToggle)(uint8_t pin));
+void Latency_Capture(uint32_t now);
+void Latency_Sample(uint32_t now);
+void Latency_Control(uint32_t now);
+void Latency_Write(uint32_t now);
+void Latency_Latch(uint32_t now);
+uint8_t Latency_Report(char *line, unsigned long now);
+
+#endif /* LATENCY_H_ */
@@ -0,0 +1,289 @@
+/*
+ * level.c
+ *
+ * Plate center and servo level calibration (MODE_LEVEL)
+ *  The touch panel center (CENTER_X/Y) and the servo level positions (SERVO_X/Y_ZERO)
+ *  are hand measured, when they are off the integrator spends its range on the bias.
+ *  The levelling finds both with the ball on the plate:
+ *  - Center: the plate is tilted towards one corner, then the opposite one, until the
+ *    ball rests against the frame. The frame is symmetric, so the middle of the two
+ *    readings is the reading of the plate center.
+ *  - Level: short probing moves tilt the plate by +/- LEVEL_PROBE around the level
+ *    estimate and the ball acceleration of each is fitted to the touch readings. The
+ *    accelerations are linear in the servo command, so a pair gives the slope and the
+ *    command where the ball would not roll. The ball is held between the moves.
+ *  Both are applied when done, the setpoint moves to the new center.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "level.h"
+
+// Search phases
+#define LEVEL_PHASE_EDGE_HIGH 0
+#define LEVEL_PHASE_EDGE_LOW 1
+#define LEVEL_PHASE_HOLD 2
+#define LEVEL_PHASE_PROBE 3
+
+_Bool LevelEnabled = LEVEL_DEFAULT_ENABLE;
+uint8_t LevelStatus = LEVEL_IDLE;
+uint8_t LevelRounds = 0;
+
+uint8_t levelPhase = LEVEL_PHASE_HOLD;
+uint32_t levelSamples = 0;
+
+// Estimates, applied when done
+int32_t levelCenterX = CENTER_X;
+int32_t levelCenterY = CENTER_Y;
+int32_t levelZeroX = SERVO_X_ZERO;
+int32_t levelZeroY = SERVO_Y_ZERO;
+
+// Samples of the current still run or hold, the first sample of the run and the sums of the run
+uint8_t levelRun = 0;
+int32_t levelFirstX = 0;
+int32_t levelFirstY = 0;
+int32_t levelSumX = 0;
+int32_t levelSumY = 0;
+
+// Ball position when the plate tilted towards a corner, frame readings of the first corner
+int32_t levelFromX = 0;
+int32_t levelFromY = 0;
+int32_t levelHighX = 0;
+int32_t levelHighY = 0;
+
+// Hold error of the last sample (derivative)
+int32_t levelLastX = 0;
+int32_t levelLastY = 0;
+
+// Current move (+1/-1), its readings and the accelerations of the positive move
+int32_t levelSign = 1;
+uint8_t levelProbeSample = 0;
+int32_t levelProbeX[LEVEL_PROBE_SAMPLES];
+int32_t levelProbeY[LEVEL_PROBE_SAMPLES];
+float levelAccelX = 0.0f;
+float levelAccelY = 0.0f;
+
+// Center changed, the setpoint follows (taken by SysTick)
+volatile _Bool levelNewCenter = false;
+
+void Level_Start(void) {
+    levelCenterX = CenterX;
+    levelCenterY = CenterY;
+    levelZeroX = ServoZeroX;
+    levelZeroY = ServoZeroY;
+    levelPhase = LEVEL_PHASE_HOLD;
+    levelSamples = 0;
+    levelRun = 0;
+    levelSign = 1;
+    LevelRounds = 0;
+    LevelStatus = LEVEL_RUNNING;
+}
+
+// True once after the levelling moved the center, called by the setpoint writer
+_Bool Level_TakeCenter(void) {
+    if(!levelNewCenter) return false;
+    levelNewCenter = false;
+    return true;
+}
+
+/* Acceleration (counts per sample squared) of a least squares parabola through <count> readings
+ *  one sample apart. With the time centered the square term is independent of the others.
+ */
+float Level_Accel(const int32_t *positions, uint8_t count) {
+    float middle = (count - 1) * 0.5f;
+    float meanSquare = 0.0f;
+    uint8_t i;
+    for(i = 0; i < count; i++) {
+        meanSquare += (i - middle) * (i - middle);
+    }
+    meanSquare /= count;
+
+    float sum = 0.0f, norm = 0.0f;
+    for(i = 0; i < count; i++) {
+        float weight = (i - middle) * (i - middle) - meanSquare;
+        sum += weight * (positions[i] - positions[0]);
+        norm += weight * weight;
+    }
+    return 2.0f * sum / norm;
+}
+
+/* Level correction (10th of a degree) from the accelerations of a pair of moves at +/- LEVEL_PROBE
+ *  a = slope * (command - level), the mean of the pair is the acceleration at the estimate.
+ *  Returns false if the ball didn't respond like a free ball
+ */
+_Bool Level_Correction(float accelPlus, float accelMinus, int32_t *correction) {
+    float slope = (accelPlus - accelMinus) / (2.0f * LEVEL_PROBE);
+    if(slope < LEVEL_MIN_SLOPE) return false;
+
+    float offset = -(accelPlus + accelMinus) * 0.5f / slope;
+    *correction = Limit(RoundFloat(offset), -LEVEL_MAX_STEP, LEVEL_MAX_STEP);
+    return true;
+}
+
+static void Level_Finish(uint8_t status) {
+    LevelStatus = status;
+    if(status == LEVEL_DONE) {
+        CenterX = levelCenterX;
+        CenterY = levelCenterY;
+        Controller_SetZero(levelZeroX, levelZeroY);
+        levelNewCenter = true;
+    }
+    Controller_ResetPID();
+}
+
+// Controller output around the level estimate
+static void Level_Output(int32_t xOffset, int32_t yOffset) {
+    Controller_Output(xOffset + levelZeroX - ServoZeroX, yOffset + levelZeroY - ServoZeroY);
+}
+
+static void Level_StartRun(int32_t x, int32_t y) {
+    levelRun = 1;
+    levelFirstX = x;
+    levelFirstY = y;
+    levelSumX = x;
+    levelSumY = y;
+}
+
+// Adds a sample to the still run, true once LEVEL_STILL_SAMPLES samples are within LEVEL_STILL_SPREAD
+static _Bool Level_Still(int32_t x, int32_t y) {
+    if(levelRun == 0 || Abs(x - levelFirstX) > LEVEL_STILL_SPREAD || Abs(y - levelFirstY) > LEVEL_STILL_SPREAD) {
+        Level_StartRun(x, y);
+    } else {
+        levelRun++;
+        levelSumX += x;
+        levelSumY += y;
+    }
+    return levelRun >= LEVEL_STILL_SAMPLES;
+}
+
+// Middle of the two frame readings, the old center if one of them is clipped
+static int32_t Level_Center(int32_t high, int32_t low, int32_t center) {
+    if(high >= 4095 - LEVEL_ADC_MARGIN || low <= LEVEL_ADC_MARGIN) return center;
+    return (high + low) / 2;
+}
+
+// Level estimate moved by <correction>, false if it left the LEVEL_MAX_TRIM range
+static _Bool Level_Move(int32_t *zero, int32_t correction, int32_t defaultZero) {
+    *zero += correction;
+    return Abs(*zero - defaultZero) <= LEVEL_MAX_TRIM;
+}
+
+// Runs the search at the PID rate, then the PID with the new center and level
+void UpdateLevelController(void) {
+    if(LevelStatus != LEVEL_RUNNING) {
+        UpdatePIDController();
+        return;
+    }
+
+    uint32_t ballX, ballY;
+    SeqLock_ReadPair(&Ball, &ballX, &ballY);
+    int32_t x = (int32_t)ballX;
+    int32_t y = (int32_t)ballY;
+    int32_t errorX = levelCenterX - x;
+    int32_t errorY = levelCenterY - y;
+    if(levelSamples == 0) {
+        levelLastX = errorX;
+        levelLastY = errorY;
+    }
+
+    if(++levelSamples > LEVEL_TIMEOUT) {
+        Level_Finish(LEVEL_FAILED);
+        UpdatePIDController();
+        return;
+    }
+
+    switch(levelPhase) {
+    case LEVEL_PHASE_EDGE_HIGH:
+    case LEVEL_PHASE_EDGE_LOW:
+        // The ball only counts as at rest against the frame once it rolled away from where it was
+        if(Abs(x - levelFromX) < LEVEL_EDGE_TRAVEL || Abs(y - levelFromY) < LEVEL_EDGE_TRAVEL) break;
+        if(Level_Still(x, y)) {
+            int32_t edgeX = levelSumX / levelRun;
+            int32_t edgeY = levelSumY / levelRun;
+            levelRun = 0;
+            if(levelPhase == LEVEL_PHASE_EDGE_HIGH) {
+                levelHighX = edgeX;
+                levelHighY = edgeY;
+                levelFromX = x;
+                levelFromY = y;
+                levelPhase = LEVEL_PHASE_EDGE_LOW;
+            } else {
+                levelCenterX = Level_Center(levelHighX, edgeX, levelCenterX);
+                levelCenterY = Level_Center(levelHighY, edgeY, levelCenterY);
+                Level_Finish(LEVEL_DONE);
+                UpdatePIDController();
+                return;
+            }
+        }
+        break;
+    case LEVEL_PHASE_HOLD:
+        if(Abs(errorX) <= LEVEL_HOLD_BAND && Abs(errorY) <= LEVEL_HOLD_BAND &&
+           Abs(errorX - levelLastX) <= LEVEL_HOLD_SPEED && Abs(errorY - levelLastY) <= LEVEL_HOLD_SPEED) {
+            levelRun++;
+        } else {
+            levelRun = 0;
+        }
+        if(levelRun >= LEVEL_HOLD_SAMPLES) {
+            levelRun = 0;
+            levelProbeSample = 0;
+            levelPhase = LEVEL_PHASE_PROBE;
+        }
+        break;
+    case LEVEL_PHASE_PROBE:
+        levelProbeX[levelProbeSample] = x;
+        levelProbeY[levelProbeSample] = y;
+        if(++levelProbeSample < LEVEL_PROBE_SAMPLES) break;
+
+        float accelX = Level_Accel(levelProbeX, LEVEL_PROBE_SAMPLES);
+        float accelY = Level_Accel(levelProbeY, LEVEL_PROBE_SAMPLES);
+        levelPhase = LEVEL_PHASE_HOLD;
+        if(levelSign > 0) {
+            levelAccelX = accelX;
+            levelAccelY = accelY;
+            levelSign = -1;
+            break;
+        }
+        levelSign = 1;
+
+        int32_t correctionX, correctionY;
+        if(!Level_Correction(levelAccelX, accelX, &correctionX) || !Level_Correction(levelAccelY, accelY, &correctionY) ||
+           !Level_Move(&levelZeroX, correctionX, SERVO_X_ZERO) || !Level_Move(&levelZeroY, correctionY, SERVO_Y_ZERO)) {
+            Level_Finish(LEVEL_FAILED);
+            UpdatePIDController();
+            return;
+        }
+        LevelRounds++;
+        if(Abs(correctionX) <= LEVEL_TOLERANCE && Abs(correctionY) <= LEVEL_TOLERANCE) {
+            levelRun = 0;
+            levelFromX = x;
+            levelFromY = y;
+            levelPhase = LEVEL_PHASE_EDGE_HIGH;
+            break;
+        }
+        if(LevelRounds >= LEVEL_ROUNDS) {
+            Level_Finish(LEVEL_FAILED);
+            UpdatePIDController();
+            return;
+        }
+        break;
+    }
+
+    // Frame: both axes towards one corner, then the other. Hold: PD without integral. Move: the probe tilt
+    if(levelPhase == LEVEL_PHASE_EDGE_HIGH) {
+        Level_Output(LEVEL_EDGE_TILT, LEVEL_EDGE_TILT);
+    } else if(levelPhase == LEVEL_PHASE_EDGE_LOW) {
+        Level_Output(-LEVEL_EDGE_TILT, -LEVEL_EDGE_TILT);
+    } else if(levelPhase == LEVEL_PHASE_HOLD) {
+        int32_t difX = Limit(errorX - levelLastX, -500, 500);
+        int32_t difY = Limit(errorY - levelLastY, -500, 500);
+        Level_Output(Px * errorX / 1000 + Dx * difX / 200, Py * errorY / 1000 + Dy * difY / 200);
+    } else {
+        Level_Output(levelSign * LEVEL_PROBE, levelSign * LEVEL_PROBE);
+    }
+    levelLastX = errorX;
+    levelLastY = errorY;
+}
@@ -0,0 +1,75 @@
+/*
+ * level.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef LEVEL_H_
+#define LEVEL_H_
+
+// Levelling at startup (MODE_LEVEL) rolls the ball into the frame corners, so it only runs if enabled here or
+//  at runtime (LevelEnabled) and no level was loaded (LEVEL_PERSIST). It can always be started from the button
+//  modes. Without it the CENTER_x and SERVO_x_ZERO defaults (or the saved level) are used
+#define LEVEL_DEFAULT_ENABLE false
+
+// Servo command (10th of a degree from the level estimate) that rolls the ball against the frame
+#define LEVEL_EDGE_TILT 200
+
+// The ball has to roll this far (counts) before it can be at rest against the frame, a hold leaves it
+//  within LEVEL_HOLD_BAND of the center
+#define LEVEL_EDGE_TRAVEL 400
+
+// The ball is at rest against the frame once STILL_SAMPLES readings in a row are within STILL_SPREAD counts
+#define LEVEL_STILL_SAMPLES 3
+#define LEVEL_STILL_SPREAD 16
+
+// Frame readings this close to the end of the ADC range are clipped, the center of the axis is kept
+#define LEVEL_ADC_MARGIN 8
+
+// Probing moves: the level estimate plus/minus PROBE (10th of a degree) for PROBE_SAMPLES PID periods,
+//  the ball acceleration is fitted to the readings of each move
+#define LEVEL_PROBE 30
+#define LEVEL_PROBE_SAMPLES 10
+
+// Between the moves the ball is held (PD with the PID gains) until it is within HOLD_BAND counts of the
+//  center and moves less than HOLD_SPEED counts per PID period, for HOLD_SAMPLES periods
+#define LEVEL_HOLD_BAND 500
+#define LEVEL_HOLD_SPEED 30
+#define LEVEL_HOLD_SAMPLES 2
+
+// Done once a pair of moves corrects the level by at most TOLERANCE (10th of a degree) on both axes,
+//  a correction is limited to MAX_STEP and the level to MAX_TRIM from the SERVO_x_ZERO defaults
+#define LEVEL_TOLERANCE 3
+#define LEVEL_MAX_STEP 60
+#define LEVEL_MAX_TRIM 150
+
+// Smallest acceleration per 10th of a degree (counts per PID period squared) of a ball that rolls freely
+#define LEVEL_MIN_SLOPE 0.03f
+
+// Give up after this many pairs of moves or PID periods, the defaults are kept
+#define LEVEL_ROUNDS 6
+#define LEVEL_TIMEOUT 400
+
+// Save the result (EEPROM) and load it at startup
+#define LEVEL_PERSIST false
+
+// Levelling status
+#define LEVEL_IDLE 0
+#define LEVEL_RUNNING 1
+#define LEVEL_DONE 2
+#define LEVEL_FAILED 3
+
+extern _Bool LevelEnabled;
+extern uint8_t LevelStatus;
+
+// Pairs of moves of the last run
+extern uint8_t LevelRounds;
+
+void Level_Start(void);
+_Bool Level_TakeCenter(void);
+float Level_Accel(const int32_t *positions, uint8_t count);
+_Bool Level_Correction(float accelPlus, float accelMinus, int32_t *correction);
+void UpdateLevelController(void);
+
+#endif /* LEVEL_H_ */
@@ -0,0 +1,55 @@
+/*
+ * linkage.c
+ *
+ * Servo linkage compensation
+ *  Maps the desired plate tilt of both axes to the servo pulses through the 2D tables
+ *  of linkageTable.h (generated by tools/linkage.c from the linkage dimensions), with
+ *  bilinear interpolation. Both tables take both tilts, the plate pivot couples the axes.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "linkage.h"
+#include "servoScale.h"
+
+#define LINKAGE_STEP (1 << LINKAGE_STEP_SHIFT)
+#define LINKAGE_LAST ((LINKAGE_GRID - 1) * LINKAGE_STEP - 1)
+
+const int16_t LinkagePulseX[LINKAGE_GRID * LINKAGE_GRID] = LINKAGE_TABLE_X;
+const int16_t LinkagePulseY[LINKAGE_GRID * LINKAGE_GRID] = LINKAGE_TABLE_Y;
+
+// Plate tilt the controller meant with a servo offset of <degrees> (10th of a degree), the linkage ratio at level
+int32_t Linkage_Tilt(int32_t degrees) {
+    return (degrees * LINKAGE_TILT_PER_DEGREE) >> 16;
+}
+
+// Table lookup, <u> and <v> are grid positions scaled by LINKAGE_STEP (rows are tiltY, columns tiltX)
+static int32_t Interpolate(const int16_t *table, uint32_t u, uint32_t v) {
+    uint32_t fu = u & (LINKAGE_STEP - 1);
+    uint32_t fv = v & (LINKAGE_STEP - 1);
+    const int16_t *cell = &table[(v >> LINKAGE_STEP_SHIFT) * LINKAGE_GRID + (u >> LINKAGE_STEP_SHIFT)];
+
+    int32_t top = cell[0] + (((cell[1] - cell[0]) * (int32_t)fu) >> LINKAGE_STEP_SHIFT);
+    int32_t bottom = cell[LINKAGE_GRID] + (((cell[LINKAGE_GRID + 1] - cell[LINKAGE_GRID]) * (int32_t)fu) >> LINKAGE_STEP_SHIFT);
+    return top + (((bottom - top) * (int32_t)fv) >> LINKAGE_STEP_SHIFT);
+}
+
+/* Servo pulses (PWM ticks) for a plate tilt of <tiltX>, <tiltY> (100th of a degree) from the level at the servo
+ *  positions <zeroX>, <zeroY> (10th of a degree, ServoZeroX/Y). The table is anchored at the measured level
+ *  instead of the zeros it was generated for (LINKAGE_LEVEL_PULSE_X/Y), so the levelling isn't lost.
+ */
+void Linkage_Pulse(int32_t tiltX, int32_t tiltY, int32_t zeroX, int32_t zeroY, uint32_t *pulseX, uint32_t *pulseY) {
+    int32_t u = tiltX + LINKAGE_TILT_RANGE;
+    int32_t v = tiltY + LINKAGE_TILT_RANGE;
+    if(u < 0) u = 0;
+    if(u > LINKAGE_LAST) u = LINKAGE_LAST;
+    if(v < 0) v = 0;
+    if(v > LINKAGE_LAST) v = LINKAGE_LAST;
+
+    // Table entries are offsets from the level pulse in 16th of a tick
+    *pulseX = ServoScale_Ticks(zeroX * 10) + ((Interpolate(LinkagePulseX, u, v) + 8) >> 4);
+    *pulseY = ServoScale_Ticks(zeroY * 10) + ((Interpolate(LinkagePulseY, u, v) + 8) >> 4);
+}
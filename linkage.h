@@ -0,0 +1,23 @@
+/*
+ * linkage.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef LINKAGE_H_
+#define LINKAGE_H_
+
+#include "linkageTable.h"
+
+// Drive the servos through the linkage table instead of the linear Servo_Set_Degrees() mapping.
+//  Regenerate linkageTable.h (tools/linkage.c) with the measured linkage dimensions first
+#define LINKAGE_COMPENSATION false
+
+// Plate tilt is in 100th of a degree, positive moves the ball towards larger touch readings
+#define LINKAGE_TILT_RANGE (((LINKAGE_GRID - 1) / 2) << LINKAGE_STEP_SHIFT)
+
+int32_t Linkage_Tilt(int32_t degrees);
+void Linkage_Pulse(int32_t tiltX, int32_t tiltY, int32_t zeroX, int32_t zeroY, uint32_t *pulseX, uint32_t *pulseY);
+
+#endif /* LINKAGE_H_ */
@@ -0,0 +1,70 @@
+/*
+ * linkageTable.h
+ *
+ * Generated by tools/linkage.c, do not edit
+ *  Linkage: attachment 80 mm, horn 28 mm, rod 60 mm, servo zeros 867/867
+ *  Plate tilt per horn angle at level: 0.3500
+ */
+
+#ifndef LINKAGETABLE_H_
+#define LINKAGETABLE_H_
+
+// 21 x 21 grid of plate tilts, 2^LINKAGE_STEP_SHIFT 100th of a degree apart, centered on level
+#define LINKAGE_GRID 21
+#define LINKAGE_STEP_SHIFT 7
+
+// Plate tilt (100th of a degree) per servo 10th of a degree at level (scaled by 2^16)
+#define LINKAGE_TILT_PER_DEGREE 229376
+
+// Servo pulses at level (PWM ticks)
+#define LINKAGE_LEVEL_PULSE_X 3788
+#define LINKAGE_LEVEL_PULSE_Y 3788
+
+// Pulse offsets from level (16th of a PWM tick), rows are tiltY, columns tiltX
+#define LINKAGE_TABLE_X { \
+   -16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416 \
+   ,-16768,-14795,-12947,-11187,-9493,-7848,-6240,-4658,-3096,-1545,0,1545,3096,4657,6234,7834,9462,11126,12833,14593,16416}
+
+#define LINKAGE_TABLE_Y { \
+   -16399,-16468,-16531,-16586,-16634,-16675,-16709,-16735,-16753,-16765,-16768,-16765,-16753,-16735,-16709,-16675,-16634,-16586,-16531,-16468,-16399 \
+   ,-14476,-14536,-14590,-14638,-14680,-14715,-14744,-14767,-14783,-14792,-14795,-14792,-14783,-14767,-14744,-14715,-14680,-14638,-14590,-14536,-14476 \
+   ,-12669,-12722,-12769,-12810,-12847,-12877,-12902,-12922,-12936,-12944,-12947,-12944,-12936,-12922,-12902,-12877,-12847,-12810,-12769,-12722,-12669 \
+   ,-10946,-10992,-11033,-11069,-11100,-11127,-11149,-11165,-11178,-11185,-11187,-11185,-11178,-11165,-11149,-11127,-11100,-11069,-11033,-10992,-10946 \
+   ,-9287,-9326,-9361,-9392,-9419,-9441,-9460,-9475,-9485,-9491,-9493,-9491,-9485,-9475,-9460,-9441,-9419,-9392,-9361,-9326,-9287 \
+   ,-7675,-7708,-7737,-7763,-7786,-7805,-7820,-7833,-7841,-7846,-7848,-7846,-7841,-7833,-7820,-7805,-7786,-7763,-7737,-7708,-7675 \
+   ,-6100,-6126,-6150,-6171,-6189,-6205,-6217,-6227,-6234,-6239,-6240,-6239,-6234,-6227,-6217,-6205,-6189,-6171,-6150,-6126,-6100 \
+   ,-4552,-4572,-4590,-4606,-4620,-4632,-4641,-4649,-4654,-4657,-4658,-4657,-4654,-4649,-4641,-4632,-4620,-4606,-4590,-4572,-4552 \
+   ,-3023,-3037,-3049,-3060,-3070,-3078,-3084,-3089,-3093,-3095,-3096,-3095,-3093,-3089,-3084,-3078,-3070,-3060,-3049,-3037,-3023 \
+   ,-1508,-1515,-1521,-1527,-1532,-1536,-1539,-1542,-1544,-1545,-1545,-1545,-1544,-1542,-1539,-1536,-1532,-1527,-1521,-1515,-1508 \
+   ,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 \
+   ,1505,1513,1520,1526,1531,1535,1539,1541,1543,1545,1545,1545,1543,1541,1539,1535,1531,1526,1520,1513,1505 \
+   ,3014,3029,3043,3055,3066,3075,3082,3088,3092,3095,3096,3095,3092,3088,3082,3075,3066,3055,3043,3029,3014 \
+   ,4529,4554,4575,4594,4611,4625,4636,4645,4652,4656,4657,4656,4652,4645,4636,4625,4611,4594,4575,4554,4529 \
+   ,6058,6091,6121,6148,6171,6190,6206,6218,6227,6233,6234,6233,6227,6218,6206,6190,6171,6148,6121,6091,6058 \
+   ,7604,7648,7687,7721,7751,7776,7797,7813,7825,7832,7834,7832,7825,7813,7797,7776,7751,7721,7687,7648,7604 \
+   ,9174,9228,9277,9320,9358,9390,9416,9436,9451,9460,9462,9460,9451,9436,9416,9390,9358,9320,9277,9228,9174 \
+   ,10773,10839,10899,10952,10998,11037,11069,11094,11112,11123,11126,11123,11112,11094,11069,11037,10998,10952,10899,10839,10773 \
+   ,12408,12488,12560,12624,12679,12726,12765,12795,12816,12829,12833,12829,12816,12795,12765,12726,12679,12624,12560,12488,12408 \
+   ,14088,14183,14269,14344,14410,14466,14511,14547,14572,14588,14593,14588,14572,14547,14511,14466,14410,14344,14269,14183,14088 \
+   ,15822,15934,16034,16123,16201,16266,16320,16362,16392,16410,16416,16410,16392,16362,16320,16266,16201,16123,16034,15934,15822}
+
+#endif /* LINKAGETABLE_H_ */
@@ -0,0 +1,212 @@
+/*
+ * loss.c
+ *
+ * Ball loss detection and recovery
+ *  A failed touch read starts a contact dropout: the controllers keep running at
+ *  the PID rate on the position predicted from the last sample and its velocity,
+ *  a bouncing ball flies on without feeling the plate. The sample that ends the
+ *  dropout moves the derivative history by the prediction error. If no sample
+ *  arrives for LOSS_DROPOUT_MS the ball is lost, the controllers stop and the plate
+ *  is levelled so a ball put back doesn't roll off. Once the ball is back the
+ *  setpoint profile restarts from it at its speed (reference.c) and the controllers
+ *  restart on it with empty integrators and the current servo command, so there is
+ *  no kick and the ball is brought to the target like a new target. The first ball
+ *  starts control on the setpoint as it is.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "lqr.h"
+#include "reference.h"
+#include "loss.h"
+
+_Bool LossEnabled = LOSS_DEFAULT_ENABLE;
+
+// No ball until the first samples arrive
+uint8_t LossState = LOSS_LOST;
+
+// Last touch sample, its time and the velocity estimate (counts per ms, scaled by 2^LOSS_SHIFT)
+int32_t lossLastX = 0;
+int32_t lossLastY = 0;
+int32_t lossVelX = 0;
+int32_t lossVelY = 0;
+unsigned long lossSampleTime = 0;
+
+// The controllers ran on a coasted position since the last sample
+_Bool lossCoasting = false;
+
+// A ball was tracked since Loss_Init(), only a ball that comes back restarts the profile
+_Bool lossTracked = false;
+
+// Samples in a row since the ball was lost, the first of them and its time
+uint8_t lossSamples = 0;
+int32_t lossFirstX = 0;
+int32_t lossFirstY = 0;
+unsigned long lossFirstTime = 0;
+
+// Profile restart for the setpoint writer (Loss_TakeRestart()), the ball position and velocity (counts/s)
+//  are written before the flag. Posted is the main loop's side: asked for this return of the ball
+uint32_t lossRestartX = 0;
+uint32_t lossRestartY = 0;
+int32_t lossRestartVelX = 0;
+int32_t lossRestartVelY = 0;
+volatile _Bool lossRestart = false;
+_Bool lossPosted = false;
+
+void Loss_Init(void) {
+    LossState = LOSS_LOST;
+    lossVelX = lossVelY = 0;
+    lossCoasting = false;
+    lossTracked = false;
+    lossSamples = 0;
+    lossRestart = lossPosted = false;
+}
+
+// Velocity of one axis, averaged over two samples so touch noise doesn't dominate the coasting
+static int32_t Velocity(int32_t velocity, int32_t position, int32_t last, unsigned long elapsed) {
+    if(elapsed == 0) return velocity;
+    int32_t measured = ((position - last) << LOSS_SHIFT) / (int32_t)elapsed;
+    return velocity + (measured - velocity) / 2;
+}
+
+/* A sample while the ball is lost
+ *  The velocity is taken from the first sample since the ball came back. The first ball starts control
+ *  on the setpoint as it is after LOSS_FIRST_SAMPLES. A ball that comes back after LOSS_REACQUIRE_SAMPLES
+ *  has the setpoint writer restart the profile from it, the controllers restart with the next sample
+ *  once it has
+ */
+static void Reacquire(uint32_t x, uint32_t y, unsigned long time) {
+    if(lossSamples == 0) {
+        lossFirstX = x;
+        lossFirstY = y;
+        lossFirstTime = time;
+        lossVelX = lossVelY = 0;
+    } else if(time != lossFirstTime) {
+        lossVelX = (((int32_t)x - lossFirstX) << LOSS_SHIFT) / (int32_t)(time - lossFirstTime);
+        lossVelY = (((int32_t)y - lossFirstY) << LOSS_SHIFT) / (int32_t)(time - lossFirstTime);
+    }
+    if(lossSamples < LOSS_REACQUIRE_SAMPLES) lossSamples++;
+
+    if(!lossTracked) {
+        if(lossSamples >= LOSS_FIRST_SAMPLES) {
+            lossSamples = 0;
+            LossState = LOSS_TRACKING;
+            lossTracked = true;
+            Controller_Restart((lossVelX * PID_UPDATE_RATE) >> LOSS_SHIFT, (lossVelY * PID_UPDATE_RATE) >> LOSS_SHIFT);
+            LQR_Init();
+        }
+    } else if(!lossPosted) {
+        if(lossSamples >= LOSS_REACQUIRE_SAMPLES && !lossRestart) {
+            lossRestartX = x;
+            lossRestartY = y;
+            lossRestartVelX = (lossVelX * 1000) >> LOSS_SHIFT;
+            lossRestartVelY = (lossVelY * 1000) >> LOSS_SHIFT;
+            lossRestart = true;
+            lossPosted = true;
+        }
+    } else if(!lossRestart) {
+        lossSamples = 0;
+        lossPosted = false;
+        LossState = LOSS_TRACKING;
+        // The profile moves the setpoint with the ball, without it the derivative starts from the ball movement
+        if(ReferenceEnabled) {
+            Controller_Restart(0, 0);
+        } else {
+            Controller_Restart((lossVelX * PID_UPDATE_RATE) >> LOSS_SHIFT, (lossVelY * PID_UPDATE_RATE) >> LOSS_SHIFT);
+        }
+        LQR_Init();
+    }
+}
+
+// Called with every good touch sample
+void Loss_Sample(uint32_t x, uint32_t y, unsigned long time) {
+    if(LossState == LOSS_LOST && LossEnabled) {
+        Reacquire(x, y, time);
+    } else {
+        if(LossState == LOSS_DROPOUT && lossCoasting) {
+            uint32_t coastX, coastY;
+            Loss_Coast(time, &coastX, &coastY);
+            Controller_Correct((int32_t)x - (int32_t)coastX, (int32_t)y - (int32_t)coastY);
+        }
+        lossCoasting = false;
+        lossVelX = Velocity(lossVelX, x, lossLastX, time - lossSampleTime);
+        lossVelY = Velocity(lossVelY, y, lossLastY, time - lossSampleTime);
+        LossState = LOSS_TRACKING;
+        lossTracked = true;
+    }
+
+    lossLastX = x;
+    lossLastY = y;
+    lossSampleTime = time;
+}
+
+// Called with every failed touch read
+void Loss_Missed(unsigned long time) {
+    lossSamples = 0;
+    lossPosted = false;
+    if(LossState == LOSS_LOST) return;
+
+    if(time - lossSampleTime > LOSS_DROPOUT_MS) {
+        LossState = LOSS_LOST;
+    } else {
+        LossState = LOSS_DROPOUT;
+    }
+}
+
+// True if the control updates run without a touch sample (coasting or levelling)
+_Bool Loss_Controlling(void) {
+    return LossEnabled && (LossState != LOSS_TRACKING);
+}
+
+/* Predicted ball position at <time> during a dropout
+ *  Constant velocity: the servo command doesn't move a ball in the air, and on the plate the tilt
+ *  lags the command by more than a dropout lasts
+ */
+void Loss_Coast(unsigned long time, uint32_t *x, uint32_t *y) {
+    int32_t elapsed = time - lossSampleTime;
+    int32_t predictedX = lossLastX + ((lossVelX * elapsed) >> LOSS_SHIFT);
+    int32_t predictedY = lossLastY + ((lossVelY * elapsed) >> LOSS_SHIFT);
+
+    *x = Limit(predictedX, 0, 4095);
+    *y = Limit(predictedY, 0, 4095);
+}
+
+// One step of the level plate profile for an axis (10th of a degree from the servo zero)
+static int32_t Level(int32_t offset) {
+    return offset - Limit(offset, -LOSS_LEVEL_STEP, LOSS_LEVEL_STEP);
+}
+
+/* Called at the PID update, returns true if the controller should run
+ *  During a dropout the predicted position is published as the ball position, after a loss the
+ *  plate is moved towards level instead
+ */
+_Bool Loss_ControlUpdate(unsigned long time) {
+    if(!LossEnabled || LossState == LOSS_TRACKING) return true;
+
+    if(LossState == LOSS_DROPOUT) {
+        uint32_t x, y;
+        Loss_Coast(time, &x, &y);
+        SeqLock_WritePair(&Ball, x, y);
+        lossCoasting = true;
+        return true;
+    }
+
+    currentXDegrees = ServoZeroX + Level((int32_t)currentXDegrees - ServoZeroX);
+    currentYDegrees = ServoZeroY + Level((int32_t)currentYDegrees - ServoZeroY);
+    return false;
+}
+
+// True once after the ball came back, with where it is and how fast it moves (counts/s), called by the setpoint writer
+_Bool Loss_TakeRestart(uint32_t *x, uint32_t *y, int32_t *velocityX, int32_t *velocityY) {
+    if(!lossRestart) return false;
+    *x = lossRestartX;
+    *y = lossRestartY;
+    *velocityX = lossRestartVelX;
+    *velocityY = lossRestartVelY;
+    lossRestart = false;
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+ * loss.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef LOSS_H_
+#define LOSS_H_
+
+// Ball loss handling is on unless disabled here or at runtime (LossEnabled), without it the
+//  servos hold their last command while there is no touch sample
+#define LOSS_DEFAULT_ENABLE true
+
+// Touch samples may be missing this long (ms) before the ball counts as lost. Shorter gaps are
+//  a contact dropout (bounce, panel contact) and the controllers coast on the predicted position
+#define LOSS_DROPOUT_MS 60
+
+// Servo command change per PID period while the plate is levelled after a loss (10th of a degree)
+#define LOSS_LEVEL_STEP 20
+
+// Touch samples in a row that start control on the first ball (boot.c)
+#define LOSS_FIRST_SAMPLES 2
+
+// Touch samples in a row that bring the ball back after a loss, its velocity is taken over them
+#define LOSS_REACQUIRE_SAMPLES 5
+
+// Velocity estimate is in counts per ms scaled by 2^LOSS_SHIFT, the command model by 2^16
+#define LOSS_SHIFT 8
+
+// Loss states
+#define LOSS_TRACKING 0             // Touch samples arrive
+#define LOSS_DROPOUT 1              // Samples missing for less than LOSS_DROPOUT_MS, coasting
+#define LOSS_LOST 2                 // No ball, the plate is levelled until it is back
+
+extern _Bool LossEnabled;
+extern uint8_t LossState;
+
+void Loss_Init(void);
+void Loss_Sample(uint32_t x, uint32_t y, unsigned long time);
+void Loss_Missed(unsigned long time);
+_Bool Loss_Controlling(void);
+_Bool Loss_ControlUpdate(unsigned long time);
+void Loss_Coast(unsigned long time, uint32_t *x, uint32_t *y);
+_Bool Loss_TakeRestart(uint32_t *x, uint32_t *y, int32_t *velocityX, int32_t *velocityY);
+
+#endif /* LOSS_H_ */
@@ -0,0 +1,110 @@
+/*
+ * lqr.c
+ *
+ * State feedback (LQR) controller, an alternative to UpdatePIDController()
+ *  Per axis state: position error, change in position since the last update,
+ *  sum of the position error and the last LQR_DELAY+1 commands. The gains in
+ *  lqrGains.h are generated by tools/lqr.c from the plant model.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "lqrGains.h"
+#include "lqr.h"
+
+const int32_t LQRGainInput[LQR_DELAY + 1] = LQR_GAIN_INPUT;
+
+int32_t lqrIntegralX = 0;
+int32_t lqrIntegralY = 0;
+int32_t lqrLastX = 0;
+int32_t lqrLastY = 0;
+uint32_t lqrLastSetX = 0;
+uint32_t lqrLastSetY = 0;
+_Bool lqrStarted = false;
+
+// Commands sent in the last LQR_DELAY+1 updates (newest first, 10th of a degree from zero)
+int32_t lqrInputX[LQR_DELAY + 1];
+int32_t lqrInputY[LQR_DELAY + 1];
+
+void LQR_Init(void) {
+    uint8_t i;
+    for(i = 0; i <= LQR_DELAY; i++) {
+        lqrInputX[i] = 0;
+        lqrInputY[i] = 0;
+    }
+    lqrIntegralX = 0;
+    lqrIntegralY = 0;
+    lqrStarted = false;
+}
+
+// command = -K * state, rounded
+static int32_t Feedback(int32_t error, int32_t dif, int32_t integral, const int32_t *inputs) {
+    int32_t sum = LQR_GAIN_POS * error + LQR_GAIN_DIF * dif + LQR_GAIN_INT * integral;
+    uint8_t i;
+    for(i = 0; i <= LQR_DELAY; i++) {
+        sum += LQRGainInput[i] * inputs[i];
+    }
+    return -((sum + (1 << (LQR_SHIFT - 1))) >> LQR_SHIFT);
+}
+
+static void PushInput(int32_t *inputs, int32_t command) {
+    uint8_t i;
+    for(i = LQR_DELAY; i > 0; i--) {
+        inputs[i] = inputs[i - 1];
+    }
+    inputs[0] = command;
+}
+
+void UpdateLQRController(void) {
+    uint32_t setX, setY, x, y;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+    SeqLock_ReadPair(&Ball, &x, &y);
+
+    if(!lqrStarted) {
+        lqrLastX = x;
+        lqrLastY = y;
+        lqrLastSetX = setX;
+        lqrLastSetY = setY;
+        lqrStarted = true;
+    }
+
+    int32_t errorX = (int32_t)(x) - (int32_t)setX;
+    int32_t errorY = (int32_t)(y) - (int32_t)setY;
+
+    // Ball movement rather than error change so set point changes don't kick the output
+    int32_t difX = (int32_t)(x) - lqrLastX;
+    int32_t difY = (int32_t)(y) - lqrLastY;
+    lqrLastX = x;
+    lqrLastY = y;
+
+    // During a setpoint transition the state is taken relative to the profile: its movement and its
+    //  feedforward command are left out, so the feedback doesn't work against the feedforward
+    int32_t feedforwardX = 0, feedforwardY = 0;
+    if(SetpointMoving) {
+        difX -= (int32_t)setX - (int32_t)lqrLastSetX;
+        difY -= (int32_t)setY - (int32_t)lqrLastSetY;
+        feedforwardX = SetpointFeedforwardX;
+        feedforwardY = SetpointFeedforwardY;
+    }
+    lqrLastSetX = setX;
+    lqrLastSetY = setY;
+
+    int32_t xVal = Feedback(errorX, difX, lqrIntegralX, lqrInputX) + feedforwardX;
+    int32_t yVal = Feedback(errorY, difY, lqrIntegralY, lqrInputY) + feedforwardY;
+
+    Controller_Output(xVal, yVal);
+
+    int32_t appliedX = currentXDegrees - ServoZeroX;
+    int32_t appliedY = currentYDegrees - ServoZeroY;
+    PushInput(lqrInputX, appliedX - feedforwardX);
+    PushInput(lqrInputY, appliedY - feedforwardY);
+
+    // Only integrate while the output isn't saturated (anti windup) and the setpoint isn't in a transition
+    if(SetpointMoving) return;
+    if(appliedX == xVal) lqrIntegralX = Limit(lqrIntegralX + errorX, -LQR_INTEGRAL_RANGE, LQR_INTEGRAL_RANGE);
+    if(appliedY == yVal) lqrIntegralY = Limit(lqrIntegralY + errorY, -LQR_INTEGRAL_RANGE, LQR_INTEGRAL_RANGE);
+}
@@ -0,0 +1,17 @@
+/*
+ * lqr.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef LQR_H_
+#define LQR_H_
+
+// Limit of the position error sum (counts * PID periods)
+#define LQR_INTEGRAL_RANGE 40000
+
+void LQR_Init(void);
+void UpdateLQRController(void);
+
+#endif /* LQR_H_ */
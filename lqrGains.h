@@ -0,0 +1,22 @@
+/*
+ * lqrGains.h
+ *
+ * Generated by tools/lqr.c, do not edit
+ *  Model: K = 77 counts/s^2 per 0.1 deg, a = 0.3 1/s, T = 40 ms, 1 period(s) of dead time
+ *  Weights: qpos = 1, qdif = 12, qint = 5e-05, r = 3
+ *  Closed loop spectral radius: 0.9930
+ */
+
+#ifndef LQRGAINS_H_
+#define LQRGAINS_H_
+
+// Gains are scaled by 2^LQR_SHIFT, command = -(POS*p + DIF*dp + INT*i + INPUT . past commands)
+#define LQR_SHIFT 16
+#define LQR_DELAY 1
+
+#define LQR_GAIN_POS 32289
+#define LQR_GAIN_DIF 234392
+#define LQR_GAIN_INT 216
+#define LQR_GAIN_INPUT {27242, 14497}
+
+#endif /* LQRGAINS_H_ */
@@ -7,128 +7,201 @@
 #include "driverlib/interrupt.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/gpio.h"
+#include "driverlib/fpu.h"
+#include "driverlib/watchdog.h"
 #include "button.h"
+#include "touchPhase.h"
 #include "touch.h"
+#include "settle.h"
+#include "boot.h"
 #include "servo.h"
 #include "com.h"
-
-// Timer related defines, Change these to modify update times
-// All variables in milliseconds (ms)
-#define TOUCH_UPDATE_RATE 10
-
-#define UART_UPDATE_DELAY 100
-#define UART_UPDATE_RATE 100
-
-#define PID_UPDATE_DELAY 240
-#define PID_UPDATE_RATE 40
-
-#define MOTOR_UPDATE_DELAY 280
-#define MOTOR_UPDATE_RATE 40
-
-
-// Maximum PID ErrorSum before Ki saturates (Keep this low as Windup is not handled)
-#define PID_ERROR_SUM_RANGE 100000
-
-// Number of motor samples to be averaged (Will slow down the response of the system but reduces
-#define MOTOR_SAMPLES 1
-
-// Touch screen center positions
-#define CENTER_X 2150
-#define CENTER_Y 2150
-
-// Servo center positions and range of movements (in 10th of a degrees, 900 = 90 deg)
-#define SERVO_X_ZERO 880
-#define SERVO_Y_ZERO 880
-
-#define SERVO_X_RANGE 300
-#define SERVO_Y_RANGE 350
-
-// This depends on the python script used to generate the lookup table
-#define CIRCLE_SIZE 360
-#define CIRCLE_DEFAULT_RATE 5
+#include "controller.h"
+#include "circle.h"
+#include "trajectory.h"
+#include "waypoint.h"
+#include "sysid.h"
+#include "lqr.h"
+#include "autotune.h"
+#include "level.h"
+#include "storage.h"
+#include "linkage.h"
+#include "idle.h"
+#include "loss.h"
+#include "reference.h"
+#include "latency.h"
+#include "supervisor.h"
 
 // Function Definitions
 void Setup(void);
 void SysTick_Init(unsigned long);
 void SysTick_Handler(void);
+void MoveCircleTarget(uint16_t next);
+void MoveTrajectoryTarget(void);
+void MoveWaypointTarget(void);
+void OnServoFrame(void);
 void OnButtonPushed(_Bool btn1, _Bool btn2);
+void OnLatencyPin(uint8_t pin);
+void OnFault(uint32_t *frame);
+uint8_t RestartDecision(void);
+void Watchdog_Init(void);
 _Bool UpdateBallPosition(void);
-void UpdatePIDController(void);
 void UpdateMotor(void);
+void UpdateSystemIdentification(void);
+void Idle(void);
+uint32_t BootMicros(void);
 
 // Volatile Definitions
-volatile uint32_t currentXDegrees = SERVO_X_ZERO;
-volatile uint32_t currentYDegrees = SERVO_Y_ZERO;
 volatile unsigned long currentTime = 0;
+
+// SysTick time of the servo frame starts (modulo SERVO_FRAME_PERIOD) less SERVO_UPDATE_LEAD
+volatile unsigned long frameOffset = 0;
 volatile _Bool needTouchUpdate = true;
 volatile _Bool needUARTUpdate = false;
 volatile _Bool needPIDUpdate = false;
 volatile _Bool needMotorUpdate = false;
-volatile _Bool needCircleUpdate = false;
-
-
-// PID Controller Variables
-uint32_t SetPosition_X = CENTER_X;
-uint32_t SetPosition_Y = CENTER_Y;
 
-int32_t ErrorXLast = 0;
-int32_t ErrorXSum = 0;
-int32_t ErrorXDif = 0;
+// Touch read failed in this SysTick period, retried after the next one
+volatile _Bool touchRetry = false;
 
-int32_t ErrorYLast = 0;
-int32_t ErrorYSum = 0;
-int32_t ErrorYDif = 0;
 
-// PID K Constants. (Good values: 120, 25, 240)
-const int32_t Px = 120;
-const int32_t Ix = 5;
-const int32_t Dx = 240;
-
-const int32_t Py = 120;
-const int32_t Iy = 5;
-const int32_t Dy = 220;
-
-// Lookup tables generated with Python script (CircleGenerator.py)
+// Circle mode state (tables are in circle.c), only used by the interrupts
 uint16_t CircleUpdateRate = CIRCLE_DEFAULT_RATE;
 uint16_t CirclePosition_Index = 0;
-const int16_t CirclePosition_X[CIRCLE_SIZE] = {250,250,250,250,249,249,249,248,248,247,246,245,245,244,243,241,240,239,238,236,235,233,232,230,228,227,225,223,221,219,217,214,212,210,207,205,202,200,197,194,192,189,186,183,180,177,174,170,167,164,161,157,154,150,147,143,140,136,132,129,125,121,117,113,110,106,102,98,94,90,86,81,77,73,69,65,60,56,52,48,43,39,35,30,26,22,17,13,9,4,0,-4,-9,-13,-17,-22,-26,-30,-35,-39,-43,-48,-52,-56,-60,-65,-69,-73,-77,-81,-86,-90,-94,-98,-102,-106,-110,-113,-117,-121,-125,-129,-132,-136,-140,-143,-147,-150,-154,-157,-161,-164,-167,-170,-174,-177,-180,-183,-186,-189,-192,-194,-197,-200,-202,-205,-207,-210,-212,-214,-217,-219,-221,-223,-225,-227,-228,-230,-232,-233,-235,-236,-238,-239,-240,-241,-243,-244,-245,-245,-246,-247,-248,-248,-249,-249,-249,-250,-250,-250,-250,-250,-250,-250,-249,-249,-249,-248,-248,-247,-246,-245,-245,-244,-243,-241,-240,-239,-238,-236,-235,-233,-232,-230,-228,-227,-225,-223,-221,-219,-217,-214,-212,-210,-207,-205,-202,-200,-197,-194,-192,-189,-186,-183,-180,-177,-174,-170,-167,-164,-161,-157,-154,-150,-147,-143,-140,-136,-132,-129,-125,-121,-117,-113,-110,-106,-102,-98,-94,-90,-86,-81,-77,-73,-69,-65,-60,-56,-52,-48,-43,-39,-35,-30,-26,-22,-17,-13,-9,-4,0,4,9,13,17,22,26,30,35,39,43,48,52,56,60,65,69,73,77,81,86,90,94,98,102,106,110,113,117,121,125,129,132,136,140,143,147,150,154,157,161,164,167,170,174,177,180,183,186,189,192,194,197,200,202,205,207,210,212,214,217,219,221,223,225,227,228,230,232,233,235,236,238,239,240,241,243,244,245,245,246,247,248,248,249,249,249,250,250,250};
-const int16_t CirclePosition_Y[CIRCLE_SIZE] = {0,4,9,13,17,22,26,30,35,39,43,48,52,56,60,65,69,73,77,81,86,90,94,98,102,106,110,113,117,121,125,129,132,136,140,143,147,150,154,157,161,164,167,170,174,177,180,183,186,189,192,194,197,200,202,205,207,210,212,214,217,219,221,223,225,227,228,230,232,233,235,236,238,239,240,241,243,244,245,245,246,247,248,248,249,249,249,250,250,250,250,250,250,250,249,249,249,248,248,247,246,245,245,244,243,241,240,239,238,236,235,233,232,230,228,227,225,223,221,219,217,214,212,210,207,205,202,200,197,194,192,189,186,183,180,177,174,170,167,164,161,157,154,150,147,143,140,136,132,129,125,121,117,113,110,106,102,98,94,90,86,81,77,73,69,65,60,56,52,48,43,39,35,30,26,22,17,13,9,4,0,-4,-9,-13,-17,-22,-26,-30,-35,-39,-43,-48,-52,-56,-60,-65,-69,-73,-77,-81,-86,-90,-94,-98,-102,-106,-110,-113,-117,-121,-125,-129,-132,-136,-140,-143,-147,-150,-154,-157,-161,-164,-167,-170,-174,-177,-180,-183,-186,-189,-192,-194,-197,-200,-202,-205,-207,-210,-212,-214,-217,-219,-221,-223,-225,-227,-228,-230,-232,-233,-235,-236,-238,-239,-240,-241,-243,-244,-245,-245,-246,-247,-248,-248,-249,-249,-249,-250,-250,-250,-250,-250,-250,-250,-249,-249,-249,-248,-248,-247,-246,-245,-245,-244,-243,-241,-240,-239,-238,-236,-235,-233,-232,-230,-228,-227,-225,-223,-221,-219,-217,-214,-212,-210,-207,-205,-202,-200,-197,-194,-192,-189,-186,-183,-180,-177,-174,-170,-167,-164,-161,-157,-154,-150,-147,-143,-140,-136,-132,-129,-125,-121,-117,-113,-110,-106,-102,-98,-94,-90,-86,-81,-77,-73,-69,-65,-60,-56,-52,-48,-43,-39,-35,-30,-26,-22,-17,-13,-9,-4};
-;
 
-// Variables for averaging motor set points
-uint8_t averageIndex = 0;
-uint32_t degreeAverageX[MOTOR_SAMPLES];
-uint32_t degreeAverageY[MOTOR_SAMPLES];
+// Trajectory mode state (streams are in trajectoryTable.h), only used by the interrupts. The player is one
+//  setpoint ahead of the target, each trajectory mode entry plays the next trajectory
+TrajectoryPlayer trajectoryPlayer;
+uint8_t trajectoryIndex = TRAJECTORY_COUNT - 1;
+
+// Waypoint mode target (counts from the center), only used by the interrupts
+int32_t waypointTargetX = 0;
+int32_t waypointTargetY = 0;
 
 // Variables to hold the current ball position
 _Bool touchPresent = false;
-uint32_t x = 0;
-uint32_t y = 0;
 
-uint8_t mode = 0;
+// Written by the button interrupt, the main loop reads it once per pass
+volatile uint8_t mode = 0;
+
+// Auto-tune result has been written to the EEPROM
+_Bool gainsSaved = false;
+
+// Levelling result has been written to the EEPROM
+_Bool levelSaved = false;
+
+// Boot breakdown has been sent
+_Bool bootReported = false;
+
+// Fault report of the restart (supervisor.h), sent at the end of Setup()
+char faultReport[SUPERVISOR_REPORT_SIZE];
+uint8_t faultReportLength = 0;
+
+// SysTick feeds the watchdog once it runs, the fault handlers write the state here (not on a stack that may be broken)
+volatile _Bool watchdogStarted = false;
+SupervisorState faultState;
+
+// Peripherals of all modules, their clocks start together instead of one after the other
+static const uint32_t bootPeripherals[] = {
+    SYSCTL_PERIPH_GPIOA, SYSCTL_PERIPH_UART0,                       // com.c
+    SYSCTL_PERIPH_GPIOF, SYSCTL_PERIPH_TIMER1,                      // button.c
+    SYSCTL_PERIPH_EEPROM0,                                          // storage.c
+    SYSCTL_PERIPH_GPIOB, SYSCTL_PERIPH_PWM0,                        // servo.c
+    SYSCTL_PERIPH_GPIOD, SYSCTL_PERIPH_ADC0, SYSCTL_PERIPH_ADC1,    // touch.c
+    SYSCTL_PERIPH_WDOG0                                             // supervisor.c
+};
+
+#define BOOT_PERIPHERAL_COUNT (sizeof(bootPeripherals) / sizeof(bootPeripherals[0]))
 
 void Setup(void) {
+    // Control starts once the system is ready (boot.c), SysTick checks it from its first tick
+    Boot_Init();
+
+    // The compiler emits FPU instructions for float code (CONTROLLER_FLOAT, --float_support=FPv4SPD16), the FPU is off
+    //  after reset. With lazy stacking an interrupt of float code only reserves stack for the FPU registers,
+    //  they are saved if the handler uses the FPU too, so the integer interrupt handlers don't pay for it
+    FPUEnable();
+    FPULazyStackingEnable();
+
     // Setting Clock to 80MHz
       SysCtlClockSet(SYSCTL_SYSDIV_2_5|SYSCTL_USE_PLL|SYSCTL_XTAL_16MHZ|SYSCTL_OSC_MAIN);
 
+    // A restart after a fault takes the level, center and gains of the record instead of the EEPROM and the levelling
+    uint8_t restart = RestartDecision();
+
     //mInitialization of system components..
-    SysTick_Init(80000);
+    SysTick_Init(IDLE_TICK_CYCLES);
+
+    // Start all peripheral clocks, then wait for all, the module inits find them ready
+    uint8_t i;
+    for(i = 0; i < BOOT_PERIPHERAL_COUNT; i++) {
+        SysCtlPeripheralEnable(bootPeripherals[i]);
+    }
+    for(i = 0; i < BOOT_PERIPHERAL_COUNT; i++) {
+        while(!SysCtlPeripheralReady(bootPeripherals[i])) {}
+    }
+    Boot_Stage(BOOT_STAGE_PERIPHERALS, BootMicros());
+
     Button_Init(OnButtonPushed); // on_button_pushed() is provided as the callback function
 
     COM_Init();
 
-    //Send 'START\r\n' over uart
+    // Latency debug pins PA2 - PA6 (Port A is clocked for the UART)
+    if(LATENCY_GPIO) {
+        GPIOPinTypeGPIOOutput(GPIO_PORTA_BASE, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6);
+    }
+
+    //Send 'START\r\n' over uart (fits the UART FIFO, doesn't wait for the transmission)
     UARTCharSend('S'); UARTCharSend('T'); UARTCharSend('A'); UARTCharSend('R'); UARTCharSend('T'); UARTCharSend('\r'); UARTCharSend('\n');
+    Boot_Stage(BOOT_STAGE_IO, BootMicros());
+
+    Controller_Init();
+    Reference_Init(CenterX, CenterY);
+    Loss_Init();
+    Idle_Init();
+    Latency_Init(OnLatencyPin);
+    Boot_Stage(BOOT_STAGE_STATE, BootMicros());
+
+    if(restart == SUPERVISOR_WARM) {
+        // The servos start at the level of the fault, control holds the center as soon as the ball is read
+        Supervisor_Restore(&SupervisorFault.state);
+        Controller_Init();
+        Reference_Init(CenterX, CenterY);
+    } else {
+        // Use the gains of the last auto-tune and the center and level of the last levelling
+        Storage_Init();
+        if(AUTOTUNE_PERSIST) {
+            Storage_LoadGains();
+        }
+        _Bool levelLoaded = LEVEL_PERSIST && Storage_LoadLevel();
+        if(levelLoaded) {
+            Controller_Init();
+            Reference_Init(CenterX, CenterY);
+        }
 
-    //Initialize Average Motor Arrays
-    uint8_t i;
-    for(i = 0; i < MOTOR_SAMPLES; i++) {
-        degreeAverageX[i] = SERVO_X_ZERO;
-        degreeAverageY[i] = SERVO_Y_ZERO;
+        // Start in the levelling mode if there is no saved level, it holds the ball with the PID once done
+        if(LevelEnabled && !levelLoaded) {
+            mode = MODE_LEVEL;
+            levelSaved = false;
+            Level_Start();
+        }
     }
-    Servo_Init(SERVO_Y_ZERO, SERVO_X_ZERO);
+    Boot_ConfigLoaded();
+    Boot_Stage(BOOT_STAGE_STORAGE, BootMicros());
+
+    Servo_Init(ServoZeroY, ServoZeroX);
+    Servo_Frame_Init(OnServoFrame);
+    Boot_Stage(BOOT_STAGE_SERVO, BootMicros());
 
     Touch_Init();
+    Boot_Stage(BOOT_STAGE_TOUCH, BootMicros());
+
+    // Fault that caused the restart (waits for the UART), the servos are already on their way to the level
+    for(i = 0; i < faultReportLength; i++) {
+        UARTCharSend(faultReport[i]);
+    }
+
+    Watchdog_Init();
 }
 
 int main(void) {
@@ -137,145 +210,388 @@ int main(void) {
   // Main update loop
   while(1) {
       // Waits for SysTick Timer logic to set the "need____Update" variables for true
+      uint8_t currentMode = mode;
 
-      if(needTouchUpdate) {
-          //UpdateBallPosition returns true only if the read was successful, keep trying until then
+      // PID period this pass works for (supervisor.h), one that starts during the pass isn't done by it
+      uint32_t period = Supervisor_Token();
+
+      // Periodic characterization pass of the touch settle times, probed during the next readings
+      Settle_Update(currentTime);
+
+      if(needTouchUpdate && !touchRetry) {
+          //UpdateBallPosition returns true only if the read was successful, try again after the next SysTick until then
           if(UpdateBallPosition()) {
               // If Read was successful, clear the update flag and set <touchPresent> to true
               needTouchUpdate = false;
               touchPresent = true;
               LEDWrite(RED);
+
+              // System identification drives the servos at the touch rate
+              if(currentMode == MODE_SYSID) {
+                  UpdateSystemIdentification();
+              }
           } else {
               touchPresent = false;
+              touchRetry = true;
+              Loss_Missed(currentTime);
+              Boot_TouchSample(false, 0, 0);
               LEDWrite(OFF);
           }
       }
 
-      // Only called when the current mode is following a circle
-      if(needCircleUpdate) {
-          needCircleUpdate = false;
-          SetPosition_X = CENTER_X + CirclePosition_X[CirclePosition_Index];
-          SetPosition_Y = CENTER_Y + CirclePosition_Y[CirclePosition_Index];
-      }
-
-      // Update PID controller
-      if(needPIDUpdate && touchPresent) {
+      // Update PID controller, without a touch sample it coasts through a dropout or levels the plate (loss.c)
+      if(needPIDUpdate && (touchPresent || Loss_Controlling()) && (currentMode != MODE_SYSID)) {
           needPIDUpdate = false;
-          UpdatePIDController();
+          if(Loss_ControlUpdate(currentTime)) {
+              if(currentMode == MODE_LQR) {
+                  UpdateLQRController();
+              } else if(currentMode == MODE_AUTOTUNE) {
+                  UpdateAutoTuneController();
+
+                  if(AUTOTUNE_PERSIST && (AutoTuneStatus == AUTOTUNE_DONE) && !gainsSaved) {
+                      Storage_SaveGains();
+                      gainsSaved = true;
+                  }
+              } else if(currentMode == MODE_LEVEL) {
+                  UpdateLevelController();
+
+                  if(LEVEL_PERSIST && (LevelStatus == LEVEL_DONE) && !levelSaved) {
+                      Storage_SaveLevel();
+                      levelSaved = true;
+                  }
+              } else {
+                  UpdatePIDController();
+              }
+              Latency_Control(BootMicros());
+          }
       }
 
       // Update Motor with the current PID values
-      if(needMotorUpdate && touchPresent) {
+      if(needMotorUpdate && (touchPresent || Loss_Controlling()) && (currentMode != MODE_SYSID)) {
           needMotorUpdate = false;
           UpdateMotor();
+          Latency_Write(BootMicros());
+      }
+
+      // Nothing of the control work of the period waiting, it counts for the watchdog if within its window
+      if(!((needPIDUpdate || needMotorUpdate) && (touchPresent || Loss_Controlling()) && (currentMode != MODE_SYSID))) {
+          Supervisor_Done(period, currentTime);
       }
 
       // Send the current ball position over UART to a connected Computer
-      if(needUARTUpdate && touchPresent) {
+      if(needUARTUpdate && touchPresent && (currentMode != MODE_SYSID)) {
           needUARTUpdate = false;
+          uint32_t x, y;
+          SeqLock_ReadPair(&Ball, &x, &y);
           UARTIntSend(x);
           UARTCharSend(',');
           UARTIntSend(y);
+          if(IDLE_REPORT) {
+              UARTCharSend(',');
+              UARTSignedIntSend(IdlePercent);
+          }
+          UARTCharSend('\r');
+          UARTCharSend('\n');
+      }
+
+      // Waypoint flow control and underruns (waypoint.h)
+      if(currentMode == MODE_WAYPOINT) {
+          char report[WAYPOINT_REPORT_SIZE];
+          uint8_t length = Waypoint_Report(report);
+          uint8_t i;
+          for(i = 0; i < length; i++) {
+              UARTCharSend(report[i]);
+          }
+      }
+
+      // Touch to servo latency percentiles (latency.h), also collects the latch ages of the frame interrupt
+      if(LatencyEnabled && (currentMode != MODE_SYSID)) {
+          char report[LATENCY_REPORT_SIZE];
+          uint8_t length = Latency_Report(report, currentTime);
+          uint8_t i;
+          for(i = 0; i < length; i++) {
+              UARTCharSend(report[i]);
+          }
+      }
+
+      // Boot breakdown once control started: "BOOT,<stage us>...,<control start ms>"
+      if(BOOT_REPORT && !bootReported && BootControlMs > 0 && (currentMode != MODE_SYSID)) {
+          bootReported = true;
+          uint8_t stage;
+          UARTCharSend('B'); UARTCharSend('O'); UARTCharSend('O'); UARTCharSend('T');
+          for(stage = 0; stage < BOOT_STAGE_COUNT; stage++) {
+              UARTCharSend(',');
+              UARTSignedIntSend(BootStageUs[stage]);
+          }
+          UARTCharSend(',');
+          UARTSignedIntSend(BootControlMs);
           UARTCharSend('\r');
           UARTCharSend('\n');
       }
+
+      Idle();
   }
 }
 
-/* Function called when a button is pushed */
+/* Function called when a button is pushed
+ *  Runs in the debounce timer interrupt, which has the same priority as SysTick so the
+ *  two setpoint writers never preempt each other
+ */
 void OnButtonPushed(_Bool btn1, _Bool btn2) {
     // Change mode/state variable depending on the button that was pushed
     if(btn1) {
-        mode = (mode + 1)%6;
+        mode = (mode + 1)%MODE_COUNT;
     } else if(btn2) {
         if(mode > 0) {
             mode --;
         } else {
-            mode = 5;
+            mode = MODE_COUNT - 1;
         }
     }
 
-    // Handle new mode
+    // Waypoint lines are only taken in their mode
+    if(mode != MODE_WAYPOINT) {
+        Waypoint_Stop();
+    }
+
+    // Handle new mode, the setpoint moves to the new target on a profile (reference.c)
     switch(mode) {
     default:
-        needCircleUpdate = false;
-        SetPosition_X = CENTER_X;
-        SetPosition_Y = CENTER_Y;
+        Reference_Target(CenterX, CenterY);
         break;
     case(1):
-        needCircleUpdate = false;
-        SetPosition_X = CENTER_X + 600;
-        SetPosition_Y = CENTER_Y;
+        Reference_Target(CenterX + 600, CenterY);
         break;
     case(2):
-        needCircleUpdate = false;
-        SetPosition_X = CENTER_X - 600;
-        SetPosition_Y = CENTER_Y;
+        Reference_Target(CenterX - 600, CenterY);
         break;
     case(3):
-        CircleUpdateRate = CIRCLE_DEFAULT_RATE;
     case(4):
+        // Chases the circle from the current setpoint, SysTick moves the target on
         CircleUpdateRate = CIRCLE_DEFAULT_RATE;
+        Reference_Target(CenterX + CirclePosition_X[CirclePosition_Index], CenterY + CirclePosition_Y[CirclePosition_Index]);
+        break;
+    case(MODE_SYSID):
+        // The identification drives the servos itself, no profile
+        Reference_Init(CenterX, CenterY);
+        SysId_Start(SYSID_DEFAULT_SIGNAL);
+        break;
+    case(MODE_LQR):
+        Reference_Target(CenterX, CenterY);
+        LQR_Init();
+        break;
+    case(MODE_AUTOTUNE):
+        Reference_Target(CenterX, CenterY);
+        gainsSaved = false;
+        AutoTune_Start(AUTOTUNE_DEFAULT_RULE);
+        break;
+    case(MODE_LEVEL):
+        Reference_Target(CenterX, CenterY);
+        levelSaved = false;
+        Level_Start();
+        break;
+    case(MODE_TRAJECTORY):
+        // Chases the first setpoint like the circles, SysTick moves the target on
+        trajectoryIndex = (trajectoryIndex + 1) % TRAJECTORY_COUNT;
+        Trajectory_Start(&trajectoryPlayer, &Trajectories[trajectoryIndex], TrajectoryData);
+        Reference_Target(CenterX + trajectoryPlayer.x, CenterY + trajectoryPlayer.y);
+        break;
+    case(MODE_WAYPOINT):
+        // Holds the center until the host streams waypoints
+        waypointTargetX = 0;
+        waypointTargetY = 0;
+        Waypoint_Start(0, 0);
+        Reference_Target(CenterX, CenterY);
+        break;
     }
 }
 
+/* Called at the start of every servo frame (PWM reload, where new pulse widths are latched)
+ *  Moves the control update phase to SERVO_UPDATE_LEAD ms before the frame start
+ */
+void OnServoFrame(void) {
+    frameOffset = (currentTime + SERVO_FRAME_PERIOD - SERVO_UPDATE_LEAD) % SERVO_FRAME_PERIOD;
+    Boot_ServoFrame();
+
+    // SysTick can't preempt here, a tick pending since the frame interrupt was taken reads up to 1 ms early
+    Latency_Latch(BootMicros());
+}
+
+// Publishes the sample only if both axes were read with the ball on the plate
 _Bool UpdateBallPosition() {
+    Latency_Capture(BootMicros());
     if(!Touch_Present()) return false;
-    x = Touch_Read_X();
+    uint32_t x = Touch_Read_X();
     if(!Touch_Present()) return false;
-    y = Touch_Read_Y();
+    uint32_t y = Touch_Read_Y();
+    SeqLock_WritePair(&Ball, x, y);
+    Latency_Sample(BootMicros());
+    Loss_Sample(x, y, currentTime);
+    Boot_TouchSample(true, x, y);
     return true;
 }
 
-int32_t Limit(int32_t value, int32_t min, int32_t max) {
-    if(value > max) return max;
-    if(value < min) return min;
-    return value;
+void UpdateMotor(void) {
+    uint32_t xDegrees = currentXDegrees;
+    uint32_t yDegrees = currentYDegrees;
+
+    if(LINKAGE_COMPENSATION) {
+        // The outputs are plate tilts (at the linkage ratio at level), the table finds the horn angles
+        uint32_t pulseX, pulseY;
+        Linkage_Pulse(Linkage_Tilt((int32_t)xDegrees - ServoZeroX), Linkage_Tilt((int32_t)yDegrees - ServoZeroY),
+                      ServoZeroX, ServoZeroY, &pulseX, &pulseY);
+
+        Servo_Set(SERVO_1, pulseY);
+        Servo_Set(SERVO_2, pulseX);
+        Servo_Update();
+        return;
+    }
+
+    Servo_Set_Degrees(SERVO_1, yDegrees);
+    Servo_Set_Degrees(SERVO_2, xDegrees);
+    Servo_Update();
 }
 
-int32_t Abs(int32_t value) {
-    if(value < 0) return -value;
-    return value;
+/* System identification update, called after every successful touch read
+ *  Streams "sample,excitationX,commandX,x,excitationY,commandY,y" until the excitation ends
+ */
+void UpdateSystemIdentification(void) {
+    _Bool streaming = SysId_Running();
+    uint32_t x, y;
+    SeqLock_ReadPair(&Ball, &x, &y);
+    SysId_Update(x, y);
+
+    Servo_Set_Degrees(SERVO_1, ServoZeroY + SysIdCommandY);
+    Servo_Set_Degrees(SERVO_2, ServoZeroX + SysIdCommandX);
+    Servo_Update();
+
+    if(!streaming) return;
+
+    UARTSignedIntSend(SysIdSample - 1); UARTCharSend(',');
+    UARTSignedIntSend(SysIdExcitationX); UARTCharSend(',');
+    UARTSignedIntSend(SysIdCommandX); UARTCharSend(',');
+    UARTSignedIntSend(x); UARTCharSend(',');
+    UARTSignedIntSend(SysIdExcitationY); UARTCharSend(',');
+    UARTSignedIntSend(SysIdCommandY); UARTCharSend(',');
+    UARTSignedIntSend(y);
+    UARTCharSend('\r');
+    UARTCharSend('\n');
 }
 
-void UpdatePIDController(void) {
-    int32_t ErrorX = SetPosition_X - (int32_t)(x); //Range of -4096 to 4096
-    int32_t ErrorY = SetPosition_Y - (int32_t)(y); //Range of -4096 to 4096
+// Toggles the latency debug pin of a stage (latency.h), PA2 for the capture, PA3 - PA6 for the stages
+void OnLatencyPin(uint8_t pin) {
+    uint8_t mask = (pin == LATENCY_PIN_CAPTURE) ? GPIO_PIN_2 : (GPIO_PIN_3 << pin);
+    GPIOPinWrite(GPIO_PORTA_BASE, mask, ~GPIOPinRead(GPIO_PORTA_BASE, mask));
+}
 
-	// This should have code for resetting/handling wind-up
-    ErrorXSum = Limit(ErrorXSum + ErrorX, -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE); //*dt
-    ErrorYSum = Limit(ErrorYSum + ErrorY, -PID_ERROR_SUM_RANGE, PID_ERROR_SUM_RANGE); //*dt
+/* Reads and clears the reset cause, decides the restart from it and the fault record (supervisor.h)
+ *  Keeps the report of the fault for the end of Setup() and takes the fault as handled
+ */
+uint8_t RestartDecision(void) {
+    uint32_t cause = SysCtlResetCauseGet();
+    SysCtlResetCauseClear(cause);
+
+    uint8_t reset;
+    if(cause & (SYSCTL_CAUSE_POR | SYSCTL_CAUSE_BOR)) {
+        reset = SUPERVISOR_RESET_POWER;
+    } else if(cause & SYSCTL_CAUSE_WDOG0) {
+        reset = SUPERVISOR_RESET_WATCHDOG;
+    } else if(cause & SYSCTL_CAUSE_SW) {
+        reset = SUPERVISOR_RESET_SOFTWARE;
+    } else {
+        reset = SUPERVISOR_RESET_PIN;
+    }
 
-    ErrorXDif = Limit(ErrorX - ErrorXLast, -500, 500); //dt
-    ErrorYDif = Limit(ErrorY - ErrorYLast, -500, 500); //dt
+    uint8_t decision = SupervisorEnabled ? Supervisor_Decide(&SupervisorFault, reset) : SUPERVISOR_COLD;
+    faultReportLength = Supervisor_Report(faultReport, &SupervisorFault, decision);
+    Supervisor_Restart(&SupervisorFault, decision);
+    return decision;
+}
 
-    // Calculate PID Control
-    int32_t xVal = ((Px * ErrorX) + (Ix * ErrorXSum)/5 + (Dx * ErrorXDif) * 5)/100;
-    int32_t yVal = ((Py * ErrorY) + (Iy * ErrorYSum)/5 + (Dy * ErrorYDif) * 5)/100;
+/* Starts the watchdog, SysTick feeds it from the next PID period
+ *  Its first timeout raises the NMI that captures the fault and resets, the second one
+ *  resets in hardware if the capture doesn't get there (a locked up core). Stops with the debugger.
+ */
+void Watchdog_Init(void) {
+    // MPU, bus and usage faults are taken by their own vectors, not escalated to a hard fault
+    NVIC_SYS_HND_CTRL_R |= NVIC_SYS_HND_CTRL_USAGE | NVIC_SYS_HND_CTRL_BUS | NVIC_SYS_HND_CTRL_MEM;
+
+    if(!SupervisorEnabled) return;
+
+    Supervisor_Start();
+    WatchdogReloadSet(WATCHDOG0_BASE, SUPERVISOR_TIMEOUT * IDLE_TICK_CYCLES);
+    WatchdogIntTypeSet(WATCHDOG0_BASE, WATCHDOG_INT_TYPE_NMI);
+    WatchdogStallEnable(WATCHDOG0_BASE);
+    WatchdogResetEnable(WATCHDOG0_BASE);
+    WatchdogEnable(WATCHDOG0_BASE);
+    watchdogStarted = true;
+}
 
-    averageIndex = (averageIndex + 1) % MOTOR_SAMPLES;
+/* Fault capture, the fault handlers of the startup file branch here with the stack frame of the exception entry
+ *  Writes the fault record (supervisor.h) and resets. Spins as the handlers did with the supervision off.
+ */
+void OnFault(uint32_t *frame) {
+    if(!SupervisorEnabled) {
+        while(1) {}
+    }
 
-    currentXDegrees = SERVO_X_ZERO + Limit(xVal / 10, -SERVO_X_RANGE, SERVO_X_RANGE);
-    degreeAverageX[averageIndex] = currentXDegrees;
+    uint32_t exception = NVIC_INT_CTRL_R & NVIC_INT_CTRL_VEC_ACT_M;
+    uint8_t cause;
+    if(exception == SUPERVISOR_CAUSE_NMI && watchdogStarted && WatchdogIntStatus(WATCHDOG0_BASE, false)) {
+        cause = SUPERVISOR_CAUSE_WATCHDOG;
+    } else if(exception <= SUPERVISOR_CAUSE_USAGE) {
+        cause = exception;
+    } else {
+        cause = SUPERVISOR_CAUSE_INTERRUPT;
+    }
 
-    currentYDegrees = SERVO_Y_ZERO + Limit(yVal / 10, -SERVO_Y_RANGE, SERVO_Y_RANGE);
-    degreeAverageY[averageIndex] = currentYDegrees;
+    // The frame is only read if the stack pointer is within the SRAM (a stack overflow or a corrupted one)
+    if((uint32_t)frame < 0x20000000 || (uint32_t)frame > 0x20008000 - SUPERVISOR_REGISTERS * 4) {
+        frame = 0;
+    }
 
-    ErrorXLast = ErrorX;
-    ErrorYLast = ErrorY;
+    uint32_t cfsr = NVIC_FAULT_STAT_R;
+    uint32_t address = 0;
+    if(cfsr & NVIC_FAULT_STAT_BFARV) {
+        address = NVIC_FAULT_ADDR_R;
+    } else if(cfsr & NVIC_FAULT_STAT_MMARV) {
+        address = NVIC_MM_ADDR_R;
+    }
+
+    Supervisor_Save(&faultState, mode, BootControlMs > 0);
+    Supervisor_Capture(&SupervisorFault, cause, frame, cfsr, NVIC_HFAULT_STAT_R, address, currentTime, &faultState);
+    SysCtlReset();
 }
 
-void UpdateMotor(void) {
-    uint32_t sumX = 0;
-    uint32_t sumY = 0;
-    uint8_t i;
-    for(i = 0; i < MOTOR_SAMPLES; i++) {
-        sumX += degreeAverageX[i];
-        sumY += degreeAverageY[i];
+/* Sleeps until the next interrupt when none of the tasks can run
+ *  The flags are checked with interrupts disabled. An interrupt after the check stays
+ *  pending, so the WFI returns at once and its handler runs when they are enabled again.
+ */
+void Idle(void) {
+    IntMasterDisable();
+
+    IdleTasks tasks = {needTouchUpdate, touchRetry, needPIDUpdate, needMotorUpdate, needUARTUpdate,
+                       touchPresent, Loss_Controlling(), (mode == MODE_SYSID)};
+    if(Idle_CanSleep(&tasks)) {
+        // SysTick counts down and reloads every IDLE_TICK_CYCLES, the sleep is shorter than a tick
+        uint32_t start = SysTickValueGet();
+        SysCtlSleep();
+        uint32_t end = SysTickValueGet();
+        Idle_Slept((start + IDLE_TICK_CYCLES - end) % IDLE_TICK_CYCLES);
     }
 
-    Servo_Set_Degrees(SERVO_1, sumY / MOTOR_SAMPLES);
-    Servo_Set_Degrees(SERVO_2, sumX / MOTOR_SAMPLES);
+    IntMasterEnable();
+}
+
+// Time since SysTick started (us), SysTick counts down from IDLE_TICK_CYCLES - 1 every ms
+uint32_t BootMicros(void) {
+    unsigned long ms;
+    uint32_t value;
+    do {
+        ms = currentTime;
+        value = SysTickValueGet();
+    } while(ms != currentTime);
+    return ms * 1000 + (IDLE_TICK_CYCLES - 1 - value) / (IDLE_TICK_CYCLES / 1000);
 }
 
 void SysTick_Init(unsigned long period) {
@@ -309,12 +625,18 @@ void SysTick_Init(unsigned long period) {
 */
 void SysTick_Handler(void){
     currentTime++;
+    touchRetry = false;
+    Idle_Tick();
+
+    // Time shifted so the control updates land just before a servo frame starts
+    unsigned long frameTime = currentTime + SERVO_FRAME_PERIOD - frameOffset;
 
-    if((currentTime % TOUCH_UPDATE_RATE) == 0) {
+    if((frameTime % TOUCH_UPDATE_RATE) == 0) {
         needTouchUpdate = true;
     }
 
-    if((currentTime > PID_UPDATE_DELAY) && ((currentTime % PID_UPDATE_RATE) == 0)) {
+    // Control starts when the system is ready (boot.c)
+    if(Boot_ControlReady(currentTime, PID_UPDATE_DELAY) && ((frameTime % PID_UPDATE_RATE) == 0)) {
         needPIDUpdate = true;
     }
 
@@ -322,15 +644,20 @@ void SysTick_Handler(void){
         needUARTUpdate = true;
     }
 
-    if((currentTime > MOTOR_UPDATE_DELAY) && ((currentTime % MOTOR_UPDATE_RATE) == 0)) {
+    if(Boot_ControlReady(currentTime, MOTOR_UPDATE_DELAY) && ((frameTime % MOTOR_UPDATE_RATE) == 0)) {
         needMotorUpdate = true;
     }
 
+    // Feeds the watchdog (clearing its interrupt reloads it) if the main loop made the last PID period
+    if(watchdogStarted && ((frameTime % PID_UPDATE_RATE) == 0) && Supervisor_Period(currentTime)) {
+        WatchdogIntClear(WATCHDOG0_BASE);
+    }
+
     // If the mode is a circle update mode, increment the index
     if((mode == 3) && (currentTime % CircleUpdateRate) == 0) {
 		// Increment Up
         CirclePosition_Index = (CirclePosition_Index + 1) % CIRCLE_SIZE;
-        needCircleUpdate = true;
+        MoveCircleTarget((CirclePosition_Index + 1) % CIRCLE_SIZE);
     } else if((mode == 4) && (currentTime % CircleUpdateRate) == 0) {
 		// Increment Down
         if(CirclePosition_Index > 0) {
@@ -338,7 +665,48 @@ void SysTick_Handler(void){
         } else {
             CirclePosition_Index = CIRCLE_SIZE - 1;
         }
-        needCircleUpdate = true;
+        MoveCircleTarget((CirclePosition_Index + CIRCLE_SIZE - 1) % CIRCLE_SIZE);
+    } else if((mode == MODE_TRAJECTORY) && (currentTime % trajectoryPlayer.trajectory->period) == 0) {
+        MoveTrajectoryTarget();
+    } else if((mode == MODE_WAYPOINT) && (currentTime % WAYPOINT_UPDATE_RATE) == 0) {
+        MoveWaypointTarget();
+    }
+
+    // The setpoint follows the center found by the levelling
+    if(Level_TakeCenter()) {
+        Reference_Target(CenterX, CenterY);
     }
+
+    // A ball back after a loss is brought to the target by the profile (loss.c)
+    uint32_t x, y;
+    int32_t velocityX, velocityY;
+    if(Loss_TakeRestart(&x, &y, &velocityX, &velocityY)) {
+        Reference_Restart(x, y, velocityX, velocityY);
+    }
+
+    Reference_Update();
+}
+
+// Circle target at the current index, reaching index <next> at the next circle update
+void MoveCircleTarget(uint16_t next) {
+    Reference_Moving(CenterX + CirclePosition_X[CirclePosition_Index], CenterY + CirclePosition_Y[CirclePosition_Index],
+                     CenterX + CirclePosition_X[next], CenterY + CirclePosition_Y[next], CircleUpdateRate);
+}
+
+// Trajectory target at the player's setpoint, reaching the next one a period later (held at the end of an open one)
+void MoveTrajectoryTarget(void) {
+    int32_t x = trajectoryPlayer.x;
+    int32_t y = trajectoryPlayer.y;
+    Trajectory_Next(&trajectoryPlayer);
+    Reference_Moving(CenterX + x, CenterY + y, CenterX + trajectoryPlayer.x, CenterY + trajectoryPlayer.y,
+                     trajectoryPlayer.trajectory->period);
+}
+
+// Waypoint target at the last interpolated setpoint, reaching the next one an update later
+void MoveWaypointTarget(void) {
+    int32_t x = waypointTargetX;
+    int32_t y = waypointTargetY;
+    Waypoint_Setpoint(currentTime + WAYPOINT_UPDATE_RATE, &waypointTargetX, &waypointTargetY);
+    Reference_Moving(CenterX + x, CenterY + y, CenterX + waypointTargetX, CenterY + waypointTargetY, WAYPOINT_UPDATE_RATE);
 }
 
@@ -0,0 +1,99 @@
+/*
+ * notch.c
+ *
+ * Adaptive notch on the controller outputs against the structure resonance
+ *  A high D gain makes the loop ring the printed plate and servo mounts at their
+ *  resonance, the servos chatter at that frequency. The oscillation is tracked in
+ *  the second difference of the error by a second order all pass notch whose
+ *  frequency follows the normalized gradient of its output power. The same
+ *  frequency notches the controller output, (x + A(x)) / 2 has unity gain away
+ *  from the notch so the loop keeps its phase at the ball frequencies.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "notch.h"
+
+_Bool NotchEnabled = NOTCH_DEFAULT_ENABLE;
+int32_t NotchDepth = NOTCH_DEFAULT_DEPTH;
+int32_t NotchWidth = NOTCH_DEFAULT_WIDTH;
+
+#define ONE (1L << NOTCH_SHIFT)
+
+/* All pass pole radius squared for the notch width (scaled by 2^NOTCH_SHIFT)
+ *  k = (1 - t) / (1 + t) with t = tan(pi * width / 25 Hz) ~ pi * width / 25 Hz
+ */
+static int32_t Radius(void) {
+    int32_t t = NotchWidth * 206;           // pi * 2^14 / (10 * 25 Hz), width in 10th of a Hz
+    if(t < 0) t = 0;
+    if(t > ONE) t = ONE;
+    return ((ONE - t) << NOTCH_SHIFT) / (ONE + t);
+}
+
+/* Second order all pass with its phase at -180 deg at the notch frequency, one sample of <x>
+ *  A(z) = (k - c z^-1 + z^-2) / (1 - c z^-1 + k z^-2), c = coeff * (1 + k) / 2
+ *  <s1>, <s2> are the last two values of its direct form II state
+ */
+static int32_t AllPass(int32_t x, int32_t c, int32_t k, int32_t *s1, int32_t *s2) {
+    int32_t s = x + (int32_t)(((int64_t)c * *s1 - (int64_t)k * *s2) >> NOTCH_SHIFT);
+    int32_t a = (int32_t)(((int64_t)k * s - (int64_t)c * *s1) >> NOTCH_SHIFT) + *s2;
+    *s2 = *s1;
+    *s1 = s;
+    return a;
+}
+
+// Starts an axis at the start frequency, at rest at <output> (10th of a degree)
+void Notch_Reset(NotchAxis *n, int32_t output) {
+    int32_t k = Radius();
+    int32_t c = (int32_t)(((int64_t)NOTCH_COEFF_START * (ONE + k)) >> (NOTCH_SHIFT + 1));
+
+    n->coeff = NOTCH_COEFF_START;
+    n->lastError = n->lastError2 = 0;
+    n->started = false;
+    n->w1 = n->w2 = 0;
+    n->power = 0;
+
+    // State of a constant input, s = x + c * s - k * s
+    n->u1 = n->u2 = (int32_t)(((int64_t)(output << NOTCH_SIGNAL_SHIFT) << NOTCH_SHIFT) / (ONE - c + k));
+}
+
+/* Notches one controller output of an axis, call once per output
+ *  <error> is the position error (counts) the output was computed from, <output> the output (10th of
+ *  a degree). Returns the output with the tracked frequency attenuated by NotchDepth
+ */
+int32_t Notch_Update(NotchAxis *n, int32_t error, int32_t output) {
+    int32_t k = Radius();
+
+    // Track on the second difference of the error, the ball movement itself is far below the resonance
+    if(!n->started) {
+        n->lastError = n->lastError2 = error;
+        n->started = true;
+    }
+    int32_t x = (error - 2 * n->lastError + n->lastError2) << NOTCH_SIGNAL_SHIFT;
+    n->lastError2 = n->lastError;
+    n->lastError = error;
+
+    int32_t c = (int32_t)(((int64_t)n->coeff * (ONE + k)) >> (NOTCH_SHIFT + 1));
+    int32_t w1 = n->w1;
+    int32_t notched = (x + AllPass(x, c, k, &n->w1, &n->w2)) / 2;
+
+    // Gradient step on the notched power, normalized by the power of the state it moves with
+    n->power += ((int64_t)w1 * w1 - n->power) >> NOTCH_POWER_SHIFT;
+    int64_t step = ((int64_t)notched * w1 << (NOTCH_SHIFT - NOTCH_ADAPT_SHIFT)) / (n->power + NOTCH_POWER_FLOOR);
+    if(step > NOTCH_ADAPT_LIMIT) step = NOTCH_ADAPT_LIMIT;
+    if(step < -NOTCH_ADAPT_LIMIT) step = -NOTCH_ADAPT_LIMIT;
+    n->coeff += (int32_t)step;
+    if(n->coeff > NOTCH_COEFF_MAX) n->coeff = NOTCH_COEFF_MAX;
+    if(n->coeff < NOTCH_COEFF_MIN) n->coeff = NOTCH_COEFF_MIN;
+
+    // Output minus the band around the notch, (x - A(x)) / 2
+    int32_t u = output << NOTCH_SIGNAL_SHIFT;
+    c = (int32_t)(((int64_t)n->coeff * (ONE + k)) >> (NOTCH_SHIFT + 1));
+    int32_t band = (u - AllPass(u, c, k, &n->u1, &n->u2)) / 2;
+    u -= (band * NotchDepth) >> 8;
+
+    return (u + (1 << (NOTCH_SIGNAL_SHIFT - 1))) >> NOTCH_SIGNAL_SHIFT;
+}
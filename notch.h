@@ -0,0 +1,54 @@
+/*
+ * notch.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef NOTCH_H_
+#define NOTCH_H_
+
+// Resonance notch on the controller outputs is off unless enabled here or at runtime (NotchEnabled)
+#define NOTCH_DEFAULT_ENABLE false
+
+// Attenuation at the tracked frequency (256 = full notch, 128 = -6 dB) and the notch width (10th of a Hz, -3 dB)
+#define NOTCH_DEFAULT_DEPTH 256
+#define NOTCH_DEFAULT_WIDTH 15
+
+// Coefficient scale, the notch frequency f is kept as 2 * cos(2 * pi * f / 25 Hz) (PID_UPDATE_RATE)
+#define NOTCH_SHIFT 14
+
+// Tracked frequencies, 11 Hz to 3 Hz (below the 12.5 Hz Nyquist frequency of the outputs), start at 7 Hz
+#define NOTCH_COEFF_MIN -30467
+#define NOTCH_COEFF_MAX 23887
+#define NOTCH_COEFF_START -6140
+
+// Adaptation step (1 / 2^NOTCH_ADAPT_SHIFT of the normalized gradient), its limit per output, the
+//  smoothing of the signal power (1 / 2^NOTCH_POWER_SHIFT per output) and the power below which the
+//  frequency moves slower (tracker state of 8 counts)
+#define NOTCH_ADAPT_SHIFT 3
+#define NOTCH_ADAPT_LIMIT 1024
+#define NOTCH_POWER_SHIFT 4
+#define NOTCH_POWER_FLOOR 16384
+
+// Internal resolution of the signals (16th of a count / of a 10th of a degree)
+#define NOTCH_SIGNAL_SHIFT 4
+
+typedef struct {
+    int32_t coeff;                  // 2 * cos(2 * pi * f / 25 Hz), scaled by 2^NOTCH_SHIFT
+    int32_t lastError, lastError2;  // Errors of the last two outputs (counts)
+    _Bool started;
+    int32_t w1, w2;                 // Tracker all pass state (scaled by 2^NOTCH_SIGNAL_SHIFT)
+    int64_t power;                  // Smoothed w1^2
+    int32_t u1, u2;                 // Output all pass state
+} NotchAxis;
+
+// Notch settings, can be changed at runtime
+extern _Bool NotchEnabled;
+extern int32_t NotchDepth;
+extern int32_t NotchWidth;
+
+void Notch_Reset(NotchAxis *n, int32_t output);
+int32_t Notch_Update(NotchAxis *n, int32_t error, int32_t output);
+
+#endif /* NOTCH_H_ */
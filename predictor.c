@@ -0,0 +1,145 @@
+/*
+ * predictor.c
+ *
+ * Dead time compensation for the PID controller
+ *  Commands only move the ball after the touch, servo frame and servo lag delays,
+ *  so the PID is given the position the ball will have once its new command takes
+ *  effect. The ball velocity is taken from the last two touch samples and rolled
+ *  forward through a double integrator model with the commands that were already
+ *  sent but haven't acted yet (the last <PredictorDelay> commands).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "predictor.h"
+
+_Bool PredictorEnabled = PREDICTOR_DEFAULT_ENABLE;
+uint8_t PredictorDelay = PREDICTOR_DEFAULT_DELAY;
+
+// Commands sent in the last PREDICTOR_HISTORY periods (10th of a degree from zero)
+int32_t commandHistoryX[PREDICTOR_HISTORY];
+int32_t commandHistoryY[PREDICTOR_HISTORY];
+uint8_t commandIndex = 0;
+
+// Observer estimate of the ball at the time of the touch sample (counts and counts/period, scaled by 65536)
+int32_t observedPosX = 0;
+int32_t observedPosY = 0;
+int32_t observedVelX = 0;
+int32_t observedVelY = 0;
+_Bool predictorStarted = false;
+
+// Same observer in float for Predictor_PredictFloat() (counts and counts/period)
+float observedPosXF = 0.0f;
+float observedPosYF = 0.0f;
+float observedVelXF = 0.0f;
+float observedVelYF = 0.0f;
+_Bool predictorFloatStarted = false;
+
+void Predictor_Init(void) {
+    uint8_t i;
+    for(i = 0; i < PREDICTOR_HISTORY; i++) {
+        commandHistoryX[i] = 0;
+        commandHistoryY[i] = 0;
+    }
+    commandIndex = 0;
+    predictorStarted = false;
+    predictorFloatStarted = false;
+}
+
+// Command sent <age> periods ago (1 = last period)
+static int32_t History(const int32_t *history, uint8_t age) {
+    return history[(commandIndex + PREDICTOR_HISTORY - age) % PREDICTOR_HISTORY];
+}
+
+/* Updates the observer of one axis with a new touch sample and returns the predicted position
+ *  The model is advanced with the command that was acting while the ball moved to <position>,
+ *  corrected toward the sample, then rolled forward with the commands still in the dead time
+ */
+static int32_t PredictAxis(int32_t position, int32_t *pos, int32_t *vel, const int32_t *history, int32_t gain) {
+    uint8_t delay = PredictorDelay;
+    if(delay > PREDICTOR_MAX_DELAY) delay = PREDICTOR_MAX_DELAY;
+
+    *vel += gain * History(history, delay + 1);
+    *pos += *vel;
+
+    int32_t innovation = (position << 16) - *pos;
+    *pos += (innovation / 256) * PREDICTOR_OBSERVER_POS;
+    *vel += (innovation / 256) * PREDICTOR_OBSERVER_VEL;
+
+    int32_t p = *pos;
+    int32_t v = *vel;
+    uint8_t age;
+    for(age = delay; age > 0; age--) {
+        v += gain * History(history, age);
+        p += v;
+    }
+
+    return (p + 0x8000) >> 16;
+}
+
+// Predicted ball position <PredictorDelay> PID periods after the touch sample
+void Predictor_Predict(int32_t x, int32_t y, int32_t *predictedX, int32_t *predictedY) {
+    if(!predictorStarted) {
+        observedPosX = x << 16;
+        observedPosY = y << 16;
+        observedVelX = 0;
+        observedVelY = 0;
+        predictorStarted = true;
+    }
+
+    *predictedX = PredictAxis(x, &observedPosX, &observedVelX, commandHistoryX, PREDICTOR_GAIN_X);
+    *predictedY = PredictAxis(y, &observedPosY, &observedVelY, commandHistoryY, PREDICTOR_GAIN_Y);
+}
+
+// PredictAxis() in float, the innovation isn't truncated to 256ths and the prediction keeps its fraction
+static float PredictAxisFloat(float position, float *pos, float *vel, const int32_t *history, float gain) {
+    uint8_t delay = PredictorDelay;
+    if(delay > PREDICTOR_MAX_DELAY) delay = PREDICTOR_MAX_DELAY;
+
+    *vel += gain * (float)History(history, delay + 1);
+    *pos += *vel;
+
+    float innovation = position - *pos;
+    *pos += innovation * (PREDICTOR_OBSERVER_POS / 256.0f);
+    *vel += innovation * (PREDICTOR_OBSERVER_VEL / 256.0f);
+
+    float p = *pos;
+    float v = *vel;
+    uint8_t age;
+    for(age = delay; age > 0; age--) {
+        v += gain * (float)History(history, age);
+        p += v;
+    }
+
+    return p;
+}
+
+// Predictor_Predict() for the float PID (CONTROLLER_FLOAT), the positions are in counts with their fraction
+void Predictor_PredictFloat(int32_t x, int32_t y, float *predictedX, float *predictedY) {
+    if(!predictorFloatStarted) {
+        observedPosXF = (float)x;
+        observedPosYF = (float)y;
+        observedVelXF = 0.0f;
+        observedVelYF = 0.0f;
+        predictorFloatStarted = true;
+    }
+
+    *predictedX = PredictAxisFloat((float)x, &observedPosXF, &observedVelXF, commandHistoryX, PREDICTOR_GAIN_X / 65536.0f);
+    *predictedY = PredictAxisFloat((float)y, &observedPosYF, &observedVelYF, commandHistoryY, PREDICTOR_GAIN_Y / 65536.0f);
+}
+
+// Records the command sent this period
+void Predictor_Push(int32_t commandX, int32_t commandY) {
+    commandHistoryX[commandIndex] = commandX;
+    commandHistoryY[commandIndex] = commandY;
+    commandIndex = (commandIndex + 1) % PREDICTOR_HISTORY;
+}
+
+// Command sent <age> periods ago (1 = last period, up to PREDICTOR_HISTORY)
+void Predictor_Command(uint8_t age, int32_t *commandX, int32_t *commandY) {
+    *commandX = History(commandHistoryX, age);
+    *commandY = History(commandHistoryY, age);
+}
@@ -0,0 +1,37 @@
+/*
+ * predictor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef PREDICTOR_H_
+#define PREDICTOR_H_
+
+// Dead time compensation is off unless enabled here or at runtime (PredictorEnabled)
+#define PREDICTOR_DEFAULT_ENABLE false
+
+// Dead time of the loop (touch sampling, servo frame and servo lag) in PID periods
+#define PREDICTOR_MAX_DELAY 8
+#define PREDICTOR_DEFAULT_DELAY 1
+#define PREDICTOR_HISTORY (PREDICTOR_MAX_DELAY + 1)
+
+// Observer correction of position and velocity per touch sample error (256 = 1.0)
+#define PREDICTOR_OBSERVER_POS 128
+#define PREDICTOR_OBSERVER_VEL 40
+
+// Model acceleration per PID period squared for a 10th of a degree command, scaled by 65536
+//  K * T^2 * 65536 with K from tools/sysid (77 counts/s^2 per 0.1 deg) and T = PID_UPDATE_RATE
+#define PREDICTOR_GAIN_X 8074
+#define PREDICTOR_GAIN_Y 8074
+
+extern _Bool PredictorEnabled;
+extern uint8_t PredictorDelay;
+
+void Predictor_Init(void);
+void Predictor_Predict(int32_t x, int32_t y, int32_t *predictedX, int32_t *predictedY);
+void Predictor_PredictFloat(int32_t x, int32_t y, float *predictedX, float *predictedY);
+void Predictor_Push(int32_t commandX, int32_t commandY);
+void Predictor_Command(uint8_t age, int32_t *commandX, int32_t *commandY);
+
+#endif /* PREDICTOR_H_ */
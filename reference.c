@@ -0,0 +1,208 @@
+/*
+ * reference.c
+ *
+ * Setpoint transition profiles
+ *  A new target (button mode change) no longer jumps the setpoint. The setpoint follows
+ *  a time optimal profile with an acceleration limit (and an optional speed limit) from
+ *  where it is, at the speed it has, to the target. A moving target (circle modes) is
+ *  chased the same way relative to the target until the profile joins it, after that
+ *  the target passes straight through. The profile brakes ahead of the target, so it
+ *  never overshoots it. While the profile runs the controllers don't integrate
+ *  (SetpointMoving), so a long move leaves no integral kick behind.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "shaper.h"
+#include "reference.h"
+
+_Bool ReferenceEnabled = REFERENCE_DEFAULT_ENABLE;
+int32_t ReferenceAccel = REFERENCE_DEFAULT_ACCEL;
+int32_t ReferenceSpeed = REFERENCE_DEFAULT_SPEED;
+
+ReferenceAxis referenceX;
+ReferenceAxis referenceY;
+
+// The target moves (Reference_Moving() since the last Reference_Target())
+_Bool targetMoving = false;
+
+// The profile brings back a ball (Reference_Restart() since the last Reference_Target())
+_Bool targetRestart = false;
+
+// Starts an axis at rest on the target <position> (counts)
+static void Axis_Join(ReferenceAxis *r, uint32_t position) {
+    r->position = r->target = (int32_t)position << REFERENCE_SHIFT;
+    r->velocity = r->targetVelocity = 0;
+    r->accel = r->lead = 0;
+}
+
+static uint32_t Axis_Position(const ReferenceAxis *r) {
+    return (r->position + (1 << (REFERENCE_SHIFT - 1))) >> REFERENCE_SHIFT;
+}
+
+// Servo command for the profile acceleration (10th of a degree), 1000000 / 2^16 = 15625 / 2^10 converts to counts/s^2
+static int32_t Axis_Feedforward(const ReferenceAxis *r) {
+    if(REFERENCE_FEEDFORWARD_GAIN == 0) return 0;
+    return ((Limit(r->accel, -(1 << REFERENCE_SHIFT), 1 << REFERENCE_SHIFT) * 15625) >> 10) / REFERENCE_FEEDFORWARD_GAIN;
+}
+
+// Setpoint at rest at <x>, <y>
+void Reference_Init(uint32_t x, uint32_t y) {
+    Axis_Join(&referenceX, x);
+    Axis_Join(&referenceY, y);
+    targetMoving = false;
+    targetRestart = false;
+    SetpointMoving = false;
+    SetpointFeedforwardX = SetpointFeedforwardY = 0;
+    SeqLock_WritePair(&Setpoint, x, y);
+}
+
+/* New fixed target, the profile starts from the current setpoint position and speed
+ *  Called from the debounce timer and SysTick interrupts, both at priority 2 (button.c, main.c)
+ */
+void Reference_Target(uint32_t x, uint32_t y) {
+    if(!ReferenceEnabled) {
+        Reference_Init(x, y);
+        return;
+    }
+
+    referenceX.target = (int32_t)x << REFERENCE_SHIFT;
+    referenceY.target = (int32_t)y << REFERENCE_SHIFT;
+    referenceX.targetVelocity = referenceY.targetVelocity = 0;
+    referenceX.lead = referenceY.lead = 0;
+    targetMoving = false;
+    targetRestart = false;
+    SetpointMoving = true;
+}
+
+// Moves an axis profile to the ball at <position> (counts) and <velocity> (scaled), false if the ball is on the target
+static _Bool Axis_Restart(ReferenceAxis *r, uint32_t position, int32_t velocity) {
+    int32_t capture = (REFERENCE_CAPTURE_SPEED << REFERENCE_SHIFT) / 1000;
+    int32_t start = (int32_t)position << REFERENCE_SHIFT;
+    r->accel = 0;
+    if((Abs(r->target + r->lead - start) <= (REFERENCE_CAPTURE << REFERENCE_SHIFT)) &&
+       (Abs(velocity - r->targetVelocity) <= capture)) {
+        r->position = r->target + r->lead;
+        r->velocity = r->targetVelocity;
+        return false;
+    }
+
+    r->position = start;
+    r->velocity = velocity;
+    return true;
+}
+
+/* Restarts the profile from a ball at <x>, <y> moving at <velocityX>, <velocityY> (counts/s) to the current target
+ *  A ball put back or landing away from the target is brought to it like a new target, at REFERENCE_RESTART_ACCEL.
+ *  An axis within the capture band stays on the target. Called from SysTick (the setpoint writer)
+ */
+void Reference_Restart(uint32_t x, uint32_t y, int32_t velocityX, int32_t velocityY) {
+    if(!ReferenceEnabled) return;
+
+    _Bool restartX = Axis_Restart(&referenceX, x, (velocityX << REFERENCE_SHIFT) / 1000);
+    _Bool restartY = Axis_Restart(&referenceY, y, (velocityY << REFERENCE_SHIFT) / 1000);
+    if(restartX || restartY) {
+        targetRestart = true;
+        SetpointMoving = true;
+    }
+}
+
+/* Next target of a moving target for an axis
+ *  While chasing, the change of the target velocity is added to the profile velocity so the
+ *  profile turns with the target (a circle) and the limit only applies to closing in on it
+ */
+static void Axis_Moving(ReferenceAxis *r, uint32_t position, uint32_t next, uint16_t interval) {
+    int32_t velocity = (((int32_t)next - (int32_t)position) << REFERENCE_SHIFT) / interval;
+    if(targetMoving) {
+        r->velocity += velocity - r->targetVelocity;
+    }
+    r->target = (int32_t)position << REFERENCE_SHIFT;
+    r->targetVelocity = velocity;
+    r->lead = 0;
+}
+
+/* Target at <x>, <y> moving on to <nextX>, <nextY> in <interval> ms (the next call)
+ *  Passes straight to the setpoint once the profile has joined the target
+ */
+void Reference_Moving(uint32_t x, uint32_t y, uint32_t nextX, uint32_t nextY, uint16_t interval) {
+    Axis_Moving(&referenceX, x, nextX, interval);
+    Axis_Moving(&referenceY, y, nextY, interval);
+    targetMoving = true;
+
+    if(ReferenceEnabled && SetpointMoving) return;
+
+    referenceX.position = referenceX.target;
+    referenceY.position = referenceY.target;
+    referenceX.velocity = referenceX.targetVelocity;
+    referenceY.velocity = referenceY.targetVelocity;
+    SeqLock_WritePair(&Setpoint, x, y);
+}
+
+/* One ms of an axis profile, returns true once it can join the target
+ *  The acceleration limit applies to the speed relative to the target, a circle adds its own acceleration.
+ *  A fixed target is reached exactly, a moving one is joined within the capture band
+ */
+static _Bool Axis_Step(ReferenceAxis *r, int32_t accel, int32_t speed) {
+    r->lead += r->targetVelocity;
+    int32_t distance = r->target + r->lead - r->position;
+    int32_t relative = r->velocity - r->targetVelocity;
+
+    int32_t velocity = Shaper_Approach(distance, accel);
+    velocity = Limit(velocity, relative - accel, relative + accel);
+    velocity += r->targetVelocity;
+    if(speed > 0) {
+        velocity = Limit(velocity, -speed, speed);
+    }
+
+    r->accel = velocity - r->velocity;
+    r->velocity = velocity;
+    r->position += velocity;
+
+    if(!targetMoving) {
+        return (r->position == r->target) && (r->velocity == 0);
+    }
+
+    int32_t capture = (REFERENCE_CAPTURE_SPEED << REFERENCE_SHIFT) / 1000;
+    return (Abs(r->target + r->lead - r->position) <= (REFERENCE_CAPTURE << REFERENCE_SHIFT)) &&
+           (Abs(r->velocity - r->targetVelocity) <= capture);
+}
+
+// Called every ms from SysTick, publishes the profile while it runs
+void Reference_Update(void) {
+    if(!SetpointMoving) return;
+
+    // Limits per ms (squared), rounded
+    int32_t limit = targetRestart && ReferenceAccel > REFERENCE_RESTART_ACCEL ? REFERENCE_RESTART_ACCEL : ReferenceAccel;
+    int32_t accel = ((limit << REFERENCE_SHIFT) + 500000) / 1000000;
+    int32_t speed = ((ReferenceSpeed << REFERENCE_SHIFT) + 500) / 1000;
+    if(accel < 1) accel = 1;
+
+    _Bool joinedX = Axis_Step(&referenceX, accel, speed);
+    _Bool joinedY = Axis_Step(&referenceY, accel, speed);
+
+    if(joinedX && joinedY) {
+        // Moving targets join at the next Reference_Moving(), the last target is where they are now
+        referenceX.position = referenceX.target + referenceX.lead;
+        referenceY.position = referenceY.target + referenceY.lead;
+        referenceX.velocity = referenceX.targetVelocity;
+        referenceY.velocity = referenceY.targetVelocity;
+        referenceX.accel = referenceY.accel = 0;
+        SetpointMoving = false;
+    }
+
+    // A chase has no feedforward, its acceleration is relative to the circle and without the circle's own
+    //  the feedforward costs tracking (sim/reference)
+    SetpointFeedforwardX = targetMoving ? 0 : Axis_Feedforward(&referenceX);
+    SetpointFeedforwardY = targetMoving ? 0 : Axis_Feedforward(&referenceY);
+    SeqLock_WritePair(&Setpoint, Axis_Position(&referenceX), Axis_Position(&referenceY));
+}
+
+// Final target of the profile (counts), the setpoint once the profile is done
+void Reference_GetTarget(uint32_t *x, uint32_t *y) {
+    *x = (referenceX.target + (1 << (REFERENCE_SHIFT - 1))) >> REFERENCE_SHIFT;
+    *y = (referenceY.target + (1 << (REFERENCE_SHIFT - 1))) >> REFERENCE_SHIFT;
+}
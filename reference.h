@@ -0,0 +1,56 @@
+/*
+ * reference.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef REFERENCE_H_
+#define REFERENCE_H_
+
+// Setpoint changes are profiled unless disabled here or at runtime (ReferenceEnabled), without it
+//  the setpoint jumps to every new target
+#define REFERENCE_DEFAULT_ENABLE true
+
+// Defaults of the profile limits (counts/s^2 and counts/s, speed 0 = no limit), can be changed at runtime
+#define REFERENCE_DEFAULT_ACCEL 6000
+#define REFERENCE_DEFAULT_SPEED 0
+
+// Acceleration limit (counts/s^2) of a profile that brings back a ball after a loss. The plate starts
+//  level and the ball lags the feedforward by the servo, at the full limit short moves overshoot
+#define REFERENCE_RESTART_ACCEL 5000
+
+// Ball acceleration per 10th of a degree of servo command (counts/s^2, K from tools/sysid as in
+//  PREDICTOR_GAIN_X), the feedforward command of a transition is its acceleration over this. 0 = off
+#define REFERENCE_FEEDFORWARD_GAIN 77
+
+// The profile joins the target once it is this close (counts) and this slow relative to it (counts/s),
+//  a moving target (circle modes) advances several counts at once
+#define REFERENCE_CAPTURE 12
+#define REFERENCE_CAPTURE_SPEED 50
+
+// Profile resolution, counts and counts per ms scaled by 2^REFERENCE_SHIFT
+#define REFERENCE_SHIFT 16
+
+typedef struct {
+    int32_t position;               // Profile position, velocity and the acceleration of the last ms (scaled)
+    int32_t velocity;
+    int32_t accel;
+    int32_t target;                 // Last target and its velocity (scaled)
+    int32_t targetVelocity;
+    int32_t lead;                   // Target movement since the last target (scaled)
+} ReferenceAxis;
+
+// Profile settings, can be changed at runtime
+extern _Bool ReferenceEnabled;
+extern int32_t ReferenceAccel;
+extern int32_t ReferenceSpeed;
+
+void Reference_Init(uint32_t x, uint32_t y);
+void Reference_Target(uint32_t x, uint32_t y);
+void Reference_Restart(uint32_t x, uint32_t y, int32_t velocityX, int32_t velocityY);
+void Reference_Moving(uint32_t x, uint32_t y, uint32_t nextX, uint32_t nextY, uint16_t interval);
+void Reference_Update(void);
+void Reference_GetTarget(uint32_t *x, uint32_t *y);
+
+#endif /* REFERENCE_H_ */
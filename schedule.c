@@ -0,0 +1,228 @@
+/*
+ * schedule.c
+ *
+ * Gain scheduling of the PID controller by ball speed and distance from the center
+ *  One gain set has to hold the center and follow the circles. Holding wants a high
+ *  P against the touch noise the slow ball sits in, following wants a high D for the
+ *  phase the moving target needs. The table scales Px/Ix/Dx (and the Y gains) by the
+ *  filtered ball speed and the distance from the center, interpolated between its
+ *  grid points. The scales move at most SCHEDULE_SLEW per PID period and the PID
+ *  integrates the scaled error, so a change of the gains doesn't bump the output.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "schedule.h"
+
+#define SCHEDULE_SIZE (SCHEDULE_SPEEDS * SCHEDULE_DISTANCES)
+
+_Bool ScheduleEnabled = SCHEDULE_DEFAULT_ENABLE;
+
+volatile int32_t ScheduleP = 256;
+volatile int32_t ScheduleI = 256;
+volatile int32_t ScheduleD = 256;
+volatile uint32_t ScheduleSpeed = 0;
+volatile uint32_t ScheduleErrors = 0;
+
+/* Rows of increasing speed (0, 16, 32, 48 counts per PID period), columns of distance (0, 600, 1200 counts)
+ *  Tuned on the simulated plant: away from the center less I settles a dropped ball sooner and more P and D
+ *  at medium speeds follow the circles closer. The ball doesn't reach the last column in the sim, it repeats
+ *  the middle one. A panel that reads compressed toward its edges gets more gain in
+ *  the outer columns (loaded over UART).
+ */
+const ScheduleEntry ScheduleDefault[SCHEDULE_SIZE] = {
+    {512, 512, 192},    {512, 192, 160},    {512, 192, 160},
+    {512, 256, 384},    {768, 160, 448},    {768, 160, 448},
+    {448, 256, 640},    {512, 128, 768},    {512, 128, 768},
+    {448, 256, 768},    {448, 160, 768},    {448, 160, 768},
+};
+
+// The PID reads the active table, a load fills the other one and makes it the active one
+ScheduleEntry scheduleTables[2][SCHEDULE_SIZE];
+volatile uint8_t scheduleActive = 0;
+
+// Table the host lines edit until it is loaded
+ScheduleEntry scheduleStaged[SCHEDULE_SIZE];
+char scheduleLine[SCHEDULE_LINE];
+uint8_t scheduleLength = 0;
+_Bool scheduleOverlong = false;
+
+// Ball position of the last update
+int32_t scheduleLastX = 0;
+int32_t scheduleLastY = 0;
+_Bool scheduleStarted = false;
+
+static void Copy(ScheduleEntry *to, const ScheduleEntry *from) {
+    uint8_t i;
+    for(i = 0; i < SCHEDULE_SIZE; i++) {
+        to[i] = from[i];
+    }
+}
+
+// Loads the default table, the scales start at 1.0
+void Schedule_Init(void) {
+    Copy(scheduleTables[0], ScheduleDefault);
+    scheduleActive = 0;
+    Copy(scheduleStaged, ScheduleDefault);
+    scheduleLength = 0;
+    scheduleOverlong = false;
+
+    ScheduleP = ScheduleI = ScheduleD = 256;
+    ScheduleSpeed = 0;
+    scheduleStarted = false;
+}
+
+// Starts the speed over from the next position (after a ball loss), the scales are kept
+void Schedule_Restart(void) {
+    scheduleStarted = false;
+}
+
+// Length of a vector, within 3% (largest component plus 11/32 of the smaller one)
+static uint32_t Length(int32_t dx, int32_t dy) {
+    uint32_t a = Abs(dx);
+    uint32_t b = Abs(dy);
+    if(a < b) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    return a + ((b * 11) >> 5);
+}
+
+// Grid index and position between it and the next one (65536 = at the next) of <value> on a grid of <step>
+static uint8_t Grid(uint32_t value, uint32_t step, uint8_t count, int32_t *fraction) {
+    uint32_t index = value / step;
+    if(index >= (uint32_t)(count - 1)) {
+        *fraction = 0;
+        return count - 1;
+    }
+    *fraction = (int32_t)(((value - index * step) << 16) / step);
+    return (uint8_t)index;
+}
+
+static int32_t Blend(int32_t a, int32_t b, int32_t fraction) {
+    return a + (((b - a) * fraction + 0x8000) >> 16);
+}
+
+/* Scales of <table> for a ball <speed> (counts per PID period, scaled by 16) and <distance> from the center
+ *  (counts), bilinear between the grid points
+ */
+void Schedule_Lookup(const ScheduleEntry *table, uint32_t speed, uint32_t distance, ScheduleEntry *scale) {
+    int32_t fs, fd;
+    uint8_t s = Grid(speed, SCHEDULE_SPEED_STEP * 16, SCHEDULE_SPEEDS, &fs);
+    uint8_t d = Grid(distance, SCHEDULE_DISTANCE_STEP, SCHEDULE_DISTANCES, &fd);
+    uint8_t s1 = (s + 1 < SCHEDULE_SPEEDS) ? s + 1 : s;
+    uint8_t d1 = (d + 1 < SCHEDULE_DISTANCES) ? d + 1 : d;
+
+    const ScheduleEntry *a = &table[s * SCHEDULE_DISTANCES + d];
+    const ScheduleEntry *b = &table[s * SCHEDULE_DISTANCES + d1];
+    const ScheduleEntry *c = &table[s1 * SCHEDULE_DISTANCES + d];
+    const ScheduleEntry *e = &table[s1 * SCHEDULE_DISTANCES + d1];
+
+    scale->p = Blend(Blend(a->p, b->p, fd), Blend(c->p, e->p, fd), fs);
+    scale->i = Blend(Blend(a->i, b->i, fd), Blend(c->i, e->i, fd), fs);
+    scale->d = Blend(Blend(a->d, b->d, fd), Blend(c->d, e->d, fd), fs);
+}
+
+static int32_t Approach(int32_t value, int32_t target) {
+    return Limit(target, value - SCHEDULE_SLEW, value + SCHEDULE_SLEW);
+}
+
+// Moves the scales toward the table at the ball position <x>, <y> (touch counts), call once per PID period
+void Schedule_Update(int32_t x, int32_t y) {
+    if(!scheduleStarted) {
+        scheduleLastX = x;
+        scheduleLastY = y;
+        scheduleStarted = true;
+    }
+
+    uint32_t speed = Length(x - scheduleLastX, y - scheduleLastY) << 4;
+    scheduleLastX = x;
+    scheduleLastY = y;
+    ScheduleSpeed += ((int32_t)speed - (int32_t)ScheduleSpeed) >> SCHEDULE_SPEED_SHIFT;
+
+    ScheduleEntry target;
+    Schedule_Lookup(scheduleTables[scheduleActive], ScheduleSpeed, Length(x - (int32_t)CenterX, y - (int32_t)CenterY), &target);
+    ScheduleP = Approach(ScheduleP, target.p);
+    ScheduleI = Approach(ScheduleI, target.i);
+    ScheduleD = Approach(ScheduleD, target.d);
+}
+
+/* Makes <table> (SCHEDULE_SPEEDS rows of SCHEDULE_DISTANCES) the active one, false if a scale is out of range
+ *  Called from the UART interrupt, the PID finishes an update on the table it started with
+ */
+_Bool Schedule_Load(const ScheduleEntry *table) {
+    uint8_t i;
+    for(i = 0; i < SCHEDULE_SIZE; i++) {
+        if(table[i].p < SCHEDULE_SCALE_MIN || table[i].p > SCHEDULE_SCALE_MAX ||
+           table[i].i < SCHEDULE_SCALE_MIN || table[i].i > SCHEDULE_SCALE_MAX ||
+           table[i].d < SCHEDULE_SCALE_MIN || table[i].d > SCHEDULE_SCALE_MAX) {
+            return false;
+        }
+    }
+
+    uint8_t next = scheduleActive ^ 1;
+    Copy(scheduleTables[next], table);
+    scheduleActive = next;
+    return true;
+}
+
+const ScheduleEntry *Schedule_Table(void) {
+    return scheduleTables[scheduleActive];
+}
+
+static _Bool Field(const char **text, int32_t *value) {
+    const char *p = *text;
+    _Bool negative = false;
+    uint32_t v = 0;
+    if(*p++ != ',') return false;
+    if(*p == '-') {
+        negative = true;
+        p++;
+    }
+    if(*p < '0' || *p > '9') return false;
+    while(*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    *value = negative ? -(int32_t)v : (int32_t)v;
+    *text = p;
+    return true;
+}
+
+static void Schedule_Line(void) {
+    const char *p = scheduleLine + 1;
+    int32_t s, d, kp, ki, kd;
+
+    scheduleLine[scheduleLength] = '\0';
+    if(scheduleLength == 1) {
+        if(!Schedule_Load(scheduleStaged)) ScheduleErrors++;
+    } else if(Field(&p, &s) && Field(&p, &d) && Field(&p, &kp) && Field(&p, &ki) && Field(&p, &kd) && *p == '\0' &&
+              s >= 0 && s < SCHEDULE_SPEEDS && d >= 0 && d < SCHEDULE_DISTANCES &&
+              kp >= SCHEDULE_SCALE_MIN && kp <= SCHEDULE_SCALE_MAX && ki >= SCHEDULE_SCALE_MIN && ki <= SCHEDULE_SCALE_MAX &&
+              kd >= SCHEDULE_SCALE_MIN && kd <= SCHEDULE_SCALE_MAX) {
+        ScheduleEntry *e = &scheduleStaged[s * SCHEDULE_DISTANCES + d];
+        e->p = (int16_t)kp;
+        e->i = (int16_t)ki;
+        e->d = (int16_t)kd;
+    } else {
+        ScheduleErrors++;
+    }
+}
+
+// Character received by the UART interrupt, only lines starting with 'G' that end while <take> is set are taken
+void Schedule_Char(char c, _Bool take) {
+    if(c == '\n' || c == '\r') {
+        if(take && scheduleLength > 0 && scheduleLine[0] == 'G') {
+            if(scheduleOverlong) ScheduleErrors++;
+            else Schedule_Line();
+        }
+        scheduleLength = 0;
+        scheduleOverlong = false;
+    } else if(scheduleLength < SCHEDULE_LINE - 1) {
+        scheduleLine[scheduleLength++] = c;
+    } else {
+        scheduleOverlong = true;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * schedule.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+// Gain scheduling of the PID is off unless enabled here or at runtime (ScheduleEnabled)
+#define SCHEDULE_DEFAULT_ENABLE false
+
+/* Gain table: a scale of the PID gains (256 = Px/Ix/Dx as they are) for each ball speed and distance from
+ *  the center, on a grid of SPEED_STEP counts per PID period and DISTANCE_STEP counts. Interpolated between
+ *  the grid points and held beyond the last ones.
+ */
+#define SCHEDULE_SPEEDS 4
+#define SCHEDULE_DISTANCES 3
+#define SCHEDULE_SPEED_STEP 16
+#define SCHEDULE_DISTANCE_STEP 600
+
+// Scales a table can hold
+#define SCHEDULE_SCALE_MIN 32
+#define SCHEDULE_SCALE_MAX 1024
+
+// Low pass of the ball speed (time constant of 2^SPEED_SHIFT PID periods), largest scale change per PID period
+#define SCHEDULE_SPEED_SHIFT 2
+#define SCHEDULE_SLEW 16
+
+/* Table lines from the host (UART), taken outside the waypoint mode only (dropped while a stream plays):
+ *      G,<speed>,<distance>,<p>,<i>,<d>    sets a grid point (indices) of the staged table
+ *      G                                   loads the staged table, the PID takes it from its next update
+ */
+#define SCHEDULE_LINE 32
+
+typedef struct {
+    int16_t p, i, d;
+} ScheduleEntry;
+
+extern _Bool ScheduleEnabled;
+
+// Table loaded by Schedule_Init()
+extern const ScheduleEntry ScheduleDefault[SCHEDULE_SPEEDS * SCHEDULE_DISTANCES];
+
+// Scales in use (256 = 1.0) and the filtered ball speed (counts per PID period, scaled by 16)
+extern volatile int32_t ScheduleP;
+extern volatile int32_t ScheduleI;
+extern volatile int32_t ScheduleD;
+extern volatile uint32_t ScheduleSpeed;
+
+// Table lines that were rejected
+extern volatile uint32_t ScheduleErrors;
+
+void Schedule_Init(void);
+void Schedule_Restart(void);
+void Schedule_Update(int32_t x, int32_t y);
+void Schedule_Lookup(const ScheduleEntry *table, uint32_t speed, uint32_t distance, ScheduleEntry *scale);
+_Bool Schedule_Load(const ScheduleEntry *table);
+const ScheduleEntry *Schedule_Table(void);
+void Schedule_Char(char c, _Bool take);
+
+#endif /* SCHEDULE_H_ */
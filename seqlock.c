@@ -0,0 +1,57 @@
+/*
+ * seqlock.c
+ *
+ * Sequence lock for multi-word data shared between interrupts and the main loop
+ *  The writer makes the sequence odd, writes the data and makes it even again. A reader
+ *  takes the sequence, copies the data and checks the sequence is unchanged, otherwise
+ *  a write preempted the copy and it copies again. On the target an interrupt always
+ *  finishes its write before the main loop continues, so a reader retries at most once
+ *  per write and never sees an odd sequence.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "seqlock.h"
+
+void SeqLock_WriteBegin(SeqLock *lock) {
+    lock->sequence++;
+    SEQLOCK_WRITE_BARRIER();
+}
+
+void SeqLock_WriteEnd(SeqLock *lock) {
+    SEQLOCK_WRITE_BARRIER();
+    lock->sequence++;
+}
+
+// Waits out a write in progress (only possible when the writer runs on another core, in the PC checks)
+uint32_t SeqLock_ReadBegin(const SeqLock *lock) {
+    uint32_t sequence;
+    while((sequence = lock->sequence) & 1);
+    SEQLOCK_READ_BARRIER();
+    return sequence;
+}
+
+// True if the data copied since SeqLock_ReadBegin() may be torn
+_Bool SeqLock_ReadRetry(const SeqLock *lock, uint32_t sequence) {
+    SEQLOCK_READ_BARRIER();
+    return lock->sequence != sequence;
+}
+
+void SeqLock_WritePair(SeqLockPair *pair, uint32_t x, uint32_t y) {
+    SeqLock_WriteBegin(&pair->lock);
+    pair->x = x;
+    pair->y = y;
+    SeqLock_WriteEnd(&pair->lock);
+}
+
+void SeqLock_ReadPair(const SeqLockPair *pair, uint32_t *x, uint32_t *y) {
+    uint32_t sequence;
+    do {
+        sequence = SeqLock_ReadBegin(&pair->lock);
+        *x = pair->x;
+        *y = pair->y;
+    } while(SeqLock_ReadRetry(&pair->lock, sequence));
+}
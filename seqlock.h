@@ -0,0 +1,51 @@
+/*
+ * seqlock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+/* Memory barriers around the data of a sequence lock
+ *  The Cortex-M4 has one core and keeps the order of its memory accesses, the volatile
+ *  accesses are enough there. GCC builds (the PC checks in sim/ run the lock on threads)
+ *  use release fences on the write side and acquire fences on the read side.
+ */
+#if defined(__GNUC__) && !defined(__TI_COMPILER_VERSION__)
+#define SEQLOCK_WRITE_BARRIER() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define SEQLOCK_READ_BARRIER() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#define SEQLOCK_WRITE_BARRIER()
+#define SEQLOCK_READ_BARRIER()
+#endif
+
+/* Sequence count of data shared between interrupts and the main loop
+ *  Odd while a write is in progress. A reader copies the data between SeqLock_ReadBegin()
+ *  and SeqLock_ReadRetry() and copies again if it changed, it never disables interrupts.
+ *  Only one context may write (the main loop, or interrupts of the same priority that
+ *  can't preempt each other), readers never block the writer.
+ */
+typedef struct {
+    volatile uint32_t sequence;
+} SeqLock;
+
+// Pair of values published together (setpoint, touch sample)
+typedef struct {
+    SeqLock lock;
+    volatile uint32_t x;
+    volatile uint32_t y;
+} SeqLockPair;
+
+#define SEQLOCK_PAIR_INIT(x, y) {{0}, (x), (y)}
+
+void SeqLock_WriteBegin(SeqLock *lock);
+void SeqLock_WriteEnd(SeqLock *lock);
+uint32_t SeqLock_ReadBegin(const SeqLock *lock);
+_Bool SeqLock_ReadRetry(const SeqLock *lock, uint32_t sequence);
+
+void SeqLock_WritePair(SeqLockPair *pair, uint32_t x, uint32_t y);
+void SeqLock_ReadPair(const SeqLockPair *pair, uint32_t *x, uint32_t *y);
+
+#endif /* SEQLOCK_H_ */
@@ -21,8 +21,10 @@
 #include "driverlib/timer.h"
 #include "servo.h"
 
+void (*servoFrameCallBack)(void) = 0;
+
 void PWM_Init(uint32_t init_1, uint32_t init_2) {
-    // Set the PWM CLOCK divider to /32 of the main clock
+    // Set the PWM CLOCK divider to /32 of the main clock (2.5 MHz)
     SysCtlPWMClockSet(SYSCTL_PWMDIV_32);
 
     SysCtlPeripheralEnable(SYSCTL_PERIPH_PWM0);
@@ -30,15 +32,16 @@ void PWM_Init(uint32_t init_1, uint32_t init_2) {
     // Wait for the PWM module to be ready.
     while(!SysCtlPeripheralReady(SYSCTL_PERIPH_PWM0)) {}
 
-    // Configure the PWM mode
-    PWMGenConfigure(PWM0_BASE, PWM_GEN_0, PWM_GEN_MODE_DOWN);
+    // Configure the PWM mode, new pulse widths only take effect at the end of a period after Servo_Update()
+    PWMGenConfigure(PWM0_BASE, PWM_GEN_0, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_SYNC | PWM_GEN_MODE_GEN_SYNC_GLOBAL);
 
-    // Configure the frequency to 100Hz
+    // Configure the frequency to 50Hz (20 ms servo frame)
     PWMGenPeriodSet(PWM0_BASE, PWM_GEN_0, PWM_PERIOD);
 
     // Init duty cycle
-    PWMPulseWidthSet(PWM0_BASE, SERVO_1, (SERVO_DUTYCYCLE_START + SERVO_DUTYCYCLE_END)/2);
-    PWMPulseWidthSet(PWM0_BASE, SERVO_2, (SERVO_DUTYCYCLE_START + SERVO_DUTYCYCLE_END)/2);
+    Servo_Set_Degrees(SERVO_1, init_1);
+    Servo_Set_Degrees(SERVO_2, init_2);
+    Servo_Update();
 
     // Turning on PWM
     PWMOutputState(PWM0_BASE, (PWM_OUT_0_BIT | PWM_OUT_1_BIT), true);
@@ -62,15 +65,35 @@ void Servo_Init(uint32_t init_1, uint32_t init_2) {
     PWM_Init(init_1, init_2);
 }
 
+/* Calls <callBackFunction> at the start of every servo frame (PWM counter reload)
+ *  This is where pulse widths from Servo_Update() are latched
+ */
+void Servo_Frame_Init(void (*callBackFunction)(void)) {
+    servoFrameCallBack = callBackFunction;
+
+    PWMGenIntRegister(PWM0_BASE, PWM_GEN_0, Servo_Frame_Handler);
+    PWMGenIntTrigEnable(PWM0_BASE, PWM_GEN_0, PWM_INT_CNT_ZERO);
+    PWMIntEnable(PWM0_BASE, PWM_INT_GEN_0);
+}
+
+void Servo_Frame_Handler(void) {
+    PWMGenIntClear(PWM0_BASE, PWM_GEN_0, PWM_INT_CNT_ZERO);
+
+    if(servoFrameCallBack) servoFrameCallBack();
+}
+
 // Function to set <servo> to position <dutyCycle>
-//  Use "Servo_Set_Degrees" to avoid problems if possible
+//  Use "Servo_Set_Degrees" to avoid problems if possible, the pulse is sent after Servo_Update()
 void Servo_Set(uint32_t servo, uint32_t dutyCycle) {
     PWMPulseWidthSet(PWM0_BASE, servo, dutyCycle);
 }
 
 // Function to set <servo> to position <degrees> which is scaled by 10 (900 = 90 degrees)
 void Servo_Set_Degrees(uint32_t servo, uint32_t degrees) {
-    uint32_t dutyCycle = SERVO_DUTYCYCLE_START + (degrees * SERVO_DUTYCYCLE_DEGREES)/10;
+    PWMPulseWidthSet(PWM0_BASE, servo, ServoScale_Ticks(degrees * 10));
+}
 
-    PWMPulseWidthSet(PWM0_BASE, servo, dutyCycle);
+// Both servos switch to the pulse widths set since the last update at the start of the next frame
+void Servo_Update(void) {
+    PWMSyncUpdate(PWM0_BASE, PWM_GEN_0_BIT);
 }
@@ -0,0 +1,20 @@
+/*
+ * servoScale.c
+ *
+ * Servo angle to PWM pulse width conversion
+ *  A single multiply and shift with a compile time factor, 100th of a degree input
+ *  resolution (about 0.26 ticks) and within 0.52 ticks of the exact scaling over the
+ *  whole range. Checked on a PC by sim/servoscale.c.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include "servoScale.h"
+
+// Pulse width (PWM ticks) for a servo angle of <centiDegrees> (limited to 0 - 180 deg)
+uint32_t ServoScale_Ticks(uint32_t centiDegrees) {
+    if(centiDegrees > SERVO_SCALE_MAX) centiDegrees = SERVO_SCALE_MAX;
+    return SERVO_DUTYCYCLE_START + ((centiDegrees * SERVO_SCALE_FACTOR + (1u << (SERVO_SCALE_SHIFT - 1))) >> SERVO_SCALE_SHIFT);
+}
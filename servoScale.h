@@ -0,0 +1,30 @@
+/*
+ * servoScale.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SERVOSCALE_H_
+#define SERVOSCALE_H_
+
+// PWM clock is 80 MHz / 32 = 2.5 MHz (0.4 us per tick)
+#define SERVO_TICKS_PER_USEC_X10 25
+
+// Servo frame (PWM period) of 20 ms (50 Hz)
+#define PWM_PERIOD 50000
+
+// Pulse width range for 0 to 180 degrees (600 us to 2500 us)
+#define SERVO_DUTYCYCLE_START 1500
+#define SERVO_DUTYCYCLE_END 6250
+
+// Angles are in 100th of a degree (18000 = 180 deg)
+#define SERVO_SCALE_MAX 18000
+
+// (END - START) / SCALE_MAX ticks per 100th of a degree, scaled by 2^SHIFT and rounded at compile time
+#define SERVO_SCALE_SHIFT 19
+#define SERVO_SCALE_FACTOR ((((uint32_t)(SERVO_DUTYCYCLE_END - SERVO_DUTYCYCLE_START) << SERVO_SCALE_SHIFT) + SERVO_SCALE_MAX / 2) / SERVO_SCALE_MAX)
+
+uint32_t ServoScale_Ticks(uint32_t centiDegrees);
+
+#endif /* SERVOSCALE_H_ */
@@ -0,0 +1,134 @@
+/*
+ * settle.c
+ *
+ * Settle time characterization of the touch panel phases
+ *  After a phase switch the panel and the ADC input charge through the panel
+ *  resistance, the pull ups charge the X surface for the presence check. A probed
+ *  reading samples the pins after a short probe delay, then again after the
+ *  longest settle time of the phase (the reference, the reading that is used).
+ *  The probe and the reference are a few 100 us apart, so the ball hardly moves
+ *  between them and their difference is the settling error at the probe delay.
+ *
+ *  A pass probes every delay of an even grid up to the maximum, one probe per
+ *  reading, and takes the settle time from the first delay the phase was settled
+ *  from on (every later probe within SETTLE_TOLERANCE) plus SETTLE_MARGIN_PERCENT.
+ *  Passes run at startup and every SETTLE_PERIOD_MS, the read phases only probe
+ *  while the ball is on the panel and the presence phase only while it is not
+ *  (the touch driver decides).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "touchPhase.h"
+#include "touchConvert.h"
+#include "settle.h"
+
+_Bool SettleEnabled = SETTLE_DEFAULT_ENABLE;
+
+uint16_t SettleTimeUs[TOUCH_PHASE_COUNT];
+
+// Pass of a phase, largest error seen at each probe delay
+typedef struct {
+    uint32_t errors[SETTLE_STEPS];
+    uint8_t probes;                 // Probes done, the pass is done at SETTLE_STEPS * SETTLE_REPEATS
+    _Bool active;
+} SettlePass;
+
+SettlePass settlePasses[TOUCH_PHASE_COUNT];
+
+unsigned long settleStartTime = 0;
+
+// Longest settle time and the error allowed of each phase (TOUCH_PHASE_x), presence compares pin levels
+static const uint16_t maxUs[TOUCH_PHASE_COUNT] = {0, SETTLE_READ_MAX_US, SETTLE_READ_MAX_US, SETTLE_PRESENT_MAX_US};
+static const uint32_t tolerances[TOUCH_PHASE_COUNT] = {0, SETTLE_TOLERANCE * TOUCH_SAMPLES, SETTLE_TOLERANCE * TOUCH_SAMPLES, 0};
+
+void Settle_Init(void) {
+    uint8_t phase;
+    for(phase = 0; phase < TOUCH_PHASE_COUNT; phase++) {
+        SettleTimeUs[phase] = SETTLE_DEFAULT_READ_US;
+        settlePasses[phase].active = false;
+    }
+    SettleTimeUs[TOUCH_PHASE_OFF] = 0;
+    SettleTimeUs[TOUCH_PHASE_PRESENT] = SETTLE_DEFAULT_PRESENT_US;
+    Settle_Start(0);
+}
+
+// Starts a pass of every phase that settles (not off)
+void Settle_Start(unsigned long time) {
+    uint8_t phase, i;
+    settleStartTime = time;
+    for(phase = 0; phase < TOUCH_PHASE_COUNT; phase++) {
+        SettlePass *pass = &settlePasses[phase];
+        for(i = 0; i < SETTLE_STEPS; i++) {
+            pass->errors[i] = 0;
+        }
+        pass->probes = 0;
+        pass->active = maxUs[phase] > 0;
+    }
+}
+
+// Called from the main loop, starts the periodic passes
+void Settle_Update(unsigned long time) {
+    if(time - settleStartTime >= SETTLE_PERIOD_MS) {
+        Settle_Start(time);
+    }
+}
+
+// The next reading of <phase> is to be probed
+_Bool Settle_Probing(uint8_t phase) {
+    return SettleEnabled && settlePasses[phase].active;
+}
+
+static uint16_t StepDelay(uint8_t phase, uint8_t step) {
+    return (uint32_t)maxUs[phase] * step / (SETTLE_STEPS - 1);
+}
+
+// Delay (us) of the next probe of <phase>, the steps in turn so a pass sees each delay at different positions
+uint16_t Settle_ProbeDelay(uint8_t phase) {
+    return StepDelay(phase, settlePasses[phase].probes % SETTLE_STEPS);
+}
+
+uint16_t Settle_MaxUs(uint8_t phase) {
+    return maxUs[phase];
+}
+
+/* Adds a probed reading of <phase>: the <probe> after Settle_ProbeDelay() and the <reference> after
+ *  Settle_MaxUs(). Sets the settle time of the phase at the end of the pass
+ */
+void Settle_Add(uint8_t phase, uint32_t probe, uint32_t reference) {
+    SettlePass *pass = &settlePasses[phase];
+    if(!pass->active) return;
+
+    uint8_t step = pass->probes % SETTLE_STEPS;
+    uint32_t error = probe > reference ? probe - reference : reference - probe;
+    if(error > pass->errors[step]) {
+        pass->errors[step] = error;
+    }
+
+    pass->probes++;
+    if(pass->probes >= SETTLE_STEPS * SETTLE_REPEATS) {
+        pass->active = false;
+        SettleTimeUs[phase] = Settle_Time(Settle_Converged(pass->errors, SETTLE_STEPS, tolerances[phase]), maxUs[phase]);
+    }
+}
+
+// First of the <count> probe <errors> from which on all are within <tolerance>, -1 if the last isn't
+int8_t Settle_Converged(const uint32_t *errors, uint8_t count, uint32_t tolerance) {
+    int8_t i = count - 1;
+    if(errors[i] > tolerance) return -1;
+    while(i > 0 && errors[i - 1] <= tolerance) {
+        i--;
+    }
+    return i;
+}
+
+// Settle time from the <converged> step of a pass up to <limitUs>, the limit if it didn't converge
+uint16_t Settle_Time(int8_t converged, uint16_t limitUs) {
+    if(converged < 0) return limitUs;
+    uint32_t time = (uint32_t)limitUs * converged / (SETTLE_STEPS - 1);
+    time += (time * SETTLE_MARGIN_PERCENT + 99) / 100;
+    return time < limitUs ? time : limitUs;
+}
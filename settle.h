@@ -0,0 +1,51 @@
+/*
+ * settle.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SETTLE_H_
+#define SETTLE_H_
+
+// Settle times are characterized on the panel unless disabled here or at runtime (SettleEnabled),
+//  without it the phases wait the defaults
+#define SETTLE_DEFAULT_ENABLE true
+
+// Waits after switching to a phase before the pins are read (us), the presence wait was SysCtlDelay(8000)
+#define SETTLE_DEFAULT_READ_US 0
+#define SETTLE_DEFAULT_PRESENT_US 300
+
+// Longest settle time a phase is probed up to (us), also the wait of a probed reading
+#define SETTLE_READ_MAX_US 150
+#define SETTLE_PRESENT_MAX_US 600
+
+// Probe delays of a pass, evenly spaced from 0 to the maximum, each probed SETTLE_REPEATS times
+#define SETTLE_STEPS 16
+#define SETTLE_REPEATS 2
+
+// Largest change of a reading (counts of the mean of the TOUCH_SAMPLES samples) still counted as settled
+#define SETTLE_TOLERANCE 3
+
+// Settle time is the first probe delay the phase was settled from on, plus this much (%)
+#define SETTLE_MARGIN_PERCENT 25
+
+// A new pass is started this often (ms) so the settle times follow the panel
+#define SETTLE_PERIOD_MS 60000
+
+extern _Bool SettleEnabled;
+
+// Wait after switching to each phase (us, TOUCH_PHASE_x)
+extern uint16_t SettleTimeUs[TOUCH_PHASE_COUNT];
+
+void Settle_Init(void);
+void Settle_Start(unsigned long time);
+void Settle_Update(unsigned long time);
+_Bool Settle_Probing(uint8_t phase);
+uint16_t Settle_ProbeDelay(uint8_t phase);
+uint16_t Settle_MaxUs(uint8_t phase);
+void Settle_Add(uint8_t phase, uint32_t probe, uint32_t reference);
+int8_t Settle_Converged(const uint32_t *errors, uint8_t count, uint32_t tolerance);
+uint16_t Settle_Time(int8_t converged, uint16_t limitUs);
+
+#endif /* SETTLE_H_ */
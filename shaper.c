@@ -0,0 +1,140 @@
+/*
+ * shaper.c
+ *
+ * Servo command shaping
+ *  Smooths the controller outputs (running average or biquad low pass, both O(1) per
+ *  output) and limits the rate, acceleration and jerk of the command each servo gets.
+ *  The limiter brakes ahead of the target so a limited move never overshoots it, the
+ *  jerk limit averages the limited moves into S-curves. Without limits or filter the
+ *  output is the controller output.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "shaper.h"
+
+uint8_t ShaperFilter = SHAPER_DEFAULT_FILTER;
+int32_t ShaperSlew = SHAPER_DEFAULT_SLEW;
+int32_t ShaperAccel = SHAPER_DEFAULT_ACCEL;
+int32_t ShaperJerk = SHAPER_DEFAULT_JERK;
+
+// Outputs the jerk limit spreads each acceleration step over, the ramp from -a to a takes 2 * a / jerk
+static uint8_t RampSamples(void) {
+    if(ShaperAccel <= 0 || ShaperJerk <= 0) return 1;
+    return Limit((2 * ShaperAccel + ShaperJerk - 1) / ShaperJerk, 1, SHAPER_RAMP_SAMPLES);
+}
+
+// Starts an axis at rest at <position> (10th of a degree)
+void Shaper_Reset(ShaperAxis *s, int32_t position) {
+    uint8_t i;
+    for(i = 0; i < SHAPER_AVERAGE_SAMPLES; i++) {
+        s->window[i] = position;
+    }
+    s->sum = position * SHAPER_AVERAGE_SAMPLES;
+    s->index = 0;
+
+    s->x1 = s->x2 = s->y1 = s->y2 = position << SHAPER_SHIFT;
+
+    s->position = position << SHAPER_SHIFT;
+    s->velocity = 0;
+
+    for(i = 0; i < SHAPER_RAMP_SAMPLES; i++) {
+        s->ramp[i] = s->position;
+    }
+    s->rampSum = s->position * RampSamples();
+    s->rampIndex = 0;
+}
+
+static uint32_t SquareRoot(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while(bit > value) bit >>= 2;
+
+    while(bit) {
+        if(value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Smoothed target (scaled by 2^SHAPER_SHIFT)
+static int32_t Filter(ShaperAxis *s, int32_t target) {
+    int32_t input = target << SHAPER_SHIFT;
+
+    if(ShaperFilter == SHAPER_FILTER_AVERAGE) {
+        s->sum += target - s->window[s->index];
+        s->window[s->index] = target;
+        s->index = (s->index + 1) % SHAPER_AVERAGE_SAMPLES;
+        return (s->sum << SHAPER_SHIFT) / SHAPER_AVERAGE_SAMPLES;
+    }
+
+    if(ShaperFilter == SHAPER_FILTER_BIQUAD) {
+        int32_t sum = SHAPER_BIQUAD_B0 * input + SHAPER_BIQUAD_B1 * s->x1 + SHAPER_BIQUAD_B2 * s->x2
+                    - SHAPER_BIQUAD_A1 * s->y1 - SHAPER_BIQUAD_A2 * s->y2;
+        int32_t output = (sum + (1 << (SHAPER_BIQUAD_SHIFT - 1))) >> SHAPER_BIQUAD_SHIFT;
+        s->x2 = s->x1;
+        s->x1 = input;
+        s->y2 = s->y1;
+        s->y1 = output;
+        return output;
+    }
+
+    return input;
+}
+
+/* Largest step towards <distance> from which it can still stop there, the step shrinking by <rate> each output
+ *  n whole <rate> steps need rate * n * (n + 1) / 2, the rest is spread over the n + 1 outputs. n is the
+ *  triangular root of remaining / rate, so large distances (reference.c) don't overflow
+ */
+int32_t Shaper_Approach(int32_t distance, int32_t rate) {
+    int32_t remaining = Abs(distance);
+    int32_t n = ((int32_t)SquareRoot(8 * (uint32_t)(remaining / rate) + 1) - 1) / 2;
+    int32_t step = n * rate + Limit((remaining - rate * n * (n + 1) / 2) / (n + 1), 0, rate);
+    return Limit(distance, -step, step);
+}
+
+/* Shapes one controller output of an axis, call once per output
+ *  Returns the servo command (10th of a degree)
+ */
+int32_t Shaper_Update(ShaperAxis *s, int32_t target) {
+    int32_t filtered = Filter(s, target);
+    int32_t velocity = filtered - s->position;
+    int32_t accel = ShaperAccel << SHAPER_SHIFT;
+
+    if(ShaperAccel > 0) {
+        velocity = Shaper_Approach(velocity, accel);
+    }
+
+    if(ShaperSlew > 0) {
+        velocity = Limit(velocity, -(ShaperSlew << SHAPER_SHIFT), ShaperSlew << SHAPER_SHIFT);
+    }
+
+    if(ShaperAccel > 0) {
+        velocity = Limit(velocity, s->velocity - accel, s->velocity + accel);
+    }
+
+    s->velocity = velocity;
+    s->position += velocity;
+    int32_t position = s->position;
+
+    if(ShaperAccel > 0 && ShaperJerk > 0) {
+        // Averaging the limited moves over <ramp> outputs turns the acceleration steps into ramps (S-curve),
+        //  an average of positions short of the target can't pass it either
+        uint8_t ramp = RampSamples();
+        s->rampSum += position - s->ramp[(s->rampIndex + SHAPER_RAMP_SAMPLES - ramp) % SHAPER_RAMP_SAMPLES];
+        s->ramp[s->rampIndex] = position;
+        s->rampIndex = (s->rampIndex + 1) % SHAPER_RAMP_SAMPLES;
+        position = s->rampSum / ramp;
+    }
+
+    return (position + (1 << (SHAPER_SHIFT - 1))) >> SHAPER_SHIFT;
+}
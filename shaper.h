@@ -0,0 +1,64 @@
+/*
+ * shaper.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SHAPER_H_
+#define SHAPER_H_
+
+// Smoothing filter in front of the limiter
+#define SHAPER_FILTER_NONE 0
+#define SHAPER_FILTER_AVERAGE 1                 // Running sum of the last SHAPER_AVERAGE_SAMPLES outputs
+#define SHAPER_FILTER_BIQUAD 2                  // Second order low pass (coefficients below)
+
+// Number of controller outputs averaged by SHAPER_FILTER_AVERAGE
+#define SHAPER_AVERAGE_SAMPLES 4
+
+// Longest acceleration ramp of the jerk limit (outputs), lower jerk limits are raised to 2 * accel / SHAPER_RAMP_SAMPLES
+#define SHAPER_RAMP_SAMPLES 8
+
+// Second order Butterworth low pass at 8 Hz for the 25 Hz output rate (PID_UPDATE_RATE), scaled by 2^14
+//  y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2, b0 + b1 + b2 = 2^14 + a1 + a2 for unity DC gain
+#define SHAPER_BIQUAD_SHIFT 14
+#define SHAPER_BIQUAD_B0 7123
+#define SHAPER_BIQUAD_B1 14245
+#define SHAPER_BIQUAD_B2 7123
+#define SHAPER_BIQUAD_A1 8508
+#define SHAPER_BIQUAD_A2 3599
+
+// Defaults of the runtime settings, limits are in 10th of a degree per output (0 = off), jerk needs accel
+//  Everything is off as the filters' lag costs PID circle tracking, sim/shaper compares the settings on the plant
+#define SHAPER_DEFAULT_FILTER SHAPER_FILTER_NONE
+#define SHAPER_DEFAULT_SLEW 0
+#define SHAPER_DEFAULT_ACCEL 0
+#define SHAPER_DEFAULT_JERK 0
+
+// Internal resolution (16th of a 10th of a degree)
+#define SHAPER_SHIFT 4
+
+typedef struct {
+    int32_t window[SHAPER_AVERAGE_SAMPLES];     // Average filter inputs
+    int32_t sum;
+    uint8_t index;
+    int32_t x1, x2;                             // Biquad inputs and outputs
+    int32_t y1, y2;
+    int32_t position;                           // Limiter state (scaled by 2^SHAPER_SHIFT)
+    int32_t velocity;
+    int32_t ramp[SHAPER_RAMP_SAMPLES];          // Jerk limit averaging of the limiter positions
+    int32_t rampSum;
+    uint8_t rampIndex;
+} ShaperAxis;
+
+// Command shaping settings, can be changed at runtime (reset the axes after changing the filter)
+extern uint8_t ShaperFilter;
+extern int32_t ShaperSlew;
+extern int32_t ShaperAccel;
+extern int32_t ShaperJerk;
+
+void Shaper_Reset(ShaperAxis *s, int32_t position);
+int32_t Shaper_Update(ShaperAxis *s, int32_t target);
+int32_t Shaper_Approach(int32_t distance, int32_t rate);
+
+#endif /* SHAPER_H_ */
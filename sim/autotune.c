@@ -0,0 +1,162 @@
+/*
+ * autotune.c
+ *
+ * Relay auto-tune check (runs on a PC)
+ *
+ *  First feeds synthetic limit cycles (sine and double integrator shaped waves with
+ *  offset and noise) through the relay detector of ../autotune.c and checks the
+ *  detected period and amplitude. Then runs the auto-tune mode against the simulated
+ *  plant with every tuning rule and compares the +600 step with the tuned gains
+ *  against the default gains. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/autotune sim/autotune.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../autotune.h"
+#include "harness.h"
+
+#define PI 3.14159265358979
+
+// Allowed detection error (%)
+#define PERIOD_TOLERANCE 2.0
+#define AMPLITUDE_TOLERANCE 5.0
+
+typedef struct {
+    const char *name;
+    _Bool parabolic;        // Double integrator relay cycle instead of a sine
+    double period;          // Samples
+    double amplitude;       // Counts
+    double offset;
+    double noise;           // Uniform noise amplitude (counts)
+} LimitCycle;
+
+static const LimitCycle cycles[] = {
+    {"sine_p30_a200",           false,  30.0,   200,    0,      0},
+    {"sine_p47.3_a350_offset",  false,  47.3,   350,    60,     0},
+    {"sine_p22.6_a120_noise",   false,  22.6,   120,    0,      6},
+    {"parabolic_p36_a250",      true,   36.0,   250,    0,      0},
+    {"parabolic_p41.5_a400",    true,   41.5,   400,    -40,    8},
+};
+
+static double Noise(double amplitude) {
+    return amplitude * (2.0 * rand() / RAND_MAX - 1.0);
+}
+
+static double Wave(const LimitCycle *c, double n) {
+    double phase = fmod(n / c->period, 1.0);
+    if(!c->parabolic) return c->amplitude * sin(2.0 * PI * phase);
+
+    // Piecewise parabola through 0 at phase 0 and 0.5, peaks at 0.25 and 0.75
+    double half = fmod(phase, 0.5) * 4.0 - 1.0;
+    double value = c->amplitude * (1.0 - half * half);
+    return (phase < 0.5) ? value : -value;
+}
+
+static int CheckDetector(void) {
+    int failures = 0;
+    unsigned int i;
+
+    printf("Relay detector on synthetic limit cycles\n");
+    srand(1);
+    for(i = 0; i < sizeof(cycles) / sizeof(cycles[0]); i++) {
+        const LimitCycle *c = &cycles[i];
+        RelayDetector d;
+        Relay_Reset(&d);
+
+        int n;
+        for(n = 0; n < 1000 && !Relay_Converged(&d); n++) {
+            int32_t signal = (int32_t)lround(Wave(c, n) + c->offset + Noise(c->noise));
+            Relay_Update(&d, signal - (int32_t)c->offset, signal);
+        }
+
+        double period = Relay_Period(&d) / 256.0;
+        double amplitude = Relay_Amplitude(&d);
+        double periodError = fabs(period - c->period) / c->period * 100.0;
+        double amplitudeError = fabs(amplitude - c->amplitude) / c->amplitude * 100.0;
+        _Bool ok = Relay_Converged(&d) && periodError <= PERIOD_TOLERANCE && amplitudeError <= AMPLITUDE_TOLERANCE;
+
+        printf("  %-4s %-26s period %6.2f (%6.2f)  amplitude %6.1f (%6.1f)\n", ok ? "ok" : "FAIL", c->name,
+               period, c->period, amplitude, c->amplitude);
+        if(!ok) failures++;
+    }
+
+    // A chirp never repeats a cycle within the tolerance
+    RelayDetector d;
+    Relay_Reset(&d);
+    int n;
+    double phase = 0;
+    for(n = 0; n < 1000; n++) {
+        phase += 1.0 / (10.0 + n * 0.2);
+        Relay_Update(&d, (int32_t)lround(300.0 * sin(2.0 * PI * phase)), (int32_t)lround(300.0 * sin(2.0 * PI * phase)));
+    }
+    printf("  %-4s %-26s converged %s\n", Relay_Converged(&d) ? "FAIL" : "ok", "chirp_rejected", Relay_Converged(&d) ? "yes" : "no");
+    if(Relay_Converged(&d)) failures++;
+
+    return failures;
+}
+
+static void SetDefaultGains(void) {
+    Px = 120; Ix = 5; Dx = 240;
+    Py = 120; Iy = 5; Dy = 220;
+}
+
+static int CheckPlant(void) {
+    static const Scenario experiment = {.name = "autotune", .kind = SCENARIO_STEP, .duration = AUTOTUNE_TIMEOUT * PID_UPDATE_RATE + 2000, .controller = SCENARIO_AUTOTUNE};
+    static const Scenario step = {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000};
+    static const char *rules[AUTOTUNE_RULE_COUNT] = {"fast", "moderate", "robust"};
+    int failures = 0;
+
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    Metrics m;
+
+    SetDefaultGains();
+    Harness_Run(&step, &params, &m, NULL);
+    printf("\nAuto-tune on the simulated plant (+600 step)\n");
+    printf("  rule      period(ms)  amplitude  P    I    D      settle(ms)  overshoot(%%)  steady max(counts)\n");
+    printf("  default   %10s  %9s  %-4d %-4d %-6d %10.0f  %12.1f  %18.1f\n", "-", "-", Px, Ix, Dx, m.settleMs, m.overshootPct, m.maxError);
+
+    uint8_t rule;
+    for(rule = 0; rule < AUTOTUNE_RULE_COUNT; rule++) {
+        SetDefaultGains();
+        AutoTune_Start(rule);
+        Harness_Run(&experiment, &params, &m, NULL);
+        if(AutoTuneStatus != AUTOTUNE_DONE) {
+            printf("  FAIL %-8s auto-tune did not finish (status %d)\n", rules[rule], AutoTuneStatus);
+            failures++;
+            continue;
+        }
+
+        Harness_Run(&step, &params, &m, NULL);
+        printf("  %-8s  %10u  %9u  %-4d %-4d %-6d %10.0f  %12.1f  %18.1f\n", rules[rule], AutoTunePeriodX, AutoTuneAmplitudeX,
+               Px, Ix, Dx, m.settleMs, m.overshootPct, m.maxError);
+        if(m.settleMs >= step.duration - step.eventTime - 1) {
+            printf("  FAIL %-8s tuned gains do not settle the step\n", rules[rule]);
+            failures++;
+        }
+    }
+    SetDefaultGains();
+    return failures;
+}
+
+int main(void) {
+    int failures = CheckDetector();
+    failures += CheckPlant();
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * bench.c
+ *
+ * Control performance regression benchmark (runs on a PC)
+ *
+ *  Runs the standard scenarios against the simulated plant, measures the
+ *  cost of the control functions and compares everything against a stored
+ *  baseline. Exits with 1 if any metric is worse than the baseline by more
+ *  than the tolerance.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/bench sim/bench.c sim/harness.c sim/plant.c sim/cost.c controller.c predictor.c lqr.c autotune.c linkage.c servoScale.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Usage:
+ *      sim/bench [-b baseline] [-t tolerance %] [-u]
+ *          -b  Baseline file (default sim/baseline.txt)
+ *          -t  Allowed regression in percent (default 10)
+ *          -u  Write the current results as the new baseline
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../controller.h"
+#include "../circle.h"
+#include "../lqr.h"
+#include "../linkage.h"
+#include "../shaper.h"
+#include "harness.h"
+#include "cost.h"
+
+#define MAX_RESULTS 128
+
+// Absolute slack so that metrics near zero don't fail on rounding
+#define SLACK_MS 20.0
+#define SLACK_PCT 1.0
+#define SLACK_COUNTS 1.0
+#define SLACK_INSTRUCTIONS 2.0
+
+typedef struct {
+    char name[64];
+    double value;
+    double slack;
+} Result;
+
+static Result results[MAX_RESULTS];
+static int resultCount = 0;
+
+static const Scenario scenarios[] = {
+    {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000},
+    {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000},
+    {.name = "step_minus600", .kind = SCENARIO_STEP, .mode = 2, .eventTime = 3000, .duration = 10000},
+    {.name = "circle_rate3", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 3, .eventTime = 2000, .duration = 8000},
+    {.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000},
+    {.name = "circle_rate10", .kind = SCENARIO_TRACK, .mode = 4, .circleRate = 10, .eventTime = 2000, .duration = 14000},
+    {.name = "ball_drop", .kind = SCENARIO_STEP, .startX = 500, .startY = -350, .startVX = -300, .startVY = 200, .dropTime = 1500, .duration = 9500},
+
+    // Same scenarios with the state feedback controller (button mode 7 for center hold)
+    {.name = "lqr_center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000, .controller = SCENARIO_LQR},
+    {.name = "lqr_step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_LQR},
+    {.name = "lqr_step_minus600", .kind = SCENARIO_STEP, .mode = 2, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_LQR},
+    {.name = "lqr_circle_rate3", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 3, .eventTime = 2000, .duration = 8000, .controller = SCENARIO_LQR},
+    {.name = "lqr_circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000, .controller = SCENARIO_LQR},
+    {.name = "lqr_circle_rate10", .kind = SCENARIO_TRACK, .mode = 4, .circleRate = 10, .eventTime = 2000, .duration = 14000, .controller = SCENARIO_LQR},
+    {.name = "lqr_ball_drop", .kind = SCENARIO_STEP, .startX = 500, .startY = -350, .startVX = -300, .startVY = 200, .dropTime = 1500, .duration = 9500, .controller = SCENARIO_LQR},
+};
+
+static void AddResult(const char *scenario, const char *metric, double value, double slack) {
+    if(resultCount >= MAX_RESULTS) return;
+    Result *r = &results[resultCount++];
+    snprintf(r->name, sizeof(r->name), "%s.%s", scenario, metric);
+    r->value = value;
+    r->slack = slack;
+}
+
+// Call wrappers with a changing input so nothing is optimized away
+static uint32_t costStep = 0;
+
+static void CostPID(void) {
+    costStep++;
+    SeqLock_WritePair(&Ball, CENTER_X + (costStep & 0x1FF) - 256, CENTER_Y - (costStep & 0x0FF) + 128);
+    UpdatePIDController();
+}
+
+static void CostPIDFloat(void) {
+    costStep++;
+    SeqLock_WritePair(&Ball, CENTER_X + (costStep & 0x1FF) - 256, CENTER_Y - (costStep & 0x0FF) + 128);
+    UpdatePIDControllerFloat();
+}
+
+static void CostLQR(void) {
+    costStep++;
+    SeqLock_WritePair(&Ball, CENTER_X + (costStep & 0x1FF) - 256, CENTER_Y - (costStep & 0x0FF) + 128);
+    UpdateLQRController();
+}
+
+static void CostLinkage(void) {
+    uint32_t pulseX, pulseY;
+    costStep++;
+    Linkage_Pulse((int32_t)(costStep & 0x7FF) - 1024, 600 - (int32_t)(costStep & 0x3FF), SERVO_X_ZERO, SERVO_Y_ZERO, &pulseX, &pulseY);
+    CostSink += pulseX + pulseY;
+}
+
+// Every shaping stage on, one axis
+static ShaperAxis costShaper;
+
+static void CostShaper(void) {
+    costStep++;
+    CostSink += Shaper_Update(&costShaper, (int32_t)(costStep & 0x1FF) - 256);
+}
+
+// Instructions per call (sim/cost.c), the same on every host for a build. Left out where they can't be counted,
+//  the baseline reports them as missing
+static void RunCost(void) {
+    Cost_Init();
+    const char *unit = Cost_Unit();
+    if(!unit) {
+        printf("Instructions can't be counted on this host (ptrace), the cost isn't measured\n");
+        return;
+    }
+
+    Controller_Init();
+    AddResult("UpdatePIDController", unit, Cost_Measure(CostPID), SLACK_INSTRUCTIONS);
+    Controller_Init();
+    AddResult("UpdatePIDControllerFloat", unit, Cost_Measure(CostPIDFloat), SLACK_INSTRUCTIONS);
+    LQR_Init();
+    AddResult("UpdateLQRController", unit, Cost_Measure(CostLQR), SLACK_INSTRUCTIONS);
+    AddResult("Linkage_Pulse", unit, Cost_Measure(CostLinkage), SLACK_INSTRUCTIONS);
+
+    // Command shaping with every stage on
+    ShaperFilter = SHAPER_FILTER_BIQUAD;
+    ShaperSlew = 40;
+    ShaperAccel = 20;
+    ShaperJerk = 5;
+    Shaper_Reset(&costShaper, 0);
+    AddResult("Shaper_Update", unit, Cost_Measure(CostShaper), SLACK_INSTRUCTIONS);
+    ShaperFilter = SHAPER_DEFAULT_FILTER;
+    ShaperSlew = SHAPER_DEFAULT_SLEW;
+    ShaperAccel = SHAPER_DEFAULT_ACCEL;
+    ShaperJerk = SHAPER_DEFAULT_JERK;
+}
+
+static void RunScenarios(void) {
+    PlantParams params;
+    Plant_DefaultParams(&params);
+
+    unsigned int i;
+    for(i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const Scenario *scenario = &scenarios[i];
+        Metrics m;
+        Harness_Run(scenario, &params, &m, NULL);
+
+        if(scenario->kind == SCENARIO_STEP) {
+            AddResult(scenario->name, "settle_ms", m.settleMs, SLACK_MS);
+            AddResult(scenario->name, "overshoot_pct", m.overshootPct, SLACK_PCT);
+        }
+        AddResult(scenario->name, "rms_counts", m.rmsError, SLACK_COUNTS);
+        AddResult(scenario->name, "max_counts", m.maxError, SLACK_COUNTS);
+    }
+}
+
+static int WriteBaseline(const char *path) {
+    FILE *f = fopen(path, "w");
+    if(!f) {
+        perror(path);
+        return 1;
+    }
+    fprintf(f, "# Control benchmark baseline, regenerate with: sim/bench -u\n");
+    int i;
+    for(i = 0; i < resultCount; i++) {
+        fprintf(f, "%s %.2f\n", results[i].name, results[i].value);
+    }
+    fclose(f);
+    printf("Baseline written to %s\n", path);
+    return 0;
+}
+
+static int CompareBaseline(const char *path, double tolerance) {
+    FILE *f = fopen(path, "r");
+    if(!f) {
+        perror(path);
+        return 1;
+    }
+
+    int failures = 0;
+    char line[256];
+    char name[64];
+    double base;
+    while(fgets(line, sizeof(line), f)) {
+        if(line[0] == '#' || sscanf(line, "%63s %lf", name, &base) != 2) continue;
+
+        int i;
+        for(i = 0; i < resultCount; i++) {
+            if(strcmp(results[i].name, name) == 0) break;
+        }
+        if(i == resultCount) {
+            printf("  MISSING %-36s baseline %10.2f\n", name, base);
+            failures++;
+            continue;
+        }
+
+        Result *r = &results[i];
+        double limit = base * (1.0 + tolerance / 100.0) + r->slack;
+        _Bool regressed = r->value > limit;
+        printf("  %-7s %-36s baseline %10.2f  now %10.2f\n", regressed ? "FAIL" : "ok", name, base, r->value);
+        if(regressed) failures++;
+    }
+    fclose(f);
+
+    if(failures) {
+        printf("%d metric(s) regressed beyond %.0f%%\n", failures, tolerance);
+        return 1;
+    }
+    printf("All metrics within %.0f%% of the baseline\n", tolerance);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *baseline = "sim/baseline.txt";
+    double tolerance = 10.0;
+    _Bool update = false;
+
+    int opt;
+    while((opt = getopt(argc, argv, "b:t:u")) != -1) {
+        switch(opt) {
+        case 'b': baseline = optarg; break;
+        case 't': tolerance = atof(optarg); break;
+        case 'u': update = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-b baseline] [-t tolerance %%] [-u]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    RunScenarios();
+    RunCost();
+
+    if(update) return WriteBaseline(baseline);
+    return CompareBaseline(baseline, tolerance);
+}
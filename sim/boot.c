@@ -0,0 +1,157 @@
+/*
+ * boot.c
+ *
+ * Boot readiness check (runs on a PC)
+ *
+ *  Checks the readiness conditions of ../boot.c (gains, servo frames, a consistent run
+ *  of touch samples), the latch and the stage breakdown. Then boots the simulated
+ *  plant with a ball at rest, one rolling in and one put on later, with control gated
+ *  by readiness and by the old fixed delays, and compares the time to the first
+ *  control output and to the ball settling.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/boot sim/boot.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../boot.h"
+#include "harness.h"
+#include "check.h"
+
+static void Frames(int count) {
+    int i;
+    for(i = 0; i < count; i++) Boot_ServoFrame();
+}
+
+static void Samples(int count, uint32_t x, uint32_t y) {
+    int i;
+    for(i = 0; i < count; i++) Boot_TouchSample(true, x, y);
+}
+
+static void CheckConditions(void) {
+    printf("Readiness conditions\n");
+
+    Boot_Init();
+    Boot_ConfigLoaded();
+    Frames(BOOT_SERVO_FRAMES);
+    Samples(BOOT_TOUCH_SAMPLES - 1, 2000, 2000);
+    Check(!Boot_ControlReady(50, PID_UPDATE_DELAY), "waits for BOOT_TOUCH_SAMPLES touch samples");
+    Samples(1, 2000 + BOOT_TOUCH_SPREAD, 2000 - BOOT_TOUCH_SPREAD);
+    Check(Boot_ControlReady(51, PID_UPDATE_DELAY) && BootControlMs == 51, "ready with all conditions, time kept");
+
+    Boot_Init();
+    Frames(BOOT_SERVO_FRAMES);
+    Samples(BOOT_TOUCH_SAMPLES, 2000, 2000);
+    Check(!Boot_ControlReady(60, PID_UPDATE_DELAY), "waits for the gains");
+    Boot_ConfigLoaded();
+    Frames(BOOT_SERVO_FRAMES - 1);
+    Check(Boot_ControlReady(61, PID_UPDATE_DELAY), "gains loaded");
+
+    Boot_Init();
+    Boot_ConfigLoaded();
+    Samples(BOOT_TOUCH_SAMPLES, 2000, 2000);
+    Frames(BOOT_SERVO_FRAMES - 1);
+    Check(!Boot_ControlReady(70, PID_UPDATE_DELAY), "waits for BOOT_SERVO_FRAMES servo frames");
+    Frames(1);
+    Check(Boot_ControlReady(71, PID_UPDATE_DELAY), "servo frames done");
+
+    // A failed read or a sample away from the run starts over
+    Boot_Init();
+    Boot_ConfigLoaded();
+    Frames(BOOT_SERVO_FRAMES);
+    Samples(BOOT_TOUCH_SAMPLES - 1, 2000, 2000);
+    Boot_TouchSample(false, 0, 0);
+    Samples(BOOT_TOUCH_SAMPLES - 1, 2000, 2000);
+    Check(!Boot_ControlReady(80, PID_UPDATE_DELAY), "a failed read restarts the run");
+    Samples(1, 2000 + BOOT_TOUCH_SPREAD + 1, 2000);
+    Samples(BOOT_TOUCH_SAMPLES - 2, 2000, 2000);
+    Check(!Boot_ControlReady(81, PID_UPDATE_DELAY), "a sample outside BOOT_TOUCH_SPREAD restarts the run");
+    Samples(BOOT_TOUCH_SAMPLES - 1, 2000, 2000);
+    Check(Boot_ControlReady(82, PID_UPDATE_DELAY), "ready after a run around the new first sample");
+
+    // Once on, control stays on
+    Boot_TouchSample(false, 0, 0);
+    Check(Boot_ControlReady(83, PID_UPDATE_DELAY) && BootControlMs == 82, "latched, a later loss is left to loss.c");
+
+    BootEnabled = false;
+    Boot_Init();
+    Check(!Boot_ControlReady(PID_UPDATE_DELAY, PID_UPDATE_DELAY) && Boot_ControlReady(PID_UPDATE_DELAY + 1, PID_UPDATE_DELAY),
+          "disabled: the fixed delay");
+    BootEnabled = BOOT_DEFAULT_ENABLE;
+
+    Boot_Init();
+    Boot_Stage(BOOT_STAGE_PERIPHERALS, 120);
+    Boot_Stage(BOOT_STAGE_IO, 200);
+    Boot_Stage(BOOT_STAGE_STATE, 230);
+    Check(BootStageUs[BOOT_STAGE_PERIPHERALS] == 120 && BootStageUs[BOOT_STAGE_IO] == 80 && BootStageUs[BOOT_STAGE_STATE] == 30,
+          "stage durations from their end times");
+}
+
+// First time the servo command changes, the first control output
+static unsigned long firstControl;
+static double firstPendingX, firstPendingY;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    (void)setX;
+    (void)setY;
+    if(timeMs == 0) {
+        firstPendingX = plant->pendingX;
+        firstPendingY = plant->pendingY;
+        firstControl = 0;
+    } else if(firstControl == 0 && (plant->pendingX != firstPendingX || plant->pendingY != firstPendingY)) {
+        firstControl = timeMs;
+    }
+}
+
+static void CompareBoot(void) {
+    static const Scenario scenarios[] = {
+        {.name = "ball_at_rest", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 6000},
+        {.name = "ball_rolling_in", .kind = SCENARIO_STEP, .startX = 500, .startY = -350, .startVX = -300, .startVY = 200, .duration = 6000},
+        {.name = "ball_put_on_later", .kind = SCENARIO_STEP, .startX = 400, .startY = 300, .dropTime = 600, .duration = 6000},
+        {.name = "lqr_ball_at_rest", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 6000, .controller = SCENARIO_LQR},
+    };
+    PlantParams params;
+    unsigned int i;
+
+    Plant_DefaultParams(&params);
+    printf("\nBoot on the plant (ms from power up, settle from the ball being on the plate)\n");
+    printf("       %-20s %-10s %8s %14s %10s\n", "scenario", "start", "ready", "first output", "settle");
+    for(i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        const Scenario *s = &scenarios[i];
+        Metrics fixed, ready;
+        unsigned long fixedFirst, readyFirst;
+
+        BootEnabled = false;
+        Harness_Run(s, &params, &fixed, Trace);
+        fixedFirst = firstControl;
+        BootEnabled = true;
+        Harness_Run(s, &params, &ready, Trace);
+        readyFirst = firstControl;
+
+        // Ball at boot: control within about half the old delay. Put on later: control with the ball, no later
+        unsigned long placed = s->dropTime;
+        _Bool ok = (readyFirst > placed) && (readyFirst - placed <= (placed ? 100 : PID_UPDATE_DELAY / 2)) &&
+                   ready.settleMs <= fixed.settleMs + 20;
+        printf("       %-20s %-10s %8s %14lu %10.0f\n", s->name, "fixed", "-", fixedFirst, fixed.settleMs);
+        printf("  %-4s %-20s %-10s %8lu %14lu %10.0f  %+.0f ms\n", ok ? "ok" : "FAIL", "", "readiness", BootControlMs,
+               readyFirst, ready.settleMs, (double)readyFirst - (double)fixedFirst);
+        if(!ok) failures++;
+    }
+    BootEnabled = BOOT_DEFAULT_ENABLE;
+}
+
+int main(void) {
+    CheckConditions();
+    CompareBoot();
+
+    return Check_Result();
+}
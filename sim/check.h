@@ -0,0 +1,33 @@
+/*
+ * check.h
+ *
+ * Pass/fail lines of the simulation checks
+ *  Each check prints "ok" or "FAIL" with its text, Check_Result() prints the
+ *  summary and gives the exit code of the run (1 if a check failed)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdio.h>
+
+static int failures = 0;
+
+static void Check(_Bool ok, const char *text) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", text);
+    if(!ok) failures++;
+}
+
+static int Check_Result(void) {
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
+
+#endif /* CHECK_H_ */
@@ -0,0 +1,85 @@
+/*
+ * cost.c
+ *
+ * Cost measurement of the control functions on a PC
+ *  Counts the instructions the host executes per call by single stepping a
+ *  forked copy of the process (ptrace). The count only depends on the build
+ *  (compiler and flags), not on the host load or a hardware counter, so the
+ *  baseline compares the same unit on every host and run. It isn't a
+ *  Cortex-M4 cycle count, but it tracks the work a change adds to a function.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "cost.h"
+
+// Calls counted per measurement, the average is exact for functions whose path changes with the input
+#define COST_CALLS 64
+
+volatile int32_t CostSink;
+
+static _Bool costAvailable = false;
+
+static void Nothing(void) {
+}
+
+// Instructions from the start marker to the end marker of a forked copy making <calls> calls, -1 if it can't be traced
+static long long CountSteps(void (*function)(void), int calls) {
+    pid_t child = fork();
+    if(child < 0) return -1;
+
+    if(child == 0) {
+        int i;
+        if(ptrace(PTRACE_TRACEME, 0, 0, 0) != 0) _exit(1);
+        raise(SIGSTOP);
+        for(i = 0; i < calls; i++) function();
+        raise(SIGSTOP);
+        _exit(0);
+    }
+
+    int status;
+    long long steps = 0;
+    if(waitpid(child, &status, 0) != child || !WIFSTOPPED(status)) {
+        waitpid(child, &status, 0);
+        return -1;
+    }
+    while(1) {
+        if(ptrace(PTRACE_SINGLESTEP, child, 0, 0) != 0) break;
+        if(waitpid(child, &status, 0) != child || !WIFSTOPPED(status)) break;
+        if(WSTOPSIG(status) == SIGSTOP) {
+            kill(child, SIGKILL);
+            waitpid(child, &status, 0);
+            return steps;
+        }
+        steps++;
+    }
+    kill(child, SIGKILL);
+    waitpid(child, &status, 0);
+    return -1;
+}
+
+void Cost_Init(void) {
+    costAvailable = CountSteps(Nothing, 1) >= 0;
+}
+
+// Unit of the Cost_Measure() results, 0 if the instructions can't be counted on this host
+const char *Cost_Unit(void) {
+    return costAvailable ? "instructions" : 0;
+}
+
+// Instructions per call of <function> from its state at the call, the markers and the loop start are taken off
+double Cost_Measure(void (*function)(void)) {
+    if(!costAvailable) return 0.0;
+    long long overhead = CountSteps(function, 0);
+    long long steps = CountSteps(function, COST_CALLS);
+    if(overhead < 0 || steps < 0) return 0.0;
+    return (double)(steps - overhead) / COST_CALLS;
+}
@@ -0,0 +1,20 @@
+/*
+ * cost.h
+ *
+ * Cost measurement of the control functions on a PC (sim/bench, sim/fpu)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef COST_H_
+#define COST_H_
+
+// Sink for call wrappers, so results aren't optimized away
+extern volatile int32_t CostSink;
+
+void Cost_Init(void);
+const char *Cost_Unit(void);
+double Cost_Measure(void (*function)(void));
+
+#endif /* COST_H_ */
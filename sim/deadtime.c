@@ -0,0 +1,62 @@
+/*
+ * deadtime.c
+ *
+ * Dead time compensation demonstration (runs on a PC)
+ *
+ *  Runs the +600 step (mode 1) with extra sensing delay injected into the simulated
+ *  plant, at the normal PID gains and at raised P/D gains, with and without the
+ *  predictor (../predictor.c). The predictor delay is sized from the total dead time.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/deadtime sim/deadtime.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "../controller.h"
+#include "../predictor.h"
+#include "harness.h"
+
+// Dead time of the simulated rig without injected delay: touch sampling, servo frame and slew (ms)
+#define RIG_DEAD_TIME 20
+
+static const Scenario step = {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000};
+
+static void SetGainScale(int percent) {
+    Px = 120 * percent / 100;
+    Dx = 240 * percent / 100;
+    Py = 120 * percent / 100;
+    Dy = 220 * percent / 100;
+}
+
+int main(void) {
+    static const int delays[] = {0, 80, 160};
+    static const int scales[] = {100, 200, 300};
+    unsigned int d, g;
+
+    printf("injected  gains  predictor  settle(ms)  overshoot(%%)  rms(counts)  steady max(counts)\n");
+    for(d = 0; d < sizeof(delays) / sizeof(delays[0]); d++) {
+        PlantParams params;
+        Plant_DefaultParams(&params);
+        params.sensorDelay = delays[d];
+
+        for(g = 0; g < sizeof(scales) / sizeof(scales[0]); g++) {
+            int enable;
+            for(enable = 0; enable < 2; enable++) {
+                Metrics m;
+                SetGainScale(scales[g]);
+                PredictorEnabled = enable;
+                PredictorDelay = (RIG_DEAD_TIME + delays[d] + PID_UPDATE_RATE / 2) / PID_UPDATE_RATE;
+                Harness_Run(&step, &params, &m, NULL);
+
+                printf("%5d ms  %4d%%  %-9s  %10.0f  %12.1f  %11.1f  %18.1f\n", delays[d], scales[g],
+                       enable ? "on" : "off", m.settleMs, m.overshootPct, m.rmsError, m.maxError);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * disturbance.c
+ *
+ * Disturbance observer check (runs on a PC)
+ *
+ *  Holds the ball on the simulated plant while a plate tilt bias is added (an off
+ *  level mount or a cable starting to drag) and compares the PID with and without
+ *  the disturbance observer (../disturbance.c): how many PID periods the estimate
+ *  takes to reach the bias, how far the ball is pushed off and how long it takes
+ *  to come back. Then holds the ball with servo deadband, alone and with a bias,
+ *  and checks that the observer costs nothing on steps and circles without a
+ *  disturbance and what the touch noise it passes on costs in servo travel.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/disturbance sim/disturbance.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../disturbance.h"
+#include "harness.h"
+
+// Ball is back once it stays within this many counts of the target
+#define RECOVER_BAND 20
+
+// Bias is added after the hold has settled, the deadband runs are judged over their second half
+#define BIAS_TIME 4000
+#define HOLD_DURATION 12000
+
+typedef struct {
+    const char *name;
+    double biasX, biasY;        // Tilt added at BIAS_TIME (degrees)
+    double deadband;            // Servo deadband (10th of a degree)
+} Case;
+
+// Ball error and disturbance estimate after BIAS_TIME
+typedef struct {
+    double peak;                // Largest error (counts)
+    unsigned long lastOutside;  // Last time outside RECOVER_BAND (ms)
+    unsigned long estimated;    // First time the X estimate reached 85% of the bias (ms, 0 = never)
+    double squares;             // Error squares over the second half of the run
+    unsigned long samples;
+} Response;
+
+static Response response;
+static double expectedX;
+static double baseX;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    double errX = (double)setX - (plant->p.touchCenterX + Plant_ToCounts(plant->posX));
+    double errY = (double)setY - (plant->p.touchCenterY + Plant_ToCounts(plant->posY));
+    double mag = sqrt(errX * errX + errY * errY);
+
+    if(timeMs == BIAS_TIME) baseX = DisturbanceX;
+    if(timeMs >= BIAS_TIME) {
+        if(mag > response.peak) response.peak = mag;
+        if(mag > RECOVER_BAND) response.lastOutside = timeMs;
+        if(!response.estimated && expectedX != 0 && (DisturbanceX - baseX) / expectedX >= 0.85) response.estimated = timeMs;
+    }
+    if(timeMs >= HOLD_DURATION / 2) {
+        response.squares += mag * mag;
+        response.samples++;
+    }
+}
+
+static void Run(const Case *c, _Bool observer, Response *r) {
+    Scenario hold = {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = HOLD_DURATION};
+    hold.biasTime = BIAS_TIME;
+    hold.biasTiltX = c->biasX;
+    hold.biasTiltY = c->biasY;
+
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    params.servoDeadband = c->deadband;
+
+    // Servo command (10th of a degree) that levels the added tilt
+    expectedX = c->biasX / params.linkRatio * 10.0;
+
+    Response empty = {0};
+    response = empty;
+    baseX = 0;
+    DisturbanceEnabled = observer;
+    Metrics m;
+    Harness_Run(&hold, &params, &m, Trace);
+    DisturbanceEnabled = DISTURBANCE_DEFAULT_ENABLE;
+    *r = response;
+}
+
+static double Rms(const Response *r) {
+    return r->samples ? sqrt(r->squares / r->samples) : 0;
+}
+
+static int CheckBias(const Case *c) {
+    Response off, on;
+    Run(c, false, &off);
+    Run(c, true, &on);
+
+    double recoverOff = (off.lastOutside > BIAS_TIME) ? off.lastOutside - BIAS_TIME : 0;
+    double recoverOn = (on.lastOutside > BIAS_TIME) ? on.lastOutside - BIAS_TIME : 0;
+    double periods = on.estimated ? (double)(on.estimated - BIAS_TIME) / PID_UPDATE_RATE : -1;
+
+    // The estimate is there within a few periods, the ball is pushed a fraction as far and is back in a fraction of the time
+    _Bool ok = on.estimated && periods <= 6 && on.peak < off.peak / 3 && recoverOn < recoverOff / 3;
+    printf("  %-4s %-18s estimate after %4.0f periods   peak %5.1f / %5.1f counts   back after %5.0f / %5.0f ms\n",
+           ok ? "ok" : "FAIL", c->name, periods, off.peak, on.peak, recoverOff, recoverOn);
+    return ok ? 0 : 1;
+}
+
+static int CheckDeadband(const Case *c) {
+    Response off, on;
+    Run(c, false, &off);
+    Run(c, true, &on);
+
+    // The deadband leaves the ball off the target, the observer makes up the part it can
+    _Bool ok = Rms(&on) < 0.75 * Rms(&off);
+    printf("  %-4s %-18s rms %5.1f / %5.1f counts (second half)\n", ok ? "ok" : "FAIL", c->name, Rms(&off), Rms(&on));
+    return ok ? 0 : 1;
+}
+
+// Servo travel (10th of a degree) of the latched X commands
+static double travel;
+static double lastX;
+
+static void TraceTravel(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    (void)setX;
+    (void)setY;
+    if(timeMs > 0) travel += fabs(plant->latchedX - lastX);
+    lastX = plant->latchedX;
+}
+
+/* The observer passes some touch noise on to the servos, the travel holding the ball stays within 2.5 times
+ *  (the servos hardly move without it)
+ */
+static int CheckNoise(void) {
+    static const Scenario hold = {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000};
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    Metrics m;
+
+    travel = 0;
+    Harness_Run(&hold, &params, &m, TraceTravel);
+    double off = travel / 10.0 / (hold.duration / 1000.0);
+    travel = 0;
+    DisturbanceEnabled = true;
+    Harness_Run(&hold, &params, &m, TraceTravel);
+    DisturbanceEnabled = DISTURBANCE_DEFAULT_ENABLE;
+    double on = travel / 10.0 / (hold.duration / 1000.0);
+
+    _Bool ok = on < 2.5 * off;
+    printf("  %-4s %-18s servo travel %5.1f / %5.1f deg/s\n", ok ? "ok" : "FAIL", hold.name, off, on);
+    return ok ? 0 : 1;
+}
+
+// Without a disturbance the observer has nothing to cancel, the responses stay within 10%
+static int CheckClean(void) {
+    static const Scenario scenarios[] = {
+        {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000},
+        {.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000},
+    };
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    int failures = 0;
+    unsigned int i;
+
+    for(i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        Metrics off, on;
+        Harness_Run(&scenarios[i], &params, &off, NULL);
+        DisturbanceEnabled = true;
+        Harness_Run(&scenarios[i], &params, &on, NULL);
+        DisturbanceEnabled = DISTURBANCE_DEFAULT_ENABLE;
+
+        _Bool ok = on.rmsError <= 1.1 * off.rmsError && on.settleMs <= 1.1 * off.settleMs + PID_UPDATE_RATE;
+        printf("  %-4s %-18s settle %5.0f / %5.0f ms  rms %5.1f / %5.1f counts\n", ok ? "ok" : "FAIL", scenarios[i].name,
+               off.settleMs, on.settleMs, off.rmsError, on.rmsError);
+        if(!ok) failures++;
+    }
+    return failures;
+}
+
+int main(void) {
+    static const Case biases[] = {
+        {"bias_x_1deg",         1.0,    0,      0},
+        {"bias_x_-2deg",        -2.0,   0,      0},
+        {"bias_xy_1.5deg",      1.5,    -1.5,   0},
+        {"bias_1deg_deadband",  1.0,    0,      10},
+    };
+    static const Case deadbands[] = {
+        {"deadband_0.5deg",     0,      0,      5},
+        {"deadband_1deg",       0,      0,      10},
+        {"deadband_2deg",       0,      0,      20},
+    };
+    int failures = 0;
+    unsigned int i;
+
+    printf("Tilt bias added at %d ms (without / with the observer)\n", BIAS_TIME);
+    for(i = 0; i < sizeof(biases) / sizeof(biases[0]); i++) {
+        failures += CheckBias(&biases[i]);
+    }
+
+    printf("\nServo deadband (without / with the observer)\n");
+    for(i = 0; i < sizeof(deadbands) / sizeof(deadbands[0]); i++) {
+        failures += CheckDeadband(&deadbands[i]);
+    }
+
+    printf("\nNo disturbance (without / with the observer)\n");
+    failures += CheckClean();
+    failures += CheckNoise();
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * dsp.c
+ *
+ * Dual-axis kernel check (runs on a PC)
+ *
+ *  Runs the portable C and the SIMD version of every kernel in ../dsp.c on the same
+ *  inputs, the SIMD instructions emulated, and requires the results and the kernel
+ *  state to match to the bit: the corner values of 16 bits, random inputs and long
+ *  filter runs. Then checks the biquad kernel against the command shaper's low pass.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/dsp sim/dsp.c dsp.c controller.c predictor.c shaper.c notch.c disturbance.c schedule.c seqlock.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../controller.h"
+#include "../shaper.h"
+#include "../dsp.h"
+#include "check.h"
+
+#define RANDOM_CASES 1000000
+#define FILTER_SAMPLES 200000
+
+// 16 bit values the saturation and wrapping are decided at
+static const int32_t corners[] = {INT16_MIN, INT16_MIN + 1, -16384, -500, -1, 0, 1, 500, 16384, INT16_MAX - 1, INT16_MAX};
+
+#define CORNER_COUNT (sizeof(corners) / sizeof(corners[0]))
+
+static uint32_t Random32(void) {
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+// Random pair, every fourth one from the corners
+static DspPair RandomPair(void) {
+    if((rand() & 3) == 0) {
+        return Dsp_Pack(corners[rand() % CORNER_COUNT], corners[rand() % CORNER_COUNT]);
+    }
+    return Random32();
+}
+
+// Pair with both values in +/-<range>
+static DspPair RandomRange(int32_t range) {
+    return Dsp_Pack(rand() % (2 * range + 1) - range, rand() % (2 * range + 1) - range);
+}
+
+static void CheckArithmetic(void) {
+    long add = 0, sub = 0, saturate = 0, pid = 0;
+    unsigned int i, j, k, l;
+    long n;
+
+    // Every combination of the corners
+    for(i = 0; i < CORNER_COUNT; i++) {
+        for(j = 0; j < CORNER_COUNT; j++) {
+            for(k = 0; k < CORNER_COUNT; k++) {
+                for(l = 0; l < CORNER_COUNT; l++) {
+                    DspPair a = Dsp_Pack(corners[i], corners[j]);
+                    DspPair b = Dsp_Pack(corners[k], corners[l]);
+                    add += Dsp_AddC(a, b) != Dsp_AddSimd(a, b);
+                    sub += Dsp_SubC(a, b) != Dsp_SubSimd(a, b);
+                    if(corners[k] >= 0 && corners[l] >= 0) {
+                        saturate += Dsp_SaturateC(a, b) != Dsp_SaturateSimd(a, b);
+                    }
+                }
+            }
+        }
+    }
+
+    for(n = 0; n < RANDOM_CASES; n++) {
+        DspPair a = RandomPair();
+        DspPair b = RandomPair();
+        add += Dsp_AddC(a, b) != Dsp_AddSimd(a, b);
+        sub += Dsp_SubC(a, b) != Dsp_SubSimd(a, b);
+        saturate += Dsp_SaturateC(a, b & 0x7FFF7FFF) != Dsp_SaturateSimd(a, b & 0x7FFF7FFF);
+
+        // Any accumulator, the sums wrap
+        DspPair gainsX = RandomPair();
+        DspPair gainsY = RandomPair();
+        int32_t xC = (int32_t)Random32(), yC = (int32_t)Random32();
+        int32_t xSimd = xC, ySimd = yC;
+        DspPair last = RandomPair();
+        DspPair difC = Dsp_PidAccumulateC(a, last, b & 0x7FFF7FFF, gainsX, gainsY, &xC, &yC);
+        DspPair difSimd = Dsp_PidAccumulateSimd(a, last, b & 0x7FFF7FFF, gainsX, gainsY, &xSimd, &ySimd);
+        pid += (xC != xSimd) || (yC != ySimd) || (difC != difSimd);
+    }
+
+    printf("Arithmetic (%lu corner and %d random cases)\n", (unsigned long)(CORNER_COUNT * CORNER_COUNT * CORNER_COUNT * CORNER_COUNT),
+           RANDOM_CASES);
+    Check(add == 0, "Dsp_Add bit exact");
+    Check(sub == 0, "Dsp_Sub bit exact");
+    Check(saturate == 0, "Dsp_Saturate bit exact");
+    Check(pid == 0, "Dsp_PidAccumulate bit exact");
+
+    Check(Dsp_AddC(Dsp_Pack(30000, -30000), Dsp_Pack(5000, -5000)) == Dsp_Pack(INT16_MAX, INT16_MIN), "sums saturate");
+    Check(Dsp_SaturateC(Dsp_Pack(700, -900), Dsp_Pack(300, 350)) == Dsp_Pack(300, -350), "limits per axis");
+}
+
+// Runs both versions of a filter on <input> samples, outputs and state have to stay equal
+static long CompareBiquad(int16_t b0, int16_t b1, int16_t b2, int16_t a1, int16_t a2, uint8_t shift, int32_t range, _Bool steps) {
+    DspBiquad c, simd;
+    long mismatches = 0;
+    long n;
+    DspPair input = 0;
+
+    Dsp_BiquadInit(&c, b0, b1, b2, a1, a2, shift, 0);
+    Dsp_BiquadInit(&simd, b0, b1, b2, a1, a2, shift, 0);
+    for(n = 0; n < FILTER_SAMPLES; n++) {
+        if(!steps || (n % 50) == 0) input = RandomRange(range);
+        DspPair outC = Dsp_BiquadC(&c, input);
+        DspPair outSimd = Dsp_BiquadSimd(&simd, input);
+        mismatches += (outC != outSimd) || memcmp(&c, &simd, sizeof(c)) != 0;
+    }
+    return mismatches;
+}
+
+static void CheckFilters(void) {
+    long biquad = 0, average = 0;
+    int run;
+    long n;
+
+    printf("\nFilters (%d samples per run)\n", FILTER_SAMPLES);
+
+    // The shaper low pass (shaper.h) on commands in its resolution, then random coefficients on full range inputs
+    biquad += CompareBiquad(SHAPER_BIQUAD_B0, SHAPER_BIQUAD_B1, SHAPER_BIQUAD_B2, SHAPER_BIQUAD_A1, SHAPER_BIQUAD_A2,
+                            SHAPER_BIQUAD_SHIFT, SERVO_Y_RANGE << SHAPER_SHIFT, true);
+    for(run = 0; run < 20; run++) {
+        int16_t b[5];
+        int i;
+        for(i = 0; i < 5; i++) b[i] = (int16_t)Random32();
+        biquad += CompareBiquad(b[0], b[1], b[2], b[3], b[4], rand() % 16, INT16_MAX, run & 1);
+    }
+    Check(biquad == 0, "Dsp_Biquad bit exact (shaper low pass, 20 random filters)");
+
+    // Step response of the shaper low pass: unity DC gain, settles on the step
+    DspBiquad f;
+    DspPair out = 0;
+    Dsp_BiquadInit(&f, SHAPER_BIQUAD_B0, SHAPER_BIQUAD_B1, SHAPER_BIQUAD_B2, SHAPER_BIQUAD_A1, SHAPER_BIQUAD_A2,
+                   SHAPER_BIQUAD_SHIFT, 0);
+    for(n = 0; n < 100; n++) out = Dsp_Biquad(&f, Dsp_Pack(4800, -3200));
+    Check(DSP_X(out) == 4800 && DSP_Y(out) == -3200, "low pass settles on a step on both axes");
+
+    // Inputs in the 16 bit sum and beyond (the sums wrap the same)
+    DspAverage c, simd;
+    for(run = 0; run < 2; run++) {
+        int32_t range = run ? INT16_MAX : INT16_MAX / DSP_AVERAGE_SAMPLES;
+        Dsp_AverageInit(&c, 0);
+        Dsp_AverageInit(&simd, 0);
+        for(n = 0; n < FILTER_SAMPLES; n++) {
+            DspPair input = RandomRange(range);
+            average += Dsp_AverageC(&c, input) != Dsp_AverageSimd(&simd, input);
+            average += memcmp(&c, &simd, sizeof(c)) != 0;
+        }
+    }
+    Check(average == 0, "Dsp_Average bit exact");
+
+    Dsp_AverageInit(&c, Dsp_Pack(100, -100));
+    for(n = 0; n < DSP_AVERAGE_SAMPLES / 2; n++) out = Dsp_AverageC(&c, Dsp_Pack(200, -200));
+    Check(DSP_X(out) == 150 && DSP_Y(out) == -150, "average of the last DSP_AVERAGE_SAMPLES inputs");
+}
+
+// Dsp_Biquad() with the shaper coefficients against the shaper's own low pass (limits off)
+static void CheckShaper(void) {
+    ShaperAxis x, y;
+    DspBiquad f;
+    long mismatches = 0;
+    long n;
+    int32_t targetX = 0, targetY = 0;
+
+    ShaperFilter = SHAPER_FILTER_BIQUAD;
+    Shaper_Reset(&x, 0);
+    Shaper_Reset(&y, 0);
+    Dsp_BiquadInit(&f, SHAPER_BIQUAD_B0, SHAPER_BIQUAD_B1, SHAPER_BIQUAD_B2, SHAPER_BIQUAD_A1, SHAPER_BIQUAD_A2,
+                   SHAPER_BIQUAD_SHIFT, 0);
+    for(n = 0; n < FILTER_SAMPLES; n++) {
+        if((n % 20) == 0) {
+            targetX = rand() % (2 * SERVO_X_RANGE + 1) - SERVO_X_RANGE;
+            targetY = rand() % (2 * SERVO_Y_RANGE + 1) - SERVO_Y_RANGE;
+        }
+        DspPair out = Dsp_Biquad(&f, DSP_PAIR(targetX << SHAPER_SHIFT, targetY << SHAPER_SHIFT));
+        mismatches += Shaper_Update(&x, targetX) != (DSP_X(out) + (1 << (SHAPER_SHIFT - 1))) >> SHAPER_SHIFT;
+        mismatches += Shaper_Update(&y, targetY) != (DSP_Y(out) + (1 << (SHAPER_SHIFT - 1))) >> SHAPER_SHIFT;
+    }
+    ShaperFilter = SHAPER_DEFAULT_FILTER;
+
+    printf("\nShaper low pass on the kernel (%s)\n", DSP_SIMD ? "SIMD" : "C");
+    Check(mismatches == 0, "both axes in one Dsp_Biquad() give the outputs of two Shaper_Update() calls");
+}
+
+int main(void) {
+    srand(1);
+    printf("Kernels run by the firmware: %s (DSP_SIMD)\n\n", DSP_SIMD ? "SIMD" : "C");
+    CheckArithmetic();
+    CheckFilters();
+    CheckShaper();
+
+    return Check_Result();
+}
@@ -0,0 +1,351 @@
+/*
+ * fpu.c
+ *
+ * Integer vs float control path comparison (runs on a PC)
+ *
+ *  Compares the integer and the single precision float versions of the touch
+ *  conversion, the dead time predictor and the PID (CONTROLLER_FLOAT) against the
+ *  same calculation in double precision, runs the standard scenarios on the
+ *  simulated plant with both and measures their cost. The float path has to match
+ *  the double reference to its rounding and may not control worse than the integer
+ *  path. Exits with 1 if a check fails.
+ *
+ *  The cost is measured on the host (see sim/cost.c). It shows the extra work, not
+ *  Cortex-M4F cycles: there an FPU add or multiply takes 1 cycle like its integer
+ *  counterpart, while the integer PID has 6 divides (2 to 12 cycles each).
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/fpu sim/fpu.c sim/harness.c sim/plant.c sim/cost.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c touchConvert.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../predictor.h"
+#include "../touchConvert.h"
+#include "harness.h"
+#include "cost.h"
+#include "check.h"
+
+// PID periods of the open loop comparisons
+#define COMPARE_STEPS 20000
+
+// Largest difference of the sums of both touch sides compared (4 samples of 12 bits)
+#define TOUCH_SUM_MAX (TOUCH_SAMPLES * 4095)
+#define TOUCH_SUM_WINDOW 256
+
+typedef struct {
+    const char *name;
+    double maxError;
+    double sumSquares;
+    double sum;
+    long mismatches;        // Results that differ from the rounded reference
+    long count;
+    _Bool fraction;         // Results keep their fraction, mismatches don't apply
+} Accuracy;
+
+typedef struct {
+    Scenario scenario;
+    _Bool predictor;
+} PathScenario;
+
+static const PathScenario scenarios[] = {
+    {{.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000}, false},
+    {{.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000}, false},
+    {{.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000}, false},
+    {{.name = "ball_drop", .kind = SCENARIO_STEP, .startX = 500, .startY = -350, .startVX = -300, .startVY = 200, .dropTime = 1500, .duration = 9500}, false},
+    {{.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000}, true},
+    {{.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000}, true},
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// PID state of both paths (controller.c)
+extern int32_t ErrorXLast, ErrorXSum;
+extern float errorXLastF, errorXSumF;
+
+static void Accuracy_Add(Accuracy *a, double value, double reference) {
+    double error = value - reference;
+    if(fabs(error) > a->maxError) a->maxError = fabs(error);
+    a->sumSquares += error * error;
+    a->sum += error;
+    if(value != floor(reference + 0.5)) a->mismatches++;
+    a->count++;
+}
+
+static double Accuracy_Rms(const Accuracy *a) {
+    return a->count ? sqrt(a->sumSquares / a->count) : 0.0;
+}
+
+static void Accuracy_Print(const Accuracy *a) {
+    printf("       %-8s max %8.4f  rms %8.4f  bias %+8.4f", a->name, a->maxError, Accuracy_Rms(a), a->count ? a->sum / a->count : 0.0);
+    if(a->fraction) {
+        printf("  (not rounded)\n");
+    } else {
+        printf("  off the rounded reference %6.2f%%\n", a->count ? 100.0 * a->mismatches / a->count : 0.0);
+    }
+}
+
+// Ball samples and setpoints of the open loop comparisons, reproducible
+static uint32_t SampleX(int k) {
+    return (uint32_t)(CENTER_X + 400.0 * sin(2.0 * M_PI * k / 150.0) + (rand() % 7) - 3);
+}
+
+static uint32_t SampleY(int k) {
+    return (uint32_t)(CENTER_Y + 250.0 * cos(2.0 * M_PI * k / 97.0) + (rand() % 7) - 3);
+}
+
+static uint32_t SetpointX(int k) {
+    static const int32_t offsets[] = {0, 60, -60, 20};
+    return CENTER_X + offsets[(k / 500) % 4];
+}
+
+/*
+ * Touch conversion
+ *  Every pair of side sums within TOUCH_SUM_WINDOW of each other (the two sides of one reading)
+ */
+static void CompareTouch(void) {
+    Accuracy previous = {.name = "previous"}, fixed = {.name = "integer"}, single = {.name = "float"};
+    int32_t sumP, sumM;
+
+    printf("Touch conversion (counts, from the exact mean of %d samples per side)\n", TOUCH_SAMPLES);
+    for(sumP = 0; sumP <= TOUCH_SUM_MAX; sumP++) {
+        for(sumM = sumP - TOUCH_SUM_WINDOW; sumM <= sumP + TOUCH_SUM_WINDOW; sumM++) {
+            if(sumM < 0 || sumM > TOUCH_SUM_MAX) continue;
+            double mean = (sumP + sumM) / (2.0 * TOUCH_SAMPLES);
+
+            // Before: each side averaged and rounded, then the two rounded again
+            uint32_t p = (sumP + 2) / 4;
+            uint32_t m = (sumM + 2) / 4;
+            Accuracy_Add(&previous, (p + m + 1) / 2, mean);
+            Accuracy_Add(&fixed, Touch_ConvertFixed(sumP, sumM), mean);
+            Accuracy_Add(&single, Touch_ConvertFloat(sumP, sumM), mean);
+        }
+    }
+    Accuracy_Print(&previous);
+    Accuracy_Print(&fixed);
+    Accuracy_Print(&single);
+    Check(fixed.mismatches == 0 && single.mismatches == 0, "both conversions round the mean once");
+    Check(previous.maxError > fixed.maxError, "single rounding is closer than rounding each side first");
+}
+
+/*
+ * Dead time predictor
+ *  The reference is the observer of predictor.c without any scaling or truncation
+ */
+static double refHistoryX[PREDICTOR_HISTORY];
+static uint8_t refIndex = 0;
+
+static double RefHistory(uint8_t age) {
+    return refHistoryX[(refIndex + PREDICTOR_HISTORY - age) % PREDICTOR_HISTORY];
+}
+
+static double RefPredict(double position, double *pos, double *vel) {
+    double gain = PREDICTOR_GAIN_X / 65536.0;
+    uint8_t delay = PredictorDelay;
+
+    *vel += gain * RefHistory(delay + 1);
+    *pos += *vel;
+    double innovation = position - *pos;
+    *pos += innovation * PREDICTOR_OBSERVER_POS / 256.0;
+    *vel += innovation * PREDICTOR_OBSERVER_VEL / 256.0;
+
+    double p = *pos;
+    double v = *vel;
+    uint8_t age;
+    for(age = delay; age > 0; age--) {
+        v += gain * RefHistory(age);
+        p += v;
+    }
+    return p;
+}
+
+static void ComparePredictor(uint8_t delay) {
+    Accuracy fixed = {.name = "integer"}, single = {.name = "float"};
+    single.fraction = true;
+    double pos = 0, vel = 0;
+    int k, i;
+
+    srand(1);
+    PredictorDelay = delay;
+    Predictor_Init();
+    for(i = 0; i < PREDICTOR_HISTORY; i++) refHistoryX[i] = 0;
+    refIndex = 0;
+
+    for(k = 0; k < COMPARE_STEPS; k++) {
+        uint32_t x = SampleX(k);
+        uint32_t y = SampleY(k);
+        if(k == 0) pos = x;
+
+        int32_t fixedX, fixedY;
+        float singleX, singleY;
+        Predictor_Predict(x, y, &fixedX, &fixedY);
+        Predictor_PredictFloat(x, y, &singleX, &singleY);
+        double reference = RefPredict(x, &pos, &vel);
+
+        // The integer prediction is rounded to counts, the float one keeps its fraction
+        Accuracy_Add(&fixed, fixedX, reference);
+        Accuracy_Add(&single, singleX, reference);
+
+        int32_t command = (int32_t)lround(150.0 * sin(2.0 * M_PI * k / 60.0));
+        Predictor_Push(command, -command);
+        refHistoryX[refIndex] = command;
+        refIndex = (refIndex + 1) % PREDICTOR_HISTORY;
+    }
+
+    printf("\nDead time prediction, delay %u (counts, from the double precision observer)\n", delay);
+    Accuracy_Print(&fixed);
+    Accuracy_Print(&single);
+    Check(single.maxError < 0.01, "float prediction within 0.01 counts");
+    Check(Accuracy_Rms(&single) < Accuracy_Rms(&fixed), "float prediction closer than the integer one");
+    PredictorDelay = PREDICTOR_DEFAULT_DELAY;
+}
+
+/*
+ * PID
+ *  The reference is the PID in double precision, limited like Controller_Output() but not rounded
+ */
+static void ComparePID(void) {
+    Accuracy fixed = {.name = "integer"}, single = {.name = "float"};
+    double lastError = 0, errorSum = 0;
+    int32_t fixedLast = 0, fixedSum = 0;
+    float singleLast = 0.0f, singleSum = 0.0f;
+    int k;
+
+    srand(2);
+    PredictorEnabled = false;
+    for(k = 0; k < COMPARE_STEPS; k++) {
+        uint32_t setX = SetpointX(k);
+        uint32_t x = SampleX(k);
+        SeqLock_WritePair(&Setpoint, setX, CENTER_Y);
+        SeqLock_WritePair(&Ball, x, SampleY(k));
+
+        double error = (double)setX - x;
+        errorSum = fmax(-PID_ERROR_SUM_RANGE, fmin(PID_ERROR_SUM_RANGE, errorSum + error));
+        double dif = fmax(-500.0, fmin(500.0, error - lastError));
+        double reference = Px * error / 1000.0 + Ix * errorSum / 5000.0 + Dx * dif / 200.0;
+        reference = fmax(-SERVO_X_RANGE, fmin(SERVO_X_RANGE, reference));
+        lastError = error;
+
+        // Each path runs on its own state, the other one's is put back after it
+        ErrorXLast = fixedLast;
+        ErrorXSum = fixedSum;
+        UpdatePIDControllerFixed();
+        fixedLast = ErrorXLast;
+        fixedSum = ErrorXSum;
+        Accuracy_Add(&fixed, (int32_t)currentXDegrees - SERVO_X_ZERO, reference);
+
+        errorXLastF = singleLast;
+        errorXSumF = singleSum;
+        UpdatePIDControllerFloat();
+        singleLast = errorXLastF;
+        singleSum = errorXSumF;
+        Accuracy_Add(&single, (int32_t)currentXDegrees - SERVO_X_ZERO, reference);
+    }
+
+    printf("\nPID output (10th of a degree, from the double precision PID)\n");
+    Accuracy_Print(&fixed);
+    Accuracy_Print(&single);
+    Check(single.maxError <= 0.5 + 1e-3, "float output is the rounded reference");
+    Check(Accuracy_Rms(&single) < Accuracy_Rms(&fixed), "float output closer than the integer one");
+    PredictorEnabled = PREDICTOR_DEFAULT_ENABLE;
+}
+
+// Runs both paths on the plant, the float one may not be worse beyond the rounding of the plant noise
+static void CompareClosedLoop(void) {
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    unsigned int i;
+
+    printf("\nClosed loop on the simulated plant\n");
+    printf("       %-14s %-9s %-8s %10s  %12s  %11s  %11s\n", "scenario", "predictor", "path", "settle(ms)",
+           "overshoot(%)", "rms(counts)", "max(counts)");
+    for(i = 0; i < SCENARIO_COUNT; i++) {
+        Scenario scenario = scenarios[i].scenario;
+        Metrics fixed, single;
+        PredictorEnabled = scenarios[i].predictor;
+        scenario.controller = SCENARIO_PID_FIXED;
+        Harness_Run(&scenario, &params, &fixed, NULL);
+        scenario.controller = SCENARIO_PID_FLOAT;
+        Harness_Run(&scenario, &params, &single, NULL);
+
+        _Bool ok = single.rmsError <= fixed.rmsError * 1.05 + 1.0;
+        if(scenario.kind == SCENARIO_STEP) ok = ok && (single.settleMs <= fixed.settleMs * 1.10 + 20.0);
+        if(!ok) failures++;
+
+        const char *predictor = PredictorEnabled ? "on" : "off";
+        printf("       %-14s %-9s %-8s %10.0f  %12.1f  %11.1f  %11.1f\n", scenario.name, predictor, "integer",
+               fixed.settleMs, fixed.overshootPct, fixed.rmsError, fixed.maxError);
+        printf("  %-4s %-14s %-9s %-8s %10.0f  %12.1f  %11.1f  %11.1f\n", ok ? "ok" : "FAIL", "", "", "float",
+               single.settleMs, single.overshootPct, single.rmsError, single.maxError);
+    }
+    PredictorEnabled = PREDICTOR_DEFAULT_ENABLE;
+}
+
+// Call wrappers with a changing input so nothing is optimized away
+static uint32_t costStep = 0;
+
+static void CostFixed(void) {
+    costStep++;
+    SeqLock_WritePair(&Ball, CENTER_X + (costStep & 0x1FF) - 256, CENTER_Y - (costStep & 0x0FF) + 128);
+    UpdatePIDControllerFixed();
+}
+
+static void CostFloat(void) {
+    costStep++;
+    SeqLock_WritePair(&Ball, CENTER_X + (costStep & 0x1FF) - 256, CENTER_Y - (costStep & 0x0FF) + 128);
+    UpdatePIDControllerFloat();
+}
+
+static void CostTouchFixed(void) {
+    costStep++;
+    CostSink += Touch_ConvertFixed(costStep & 0x3FFF, (costStep * 7) & 0x3FFF);
+}
+
+static void CostTouchFloat(void) {
+    costStep++;
+    CostSink += Touch_ConvertFloat(costStep & 0x3FFF, (costStep * 7) & 0x3FFF);
+}
+
+static void CompareCost(void) {
+    int predictor;
+    Cost_Init();
+    const char *unit = Cost_Unit();
+    if(!unit) {
+        printf("\nCost per call: instructions can't be counted on this host (ptrace)\n");
+        return;
+    }
+
+    printf("\nCost per call (host %s)\n", unit);
+    for(predictor = 0; predictor <= 1; predictor++) {
+        PredictorEnabled = predictor;
+        Controller_Init();
+        double fixed = Cost_Measure(CostFixed);
+        Controller_Init();
+        double single = Cost_Measure(CostFloat);
+        printf("       PID, predictor %-3s   integer %8.1f  float %8.1f  (%+.0f%%)\n", predictor ? "on" : "off", fixed, single,
+               100.0 * (single - fixed) / fixed);
+    }
+    double fixed = Cost_Measure(CostTouchFixed);
+    double single = Cost_Measure(CostTouchFloat);
+    printf("       Touch conversion      integer %8.1f  float %8.1f  (%+.0f%%)\n", fixed, single, 100.0 * (single - fixed) / fixed);
+    PredictorEnabled = PREDICTOR_DEFAULT_ENABLE;
+}
+
+int main(void) {
+    printf("Selected path: %s (CONTROLLER_FLOAT)\n\n", CONTROLLER_FLOAT ? "float" : "integer");
+    CompareTouch();
+    ComparePredictor(PREDICTOR_DEFAULT_DELAY);
+    ComparePredictor(3);
+    ComparePID();
+    CompareClosedLoop();
+    CompareCost();
+
+    return Check_Result();
+}
@@ -0,0 +1,255 @@
+/*
+ * harness.c
+ *
+ * Firmware control path in a simulated main loop
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../controller.h"
+#include "../circle.h"
+#include "../lqr.h"
+#include "../autotune.h"
+#include "../loss.h"
+#include "../reference.h"
+#include "../boot.h"
+#include "../level.h"
+#include "harness.h"
+
+// Scheduler state, mirrors the volatile flags in main.c
+typedef struct {
+    unsigned long currentTime;
+    _Bool needTouchUpdate;
+    _Bool needPIDUpdate;
+    _Bool needMotorUpdate;
+    _Bool touchPresent;
+    uint8_t mode;
+    uint16_t circleRate;
+    uint16_t circleIndex;
+    uint8_t controller;
+    unsigned long frameOffset;
+} Scheduler;
+
+// Same as the switch in OnButtonPushed()
+static void EnterMode(Scheduler *s, uint8_t mode, uint16_t circleRate) {
+    s->mode = mode;
+    switch(mode) {
+    default:
+        Reference_Target(CenterX, CenterY);
+        break;
+    case(1):
+        Reference_Target(CenterX + 600, CenterY);
+        break;
+    case(2):
+        Reference_Target(CenterX - 600, CenterY);
+        break;
+    case(3):
+    case(4):
+        s->circleRate = circleRate;
+        Reference_Target(CenterX + CirclePosition_X[s->circleIndex], CenterY + CirclePosition_Y[s->circleIndex]);
+        break;
+    }
+}
+
+// Same as MoveCircleTarget()
+static void MoveCircleTarget(const Scheduler *s, uint16_t next) {
+    Reference_Moving(CenterX + CirclePosition_X[s->circleIndex], CenterY + CirclePosition_Y[s->circleIndex],
+                     CenterX + CirclePosition_X[next], CenterY + CirclePosition_Y[next], s->circleRate);
+}
+
+// Same as SysTick_Handler()
+static void Tick(Scheduler *s) {
+    s->currentTime++;
+
+    unsigned long frameTime = s->currentTime + SERVO_FRAME_PERIOD - s->frameOffset;
+
+    if((frameTime % TOUCH_UPDATE_RATE) == 0) {
+        s->needTouchUpdate = true;
+    }
+
+    if(Boot_ControlReady(s->currentTime, PID_UPDATE_DELAY) && ((frameTime % PID_UPDATE_RATE) == 0)) {
+        s->needPIDUpdate = true;
+    }
+
+    if(Boot_ControlReady(s->currentTime, MOTOR_UPDATE_DELAY) && ((frameTime % MOTOR_UPDATE_RATE) == 0)) {
+        s->needMotorUpdate = true;
+    }
+
+    if((s->mode == 3) && (s->currentTime % s->circleRate) == 0) {
+        s->circleIndex = (s->circleIndex + 1) % CIRCLE_SIZE;
+        MoveCircleTarget(s, (s->circleIndex + 1) % CIRCLE_SIZE);
+    } else if((s->mode == 4) && (s->currentTime % s->circleRate) == 0) {
+        s->circleIndex = (s->circleIndex > 0) ? s->circleIndex - 1 : CIRCLE_SIZE - 1;
+        MoveCircleTarget(s, (s->circleIndex + CIRCLE_SIZE - 1) % CIRCLE_SIZE);
+    }
+
+    if(Level_TakeCenter()) {
+        Reference_Target(CenterX, CenterY);
+    }
+
+    uint32_t x, y;
+    int32_t velocityX, velocityY;
+    if(Loss_TakeRestart(&x, &y, &velocityX, &velocityY)) {
+        Reference_Restart(x, y, velocityX, velocityY);
+    }
+
+    Reference_Update();
+}
+
+// One pass of the while(1) loop in main()
+static void MainLoop(Scheduler *s, Plant *plant) {
+    if(s->needTouchUpdate) {
+        uint32_t tx, ty;
+        if(Plant_ReadTouch(plant, &tx, &ty)) {
+            SeqLock_WritePair(&Ball, tx, ty);
+            Loss_Sample(tx, ty, s->currentTime);
+            Boot_TouchSample(true, tx, ty);
+            s->needTouchUpdate = false;
+            s->touchPresent = true;
+        } else {
+            s->touchPresent = false;
+            Loss_Missed(s->currentTime);
+            Boot_TouchSample(false, 0, 0);
+        }
+    }
+
+    if(s->needPIDUpdate && (s->touchPresent || Loss_Controlling())) {
+        s->needPIDUpdate = false;
+        if(Loss_ControlUpdate(s->currentTime)) {
+            if(s->controller == SCENARIO_LQR) {
+                UpdateLQRController();
+            } else if(s->controller == SCENARIO_AUTOTUNE) {
+                UpdateAutoTuneController();
+            } else if(s->controller == SCENARIO_LEVEL) {
+                UpdateLevelController();
+            } else if(s->controller == SCENARIO_PID_FIXED) {
+                UpdatePIDControllerFixed();
+            } else if(s->controller == SCENARIO_PID_FLOAT) {
+                UpdatePIDControllerFloat();
+            } else {
+                UpdatePIDController();
+            }
+        }
+    }
+
+    if(s->needMotorUpdate && (s->touchPresent || Loss_Controlling())) {
+        s->needMotorUpdate = false;
+        Plant_SetServo(plant, currentXDegrees, currentYDegrees);
+    }
+}
+
+void Harness_Run(const Scenario *scenario, const PlantParams *params, Metrics *metrics, TraceFunction trace) {
+    Plant plant;
+    Scheduler s = {0};
+    s.needTouchUpdate = true;
+    s.circleRate = CIRCLE_DEFAULT_RATE;
+    s.controller = scenario->controller;
+
+    Boot_Init();
+    Controller_Init();
+    Reference_Init(CenterX, CenterY);
+    LQR_Init();
+    Loss_Init();
+    Boot_ConfigLoaded();
+    SeqLock_WritePair(&Ball, CenterX, CenterY);
+    Plant_Init(&plant, params);
+    Plant_PlaceBall(&plant, scenario->startX / PLANT_COUNTS_PER_METER, scenario->startY / PLANT_COUNTS_PER_METER,
+                    scenario->startVX / PLANT_COUNTS_PER_METER, scenario->startVY / PLANT_COUNTS_PER_METER);
+    if(scenario->dropTime > 0) {
+        Plant_RemoveBall(&plant);
+    }
+
+    unsigned long event = scenario->eventTime > scenario->dropTime ? scenario->eventTime : scenario->dropTime;
+    if(scenario->lossTime > 0 && scenario->lossTime + scenario->lossMs > event) event = scenario->lossTime + scenario->lossMs;
+    double errorSquares = 0;
+    unsigned long samples = 0;
+    unsigned long lastOutside = event;
+    double initialX = 0, initialY = 0, initialMag = 0;
+    double overshoot = 0;
+    double maxError = 0;
+    unsigned long steadyStart = (scenario->kind == SCENARIO_TRACK) ?
+            event + (unsigned long)CIRCLE_SIZE * scenario->circleRate :
+            event + (scenario->duration - event) * 3 / 4;
+
+    unsigned long t;
+    for(t = 0; t < scenario->duration; t++) {
+        if(scenario->eventTime > 0 && t == scenario->eventTime) {
+            EnterMode(&s, scenario->mode, scenario->circleRate);
+        }
+        if(scenario->dropTime > 0 && t == scenario->dropTime) {
+            Plant_PlaceBall(&plant, scenario->startX / PLANT_COUNTS_PER_METER, scenario->startY / PLANT_COUNTS_PER_METER,
+                            scenario->startVX / PLANT_COUNTS_PER_METER, scenario->startVY / PLANT_COUNTS_PER_METER);
+        }
+
+        if(scenario->lossTime > 0 && t == scenario->lossTime) {
+            if(scenario->lift) {
+                Plant_RemoveBall(&plant);
+            } else {
+                Plant_Bounce(&plant, scenario->lossMs);
+            }
+        }
+        if(scenario->lift && t == scenario->lossTime + scenario->lossMs) {
+            Plant_PlaceBall(&plant, scenario->startX / PLANT_COUNTS_PER_METER, scenario->startY / PLANT_COUNTS_PER_METER,
+                            scenario->startVX / PLANT_COUNTS_PER_METER, scenario->startVY / PLANT_COUNTS_PER_METER);
+        }
+        if(scenario->biasTime > 0 && t == scenario->biasTime) {
+            plant.p.biasTiltX += scenario->biasTiltX;
+            plant.p.biasTiltY += scenario->biasTiltY;
+        }
+
+        Tick(&s);
+        MainLoop(&s, &plant);
+
+        // Same as OnServoFrame()
+        if(Plant_FrameStart(&plant)) {
+            s.frameOffset = (s.currentTime + SERVO_FRAME_PERIOD - SERVO_UPDATE_LEAD) % SERVO_FRAME_PERIOD;
+            Boot_ServoFrame();
+        }
+        Plant_Step(&plant);
+
+        uint32_t setX, setY;
+        SeqLock_ReadPair(&Setpoint, &setX, &setY);
+        if(trace) trace(t, &plant, setX, setY);
+
+        if(t < event) continue;
+
+        // Metrics use the true (noise free) ball position and the target, not the profiled setpoint
+        Reference_GetTarget(&setX, &setY);
+        double errX = (double)setX - (params->touchCenterX + Plant_ToCounts(plant.posX));
+        double errY = (double)setY - (params->touchCenterY + Plant_ToCounts(plant.posY));
+        double mag = sqrt(errX * errX + errY * errY);
+
+        if(t == event) {
+            initialX = errX;
+            initialY = errY;
+            initialMag = mag;
+        }
+
+        errorSquares += mag * mag;
+        samples++;
+
+        if(mag > HARNESS_SETTLE_BAND) {
+            lastOutside = t;
+        }
+
+        // Error along the initial error direction, negative once the ball has passed the target
+        if(initialMag > HARNESS_SETTLE_BAND) {
+            double along = (errX * initialX + errY * initialY) / initialMag;
+            if(-along > overshoot) overshoot = -along;
+        }
+
+        // Tracking error is judged after the first lap, step error over the last quarter of the run
+        if(t >= steadyStart && mag > maxError) {
+            maxError = mag;
+        }
+    }
+
+    metrics->settleMs = (double)(lastOutside - event);
+    metrics->overshootPct = (initialMag > HARNESS_SETTLE_BAND) ? 100.0 * overshoot / initialMag : 0;
+    metrics->rmsError = samples ? sqrt(errorSquares / samples) : 0;
+    metrics->maxError = maxError;
+}
@@ -0,0 +1,79 @@
+/*
+ * harness.h
+ *
+ * Runs the firmware control path against the simulated plant using the
+ *  same 1 ms task scheduling as SysTick_Handler() and main() in main.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef HARNESS_H_
+#define HARNESS_H_
+
+#include "plant.h"
+
+// Ball must stay within this many counts of the target to be settled
+#define HARNESS_SETTLE_BAND 50
+
+typedef enum {
+    SCENARIO_STEP,      // Settle on a fixed target after <eventTime>
+    SCENARIO_TRACK      // Follow a moving target (circle modes)
+} ScenarioKind;
+
+typedef struct {
+    const char *name;
+    ScenarioKind kind;
+
+    // Button mode (0-5, see OnButtonPushed) entered at <eventTime>
+    uint8_t mode;
+    uint16_t circleRate;
+    unsigned long eventTime;
+
+    // Ball start position relative to the plate center (counts) and speed (counts/s)
+    double startX, startY;
+    double startVX, startVY;
+
+    // Ball is off the plate until <dropTime> (0 = on the plate from the start)
+    unsigned long dropTime;
+
+    unsigned long duration;
+
+    // Controller run at the PID update (SCENARIO_PID = UpdatePIDController, SCENARIO_LQR = UpdateLQRController,
+    //  SCENARIO_AUTOTUNE = UpdateAutoTuneController, start the experiment with AutoTune_Start() first,
+    //  SCENARIO_PID_FIXED / SCENARIO_PID_FLOAT = one arithmetic of the PID whatever CONTROLLER_FLOAT selects,
+    //  SCENARIO_LEVEL = UpdateLevelController, start the levelling with Level_Start() first)
+    uint8_t controller;
+
+    // Ball loss at <lossTime> for <lossMs> (0 = none): a bounce (no touch sample, the ball flies on) or,
+    //  with <lift>, the ball is lifted off and put back at the start position and speed. The metrics
+    //  start when the ball is back
+    unsigned long lossTime;
+    unsigned long lossMs;
+    _Bool lift;
+
+    // Plate tilt (degrees) added at <biasTime> (0 = none), like a mount shifting or a cable starting to drag
+    unsigned long biasTime;
+    double biasTiltX, biasTiltY;
+} Scenario;
+
+#define SCENARIO_PID 0
+#define SCENARIO_LQR 1
+#define SCENARIO_AUTOTUNE 2
+#define SCENARIO_PID_FIXED 3
+#define SCENARIO_PID_FLOAT 4
+#define SCENARIO_LEVEL 5
+
+// Errors are taken from the mode target, not the profiled setpoint (reference.c)
+typedef struct {
+    double settleMs;        // Time after the event until the ball stays in the settle band
+    double overshootPct;    // Largest overshoot past the target, % of the initial error
+    double rmsError;        // RMS position error after the event (counts)
+    double maxError;        // Largest position error after the first lap / in the last quarter (counts)
+} Metrics;
+
+typedef void (*TraceFunction)(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY);
+
+void Harness_Run(const Scenario *scenario, const PlantParams *params, Metrics *metrics, TraceFunction trace);
+
+#endif /* HARNESS_H_ */
@@ -0,0 +1,365 @@
+/*
+ * idle.c
+ *
+ * Low power idle check (runs on a PC)
+ *
+ *  Runs the main loop of main.c cycle by cycle with a simulated interrupt source
+ *  (SysTick every ms, UART receive at random times and button presses), with task
+ *  costs of the real firmware, once spinning and once with the sleep of ../idle.c.
+ *  Checks that Idle_TaskReady() agrees with the tasks the loop runs, that sleeping
+ *  runs the same tasks without delaying them, and that the reported idle percentage
+ *  matches the simulated sleep time. The ball is off the plate for a while to show
+ *  the idle time without the control tasks. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/idle sim/idle.c idle.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../idle.h"
+
+#define SIM_MS 12000
+
+// Ball is off the plate in this window (ms)
+#define BALL_OFF_START 4000
+#define BALL_OFF_END 8000
+
+// Mean time between UART receive interrupts and button presses (ms)
+#define UART_INTERVAL 30
+#define BUTTON_INTERVAL 2500
+
+// Costs (core clock cycles) of the interrupt handlers, the tasks and the loop itself
+#define COST_ISR 60
+#define COST_TOUCH_READ 9000            // Four oversampled ADC conversions
+#define COST_TOUCH_FAIL 2500            // Touch_Present() only
+#define COST_CIRCLE 40                  // Circle setpoint in SysTick
+#define COST_PID 1500
+#define COST_MOTOR 600
+#define COST_UART 1200
+#define COST_IDLE 30                    // Idle() without the sleep
+#define COST_WAKE 12                    // Sleep exit before the handler runs
+
+// Extra task start latency allowed from sleeping (cycles)
+#define LATENCY_SLACK 100
+
+// Allowed difference between the reported and the simulated idle time (%)
+#define IDLE_TOLERANCE 1.0
+
+#define CIRCLE_RATE 5
+
+enum { TASK_TOUCH, TASK_PID, TASK_MOTOR, TASK_UART, TASK_COUNT };
+static const char *taskNames[TASK_COUNT] = {"touch", "pid", "motor", "uart"};
+
+typedef struct {
+    uint64_t now;
+    _Bool masked;
+
+    // Interrupt sources, next event time and pending while masked
+    uint64_t nextTick, nextUART, nextButton;
+    uint64_t tickTime;
+    _Bool pendingTick, pendingUART, pendingButton;
+    uint32_t seed;
+
+    // Firmware state, mirrors the volatile flags in main.c
+    unsigned long currentTime;
+    _Bool needTouchUpdate, needPIDUpdate, needMotorUpdate, needUARTUpdate;
+    _Bool touchRetry;
+    _Bool touchPresent;
+    uint8_t mode;
+
+    // Measurements
+    uint64_t flagTime[TASK_COUNT];
+    _Bool flagTimed[TASK_COUNT];
+    uint64_t latencyMax[TASK_COUNT];
+    double latencySum[TASK_COUNT];
+    unsigned long runs[TASK_COUNT];
+    uint64_t slept, windowSlept;
+    double reportError;
+    double reportedOn, reportedOff, sleptOn, sleptOff;
+    int reportsOn, reportsOff;
+    unsigned long inconsistent;
+} Sim;
+
+static uint32_t Random(Sim *s) {
+    s->seed = s->seed * 1103515245u + 12345u;
+    return s->seed >> 8;
+}
+
+// Exponentially distributed interval with a mean of <meanMs>
+static uint64_t Interval(Sim *s, double meanMs) {
+    double u = (Random(s) % 100000 + 1) / 100001.0;
+    return (uint64_t)(-log(u) * meanMs * IDLE_TICK_CYCLES) + 1;
+}
+
+static _Bool BallOnPlate(const Sim *s) {
+    return s->currentTime < BALL_OFF_START || s->currentTime >= BALL_OFF_END;
+}
+
+// SysTick counter, counts down from IDLE_TICK_CYCLES - 1 and the interrupt fires at the reload
+static uint32_t SysTickValue(const Sim *s) {
+    return IDLE_TICK_CYCLES - 1 - (uint32_t)(s->now % IDLE_TICK_CYCLES);
+}
+
+// Task latency counts from the SysTick event, control tasks wait for the ball and are only measured while it is on the plate
+static void SetFlag(Sim *s, _Bool *flag, int task) {
+    if(!s->flagTimed[task] && (task == TASK_TOUCH || s->touchPresent)) {
+        s->flagTime[task] = s->tickTime;
+        s->flagTimed[task] = true;
+    }
+    *flag = true;
+}
+
+// Same as SysTick_Handler() (without the servo frame alignment)
+static void SysTickHandler(Sim *s) {
+    s->currentTime++;
+    s->touchRetry = false;
+    Idle_Tick();
+
+    // Idle_Tick() closed a report window, compare it with the simulated sleep of the window
+    if((s->currentTime % IDLE_REPORT_PERIOD) == 0) {
+        double slept = 100.0 * s->windowSlept / ((double)IDLE_REPORT_PERIOD * IDLE_TICK_CYCLES);
+        double error = fabs(IdlePercent - slept);
+        if(error > s->reportError) s->reportError = error;
+        if(s->currentTime <= BALL_OFF_START || s->currentTime > BALL_OFF_END + IDLE_REPORT_PERIOD) {
+            s->reportedOn += IdlePercent;
+            s->sleptOn += slept;
+            s->reportsOn++;
+        } else if(s->currentTime > BALL_OFF_START + IDLE_REPORT_PERIOD && s->currentTime <= BALL_OFF_END) {
+            s->reportedOff += IdlePercent;
+            s->sleptOff += slept;
+            s->reportsOff++;
+        }
+        s->windowSlept = 0;
+    }
+
+    if((s->currentTime % TOUCH_UPDATE_RATE) == 0) SetFlag(s, &s->needTouchUpdate, TASK_TOUCH);
+    if((s->currentTime > PID_UPDATE_DELAY) && ((s->currentTime % PID_UPDATE_RATE) == 0)) SetFlag(s, &s->needPIDUpdate, TASK_PID);
+    if((s->currentTime > UART_UPDATE_DELAY) && ((s->currentTime % UART_UPDATE_RATE) == 0)) SetFlag(s, &s->needUARTUpdate, TASK_UART);
+    if((s->currentTime > MOTOR_UPDATE_DELAY) && ((s->currentTime % MOTOR_UPDATE_RATE) == 0)) SetFlag(s, &s->needMotorUpdate, TASK_MOTOR);
+    if((s->mode == 3) && (s->currentTime % CIRCLE_RATE) == 0) s->now += COST_CIRCLE;
+}
+
+// Button presses switch between center (0) and circle (3)
+static void ButtonHandler(Sim *s) {
+    s->mode = (s->mode == 0) ? 3 : 0;
+}
+
+static void RunHandler(Sim *s, int source) {
+    if(source == 0) SysTickHandler(s);
+    else if(source == 2) ButtonHandler(s);
+    s->now += COST_ISR;
+}
+
+static void RunPending(Sim *s) {
+    if(s->pendingTick) { s->pendingTick = false; RunHandler(s, 0); }
+    if(s->pendingUART) { s->pendingUART = false; RunHandler(s, 1); }
+    if(s->pendingButton) { s->pendingButton = false; RunHandler(s, 2); }
+}
+
+// Earliest interrupt event, returns its source
+static int NextEvent(const Sim *s, uint64_t *time) {
+    int source = 0;
+    *time = s->nextTick;
+    if(s->nextUART < *time) { *time = s->nextUART; source = 1; }
+    if(s->nextButton < *time) { *time = s->nextButton; source = 2; }
+    return source;
+}
+
+// Takes the next event off its source, runs it or leaves it pending while interrupts are disabled
+static void Fire(Sim *s, int source) {
+    if(source == 0) {
+        s->tickTime = s->nextTick;
+        s->nextTick += IDLE_TICK_CYCLES;
+    }
+    if(source == 1) s->nextUART += Interval(s, UART_INTERVAL);
+    if(source == 2) s->nextButton += Interval(s, BUTTON_INTERVAL);
+
+    if(s->masked) {
+        if(source == 0) s->pendingTick = true;
+        if(source == 1) s->pendingUART = true;
+        if(source == 2) s->pendingButton = true;
+    } else {
+        RunHandler(s, source);
+    }
+}
+
+// Runs <cycles> of main loop code, interrupts preempt it unless masked
+static void Execute(Sim *s, uint64_t cycles) {
+    uint64_t time;
+    for(;;) {
+        int source = NextEvent(s, &time);
+        if(time >= s->now + cycles) break;
+        if(time > s->now) {
+            cycles -= time - s->now;
+            s->now = time;
+        }
+        Fire(s, source);
+    }
+    s->now += cycles;
+}
+
+static void StartTask(Sim *s, int task) {
+    if(s->flagTimed[task]) {
+        uint64_t latency = s->now - s->flagTime[task];
+        if(latency > s->latencyMax[task]) s->latencyMax[task] = latency;
+        s->latencySum[task] += latency;
+        s->flagTimed[task] = false;
+    }
+    s->runs[task]++;
+}
+
+static IdleTasks Snapshot(const Sim *s) {
+    IdleTasks tasks = {s->needTouchUpdate, s->touchRetry, s->needPIDUpdate, s->needMotorUpdate, s->needUARTUpdate,
+                       s->touchPresent, false, false};
+    return tasks;
+}
+
+// One pass of the while(1) loop in main(), returns true if a task ran
+static _Bool MainLoop(Sim *s) {
+    _Bool ran = false;
+    int i;
+
+    if(s->needTouchUpdate && !s->touchRetry) {
+        ran = true;
+        if(BallOnPlate(s)) {
+            StartTask(s, TASK_TOUCH);
+            Execute(s, COST_TOUCH_READ);
+            s->needTouchUpdate = false;
+            s->touchPresent = true;
+        } else {
+            // Retries start at the next tick, the latency is only measured from a touch update tick
+            for(i = 0; i < TASK_COUNT; i++) s->flagTimed[i] = false;
+            Execute(s, COST_TOUCH_FAIL);
+            s->touchPresent = false;
+            s->touchRetry = true;
+        }
+    }
+
+    if(s->needPIDUpdate && s->touchPresent) {
+        ran = true;
+        s->needPIDUpdate = false;
+        StartTask(s, TASK_PID);
+        Execute(s, COST_PID);
+    }
+
+    if(s->needMotorUpdate && s->touchPresent) {
+        ran = true;
+        s->needMotorUpdate = false;
+        StartTask(s, TASK_MOTOR);
+        Execute(s, COST_MOTOR);
+    }
+
+    if(s->needUARTUpdate && s->touchPresent) {
+        ran = true;
+        s->needUARTUpdate = false;
+        StartTask(s, TASK_UART);
+        Execute(s, COST_UART);
+    }
+
+    return ran;
+}
+
+// Same as Idle() in main.c, WFI returns at the next interrupt, at once if one is pending
+static void SimIdle(Sim *s) {
+    s->masked = true;
+    Execute(s, COST_IDLE);
+
+    IdleTasks tasks = Snapshot(s);
+    if(Idle_CanSleep(&tasks)) {
+        uint32_t start = SysTickValue(s);
+        if(!s->pendingTick && !s->pendingUART && !s->pendingButton) {
+            uint64_t time;
+            int source = NextEvent(s, &time);
+            s->slept += time - s->now;
+            s->windowSlept += time - s->now;
+            s->now = time;
+            Fire(s, source);
+            s->now += COST_WAKE;
+        }
+        uint32_t end = SysTickValue(s);
+        Idle_Slept((start + IDLE_TICK_CYCLES - end) % IDLE_TICK_CYCLES);
+    }
+
+    s->masked = false;
+    RunPending(s);
+}
+
+static void Run(Sim *s, uint8_t policy) {
+    Sim clean = {0};
+    *s = clean;
+    s->seed = 12345;
+    s->needTouchUpdate = true;
+    s->nextTick = IDLE_TICK_CYCLES;
+    s->nextUART = Interval(s, UART_INTERVAL);
+    s->nextButton = Interval(s, BUTTON_INTERVAL);
+
+    IdlePolicy = policy;
+    Idle_Init();
+
+    while(s->currentTime < SIM_MS) {
+        IdleTasks tasks = Snapshot(s);
+        _Bool ready = Idle_TaskReady(&tasks);
+        _Bool ran = MainLoop(s);
+        if(ready != ran) s->inconsistent++;
+        SimIdle(s);
+    }
+}
+
+int main(void) {
+    static Sim spin, sleep;
+    int failures = 0;
+    int i;
+
+    Run(&spin, IDLE_SPIN);
+    Run(&sleep, IDLE_SLEEP);
+
+    printf("Main loop idle, %d ms with the ball off the plate from %d to %d ms\n", SIM_MS, BALL_OFF_START, BALL_OFF_END);
+    printf("  asleep %.1f%% of the time, ball on the plate %.1f%% (reported %.1f%%), ball off %.1f%% (reported %.1f%%)\n",
+           100.0 * sleep.slept / sleep.now, sleep.sleptOn / sleep.reportsOn, sleep.reportedOn / sleep.reportsOn,
+           sleep.sleptOff / sleep.reportsOff, sleep.reportedOff / sleep.reportsOff);
+    printf("  task     runs (spin/sleep)   mean latency (spin/sleep)   max latency (spin/sleep, cycles)\n");
+    for(i = 0; i < TASK_COUNT; i++) {
+        printf("  %-7s  %6lu / %-6lu      %8.1f / %-8.1f          %6llu / %-6llu\n", taskNames[i], spin.runs[i], sleep.runs[i],
+               spin.runs[i] ? spin.latencySum[i] / spin.runs[i] : 0, sleep.runs[i] ? sleep.latencySum[i] / sleep.runs[i] : 0,
+               (unsigned long long)spin.latencyMax[i], (unsigned long long)sleep.latencyMax[i]);
+    }
+
+    _Bool consistent = (spin.inconsistent == 0) && (sleep.inconsistent == 0);
+    printf("  %-4s Idle_TaskReady() matches the tasks the loop runs (%lu/%lu mismatches)\n", consistent ? "ok" : "FAIL",
+           spin.inconsistent, sleep.inconsistent);
+    if(!consistent) failures++;
+
+    _Bool sameWork = true, noDelay = true;
+    for(i = 0; i < TASK_COUNT; i++) {
+        if(spin.runs[i] != sleep.runs[i]) sameWork = false;
+        if(sleep.latencyMax[i] > spin.latencyMax[i] + LATENCY_SLACK) noDelay = false;
+    }
+    printf("  %-4s sleeping runs the same tasks\n", sameWork ? "ok" : "FAIL");
+    printf("  %-4s sleeping adds at most %d cycles to the task start latency\n", noDelay ? "ok" : "FAIL", LATENCY_SLACK);
+    if(!sameWork) failures++;
+    if(!noDelay) failures++;
+
+    _Bool reported = sleep.reportError <= IDLE_TOLERANCE;
+    printf("  %-4s reported idle percentage within %.0f%% of the simulated sleep (worst %.2f%%)\n", reported ? "ok" : "FAIL",
+           IDLE_TOLERANCE, sleep.reportError);
+    if(!reported) failures++;
+
+    _Bool spinAwake = (spin.slept == 0);
+    printf("  %-4s IDLE_SPIN never sleeps\n", spinAwake ? "ok" : "FAIL");
+    if(!spinAwake) failures++;
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,314 @@
+/*
+ * latency.c
+ *
+ * Latency tracer check (runs on a PC)
+ *
+ *  Fills the histogram of ../latency.c with random ages (spread, clustered, above
+ *  the last bin) and compares its percentiles with the sorted ages, then checks
+ *  an empty, a single age and a full histogram. Then runs the stages on the main
+ *  loop schedule in microseconds (touch every 10 ms, PID and motor every 40 ms
+ *  SERVO_UPDATE_LEAD ms before a frame start, failed reads retried after the next
+ *  SysTick, a ball loss the controller coasts through) and checks each stage
+ *  against the ages of the samples it really carried and the report lines.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/latency sim/latency.c latency.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../latency.h"
+
+// Same as controller.h and servo.h
+#define TOUCH_UPDATE_RATE 10
+#define PID_UPDATE_RATE 40
+#define SERVO_FRAME_PERIOD 20
+#define SERVO_UPDATE_LEAD 2
+
+#define MAX_AGES 20000
+
+static const uint8_t percents[] = {50, 90, 99, 100};
+
+static int Compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Age of the sorted <ages> that <percent> of them are at or below
+static uint32_t Reference(uint32_t *ages, int count, uint8_t percent) {
+    int rank = (count * percent + 99) / 100;
+    if(rank < 1) rank = 1;
+    qsort(ages, count, sizeof(ages[0]), Compare);
+    return ages[rank - 1];
+}
+
+/* Percentiles of <h> against the <ages> it was filled with: at or above the age and at most a bin above it,
+ *  the longest age when it is above the bins
+ */
+static int CheckAgainst(const char *name, const LatencyHistogram *h, uint32_t *ages, int count) {
+    int failures = 0;
+    unsigned int i;
+
+    printf("  %-22s %5d ages  ", name, count);
+    for(i = 0; i < sizeof(percents); i++) {
+        uint32_t expected = Reference(ages, count, percents[i]);
+        uint32_t got = Latency_Percentile(h, percents[i]);
+        _Bool ok = (expected < LATENCY_BINS * LATENCY_BIN_US) ? (got >= expected) && (got - expected <= LATENCY_BIN_US)
+                                                              : (got == h->max);
+        printf(" p%-3d %6u/%6u%s", percents[i], got, expected, ok ? "" : "!");
+        if(!ok) failures++;
+    }
+    _Bool ok = !failures && h->count == count;
+    printf("   %s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+typedef enum { SPREAD, CLUSTERED, LONG } Kind;
+
+static int CheckRandom(const char *name, Kind kind) {
+    static uint32_t ages[MAX_AGES];
+    LatencyHistogram h;
+    int i;
+
+    Latency_Clear(&h);
+    srand(11 + kind);
+    for(i = 0; i < MAX_AGES; i++) {
+        if(kind == SPREAD) {
+            ages[i] = rand() % (LATENCY_BINS * LATENCY_BIN_US);
+        } else if(kind == CLUSTERED) {
+            // Most around 2 ms, a tail of frames 20 ms late
+            ages[i] = (rand() % 10) ? 1800 + rand() % 400 : 21800 + rand() % 400;
+        } else {
+            // A fifth above the bins
+            ages[i] = (rand() % 5) ? rand() % 10000 : LATENCY_BINS * LATENCY_BIN_US + rand() % 100000;
+        }
+        Latency_Add(&h, ages[i]);
+    }
+    return CheckAgainst(name, &h, ages, MAX_AGES);
+}
+
+static int CheckEdges(void) {
+    LatencyHistogram h;
+    int failures = 0;
+    uint32_t i;
+
+    // Empty
+    Latency_Clear(&h);
+    _Bool ok = Latency_Percentile(&h, 50) == 0 && Latency_Percentile(&h, 100) == 0;
+    printf("  %-4s empty                  p50 %u p100 %u\n", ok ? "ok" : "FAIL", Latency_Percentile(&h, 50), Latency_Percentile(&h, 100));
+    if(!ok) failures++;
+
+    // A single age is every percentile, a bin edge is in the bin above
+    Latency_Add(&h, LATENCY_BIN_US);
+    ok = Latency_Percentile(&h, 1) == LATENCY_BIN_US && Latency_Percentile(&h, 100) == LATENCY_BIN_US && h.bins[1] == 1;
+    printf("  %-4s single age %4u us     p1 %u p100 %u\n", ok ? "ok" : "FAIL", LATENCY_BIN_US, Latency_Percentile(&h, 1),
+           Latency_Percentile(&h, 100));
+    if(!ok) failures++;
+
+    // Stops adding once full, the percentiles stay those of the ages it holds
+    Latency_Clear(&h);
+    for(i = 0; i < 70000; i++) {
+        Latency_Add(&h, (i < UINT16_MAX) ? 1000 : 30000);
+    }
+    ok = h.count == UINT16_MAX && Latency_Percentile(&h, 100) == 1000 && h.max == 1000;
+    printf("  %-4s full                   count %u p100 %u max %u\n", ok ? "ok" : "FAIL", h.count, Latency_Percentile(&h, 100), h.max);
+    if(!ok) failures++;
+
+    Latency_Clear(&h);
+    ok = h.count == 0 && h.max == 0 && h.overflow == 0 && Latency_Percentile(&h, 50) == 0;
+    printf("  %-4s cleared\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+    return failures;
+}
+
+// Ages (us) each stage carried on the schedule, by the samples this check knows it used
+static uint32_t expected[LATENCY_STAGE_COUNT][MAX_AGES];
+static int expectedCount[LATENCY_STAGE_COUNT];
+
+static void Expect(uint8_t stage, uint32_t age) {
+    if(expectedCount[stage] < MAX_AGES) expected[stage][expectedCount[stage]++] = age;
+}
+
+static char lines[LATENCY_STAGE_COUNT][LATENCY_REPORT_SIZE];
+static int lineCount;
+static int badLines;
+
+// Report check every pass like the main loop, keeps the lines of the last report
+static void Report(unsigned long ms) {
+    char line[LATENCY_REPORT_SIZE];
+    uint8_t length = Latency_Report(line, ms);
+    if(!length) return;
+
+    unsigned int stage, count, p50, p90, p99, max;
+    line[length] = 0;
+    if(sscanf(line, "L,%u,%u,%u,%u,%u,%u\r\n", &stage, &count, &p50, &p90, &p99, &max) != 6 ||
+       stage != (unsigned int)(lineCount % LATENCY_STAGE_COUNT) || length < 2 || strcmp(line + length - 2, "\r\n") != 0) {
+        badLines++;
+        return;
+    }
+    strcpy(lines[stage], line);
+    lineCount++;
+}
+
+/* Runs the stages for <duration> ms on the main loop schedule, one touch read in <missEvery> fails (0 = none)
+ *  and the ball is off the plate for <lossMs> ms at 3 s, the controller coasts on the last sample
+ */
+static void RunSchedule(unsigned long duration, int missEvery, unsigned long lossMs, LatencyHistogram *windows) {
+    uint32_t sampleTag = 0, commandTag = 0, writeTag = 0;
+    _Bool haveSample = false, haveCommand = false, writePending = false;
+    _Bool needTouch = true, touchRetry = false;
+    int reads = 0;
+    unsigned long ms;
+    uint8_t stage;
+
+    LatencyEnabled = true;
+    Latency_Init(0);
+    memset(expectedCount, 0, sizeof(expectedCount));
+    lineCount = 0;
+    badLines = 0;
+    srand(5);
+
+    for(ms = 1; ms <= duration; ms++) {
+        uint32_t now = ms * 1000;
+        // Frame starts SERVO_UPDATE_LEAD ms after the PID ticks, updates are aligned to them
+        _Bool pidTick = (ms % PID_UPDATE_RATE) == 0;
+        touchRetry = false;
+        if((ms % TOUCH_UPDATE_RATE) == 0) needTouch = true;
+
+        // The frame interrupt, mid tick (before the main loop pass, its SysTick at the tick start)
+        if((ms % SERVO_FRAME_PERIOD) == SERVO_UPDATE_LEAD) {
+            Latency_Latch(now + 500);
+            if(writePending) {
+                Expect(LATENCY_STAGE_LATCH, now + 500 - writeTag);
+                writePending = false;
+            }
+        }
+
+        // Main loop pass: touch read of 300 - 900 us, control 150 us, motor 50 us
+        _Bool lost = (ms >= 3000) && (ms < 3000 + lossMs);
+        if(needTouch && !touchRetry) {
+            Latency_Capture(now + 10);
+            uint32_t read = 300 + rand() % 600;
+            reads++;
+            if(!lost && !(missEvery && (reads % missEvery) == 0)) {
+                Latency_Sample(now + 10 + read);
+                Expect(LATENCY_STAGE_SAMPLE, read);
+                sampleTag = now + 10;
+                haveSample = true;
+                needTouch = false;
+            } else {
+                touchRetry = true;
+            }
+        }
+        uint32_t t = now + 1000 - 100;
+        if(pidTick) {
+            Latency_Control(t - 200);
+            if(haveSample) {
+                Expect(LATENCY_STAGE_CONTROL, t - 200 - sampleTag);
+                commandTag = sampleTag;
+                haveCommand = true;
+            }
+            Latency_Write(t - 50);
+            if(haveCommand) {
+                Expect(LATENCY_STAGE_WRITE, t - 50 - commandTag);
+                writeTag = commandTag;
+                writePending = true;
+            }
+        }
+        Report(ms);
+
+        // Windows of the last report before they are cleared
+        if(windows && ms == duration) {
+            for(stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+                windows[stage] = LatencyWindow[stage];
+            }
+        }
+    }
+    LatencyEnabled = LATENCY_DEFAULT_ENABLE;
+}
+
+// All stages against the ages they carried (one window, the run ends before the first report)
+static int CheckSchedule(const char *name, int missEvery, unsigned long lossMs) {
+    LatencyHistogram windows[LATENCY_STAGE_COUNT];
+    char label[40];
+    int failures = 0;
+    uint8_t stage;
+
+    RunSchedule(LATENCY_REPORT_RATE - 1, missEvery, lossMs, windows);
+    for(stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        static const char *stages[] = {"sample", "control", "write", "latch"};
+        snprintf(label, sizeof(label), "%s %s", name, stages[stage]);
+        failures += CheckAgainst(label, &windows[stage], expected[stage], expectedCount[stage]);
+    }
+    return failures;
+}
+
+// The latch is SERVO_UPDATE_LEAD ms after the control tick, a dropout shows in the tail
+static int CheckLoss(void) {
+    RunSchedule(LATENCY_REPORT_RATE * 4 + 10, 0, 500, NULL);
+
+    unsigned int stage, count, p50, p90, p99, max;
+    _Bool ok = !badLines && lineCount == 4 * LATENCY_STAGE_COUNT;
+    if(ok && sscanf(lines[LATENCY_STAGE_LATCH], "L,%u,%u,%u,%u,%u,%u", &stage, &count, &p50, &p90, &p99, &max) == 6) {
+        // Fourth second: 25 latches, the loss of 500 ms at 3 s leaves about half of them on the sample before it
+        ok = count == 1000 / PID_UPDATE_RATE && p50 <= (SERVO_UPDATE_LEAD + 1) * 1000 && max >= 400 * 1000;
+    } else {
+        ok = false;
+    }
+    printf("  %-4s %-22s %d lines  %s", ok ? "ok" : "FAIL", "report, 500 ms loss", lineCount, ok ? lines[LATENCY_STAGE_LATCH] : "\n");
+    return ok ? 0 : 1;
+}
+
+// A report every LATENCY_REPORT_RATE ms, the stages on consecutive passes, each window starts over
+static int CheckReport(void) {
+    RunSchedule(LATENCY_REPORT_RATE * 3 + LATENCY_STAGE_COUNT, 0, 0, NULL);
+    unsigned int stage, count, p50, p90, p99, max;
+    _Bool ok = !badLines && lineCount == 3 * LATENCY_STAGE_COUNT &&
+               sscanf(lines[LATENCY_STAGE_SAMPLE], "L,%u,%u,%u,%u,%u,%u", &stage, &count, &p50, &p90, &p99, &max) == 6 &&
+               count == 1000 / TOUCH_UPDATE_RATE && p50 >= 300 && max <= 900;
+    printf("  %-4s %-22s %d lines, %d malformed  %s", ok ? "ok" : "FAIL", "report", lineCount, badLines,
+           ok ? lines[LATENCY_STAGE_SAMPLE] : "\n");
+    if(!ok) return 1;
+
+    // Disabled, nothing is traced or reported
+    Latency_Init(0);
+    LatencyEnabled = false;
+    Latency_Capture(0);
+    Latency_Sample(1000);
+    char line[LATENCY_REPORT_SIZE];
+    ok = LatencyWindow[LATENCY_STAGE_SAMPLE].count == 0 && Latency_Report(line, 5000) == 0;
+    printf("  %-4s %-22s\n", ok ? "ok" : "FAIL", "disabled");
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    int failures = 0;
+
+    printf("Histogram (reported / sorted ages, us)\n");
+    failures += CheckRandom("spread", SPREAD);
+    failures += CheckRandom("clustered", CLUSTERED);
+    failures += CheckRandom("above the bins", LONG);
+    failures += CheckEdges();
+
+    printf("\nStages on the main loop schedule (reported / carried ages, us)\n");
+    failures += CheckSchedule("all reads", 0, 0);
+    failures += CheckSchedule("1 in 7 missed", 7, 0);
+
+    printf("\nReport lines\n");
+    failures += CheckReport();
+    failures += CheckLoss();
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ * level.c
+ *
+ * Levelling check (runs on a PC)
+ *
+ *  Checks the acceleration fit and the level correction of ../level.c, then runs
+ *  the levelling on the simulated plant with offsets injected into the servo level
+ *  positions, the mount and the touch panel center. The center and level found must
+ *  be within a few counts and 10th of a degree of the injected ones within a few
+ *  seconds. A center hold with the PID then shows the integrator no longer has to
+ *  carry the bias.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/level sim/level.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../level.h"
+#include "../shaper.h"
+#include "harness.h"
+#include "check.h"
+
+// Largest errors of the result (10th of a degree, counts) and longest levelling (ms, from power up)
+#define SIM_LEVEL_ERROR 3
+#define SIM_CENTER_ERROR 10
+#define SIM_LEVEL_MS 10000
+
+// PID integrator sums (controller.c)
+extern int32_t ErrorXSum;
+extern int32_t ErrorYSum;
+
+static void CheckFit(void) {
+    int32_t positions[LEVEL_PROBE_SAMPLES];
+    int32_t correction = 0;
+    float maxError = 0.0f;
+    uint8_t i;
+
+    printf("Acceleration fit and correction\n");
+
+    // Exact parabolas, any start position and speed
+    int trial;
+    for(trial = 0; trial < 20; trial++) {
+        float accel = (rand() % 2001 - 1000) / 100.0f;
+        float speed = (rand() % 201 - 100) / 2.0f;
+        for(i = 0; i < LEVEL_PROBE_SAMPLES; i++) {
+            positions[i] = (int32_t)lroundf(2000.0f * (trial % 2) + 500.0f + speed * i + 0.5f * accel * i * i);
+        }
+        float error = fabsf(Level_Accel(positions, LEVEL_PROBE_SAMPLES) - accel);
+        if(error > maxError) maxError = error;
+    }
+    printf("       largest fit error %.3f counts/period^2\n", maxError);
+    Check(maxError < 0.05f, "fits the acceleration of a parabola, whatever the start speed");
+
+    // a = slope * (command - level), level 7 above the estimate
+    Check(Level_Correction(0.12f * (LEVEL_PROBE - 7), 0.12f * (-LEVEL_PROBE - 7), &correction) && correction == 7,
+          "a pair of moves gives the level offset");
+    Check(Level_Correction(0.12f * (LEVEL_PROBE + 200), 0.12f * (-LEVEL_PROBE + 200), &correction) && correction == -LEVEL_MAX_STEP,
+          "the correction is limited to LEVEL_MAX_STEP");
+    Check(!Level_Correction(0.01f, -0.01f, &correction), "a ball that doesn't roll (or rolls the wrong way) fails");
+}
+
+typedef struct {
+    const char *name;
+    double levelX, levelY;          // Servo level offsets from SERVO_x_ZERO (10th of a degree)
+    double tiltX, tiltY;            // Mount tilt (degrees)
+    double centerX, centerY;        // Touch center offsets from CENTER_x (counts)
+    int noise;
+} Offsets;
+
+// Time the levelling ended
+static unsigned long levelEnd;
+
+// Servo commands of the last PID period and the largest change of a command from one period to the next
+static int32_t lastX, lastY;
+static int32_t largestStep;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    (void)plant;
+    (void)setX;
+    (void)setY;
+    if(levelEnd == 0 && LevelStatus != LEVEL_RUNNING) levelEnd = timeMs;
+}
+
+static void TraceSteps(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    Trace(timeMs, plant, setX, setY);
+    int32_t stepX = Abs((int32_t)currentXDegrees - lastX);
+    int32_t stepY = Abs((int32_t)currentYDegrees - lastY);
+    if(timeMs > 0 && stepX > largestStep) largestStep = stepX;
+    if(timeMs > 0 && stepY > largestStep) largestStep = stepY;
+    lastX = currentXDegrees;
+    lastY = currentYDegrees;
+}
+
+static void Defaults(void) {
+    CenterX = CENTER_X;
+    CenterY = CENTER_Y;
+    ServoZeroX = SERVO_X_ZERO;
+    ServoZeroY = SERVO_Y_ZERO;
+}
+
+// Servo command at which the ball doesn't roll
+static double TrueLevel(double servoLevel, double tilt, double linkRatio) {
+    return servoLevel - tilt * 10.0 / linkRatio;
+}
+
+static void Hold(const PlantParams *params, Metrics *m, int32_t *sumX, int32_t *sumY) {
+    static const Scenario hold = {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000};
+    Harness_Run(&hold, params, m, NULL);
+    *sumX = ErrorXSum;
+    *sumY = ErrorYSum;
+}
+
+static void CheckPlant(void) {
+    static const Offsets offsets[] = {
+        // name                 levelX levelY tiltX tiltY centerX centerY noise
+        {"none",                0,     0,     0,    0,    0,      0,      3},
+        {"servos",              25,    -18,   0,    0,    0,      0,      3},
+        {"servos_center",       -30,   22,    0,    0,    60,     -45,    3},
+        {"mount_center",        10,    0,     0.4,  -0.3, -70,    50,     3},
+        {"all_noisy",           -20,   35,    -0.2, 0.2,  40,     70,     6},
+        {"large",               55,    -50,   0,    0,    -90,    -80,    3},
+    };
+    static const Scenario level = {.name = "level", .kind = SCENARIO_STEP, .startX = 300, .startY = -200, .duration = 12000, .controller = SCENARIO_LEVEL};
+    unsigned int i;
+
+    printf("\nLevelling on the plant (offsets injected, results relative to the defaults)\n");
+    printf("       %-14s %12s %12s %12s %12s %7s %6s\n", "offsets", "level x", "level y", "center x", "center y", "rounds", "ms");
+    for(i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        const Offsets *o = &offsets[i];
+        PlantParams params;
+        Metrics m;
+
+        Plant_DefaultParams(&params);
+        params.servoLevelX += o->levelX;
+        params.servoLevelY += o->levelY;
+        params.biasTiltX = o->tiltX;
+        params.biasTiltY = o->tiltY;
+        params.touchCenterX += o->centerX;
+        params.touchCenterY += o->centerY;
+        params.noise = o->noise;
+
+        double levelX = TrueLevel(params.servoLevelX, params.biasTiltX, params.linkRatio);
+        double levelY = TrueLevel(params.servoLevelY, params.biasTiltY, params.linkRatio);
+
+        Defaults();
+        Level_Start();
+        levelEnd = 0;
+        Harness_Run(&level, &params, &m, Trace);
+
+        _Bool ok = (LevelStatus == LEVEL_DONE) && levelEnd <= SIM_LEVEL_MS &&
+                   fabs(ServoZeroX - levelX) <= SIM_LEVEL_ERROR && fabs(ServoZeroY - levelY) <= SIM_LEVEL_ERROR &&
+                   fabs(CenterX - params.touchCenterX) <= SIM_CENTER_ERROR && fabs(CenterY - params.touchCenterY) <= SIM_CENTER_ERROR;
+        printf("  %-4s %-14s %5.0f/%-6d %5.0f/%-6d %5.0f/%-6d %5.0f/%-6d %7u %6lu\n", ok ? "ok" : "FAIL", o->name,
+               levelX - SERVO_X_ZERO, (int)(ServoZeroX - SERVO_X_ZERO), levelY - SERVO_Y_ZERO, (int)(ServoZeroY - SERVO_Y_ZERO),
+               params.touchCenterX - CENTER_X, (int)(CenterX - CENTER_X), params.touchCenterY - CENTER_Y, (int)(CenterY - CENTER_Y),
+               LevelRounds, levelEnd);
+        if(!ok) failures++;
+    }
+    LevelStatus = LEVEL_IDLE;
+    Defaults();
+}
+
+// Levelling with a slew limit (shaper.c) and a large level offset, the PID has to take over at the new level
+//  from the servo position the levelling left, without a step of the zero change
+static void CheckHandover(void) {
+    static const Scenario level = {.name = "level", .kind = SCENARIO_STEP, .startX = 300, .startY = -200, .duration = 12000, .controller = SCENARIO_LEVEL};
+    const int32_t slew = 30;
+    PlantParams params;
+    Metrics m;
+
+    printf("\nLevelling with a slew limit of %d per output (offsets of large)\n", slew);
+    Plant_DefaultParams(&params);
+    params.servoLevelX += 55;
+    params.servoLevelY += -50;
+
+    ShaperSlew = slew;
+    Defaults();
+    Level_Start();
+    levelEnd = 0;
+    lastX = SERVO_X_ZERO;
+    lastY = SERVO_Y_ZERO;
+    largestStep = 0;
+    Harness_Run(&level, &params, &m, TraceSteps);
+    ShaperSlew = SHAPER_DEFAULT_SLEW;
+
+    printf("       level moved %d/%d, largest command step %d\n", (int)(ServoZeroX - SERVO_X_ZERO), (int)(ServoZeroY - SERVO_Y_ZERO),
+           largestStep);
+    Check(LevelStatus == LEVEL_DONE, "the levelling finishes");
+    Check(largestStep <= slew + 1, "the commands stay within the slew limit when the level moves");
+
+    LevelStatus = LEVEL_IDLE;
+    Defaults();
+}
+
+// PID center hold with the defaults and with the levelling result, integrator sums at the end
+static void CheckHold(void) {
+    PlantParams params;
+    Metrics before, after;
+    int32_t sumXBefore, sumYBefore, sumXAfter, sumYAfter;
+    static const Scenario level = {.name = "level", .kind = SCENARIO_STEP, .startX = 300, .startY = -200, .duration = 12000, .controller = SCENARIO_LEVEL};
+
+    printf("\nPID center hold with the offsets of servos_center (integrator range %d)\n", PID_ERROR_SUM_RANGE);
+    Plant_DefaultParams(&params);
+    params.servoLevelX += -30;
+    params.servoLevelY += 22;
+    params.touchCenterX += 60;
+    params.touchCenterY += -45;
+
+    Defaults();
+    Hold(&params, &before, &sumXBefore, &sumYBefore);
+
+    Level_Start();
+    Harness_Run(&level, &params, &after, NULL);
+    Hold(&params, &after, &sumXAfter, &sumYAfter);
+
+    printf("       %-10s %10s %10s %12s %12s\n", "", "rms", "max", "sum x", "sum y");
+    printf("       %-10s %10.1f %10.1f %12d %12d\n", "defaults", before.rmsError, before.maxError, sumXBefore, sumYBefore);
+    printf("       %-10s %10.1f %10.1f %12d %12d\n", "levelled", after.rmsError, after.maxError, sumXAfter, sumYAfter);
+    Check(Abs(sumXAfter) * 4 < Abs(sumXBefore) && Abs(sumYAfter) * 4 < Abs(sumYBefore), "the integrator no longer carries the bias");
+    Check(after.maxError < before.maxError, "the ball holds closer to the true center");
+
+    LevelStatus = LEVEL_IDLE;
+    Defaults();
+}
+
+int main(void) {
+    CheckFit();
+    CheckPlant();
+    CheckHandover();
+    CheckHold();
+
+    return Check_Result();
+}
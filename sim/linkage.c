@@ -0,0 +1,84 @@
+/*
+ * linkage.c
+ *
+ * Linkage compensation check with a measured level (runs on a PC)
+ *
+ *  Maps servo commands to pulses the way UpdateMotor() does with
+ *  LINKAGE_COMPENSATION, for the default servo zeros and for levels the levelling
+ *  could have measured away from them. The plate has to be commanded level at the
+ *  measured level (the pulse of Servo_Set_Degrees() there) and small commands
+ *  around it have to stay close to the linear mapping, on each axis on its own.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/linkage sim/linkage.c linkage.c servoScale.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../linkage.h"
+#include "../servoScale.h"
+
+// Same as controller.h
+#define SERVO_X_ZERO 867
+#define SERVO_Y_ZERO 867
+
+// Commands around the level (10th of a degree) and how far the compensated pulse may be from the linear one there
+#define NEAR_COMMAND 20
+#define NEAR_TICKS 2
+
+static int failures = 0;
+
+// UpdateMotor() with LINKAGE_COMPENSATION
+static void Motor(int32_t xDegrees, int32_t yDegrees, int32_t zeroX, int32_t zeroY, uint32_t *pulseX, uint32_t *pulseY) {
+    Linkage_Pulse(Linkage_Tilt(xDegrees - zeroX), Linkage_Tilt(yDegrees - zeroY), zeroX, zeroY, pulseX, pulseY);
+}
+
+static void CheckLevel(int32_t zeroX, int32_t zeroY) {
+    uint32_t pulseX, pulseY;
+    Motor(zeroX, zeroY, zeroX, zeroY, &pulseX, &pulseY);
+    uint32_t levelX = ServoScale_Ticks(zeroX * 10);
+    uint32_t levelY = ServoScale_Ticks(zeroY * 10);
+    _Bool level = pulseX == levelX && pulseY == levelY;
+
+    // Around the level, one axis at a time
+    int32_t worst = 0;
+    int32_t c;
+    for(c = -NEAR_COMMAND; c <= NEAR_COMMAND; c++) {
+        Motor(zeroX + c, zeroY, zeroX, zeroY, &pulseX, &pulseY);
+        int32_t ex = abs((int32_t)pulseX - (int32_t)ServoScale_Ticks((zeroX + c) * 10));
+        int32_t ey = abs((int32_t)pulseY - (int32_t)levelY);
+        Motor(zeroX, zeroY + c, zeroX, zeroY, &pulseX, &pulseY);
+        int32_t fx = abs((int32_t)pulseX - (int32_t)levelX);
+        int32_t fy = abs((int32_t)pulseY - (int32_t)ServoScale_Ticks((zeroY + c) * 10));
+        if(ex > worst) worst = ex;
+        if(ey > worst) worst = ey;
+        if(fx > worst) worst = fx;
+        if(fy > worst) worst = fy;
+    }
+
+    _Bool ok = level && worst <= NEAR_TICKS;
+    printf("  %-4s zeros %4d/%-4d  level pulses %s, largest difference to linear %d ticks\n", ok ? "ok" : "FAIL",
+           zeroX, zeroY, level ? "kept" : "LOST", worst);
+    if(!ok) failures++;
+}
+
+int main(void) {
+    printf("Compensated pulses at the measured level\n");
+    CheckLevel(SERVO_X_ZERO, SERVO_Y_ZERO);
+    CheckLevel(SERVO_X_ZERO + 40, SERVO_Y_ZERO);
+    CheckLevel(SERVO_X_ZERO, SERVO_Y_ZERO - 35);
+    CheckLevel(SERVO_X_ZERO - 90, SERVO_Y_ZERO + 120);
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * loss.c
+ *
+ * Ball loss handling demonstration (runs on a PC)
+ *
+ *  Checks the loss state machine of ../loss.c on its own (dropout, coasting, loss,
+ *  levelling and reacquisition), then injects bounces (no touch sample while the ball
+ *  flies on) and lifts (ball taken off and put back) into the simulated plant and
+ *  compares how much later the ball settles than without the loss, with and without
+ *  the loss handling. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/loss sim/loss.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../loss.h"
+#include "../reference.h"
+#include "../boot.h"
+#include "harness.h"
+#include "check.h"
+
+typedef struct {
+    Scenario scenario;
+    // The loss repeats in <runs> runs <spread> ms apart from the scenario's loss time, the metrics are the means.
+    //  A bounce hits the step transient, where it lands decides what it costs
+    uint8_t runs;
+    unsigned long spread;
+    // Required reduction by the loss handling (%) of the settling time the loss adds, of the rms error on a circle
+    //  (it doesn't settle)
+    int minGain;
+} LossScenario;
+
+static const LossScenario scenarios[] = {
+    {{.name = "bounce_30ms_step", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_PID, .lossTime = 3010, .lossMs = 30}, 70, 10, 5},
+    {{.name = "bounce_50ms_step", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_PID, .lossTime = 3010, .lossMs = 50}, 70, 10, 20},
+    {{.name = "bounce_120ms_step", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_PID, .lossTime = 3010, .lossMs = 120}, 70, 10, 10},
+    {{.name = "bounce_50ms_circle", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 12000, .controller = SCENARIO_PID, .lossTime = 5000, .lossMs = 50}, 8, 137, 0},
+    {{.name = "lift_1s_step", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .startX = -200, .startY = 150, .duration = 12000, .controller = SCENARIO_PID, .lossTime = 3250, .lossMs = 1000, .lift = true}, 1, 0, 50},
+    {{.name = "lift_2s_rolling", .kind = SCENARIO_STEP, .startX = 300, .startY = -250, .startVX = -150, .startVY = 100, .duration = 12000, .controller = SCENARIO_PID, .lossTime = 2000, .lossMs = 2000, .lift = true}, 1, 0, 50},
+    {{.name = "lqr_lift_1s_step", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .startX = -200, .startY = 150, .duration = 12000, .controller = SCENARIO_LQR, .lossTime = 3250, .lossMs = 1000, .lift = true}, 1, 0, 40},
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+extern int32_t ErrorXLast;
+
+// Feeds the state machine directly, samples every TOUCH_UPDATE_RATE and failed reads every ms
+static void CheckStates(void) {
+    unsigned long t = 0;
+    uint32_t x, y;
+    int i;
+
+    printf("Loss state machine\n");
+    LossEnabled = true;
+    Controller_Init();
+    Loss_Init();
+    Check(LossState == LOSS_LOST && Loss_Controlling(), "no ball at start, the plate is held level");
+
+    // The first ball starts control on the setpoint as it is
+    uint32_t restartX = 0, restartY = 0;
+    int32_t velocityX = 0, velocityY = 0;
+    _Bool restarted = false;
+    for(i = 0; i < LOSS_FIRST_SAMPLES; i++, t += TOUCH_UPDATE_RATE) {
+        SeqLock_WritePair(&Ball, 2000 + t, 2100);
+        Loss_Sample(2000 + t, 2100, t);
+        restarted |= Loss_TakeRestart(&restartX, &restartY, &velocityX, &velocityY);
+    }
+    Check(!restarted && LossState == LOSS_TRACKING && !Loss_Controlling(), "first ball tracked after LOSS_FIRST_SAMPLES samples, no profile restart");
+
+    unsigned long last = t - TOUCH_UPDATE_RATE;
+    for(; t < last + LOSS_DROPOUT_MS; t++) Loss_Missed(t);
+    Loss_Coast(t, &x, &y);
+    Check(LossState == LOSS_DROPOUT && Loss_Controlling() && Loss_ControlUpdate(t), "dropout shorter than LOSS_DROPOUT_MS coasts");
+    printf("       coasted to %u,%u after %lu ms (constant velocity: %lu,2100)\n", x, y, t - last, 2000 + t);
+    Check(abs((int)x - (int)(2000 + t)) <= 2 && y == 2100, "coasting follows the ball velocity");
+
+    // The sample that ends the dropout takes the coasting error out of the derivative history
+    ErrorXLast = 0;
+    Loss_Coast(++t, &x, &y);
+    Loss_Sample(x + 7, 2100, t);
+    Check(LossState == LOSS_TRACKING && ErrorXLast == -7, "a sample after coasting moves the derivative by the coasting error");
+
+    for(last = t; t < last + LOSS_DROPOUT_MS; t++) Loss_Missed(t);
+    Loss_Missed(++t);
+    Check(LossState == LOSS_LOST, "lost after LOSS_DROPOUT_MS");
+
+    currentXDegrees = SERVO_X_ZERO + 150;
+    currentYDegrees = SERVO_Y_ZERO - 45;
+    int periods = 0;
+    _Bool run = false;
+    do {
+        run |= Loss_ControlUpdate(t);
+        periods++;
+    } while((currentXDegrees != SERVO_X_ZERO || currentYDegrees != SERVO_Y_ZERO) && periods < 100);
+    Check(!run, "controllers don't run while the ball is lost");
+    Check(periods == (150 + LOSS_LEVEL_STEP - 1) / LOSS_LEVEL_STEP, "plate levelled at LOSS_LEVEL_STEP per PID period");
+
+    // Samples between failed reads aren't enough to come back
+    for(i = 0; i < LOSS_REACQUIRE_SAMPLES; i++) {
+        Loss_Sample(2300, 2200, t += TOUCH_UPDATE_RATE);
+        if(i < LOSS_REACQUIRE_SAMPLES - 1) Loss_Missed(++t);
+    }
+    Check(LossState == LOSS_LOST && !Loss_TakeRestart(&restartX, &restartY, &velocityX, &velocityY),
+          "samples between failed reads don't bring the ball back");
+
+    // Ball back moving at +1 count per ms in x, the setpoint writer takes the profile restart between two samples
+    Loss_Missed(++t);
+    unsigned long back = t;
+    _Bool early = false;
+    for(i = 0; i < LOSS_REACQUIRE_SAMPLES + 10; i++, t += TOUCH_UPDATE_RATE) {
+        SeqLock_WritePair(&Ball, 2000 + t - back, 2100);
+        Loss_Sample(2000 + t - back, 2100, t);
+        if(!restarted && LossState == LOSS_TRACKING) early = true;
+        if(Loss_TakeRestart(&restartX, &restartY, &velocityX, &velocityY)) {
+            restarted = true;
+            Check(i == LOSS_REACQUIRE_SAMPLES - 1 && restartX == 2000 + t - back && restartY == 2100,
+                  "profile restart at the returning ball after LOSS_REACQUIRE_SAMPLES samples");
+            Check(velocityX == 1000 && velocityY == 0, "restart velocity taken over the samples (1000,0 counts/s)");
+        }
+    }
+    Check(restarted && !early && LossState == LOSS_TRACKING && !Loss_Controlling(), "tracking once the profile restarted");
+}
+
+/* Means over the runs of a scenario, <added> is how much later (ms) the ball settles than in the same run
+ *  without the loss, counted from the ball being back
+ */
+static void Run(const LossScenario *l, const PlantParams *params, Metrics *metrics, double *added) {
+    Metrics sum = {0}, run, clean;
+    double addedSum = 0;
+    int i;
+
+    Scenario without = l->scenario;
+    without.lossTime = 0;
+    Harness_Run(&without, params, &clean, NULL);
+    double settled = without.eventTime + clean.settleMs;
+
+    for(i = 0; i < l->runs; i++) {
+        Scenario s = l->scenario;
+        s.lossTime += i * l->spread;
+        Harness_Run(&s, params, &run, NULL);
+
+        double back = s.lossTime + s.lossMs;
+        double later = back + run.settleMs - (settled > back ? settled : back);
+        addedSum += later > 0 ? later : 0;
+        sum.settleMs += run.settleMs;
+        sum.overshootPct += run.overshootPct;
+        sum.rmsError += run.rmsError;
+        sum.maxError += run.maxError;
+    }
+
+    *added = addedSum / l->runs;
+    metrics->settleMs = sum.settleMs / l->runs;
+    metrics->overshootPct = sum.overshootPct / l->runs;
+    metrics->rmsError = sum.rmsError / l->runs;
+    metrics->maxError = sum.maxError / l->runs;
+}
+
+static void Compare(void) {
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    unsigned int i;
+
+    printf("\nRestabilising after a bounce or lift (settling time added by the loss, metrics from the ball being back)\n");
+    printf("       %-20s %-9s %9s  %10s  %12s  %11s  %11s\n", "scenario", "handling", "added(ms)", "settle(ms)", "overshoot(%)",
+           "rms(counts)", "max(counts)");
+    for(i = 0; i < SCENARIO_COUNT; i++) {
+        const LossScenario *l = &scenarios[i];
+        Metrics off, on;
+        double addedOff, addedOn;
+        // The shipped setpoint profile (reference.c), the fixed control start (boot.c) the transients were timed for
+        ReferenceEnabled = true;
+        BootEnabled = false;
+        LossEnabled = false;
+        Run(l, &params, &off, &addedOff);
+        LossEnabled = true;
+        Run(l, &params, &on, &addedOn);
+
+        double gain = (l->scenario.kind == SCENARIO_TRACK) ? 100.0 * (off.rmsError - on.rmsError) / off.rmsError :
+                                                              100.0 * (addedOff - addedOn) / addedOff;
+        _Bool ok = gain >= l->minGain;
+        if(!ok) failures++;
+        printf("       %-20s %-9s %9.0f  %10.0f  %12.1f  %11.1f  %11.1f\n", l->scenario.name, "off", addedOff, off.settleMs,
+               off.overshootPct, off.rmsError, off.maxError);
+        printf("  %-4s %-20s %-9s %9.0f  %10.0f  %12.1f  %11.1f  %11.1f  %+.0f%% (need %+d%%)\n", ok ? "ok" : "FAIL", "", "on",
+               addedOn, on.settleMs, on.overshootPct, on.rmsError, on.maxError, gain, l->minGain);
+    }
+}
+
+int main(void) {
+    CheckStates();
+    Compare();
+
+    LossEnabled = LOSS_DEFAULT_ENABLE;
+    ReferenceEnabled = REFERENCE_DEFAULT_ENABLE;
+    BootEnabled = BOOT_DEFAULT_ENABLE;
+    return Check_Result();
+}
@@ -0,0 +1,276 @@
+/*
+ * notch.c
+ *
+ * Resonance notch check (runs on a PC)
+ *
+ *  Tracks sines in noise on top of a slow ball movement with Notch_Update() (../notch.c),
+ *  including a frequency step, and measures the gain of the notch at the tracked
+ *  frequency (full and half depth) and the gain and phase at the ball frequencies.
+ *  Then gives the simulated plant a structure resonance that the default D gain
+ *  excites, compares the frequency the tracker finds (at depth 0) with the chatter,
+ *  the servo chatter with and without the notch and the largest D gain that doesn't
+ *  chatter, and checks that the notch costs nothing without a resonance. Exits with
+ *  1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/notch sim/notch.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../notch.h"
+#include "harness.h"
+
+#define PI 3.14159265358979
+
+// Output rate (Hz)
+#define RATE (1000.0 / PID_UPDATE_RATE)
+
+// Structure resonance of the plant runs, reading counts per 10th of a degree of horn swing
+#define RESONANCE_GAIN 1.0
+
+// Chatter: servo travel (deg/s) over this many times the travel without the resonance
+#define CHATTER_RATIO 2.0
+
+extern NotchAxis notchX;
+
+static double Frequency(const NotchAxis *n) {
+    return acos(n->coeff / (double)(2L << NOTCH_SHIFT)) * RATE / (2.0 * PI);
+}
+
+/* Tracks a sine of <amplitude> counts from <from> Hz, stepping to <to> Hz halfway, in the error of a ball
+ *  swinging slowly by 100 counts with +-3 counts of noise. Checks the frequency 3 s after the start and the step
+ */
+static int CheckTracking(double from, double to, double amplitude) {
+    NotchAxis n;
+    double phase = 0;
+    double first = 0;
+    int i;
+
+    Notch_Reset(&n, 0);
+    srand(3);
+    for(i = 0; i < 300; i++) {
+        double f = (i < 150) ? from : to;
+        phase += 2.0 * PI * f / RATE;
+        double error = amplitude * sin(phase) + 100.0 * sin(2.0 * PI * 0.3 * i / RATE) + rand() % 7 - 3;
+        Notch_Update(&n, (int32_t)lround(error), 0);
+        if(i == 149) first = Frequency(&n);
+    }
+    double second = Frequency(&n);
+
+    _Bool ok = fabs(first - from) < 0.2 && fabs(second - to) < 0.2;
+    printf("  %-4s %5.1f Hz then %5.1f Hz, %3.0f counts   tracked %5.2f Hz then %5.2f Hz\n", ok ? "ok" : "FAIL", from, to,
+           amplitude, first, second);
+    return ok ? 0 : 1;
+}
+
+// Gain and phase (deg) of the notch at 7 Hz (the start frequency, no error so it doesn't move) for <f> Hz
+static void Response(double f, double *gain, double *phase) {
+    NotchAxis n;
+    double sumSin = 0, sumCos = 0;
+    int i;
+
+    Notch_Reset(&n, 0);
+    for(i = 0; i < 2000; i++) {
+        double angle = 2.0 * PI * f * i / RATE;
+        int32_t out = Notch_Update(&n, 0, (int32_t)lround(1000.0 * sin(angle)));
+        if(i >= 1000) {
+            sumSin += out * sin(angle);
+            sumCos += out * cos(angle);
+        }
+    }
+    *gain = 2.0 * sqrt(sumSin * sumSin + sumCos * sumCos) / 1000.0 / 1000.0;
+    *phase = atan2(sumCos, sumSin) * 180.0 / PI;
+}
+
+static int CheckResponse(void) {
+    static const struct {
+        double f;
+        int32_t depth;
+        double minDb, maxDb;        // Gain limits (dB)
+        double maxLag;              // Phase limit (deg)
+    } points[] = {
+        {7.0, 256, -100, -20, 180},
+        {7.0, 128, -6.5, -5.5, 180},
+        {0.5, 256, -0.2, 0.2, 2},
+        {1.0, 256, -0.2, 0.2, 3},
+        {2.0, 256, -0.5, 0.5, 6},
+    };
+    int failures = 0;
+    unsigned int i;
+
+    for(i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        double gain, phase;
+        NotchDepth = points[i].depth;
+        Response(points[i].f, &gain, &phase);
+        double db = 20.0 * log10(gain > 1e-5 ? gain : 1e-5);
+
+        _Bool ok = db >= points[i].minDb && db <= points[i].maxDb && fabs(phase) <= points[i].maxLag;
+        printf("  %-4s %4.1f Hz depth %3d   gain %6.1f dB  phase %6.1f deg\n", ok ? "ok" : "FAIL", points[i].f, points[i].depth,
+               db, phase);
+        if(!ok) failures++;
+    }
+    NotchDepth = NOTCH_DEFAULT_DEPTH;
+    return failures;
+}
+
+// Servo travel (10th of a degree) of the latched X commands and the sway crossings of zero
+static double travel;
+static long crossings;
+static double lastX, lastSway;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    (void)setX;
+    (void)setY;
+    if(timeMs == 0) {
+        lastX = plant->latchedX;
+        lastSway = plant->swayX;
+        return;
+    }
+    travel += fabs(plant->latchedX - lastX);
+    if((plant->swayX > 0) != (lastSway > 0)) crossings++;
+    lastX = plant->latchedX;
+    lastSway = plant->swayX;
+}
+
+typedef struct {
+    double travel;          // Servo travel (deg/s)
+    double chatterHz;       // Sway frequency (Hz)
+    double trackedHz;       // Notch frequency at the end (Hz)
+    Metrics hold, step;
+} Run;
+
+/* Holds the center and steps +600 with the X axis gain <d> on a plant with a <hz> Hz resonance (0 = none)
+ *  With the notch at <depth> (0 = tracking only, -1 = off)
+ */
+static void RunPlant(double hz, int32_t d, int32_t depth, Run *r) {
+    static const Scenario hold = {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000};
+    static const Scenario step = {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000};
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    params.resonanceHz = hz;
+    params.resonanceGain = RESONANCE_GAIN;
+
+    NotchEnabled = (depth >= 0);
+    NotchDepth = depth;
+    Dx = d;
+    travel = 0;
+    crossings = 0;
+    Harness_Run(&hold, &params, &r->hold, Trace);
+    r->travel = travel / 10.0 / (hold.duration / 1000.0);
+    r->chatterHz = crossings / 2.0 / (hold.duration / 1000.0);
+    r->trackedHz = Frequency(&notchX);
+    Harness_Run(&step, &params, &r->step, NULL);
+
+    NotchEnabled = NOTCH_DEFAULT_ENABLE;
+    NotchDepth = NOTCH_DEFAULT_DEPTH;
+    Dx = 240;
+}
+
+static int CheckPlant(double hz) {
+    Run clean, off, tracking, on;
+    RunPlant(0, 240, -1, &clean);
+    RunPlant(hz, 240, -1, &off);
+    RunPlant(hz, 240, 0, &tracking);
+    RunPlant(hz, 240, NOTCH_DEFAULT_DEPTH, &on);
+
+    // The default gain chatters without the notch, the tracker alone finds the chatter and the notch brings the travel back
+    _Bool ok = off.travel > CHATTER_RATIO * clean.travel && on.travel < CHATTER_RATIO * clean.travel &&
+               fabs(tracking.trackedHz - tracking.chatterHz) < 0.3;
+    printf("  %-4s %4.1f Hz resonance   chatter %5.2f Hz  tracked %5.2f Hz   travel %6.1f deg/s without, %5.1f with the notch"
+           " (%5.1f no resonance)\n", ok ? "ok" : "FAIL", hz, tracking.chatterHz, tracking.trackedHz, off.travel, on.travel,
+           clean.travel);
+    return ok ? 0 : 1;
+}
+
+// Largest X axis D gain (steps of 40) that doesn't chatter and settles the step within 1.2 times the default
+static int32_t UsableD(double hz, _Bool notch) {
+    Run clean, r;
+    RunPlant(0, 240, -1, &clean);
+
+    int32_t usable = 0;
+    int32_t d;
+    for(d = 120; d <= 600; d += 40) {
+        Run reference;
+        RunPlant(0, d, -1, &reference);
+        RunPlant(hz, d, notch ? NOTCH_DEFAULT_DEPTH : -1, &r);
+        if(r.travel > CHATTER_RATIO * reference.travel || r.step.settleMs > 1.2 * clean.step.settleMs) break;
+        usable = d;
+    }
+    return usable;
+}
+
+static int CheckUsableD(double hz) {
+    int32_t off = UsableD(hz, false);
+    int32_t on = UsableD(hz, true);
+    _Bool ok = on >= off + 120 && on >= 400;
+    printf("  %-4s %4.1f Hz resonance   usable Dx %3d without, %3d with the notch\n", ok ? "ok" : "FAIL", hz, off, on);
+    return ok ? 0 : 1;
+}
+
+// Without a resonance the notch has nothing to take out, the responses stay within 10%
+static int CheckClean(void) {
+    static const Scenario scenarios[] = {
+        {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000},
+        {.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000},
+    };
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    int failures = 0;
+    unsigned int i;
+
+    for(i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        Metrics off, on;
+        Harness_Run(&scenarios[i], &params, &off, NULL);
+        NotchEnabled = true;
+        Harness_Run(&scenarios[i], &params, &on, NULL);
+        NotchEnabled = NOTCH_DEFAULT_ENABLE;
+
+        _Bool ok = on.rmsError <= 1.1 * off.rmsError && on.settleMs <= 1.1 * off.settleMs + PID_UPDATE_RATE;
+        printf("  %-4s %-14s settle %5.0f / %5.0f ms  rms %5.1f / %5.1f counts (without / with the notch)\n", ok ? "ok" : "FAIL",
+               scenarios[i].name, off.settleMs, on.settleMs, off.rmsError, on.rmsError);
+        if(!ok) failures++;
+    }
+    return failures;
+}
+
+int main(void) {
+    static const double resonances[] = {5.0, 7.0, 9.0};
+    int failures = 0;
+    unsigned int i;
+
+    printf("Frequency tracking\n");
+    failures += CheckTracking(5.0, 9.0, 20.0);
+    failures += CheckTracking(9.0, 4.0, 20.0);
+    failures += CheckTracking(7.0, 10.0, 8.0);
+
+    printf("\nNotch response (7 Hz, width %d.%d Hz)\n", NOTCH_DEFAULT_WIDTH / 10, NOTCH_DEFAULT_WIDTH % 10);
+    failures += CheckResponse();
+
+    printf("\nStructure resonance on the simulated plant (Dx 240)\n");
+    for(i = 0; i < sizeof(resonances) / sizeof(resonances[0]); i++) {
+        failures += CheckPlant(resonances[i]);
+    }
+
+    printf("\nLargest D gain without chatter\n");
+    for(i = 0; i < sizeof(resonances) / sizeof(resonances[0]); i++) {
+        failures += CheckUsableD(resonances[i]);
+    }
+
+    printf("\nNo resonance\n");
+    failures += CheckClean();
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
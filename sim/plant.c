@@ -0,0 +1,191 @@
+/*
+ * plant.c
+ *
+ * Ball on a servo tilted plate, stepped at 1 ms (the SysTick period)
+ *  - Servo pulses are latched at the start of each 20 ms servo frame
+ *  - The horn then slews toward the pulse at <servoRate>
+ *  - The ball is a rolling solid sphere: a = 5/7 * g * sin(tilt)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "plant.h"
+
+#define G 9.81
+#define DT 0.001
+#define DEG_TO_RAD (3.14159265358979 / 180.0)
+
+void Plant_DefaultParams(PlantParams *params) {
+    params->linkRatio = 0.35;
+    params->servoRate = 500.0;
+    params->servoDeadband = 0;
+    params->servoLevelX = 867;
+    params->servoLevelY = 867;
+    params->biasTiltX = 0;
+    params->biasTiltY = 0;
+    params->damping = 0.15;
+    params->noise = 3;
+    params->touchCenterX = 2150;
+    params->touchCenterY = 2150;
+    params->sensorDelay = 0;
+    params->framePhase = 0;
+    params->resonanceHz = 0;
+    params->resonanceDamping = 0.03;
+    params->resonanceGain = 0;
+}
+
+void Plant_Init(Plant *plant, const PlantParams *params) {
+    plant->p = *params;
+    plant->posX = plant->posY = 0;
+    plant->velX = plant->velY = 0;
+    plant->onPlate = true;
+    plant->pendingX = plant->latchedX = plant->hornX = params->servoLevelX;
+    plant->pendingY = plant->latchedY = plant->hornY = params->servoLevelY;
+    plant->swayX = plant->swayY = 0;
+    plant->swayVelX = plant->swayVelY = 0;
+    plant->timeMs = 0;
+    plant->airborneUntil = 0;
+    plant->seed = 12345;
+
+    int i;
+    for(i = 0; i < PLANT_MAX_SENSOR_DELAY; i++) {
+        plant->historyX[i] = plant->historyY[i] = 0;
+    }
+}
+
+void Plant_PlaceBall(Plant *plant, double x, double y, double vx, double vy) {
+    plant->posX = x;
+    plant->posY = y;
+    plant->velX = vx;
+    plant->velY = vy;
+    plant->onPlate = true;
+
+    int i;
+    for(i = 0; i < PLANT_MAX_SENSOR_DELAY; i++) {
+        plant->historyX[i] = x;
+        plant->historyY[i] = y;
+    }
+}
+
+void Plant_RemoveBall(Plant *plant) {
+    plant->onPlate = false;
+}
+
+// Ball leaves the plate surface for <durationMs>, it keeps its velocity and lands where it flew to
+void Plant_Bounce(Plant *plant, unsigned long durationMs) {
+    plant->airborneUntil = plant->timeMs + durationMs;
+}
+
+// Equivalent of Servo_Set_Degrees() for both servos
+void Plant_SetServo(Plant *plant, uint32_t xDegrees, uint32_t yDegrees) {
+    plant->pendingX = xDegrees;
+    plant->pendingY = yDegrees;
+}
+
+/* Sway driven by the horn speed, x'' + 2*z*w*x' + w^2*x = 2*z*w*gain*horn'
+ *  A horn swing of amplitude H at the mode moves the reading by gain * H
+ */
+static void Sway(const PlantParams *p, double *sway, double *swayVel, double hornVel) {
+    double w = 2.0 * 3.14159265358979 * p->resonanceHz;
+    double accel = 2.0 * p->resonanceDamping * w * (p->resonanceGain * hornVel - *swayVel) - w * w * *sway;
+    *swayVel += accel * DT;
+    *sway += *swayVel * DT;
+}
+
+static double Slew(double current, double target, double maxStep) {
+    if(target > current + maxStep) return current + maxStep;
+    if(target < current - maxStep) return current - maxStep;
+    return target;
+}
+
+// True if a new servo frame (pulse latch) starts with the next step
+_Bool Plant_FrameStart(const Plant *plant) {
+    return (plant->timeMs % PLANT_SERVO_FRAME_MS) == (unsigned long)plant->p.framePhase;
+}
+
+void Plant_Step(Plant *plant) {
+    PlantParams *p = &plant->p;
+
+    if(Plant_FrameStart(plant)) {
+        if(fabs(plant->pendingX - plant->latchedX) > p->servoDeadband) plant->latchedX = plant->pendingX;
+        if(fabs(plant->pendingY - plant->latchedY) > p->servoDeadband) plant->latchedY = plant->pendingY;
+    }
+    plant->timeMs++;
+
+    // Servo rate is in degrees/s, horn angle is in 10th of a degree
+    double maxStep = p->servoRate * 10.0 * DT;
+    double hornX = plant->hornX;
+    double hornY = plant->hornY;
+    plant->hornX = Slew(plant->hornX, plant->latchedX, maxStep);
+    plant->hornY = Slew(plant->hornY, plant->latchedY, maxStep);
+
+    if(p->resonanceHz > 0) {
+        Sway(p, &plant->swayX, &plant->swayVelX, (plant->hornX - hornX) / DT);
+        Sway(p, &plant->swayY, &plant->swayVelY, (plant->hornY - hornY) / DT);
+    }
+
+    if(!plant->onPlate) return;
+
+    double tiltX = (plant->hornX - p->servoLevelX) / 10.0 * p->linkRatio + p->biasTiltX;
+    double tiltY = (plant->hornY - p->servoLevelY) / 10.0 * p->linkRatio + p->biasTiltY;
+
+    double ax = (5.0 / 7.0) * G * sin(tiltX * DEG_TO_RAD) - p->damping * plant->velX;
+    double ay = (5.0 / 7.0) * G * sin(tiltY * DEG_TO_RAD) - p->damping * plant->velY;
+    if(plant->timeMs < plant->airborneUntil) {
+        ax = ay = 0;
+    }
+
+    plant->velX += ax * DT;
+    plant->velY += ay * DT;
+    plant->posX += plant->velX * DT;
+    plant->posY += plant->velY * DT;
+
+    // The ball stops against the frame at the edge of the plate
+    if(plant->posX > PLANT_HALF_SIZE_X) { plant->posX = PLANT_HALF_SIZE_X; plant->velX = 0; }
+    if(plant->posX < -PLANT_HALF_SIZE_X) { plant->posX = -PLANT_HALF_SIZE_X; plant->velX = 0; }
+    if(plant->posY > PLANT_HALF_SIZE_Y) { plant->posY = PLANT_HALF_SIZE_Y; plant->velY = 0; }
+    if(plant->posY < -PLANT_HALF_SIZE_Y) { plant->posY = -PLANT_HALF_SIZE_Y; plant->velY = 0; }
+
+    plant->historyX[plant->timeMs % PLANT_MAX_SENSOR_DELAY] = plant->posX;
+    plant->historyY[plant->timeMs % PLANT_MAX_SENSOR_DELAY] = plant->posY;
+}
+
+static int Noise(Plant *plant) {
+    if(plant->p.noise == 0) return 0;
+    plant->seed = plant->seed * 1103515245u + 12345u;
+    return (int)((plant->seed >> 16) % (2 * plant->p.noise + 1)) - plant->p.noise;
+}
+
+double Plant_ToCounts(double meters) {
+    return meters * PLANT_COUNTS_PER_METER;
+}
+
+// Equivalent of Touch_Present() followed by Touch_Read_X() and Touch_Read_Y()
+_Bool Plant_ReadTouch(Plant *plant, uint32_t *x, uint32_t *y) {
+    if(!plant->onPlate || plant->timeMs < plant->airborneUntil) return false;
+
+    double posX = plant->posX;
+    double posY = plant->posY;
+    int delay = plant->p.sensorDelay;
+    if(delay > 0) {
+        if(delay >= PLANT_MAX_SENSOR_DELAY) delay = PLANT_MAX_SENSOR_DELAY - 1;
+        posX = plant->historyX[(plant->timeMs + PLANT_MAX_SENSOR_DELAY - delay) % PLANT_MAX_SENSOR_DELAY];
+        posY = plant->historyY[(plant->timeMs + PLANT_MAX_SENSOR_DELAY - delay) % PLANT_MAX_SENSOR_DELAY];
+    }
+
+    double sx = plant->p.touchCenterX + Plant_ToCounts(posX) - plant->swayX + Noise(plant);
+    double sy = plant->p.touchCenterY + Plant_ToCounts(posY) - plant->swayY + Noise(plant);
+
+    if(sx < 0) sx = 0;
+    if(sx > 4095) sx = 4095;
+    if(sy < 0) sy = 0;
+    if(sy > 4095) sy = 4095;
+
+    *x = (uint32_t)(sx + 0.5);
+    *y = (uint32_t)(sy + 0.5);
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+ * plant.h
+ *
+ * Simulated ball and plate used by the PC side benchmark/simulation tools
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef PLANT_H_
+#define PLANT_H_
+
+// Touch panel scaling and plate size, the travel of the ball center to the frame (stays within the
+//  ADC range of the panel, the levelling reads the frame positions)
+#define PLANT_COUNTS_PER_METER 18000.0
+#define PLANT_HALF_SIZE_X 0.100
+#define PLANT_HALF_SIZE_Y 0.085
+
+// Servo frame (PWM_PERIOD in servo.h), the servo only latches a new pulse once per frame
+#define PLANT_SERVO_FRAME_MS 20
+
+// Longest extra sensing delay that can be injected (ms)
+#define PLANT_MAX_SENSOR_DELAY 256
+
+typedef struct {
+    // Plate tilt (degrees) per degree of servo horn rotation
+    double linkRatio;
+    // Servo slew limit in degrees per second
+    double servoRate;
+    // Servo deadband (10th of a degree), a pulse this close to the held position doesn't move the horn
+    double servoDeadband;
+    // True level position of each servo (10th of a degree)
+    double servoLevelX, servoLevelY;
+    // Constant plate tilt from an off level mount (degrees)
+    double biasTiltX, biasTiltY;
+    // Viscous rolling loss (1/s)
+    double damping;
+    // Peak uniform touch noise (counts)
+    int noise;
+    // Touch panel electrical center (counts)
+    double touchCenterX, touchCenterY;
+    // Extra delay between the ball position and the touch reading (ms)
+    int sensorDelay;
+    // Time of the first servo frame start (ms, 0 to PLANT_SERVO_FRAME_MS - 1)
+    int framePhase;
+    // Lightly damped sway of the printed structure, the panel moves under the ball. Excited by the horn
+    //  motion, <resonanceGain> counts of reading per 10th of a degree of horn swing at the mode (0 Hz = none)
+    double resonanceHz, resonanceDamping, resonanceGain;
+} PlantParams;
+
+typedef struct {
+    PlantParams p;
+
+    // Ball state (m, m/s), relative to the plate center
+    double posX, posY;
+    double velX, velY;
+    _Bool onPlate;
+
+    // Ball is in the air after a bounce until this time (ms), no touch reading and no plate acceleration
+    unsigned long airborneUntil;
+
+    // Servo pulse waiting for the next frame, latched pulse and actual horn angle (10th of degree)
+    double pendingX, pendingY;
+    double latchedX, latchedY;
+    double hornX, hornY;
+
+    // Panel sway (counts) and its speed (counts/s)
+    double swayX, swayY;
+    double swayVelX, swayVelY;
+
+    // Ball position history for the sensing delay (m)
+    double historyX[PLANT_MAX_SENSOR_DELAY];
+    double historyY[PLANT_MAX_SENSOR_DELAY];
+
+    unsigned long timeMs;
+    uint32_t seed;
+} Plant;
+
+void Plant_DefaultParams(PlantParams *params);
+void Plant_Init(Plant *plant, const PlantParams *params);
+void Plant_PlaceBall(Plant *plant, double x, double y, double vx, double vy);
+void Plant_RemoveBall(Plant *plant);
+void Plant_Bounce(Plant *plant, unsigned long durationMs);
+void Plant_SetServo(Plant *plant, uint32_t xDegrees, uint32_t yDegrees);
+_Bool Plant_FrameStart(const Plant *plant);
+void Plant_Step(Plant *plant);
+_Bool Plant_ReadTouch(Plant *plant, uint32_t *x, uint32_t *y);
+double Plant_ToCounts(double meters);
+
+#endif /* PLANT_H_ */
@@ -0,0 +1,285 @@
+/*
+ * reference.c
+ *
+ * Setpoint transition profile check (runs on a PC)
+ *
+ *  Runs the profile of ../reference.c on its own: a step from rest has to reach the
+ *  target exactly in the time optimal time without overshoot, and no transition may
+ *  break the acceleration or speed limits or jump the setpoint, also when the target
+ *  changes mid move or the setpoint leaves a circle. A chased circle has to be joined
+ *  and then passed straight through. Then compares the mode changes on the simulated
+ *  plant with and without the profile. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/reference sim/reference.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../circle.h"
+#include "../reference.h"
+#include "harness.h"
+#include "check.h"
+
+// Longest profile run (ms)
+#define PROFILE_MS 5000
+
+typedef struct {
+    Scenario scenario;
+    // Required reduction of the settling time by the profile (%) and largest overshoot with it (%)
+    int minGain;
+    double maxOvershoot;
+} ModeScenario;
+
+static const ModeScenario scenarios[] = {
+    {{.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_PID}, 50, 2},
+    {{.name = "step_minus600", .kind = SCENARIO_STEP, .mode = 2, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_PID}, 50, 2},
+    {{.name = "lqr_step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_LQR}, 10, 3},
+    {{.name = "lqr_step_minus600", .kind = SCENARIO_STEP, .mode = 2, .eventTime = 3000, .duration = 10000, .controller = SCENARIO_LQR}, 10, 3},
+    {{.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000, .controller = SCENARIO_PID}, 0, 0},
+    {{.name = "lqr_circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000, .controller = SCENARIO_LQR}, 0, 0},
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// Published setpoint (x axis) while a profile runs: last value, range and run time
+typedef struct {
+    int32_t last;
+    int32_t min, max;
+    int ms;
+} Moves;
+
+static void Moves_Start(Moves *m) {
+    uint32_t x, y;
+    SeqLock_ReadPair(&Setpoint, &x, &y);
+    m->last = m->min = m->max = x;
+    m->ms = 0;
+}
+
+// Advances the profile by one ms like SysTick does
+static void Moves_Step(Moves *m) {
+    uint32_t x, y;
+    Reference_Update();
+    SeqLock_ReadPair(&Setpoint, &x, &y);
+    if((int32_t)x < m->min) m->min = x;
+    if((int32_t)x > m->max) m->max = x;
+    m->last = x;
+    m->ms++;
+}
+
+// Runs the profile until it is done, returns false if it didn't finish within PROFILE_MS
+static _Bool RunToEnd(Moves *m) {
+    while(SetpointMoving && m->ms < PROFILE_MS) {
+        Moves_Step(m);
+    }
+    return !SetpointMoving;
+}
+
+// Profile velocity of the x axis (counts/s), the change over one ms gives the acceleration
+extern ReferenceAxis referenceX;
+
+static double VelocityX(void) {
+    return referenceX.velocity * 1000.0 / (1 << REFERENCE_SHIFT);
+}
+
+static void CheckProfile(void) {
+    Moves m;
+    char text[128];
+
+    printf("Setpoint profile (accel %ld counts/s^2)\n", (long)ReferenceAccel);
+    Controller_Init();
+
+    // Step from rest, the time optimal move takes 2 * sqrt(distance / accel)
+    Reference_Init(CENTER_X, CENTER_Y);
+    Moves_Start(&m);
+    Reference_Target(CENTER_X + 600, CENTER_Y);
+    double peak = 0, accel = 0, lastVelocity = 0;
+    int32_t maxFeedforward = 0;
+    while(SetpointMoving && m.ms < PROFILE_MS) {
+        Moves_Step(&m);
+        double velocity = VelocityX();
+        if(fabs(velocity) > peak) peak = fabs(velocity);
+        if(fabs(velocity - lastVelocity) * 1000 > accel) accel = fabs(velocity - lastVelocity) * 1000;
+        if(Abs(SetpointFeedforwardX) > maxFeedforward) maxFeedforward = Abs(SetpointFeedforwardX);
+        lastVelocity = velocity;
+    }
+    double optimal = 2000.0 * sqrt(600.0 / ReferenceAccel);
+    snprintf(text, sizeof(text), "+600 step done in %d ms (time optimal %.0f ms), peak speed %.0f counts/s", m.ms, optimal, peak);
+    Check(!SetpointMoving && m.ms <= optimal * 1.02 + 2, text);
+    Check(m.last == CENTER_X + 600 && m.max == CENTER_X + 600 && m.min == CENTER_X, "ends exactly on the target, no overshoot");
+    snprintf(text, sizeof(text), "acceleration within the limit (%.0f counts/s^2)", accel);
+    Check(accel <= ReferenceAccel * 1.01, text);
+    snprintf(text, sizeof(text), "feedforward peak %ld (10th of a degree), none once done", (long)maxFeedforward);
+    Check(maxFeedforward == ReferenceAccel / REFERENCE_FEEDFORWARD_GAIN && SetpointFeedforwardX == 0, text);
+
+    // New target half way, the setpoint turns around without a jump
+    Moves_Start(&m);
+    Reference_Target(CENTER_X - 600, CENTER_Y);
+    int i;
+    for(i = 0; i < 300; i++) Moves_Step(&m);
+    Reference_Target(CENTER_X + 300, CENTER_Y);
+    lastVelocity = VelocityX();
+    accel = 0;
+    while(SetpointMoving && m.ms < PROFILE_MS) {
+        Moves_Step(&m);
+        double velocity = VelocityX();
+        if(fabs(velocity - lastVelocity) * 1000 > accel) accel = fabs(velocity - lastVelocity) * 1000;
+        lastVelocity = velocity;
+    }
+    snprintf(text, sizeof(text), "retarget mid move: smooth turn around (%.0f counts/s^2), ends on the new target", accel);
+    Check(accel <= ReferenceAccel * 1.01 && m.last == CENTER_X + 300 && m.max == CENTER_X + 600, text);
+
+    // Speed limit
+    ReferenceSpeed = 500;
+    Moves_Start(&m);
+    Reference_Target(CENTER_X - 600, CENTER_Y);
+    peak = 0;
+    while(SetpointMoving && m.ms < PROFILE_MS) {
+        Moves_Step(&m);
+        if(fabs(VelocityX()) > peak) peak = fabs(VelocityX());
+    }
+    snprintf(text, sizeof(text), "speed limit 500 counts/s holds (peak %.0f), %d ms", peak, m.ms);
+    Check(peak <= 501 && m.last == CENTER_X - 600, text);
+    ReferenceSpeed = REFERENCE_DEFAULT_SPEED;
+
+    // Without the profile the setpoint jumps
+    ReferenceEnabled = false;
+    Reference_Target(CENTER_X + 600, CENTER_Y);
+    uint32_t x, y;
+    SeqLock_ReadPair(&Setpoint, &x, &y);
+    Check(x == CENTER_X + 600 && !SetpointMoving, "disabled: the setpoint jumps to the target");
+    ReferenceEnabled = true;
+
+    // Chase of circle mode 3 at the default rate from the +600 setpoint, as SysTick runs it
+    uint16_t index = 0;
+    unsigned long t;
+    Moves_Start(&m);
+    Reference_Target(CENTER_X + CirclePosition_X[index], CENTER_Y + CirclePosition_Y[index]);
+    int joined = -1;
+    int32_t jump = 0;
+    _Bool through = true;
+    for(t = 1; t <= 3000; t++) {
+        if((t % CIRCLE_DEFAULT_RATE) == 0) {
+            index = (index + 1) % CIRCLE_SIZE;
+            uint16_t next = (index + 1) % CIRCLE_SIZE;
+            Reference_Moving(CENTER_X + CirclePosition_X[index], CENTER_Y + CirclePosition_Y[index],
+                             CENTER_X + CirclePosition_X[next], CENTER_Y + CirclePosition_Y[next], CIRCLE_DEFAULT_RATE);
+        }
+        int32_t before = m.last;
+        Moves_Step(&m);
+        if(joined < 0) {
+            if(Abs(m.last - before) > jump) jump = Abs(m.last - before);
+            if(!SetpointMoving) joined = t;
+        } else if((t % CIRCLE_DEFAULT_RATE) == 0) {
+            SeqLock_ReadPair(&Setpoint, &x, &y);
+            if(x != (uint32_t)(CENTER_X + CirclePosition_X[index]) || y != (uint32_t)(CENTER_Y + CirclePosition_Y[index])) {
+                through = false;
+            }
+        }
+    }
+    snprintf(text, sizeof(text), "circle joined after %d ms (lap %d ms), largest setpoint move %ld counts/ms", joined,
+             CIRCLE_SIZE * CIRCLE_DEFAULT_RATE, (long)jump);
+    Check(joined > 0 && joined < CIRCLE_SIZE * CIRCLE_DEFAULT_RATE && jump <= 3, text);
+    Check(through, "joined circle passes straight through");
+
+    // Leaving the circle for the center keeps the circle speed and brakes
+    double leaving = VelocityX();
+    Moves_Start(&m);
+    Reference_Target(CENTER_X, CENTER_Y);
+    Moves_Step(&m);
+    double change = fabs(VelocityX() - leaving) * 1000;
+    snprintf(text, sizeof(text), "leaving the circle at %.0f counts/s: speed kept (%.0f counts/s^2)", leaving, change);
+    Check(change <= ReferenceAccel * 1.01 && RunToEnd(&m) && m.last == CENTER_X, text);
+
+    // Random targets every 100-600 ms, the limits hold throughout
+    srand(7);
+    Reference_Init(CENTER_X, CENTER_Y);
+    Moves_Start(&m);
+    lastVelocity = 0;
+    accel = 0;
+    for(i = 0; i < 50; i++) {
+        Reference_Target(CENTER_X - 800 + rand() % 1600, CENTER_Y - 800 + rand() % 1600);
+        int hold = 100 + rand() % 500;
+        while(hold--) {
+            Moves_Step(&m);
+            double velocity = VelocityX();
+            if(fabs(velocity - lastVelocity) * 1000 > accel) accel = fabs(velocity - lastVelocity) * 1000;
+            lastVelocity = velocity;
+        }
+    }
+    snprintf(text, sizeof(text), "50 random retargets: acceleration within the limit (%.0f counts/s^2)", accel);
+    Check(accel <= ReferenceAccel * 1.01, text);
+}
+
+// Largest servo command change between two ms of a run (derivative and integral kicks show up here)
+static int32_t commandStep;
+static int32_t lastCommand;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    int32_t command = currentXDegrees;
+    (void)plant;
+    (void)setX;
+    (void)setY;
+    if(timeMs > PID_UPDATE_DELAY && Abs(command - lastCommand) > commandStep) commandStep = Abs(command - lastCommand);
+    lastCommand = command;
+}
+
+static void Compare(void) {
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    unsigned int i;
+
+    printf("\nMode changes on the plant (circles: tracking error after the first lap)\n");
+    printf("       %-18s %-8s %10s  %12s  %11s  %11s  %12s\n", "scenario", "profile", "settle(ms)", "overshoot(%)",
+           "rms(counts)", "max(counts)", "command step");
+    for(i = 0; i < SCENARIO_COUNT; i++) {
+        const ModeScenario *s = &scenarios[i];
+        Metrics off, on;
+        int32_t stepOff, stepOn;
+
+        ReferenceEnabled = false;
+        commandStep = 0;
+        lastCommand = SERVO_X_ZERO;
+        Harness_Run(&s->scenario, &params, &off, Trace);
+        stepOff = commandStep;
+
+        ReferenceEnabled = true;
+        commandStep = 0;
+        lastCommand = SERVO_X_ZERO;
+        Harness_Run(&s->scenario, &params, &on, Trace);
+        stepOn = commandStep;
+
+        _Bool ok;
+        char result[64];
+        if(s->scenario.kind == SCENARIO_TRACK) {
+            // The chase may not cost tracking once the circle is joined
+            ok = on.maxError <= off.maxError * 1.1;
+            snprintf(result, sizeof(result), "max %+.0f%% (allowed +10%%)", 100.0 * (on.maxError - off.maxError) / off.maxError);
+        } else {
+            double gain = 100.0 * (off.settleMs - on.settleMs) / off.settleMs;
+            ok = (gain >= s->minGain) && (on.overshootPct <= s->maxOvershoot);
+            snprintf(result, sizeof(result), "%+.0f%% (need %+d%%, overshoot <= %.0f%%)", gain, s->minGain, s->maxOvershoot);
+        }
+        if(!ok) failures++;
+
+        printf("       %-18s %-8s %10.0f  %12.1f  %11.1f  %11.1f  %12ld\n", s->scenario.name, "off", off.settleMs,
+               off.overshootPct, off.rmsError, off.maxError, (long)stepOff);
+        printf("  %-4s %-18s %-8s %10.0f  %12.1f  %11.1f  %11.1f  %12ld  %s\n", ok ? "ok" : "FAIL", "", "on", on.settleMs,
+               on.overshootPct, on.rmsError, on.maxError, (long)stepOn, result);
+    }
+}
+
+int main(void) {
+    CheckProfile();
+    Compare();
+
+    ReferenceEnabled = REFERENCE_DEFAULT_ENABLE;
+    return Check_Result();
+}
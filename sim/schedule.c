@@ -0,0 +1,350 @@
+/*
+ * schedule.c
+ *
+ * Gain scheduling check (runs on a PC)
+ *
+ *  Looks up a table with Schedule_Lookup() (../schedule.c) at its grid points,
+ *  between them against a floating point bilinear interpolation and beyond its
+ *  last grid points, loads tables directly and through the UART lines, and holds
+ *  a ball off the target while a very different table is loaded to check the
+ *  output moves without a bump. Then compares the scheduled PID (both arithmetics)
+ *  with the fixed gains on the simulated plant: the hold error once settled, the
+ *  circles, the steps and a ball drop, and the default table with the same
+ *  table without its distance columns. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/schedule sim/schedule.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../controller.h"
+#include "../schedule.h"
+#include "harness.h"
+
+#define SIZE (SCHEDULE_SPEEDS * SCHEDULE_DISTANCES)
+
+// Speeds are scaled by 16 in the lookup
+#define SPEED_GRID (SCHEDULE_SPEED_STEP * 16)
+
+// Test table, every grid point different: p from the speed, d from the distance, i from both
+static void TestTable(ScheduleEntry *table) {
+    int s, d;
+    for(s = 0; s < SCHEDULE_SPEEDS; s++) {
+        for(d = 0; d < SCHEDULE_DISTANCES; d++) {
+            table[s * SCHEDULE_DISTANCES + d].p = 200 + 100 * s;
+            table[s * SCHEDULE_DISTANCES + d].i = 64 + 90 * s + 37 * d;
+            table[s * SCHEDULE_DISTANCES + d].d = 900 - 250 * d;
+        }
+    }
+}
+
+static double Bilinear(const ScheduleEntry *table, double speed, double distance, int field) {
+    double s = speed / SPEED_GRID;
+    double d = distance / SCHEDULE_DISTANCE_STEP;
+    if(s > SCHEDULE_SPEEDS - 1) s = SCHEDULE_SPEEDS - 1;
+    if(d > SCHEDULE_DISTANCES - 1) d = SCHEDULE_DISTANCES - 1;
+    int s0 = (int)s, d0 = (int)d;
+    int s1 = (s0 + 1 < SCHEDULE_SPEEDS) ? s0 + 1 : s0;
+    int d1 = (d0 + 1 < SCHEDULE_DISTANCES) ? d0 + 1 : d0;
+    double fs = s - s0, fd = d - d0;
+
+    #define AT(si, di) (field == 0 ? table[(si) * SCHEDULE_DISTANCES + (di)].p : \
+                        field == 1 ? table[(si) * SCHEDULE_DISTANCES + (di)].i : table[(si) * SCHEDULE_DISTANCES + (di)].d)
+    double low = AT(s0, d0) + (AT(s0, d1) - AT(s0, d0)) * fd;
+    double high = AT(s1, d0) + (AT(s1, d1) - AT(s1, d0)) * fd;
+    return low + (high - low) * fs;
+}
+
+static int CheckLookup(void) {
+    ScheduleEntry table[SIZE];
+    ScheduleEntry scale;
+    int failures = 0;
+    int s, d, i;
+    TestTable(table);
+
+    // Grid points are exact
+    _Bool ok = true;
+    for(s = 0; s < SCHEDULE_SPEEDS; s++) {
+        for(d = 0; d < SCHEDULE_DISTANCES; d++) {
+            const ScheduleEntry *e = &table[s * SCHEDULE_DISTANCES + d];
+            Schedule_Lookup(table, s * SPEED_GRID, d * SCHEDULE_DISTANCE_STEP, &scale);
+            if(scale.p != e->p || scale.i != e->i || scale.d != e->d) ok = false;
+        }
+    }
+    printf("  %-4s grid points\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+
+    // Beyond the last grid points the table is held
+    Schedule_Lookup(table, 100 * SPEED_GRID, 100000, &scale);
+    const ScheduleEntry *last = &table[SIZE - 1];
+    ok = scale.p == last->p && scale.i == last->i && scale.d == last->d;
+    printf("  %-4s beyond the grid         p %d i %d d %d\n", ok ? "ok" : "FAIL", scale.p, scale.i, scale.d);
+    if(!ok) failures++;
+
+    // Between the grid points within a unit of the bilinear interpolation
+    double worst = 0;
+    srand(7);
+    for(i = 0; i < 100000; i++) {
+        uint32_t speed = rand() % (SCHEDULE_SPEEDS * SPEED_GRID);
+        uint32_t distance = rand() % (SCHEDULE_DISTANCES * SCHEDULE_DISTANCE_STEP);
+        Schedule_Lookup(table, speed, distance, &scale);
+        double err = fabs(scale.p - Bilinear(table, speed, distance, 0));
+        err = fmax(err, fabs(scale.i - Bilinear(table, speed, distance, 1)));
+        err = fmax(err, fabs(scale.d - Bilinear(table, speed, distance, 2)));
+        if(err > worst) worst = err;
+    }
+    ok = worst <= 1.0;
+    printf("  %-4s interpolation          worst %.2f from the bilinear\n", ok ? "ok" : "FAIL", worst);
+    if(!ok) failures++;
+
+    // No step anywhere: neighbouring speeds and distances differ by at most a grid cell's slope
+    int jump = 0;
+    for(s = 0; s < SCHEDULE_SPEEDS * SPEED_GRID; s += 3) {
+        for(d = 0; d < SCHEDULE_DISTANCES * SCHEDULE_DISTANCE_STEP; d += 37) {
+            ScheduleEntry a, b, c;
+            Schedule_Lookup(table, s, d, &a);
+            Schedule_Lookup(table, s + 1, d, &b);
+            Schedule_Lookup(table, s, d + 1, &c);
+            jump = (int)fmax(jump, abs(a.p - b.p));
+            jump = (int)fmax(jump, abs(a.i - b.i));
+            jump = (int)fmax(jump, abs(a.i - c.i));
+            jump = (int)fmax(jump, abs(a.d - c.d));
+        }
+    }
+    ok = jump <= 2;
+    printf("  %-4s continuous             largest change %d per speed or distance unit\n", ok ? "ok" : "FAIL", jump);
+    if(!ok) failures++;
+    return failures;
+}
+
+static void Lines(const char *text) {
+    while(*text) Schedule_Char(*text++, true);
+}
+
+static int CheckLoad(void) {
+    ScheduleEntry table[SIZE];
+    int failures = 0;
+    Controller_Init();
+    TestTable(table);
+
+    // A table with a scale out of range is rejected, the active one stays
+    table[5].d = SCHEDULE_SCALE_MAX + 1;
+    ScheduleEntry before = Schedule_Table()[5];
+    _Bool ok = !Schedule_Load(table) && Schedule_Table()[5].d == before.d;
+    table[5].d = 900 - 250 * 2;
+    ok = ok && Schedule_Load(table) && memcmp(Schedule_Table(), table, sizeof(table)) == 0;
+    printf("  %-4s load                   out of range rejected, valid table active\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+
+    // Host lines edit the staged table (a copy of the default) until the empty G line loads it
+    Controller_Init();
+    uint32_t errors = ScheduleErrors;
+    Lines("G,1,2,300,128,700\r\n");
+    ok = Schedule_Table()[1 * SCHEDULE_DISTANCES + 2].p != 300;
+    Lines("W,100,0,0\r\nG\n");
+    const ScheduleEntry *e = &Schedule_Table()[1 * SCHEDULE_DISTANCES + 2];
+    ok = ok && e->p == 300 && e->i == 128 && e->d == 700 && ScheduleErrors == errors;
+    printf("  %-4s lines                  G,1,2,300,128,700 then G: p %d i %d d %d\n", ok ? "ok" : "FAIL", e->p, e->i, e->d);
+    if(!ok) failures++;
+
+    // Bad lines are counted and change nothing
+    static const char *bad[] = {"G,4,0,256,256,256\n", "G,0,3,256,256,256\n", "G,0,0,16,256,256\n", "G,0,0,256,256\n",
+                                "G,0,0,256,256,256,1\n", "G,0,0,256,x,256\n", "G,0,0,256,256,256,256,256,256,256\n"};
+    unsigned int i;
+    errors = ScheduleErrors;
+    for(i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        Lines(bad[i]);
+    }
+    Lines("G\n");
+    ok = ScheduleErrors == errors + sizeof(bad) / sizeof(bad[0]) && memcmp(&Schedule_Table()[0], &ScheduleDefault[0], sizeof(ScheduleEntry)) == 0;
+    printf("  %-4s bad lines              %u of %u counted\n", ok ? "ok" : "FAIL", (unsigned int)(ScheduleErrors - errors),
+           (unsigned int)(sizeof(bad) / sizeof(bad[0])));
+    if(!ok) failures++;
+
+    // In the waypoint mode the stream owns the UART, table lines are dropped without an error
+    Controller_Init();
+    errors = ScheduleErrors;
+    const char *text = "G,1,2,300,128,700\r\nG\n";
+    while(*text) Schedule_Char(*text++, false);
+    ok = memcmp(Schedule_Table(), ScheduleDefault, sizeof(ScheduleDefault)) == 0 && ScheduleErrors == errors;
+    printf("  %-4s waypoint mode          table lines dropped\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+    Controller_Init();
+    return failures;
+}
+
+/* Ball held 200 counts off the center with the integral working, then a table with a quarter of the P and I is
+ *  loaded. The output may only move by the slewed P, the integral increment and rounding per PID period
+ */
+static int CheckBumpless(void) {
+    static const int32_t error = 200;
+    ScheduleEntry low[SIZE];
+    int i;
+    for(i = 0; i < SIZE; i++) {
+        low[i].p = 128;
+        low[i].i = 64;
+        low[i].d = 256;
+    }
+
+    Controller_Init();
+    ScheduleEnabled = true;
+    SeqLock_WritePair(&Setpoint, CenterX, CenterY);
+    SeqLock_WritePair(&Ball, CenterX + error, CenterY + error);
+    Controller_ResetPID();
+
+    int32_t last = 0;
+    int32_t worst = 0;
+    for(i = 0; i < 200; i++) {
+        if(i == 100) Schedule_Load(low);
+        UpdatePIDControllerFixed();
+        int32_t out = (int32_t)currentXDegrees - ServoZeroX;
+        if(i > 100 && abs(out - last) > worst) worst = abs(out - last);
+        last = out;
+    }
+    ScheduleEnabled = SCHEDULE_DEFAULT_ENABLE;
+
+    // 10th of a degree: P slew, I increment at the largest scale, 2 for the truncations
+    double bound = Px * error * SCHEDULE_SLEW / 256.0 / 1000.0 + Ix * error * 512.0 / 256.0 / 5000.0 + 2;
+    double naive = Px * error * (512 - 128) / 256.0 / 1000.0;
+    _Bool ok = worst <= bound;
+    printf("  %-4s table loaded holding    largest output change %d (bound %.1f, %.1f without the slew)\n", ok ? "ok" : "FAIL",
+           worst, bound, naive);
+    return ok ? 0 : 1;
+}
+
+// Error after <from> (ms)
+static double squares;
+static long samples;
+static unsigned long from;
+
+// Table loaded at the start of a run instead of the default, 0 for the default
+static const ScheduleEntry *runTable;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    if(timeMs == 0 && runTable) Schedule_Load(runTable);
+    if(timeMs < from) return;
+    double errX = (double)setX - (plant->p.touchCenterX + Plant_ToCounts(plant->posX));
+    double errY = (double)setY - (plant->p.touchCenterY + Plant_ToCounts(plant->posY));
+    squares += errX * errX + errY * errY;
+    samples++;
+}
+
+typedef struct {
+    Scenario scenario;
+    unsigned long settled;      // Error taken from here on (ms after the event, 0 = the metrics only)
+    double gainRatio;           // Scheduled error over the fixed one it must stay below
+} Case;
+
+static void Run(const Case *c, _Bool schedule, Metrics *m, double *rms) {
+    PlantParams params;
+    Plant_DefaultParams(&params);
+    squares = 0;
+    samples = 0;
+    from = c->scenario.eventTime + c->settled;
+    ScheduleEnabled = schedule;
+    Harness_Run(&c->scenario, &params, m, Trace);
+    ScheduleEnabled = SCHEDULE_DEFAULT_ENABLE;
+    *rms = samples ? sqrt(squares / samples) : 0;
+}
+
+/* The default table against the same table with its center column in every column, the distance axis
+ *  has to pay off where the ball is away from the center and cost nothing at the center
+ */
+static int CheckDistance(const Case *c, double minGain) {
+    ScheduleEntry flat[SIZE];
+    int s, d;
+    for(s = 0; s < SCHEDULE_SPEEDS; s++) {
+        for(d = 0; d < SCHEDULE_DISTANCES; d++) {
+            flat[s * SCHEDULE_DISTANCES + d] = ScheduleDefault[s * SCHEDULE_DISTANCES];
+        }
+    }
+
+    Metrics m;
+    double flatRms, tableRms;
+    runTable = flat;
+    Run(c, true, &m, &flatRms);
+    if(!c->settled) flatRms = m.rmsError;
+    runTable = 0;
+    Run(c, true, &m, &tableRms);
+    if(!c->settled) tableRms = m.rmsError;
+
+    double gain = 100.0 * (1.0 - tableRms / flatRms);
+    _Bool ok = gain >= minGain;
+    printf("  %-4s %-22s rms %6.2f / %6.2f counts  %+4.0f%% (at least %+.0f%%)\n", ok ? "ok" : "FAIL", c->scenario.name,
+           flatRms, tableRms, gain, minGain);
+    return ok ? 0 : 1;
+}
+
+static int CheckPlant(const Case *c) {
+    Metrics fixed, scheduled;
+    double fixedRms, scheduledRms;
+    Run(c, false, &fixed, &fixedRms);
+    Run(c, true, &scheduled, &scheduledRms);
+
+    _Bool ok;
+    if(c->settled) {
+        // Held: the error once settled
+        ok = scheduledRms < c->gainRatio * fixedRms;
+        printf("  %-4s %-22s rms after %4lu ms %6.2f / %6.2f counts\n", ok ? "ok" : "FAIL", c->scenario.name, c->settled,
+               fixedRms, scheduledRms);
+    } else if(c->scenario.kind == SCENARIO_TRACK) {
+        ok = scheduled.rmsError < c->gainRatio * fixed.rmsError;
+        printf("  %-4s %-22s rms %6.1f / %6.1f counts  max %6.1f / %6.1f\n", ok ? "ok" : "FAIL", c->scenario.name,
+               fixed.rmsError, scheduled.rmsError, fixed.maxError, scheduled.maxError);
+    } else {
+        // Steps: no slower and no larger error
+        ok = scheduled.settleMs <= c->gainRatio * fixed.settleMs + PID_UPDATE_RATE && scheduled.rmsError <= c->gainRatio * fixed.rmsError;
+        printf("  %-4s %-22s settle %5.0f / %5.0f ms  rms %6.1f / %6.1f counts\n", ok ? "ok" : "FAIL", c->scenario.name,
+               fixed.settleMs, scheduled.settleMs, fixed.rmsError, scheduled.rmsError);
+    }
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    static const Case cases[] = {
+        {{.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000}, 4000, 0.8},
+        {{.name = "ball_drop", .kind = SCENARIO_STEP, .startX = 500, .startY = -350, .startVX = -300, .startVY = 200, .dropTime = 1500, .duration = 9500}, 6000, 0.8},
+        {{.name = "center_hold_float", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000, .controller = SCENARIO_PID_FLOAT}, 4000, 0.8},
+        {{.name = "circle_rate3", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 3, .eventTime = 2000, .duration = 8000}, 0, 0.8},
+        {{.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000}, 0, 0.8},
+        {{.name = "circle_rate10", .kind = SCENARIO_TRACK, .mode = 4, .circleRate = 10, .eventTime = 2000, .duration = 14000}, 0, 0.8},
+        {{.name = "circle_rate5_float", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000, .controller = SCENARIO_PID_FLOAT}, 0, 0.8},
+        {{.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000}, 0, 1.05},
+        {{.name = "step_minus600", .kind = SCENARIO_STEP, .mode = 2, .eventTime = 3000, .duration = 10000}, 0, 1.05},
+    };
+    int failures = 0;
+    unsigned int i;
+
+    printf("Table lookup\n");
+    failures += CheckLookup();
+
+    printf("\nLoading\n");
+    failures += CheckLoad();
+    failures += CheckBumpless();
+
+    printf("\nSimulated plant (fixed / scheduled gains)\n");
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        failures += CheckPlant(&cases[i]);
+    }
+
+    printf("\nDistance axis (center column everywhere / default table)\n");
+    failures += CheckDistance(&cases[0], 0);
+    failures += CheckDistance(&cases[1], 20);
+    failures += CheckDistance(&cases[5], 5);
+    failures += CheckDistance(&cases[7], 0);
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * seqlock.c
+ *
+ * Sequence lock stress test (runs on a PC)
+ *
+ *  Writer threads stand in for the interrupts and publish pairs and a three word
+ *  configuration through ../seqlock.c as fast as they can, while reader threads copy
+ *  them and check that every copy belongs to one write. The same copies without the
+ *  lock show the torn reads the lock prevents. A last run writes from a timer signal
+ *  that preempts the reading thread, the way an interrupt preempts the main loop.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -pthread -o sim/seqlock sim/seqlock.c seqlock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+#include "../seqlock.h"
+
+#define READERS 3
+#define RUN_MS 1500
+
+// Signal writes every 50 us during the preemption run
+#define SIGNAL_PERIOD_US 50
+
+// The values of one write belong together: y = f(x), configuration words derived from the first
+#define PAIR_Y(x) ((x) * 2654435761u ^ 0xA5A5A5A5u)
+#define CONFIG_I(p) ((p) * 7u + 3u)
+#define CONFIG_D(p) (~(p))
+
+// Controller configuration stand-in (three gains written together)
+typedef struct {
+    SeqLock lock;
+    volatile uint32_t p, i, d;
+} Config;
+
+static SeqLockPair pair = SEQLOCK_PAIR_INIT(0, PAIR_Y(0));
+static Config config = {{0}, 0, CONFIG_I(0), CONFIG_D(0)};
+
+static volatile _Bool running;
+static volatile _Bool useLock;
+static volatile uint32_t lastWritten;
+
+typedef struct {
+    unsigned long reads;
+    unsigned long torn;
+    unsigned long retries;
+} ReaderStats;
+
+static void WriteAll(uint32_t value) {
+    if(useLock) {
+        SeqLock_WritePair(&pair, value, PAIR_Y(value));
+
+        SeqLock_WriteBegin(&config.lock);
+        config.p = value;
+        config.i = CONFIG_I(value);
+        config.d = CONFIG_D(value);
+        SeqLock_WriteEnd(&config.lock);
+    } else {
+        pair.x = value;
+        pair.y = PAIR_Y(value);
+        config.p = value;
+        config.i = CONFIG_I(value);
+        config.d = CONFIG_D(value);
+    }
+    lastWritten = value;
+}
+
+// Copies the pair and the configuration once, counts torn copies
+static void ReadAll(ReaderStats *stats) {
+    uint32_t x, y, p, i, d;
+
+    if(useLock) {
+        SeqLock_ReadPair(&pair, &x, &y);
+
+        uint32_t sequence = SeqLock_ReadBegin(&config.lock);
+        for(;;) {
+            p = config.p;
+            i = config.i;
+            d = config.d;
+            if(!SeqLock_ReadRetry(&config.lock, sequence)) break;
+            stats->retries++;
+            sequence = SeqLock_ReadBegin(&config.lock);
+        }
+    } else {
+        x = pair.x;
+        y = pair.y;
+        p = config.p;
+        i = config.i;
+        d = config.d;
+    }
+
+    if(y != PAIR_Y(x)) stats->torn++;
+    if(i != CONFIG_I(p) || d != CONFIG_D(p)) stats->torn++;
+    stats->reads++;
+}
+
+static void *Writer(void *arg) {
+    uint32_t value = 0;
+    (void)arg;
+    while(running) {
+        WriteAll(++value);
+    }
+    return NULL;
+}
+
+static void *Reader(void *arg) {
+    ReaderStats *stats = arg;
+    while(running) {
+        ReadAll(stats);
+    }
+    return NULL;
+}
+
+static void SleepMs(long ms) {
+    struct timespec t = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&t, NULL);
+}
+
+// One writer thread and READERS reader threads for RUN_MS, returns the summed reader stats
+static ReaderStats RunThreads(_Bool lock) {
+    pthread_t writer, readers[READERS];
+    ReaderStats stats[READERS];
+    ReaderStats total = {0, 0, 0};
+    int i;
+
+    memset(stats, 0, sizeof(stats));
+    useLock = lock;
+    running = true;
+    pthread_create(&writer, NULL, Writer, NULL);
+    for(i = 0; i < READERS; i++) {
+        pthread_create(&readers[i], NULL, Reader, &stats[i]);
+    }
+    SleepMs(RUN_MS);
+    running = false;
+    pthread_join(writer, NULL);
+    for(i = 0; i < READERS; i++) {
+        pthread_join(readers[i], NULL);
+        total.reads += stats[i].reads;
+        total.torn += stats[i].torn;
+        total.retries += stats[i].retries;
+    }
+    return total;
+}
+
+// Timer signal as the interrupt, it preempts the reader and always finishes its write
+static volatile uint32_t signalValue;
+
+static void OnSignal(int sig) {
+    (void)sig;
+    WriteAll(++signalValue);
+}
+
+static ReaderStats RunSignal(void) {
+    ReaderStats stats = {0, 0, 0};
+    struct sigaction action;
+    struct itimerval timer = {{0, SIGNAL_PERIOD_US}, {0, SIGNAL_PERIOD_US}};
+    struct timespec start, now;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = OnSignal;
+    sigaction(SIGALRM, &action, NULL);
+
+    useLock = true;
+    signalValue = lastWritten;
+    setitimer(ITIMER_REAL, &timer, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        ReadAll(&stats);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < RUN_MS);
+
+    struct itimerval off = {{0, 0}, {0, 0}};
+    setitimer(ITIMER_REAL, &off, NULL);
+    return stats;
+}
+
+int main(void) {
+    int failures = 0;
+
+    printf("Sequence lock, %d reader threads against one writer for %d ms\n", READERS, RUN_MS);
+
+    ReaderStats plain = RunThreads(false);
+    printf("  without the lock  %10lu reads  %8lu torn\n", plain.reads, plain.torn);
+
+    ReaderStats locked = RunThreads(true);
+    printf("  with the lock     %10lu reads  %8lu torn  %8lu configuration retries\n", locked.reads, locked.torn,
+           locked.retries);
+
+    _Bool ok = (locked.torn == 0) && (locked.reads > 0);
+    printf("  %-4s every locked copy belongs to one write\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+
+    // Nothing is left half written after the writer stops
+    uint32_t x, y;
+    SeqLock_ReadPair(&pair, &x, &y);
+    ok = (x == lastWritten) && (y == PAIR_Y(x)) && ((pair.lock.sequence & 1) == 0) && ((config.lock.sequence & 1) == 0);
+    printf("  %-4s last write visible, sequences even\n", ok ? "ok" : "FAIL");
+    if(!ok) failures++;
+
+    ReaderStats signal = RunSignal();
+    ok = (signal.torn == 0) && (signal.reads > 0);
+    printf("  %-4s timer signal writer preempting the reader: %lu reads, %lu torn, %lu configuration retries\n",
+           ok ? "ok" : "FAIL", signal.reads, signal.torn, signal.retries);
+    if(!ok) failures++;
+
+    if(plain.torn == 0) {
+        printf("  (no torn reads without the lock in this run, the writer never preempted a copy)\n");
+    }
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
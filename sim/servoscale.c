@@ -0,0 +1,76 @@
+/*
+ * servoscale.c
+ *
+ * Servo pulse width scaling check (runs on a PC)
+ *
+ *  Runs every input code of ServoScale_Ticks() (../servoScale.c) and checks that the
+ *  pulse widths are monotonic, that no PWM tick between the end points is skipped (no
+ *  lost codes), that every 10th of a degree gets its own pulse width and that the
+ *  result stays within rounding of the exact scaling. Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/servoscale sim/servoscale.c servoScale.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "../servoScale.h"
+
+// Largest allowed distance from the exact pulse width (ticks), rounding plus the factor error
+#define MAX_ERROR 0.52
+
+static int Check(const char *name, _Bool ok) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", name);
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    const double exactScale = (double)(SERVO_DUTYCYCLE_END - SERVO_DUTYCYCLE_START) / SERVO_SCALE_MAX;
+    _Bool monotonic = true, noLostCodes = true, tenthsDistinct = true;
+    double maxError = 0, maxErrorOld = 0;
+    uint32_t code;
+
+    uint32_t last = ServoScale_Ticks(0);
+    for(code = 1; code <= SERVO_SCALE_MAX; code++) {
+        uint32_t ticks = ServoScale_Ticks(code);
+        if(ticks < last) monotonic = false;
+        if(ticks > last + 1) noLostCodes = false;
+        last = ticks;
+
+        double error = fabs(ticks - (SERVO_DUTYCYCLE_START + code * exactScale));
+        if(error > maxError) maxError = error;
+
+        if(code % 10 == 0) {
+            if(ServoScale_Ticks(code) == ServoScale_Ticks(code - 10)) tenthsDistinct = false;
+
+            // Previous Servo_Set_Degrees(): truncated whole ticks per degree
+            uint32_t old = SERVO_DUTYCYCLE_START + (code / 10) * ((SERVO_DUTYCYCLE_END - SERVO_DUTYCYCLE_START) / 180) / 10;
+            double errorOld = fabs(old - (SERVO_DUTYCYCLE_START + code * exactScale));
+            if(errorOld > maxErrorOld) maxErrorOld = errorOld;
+        }
+    }
+
+    printf("Servo pulse scaling, %u codes (100th of a degree), %.4f ticks per code\n", SERVO_SCALE_MAX + 1, exactScale);
+    printf("  max error %.3f ticks (truncated scaling: %.1f ticks)\n", maxError, maxErrorOld);
+
+    int failures = 0;
+    failures += Check("end points", ServoScale_Ticks(0) == SERVO_DUTYCYCLE_START && ServoScale_Ticks(SERVO_SCALE_MAX) == SERVO_DUTYCYCLE_END);
+    failures += Check("limited above 180 deg", ServoScale_Ticks(SERVO_SCALE_MAX + 1) == SERVO_DUTYCYCLE_END && ServoScale_Ticks(UINT32_MAX) == SERVO_DUTYCYCLE_END);
+    failures += Check("monotonic", monotonic);
+    failures += Check("no lost codes (every tick reachable)", noLostCodes);
+    failures += Check("every 10th of a degree distinct", tenthsDistinct);
+    failures += Check("within rounding of the exact scaling", maxError <= MAX_ERROR);
+    failures += Check("pulse within the PWM period", SERVO_DUTYCYCLE_END < PWM_PERIOD);
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+ * settle.c
+ *
+ * Touch settle time characterization check (runs on a PC)
+ *
+ *  Runs the passes of ../settle.c on synthetic panels: after a phase switch the ADC
+ *  samples follow an RC curve from the old to the new level (with noise and a ball
+ *  that moves between readings), the presence pins read high once the pull ups charged
+ *  the surface past the input threshold. The probed readings are taken the way
+ *  touch.c takes them. Checks the convergence detection, that the settle times found
+ *  are just above the real ones for a range of time constants, that the readings after
+ *  them are within the tolerance, and how much delay and bias they save.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/settle sim/settle.c settle.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../touchPhase.h"
+#include "../touchConvert.h"
+#include "../settle.h"
+#include "check.h"
+
+// ADC samples of a sequence are this far apart (us, 8x hardware oversampling at 1 Msps)
+#define SAMPLE_US 8.0
+
+// Counts a side of the panel starts from after the phase switch (the old level)
+#define START_COUNTS 4000.0
+
+// Noise of one sample (counts) and ball movement between readings (counts)
+#define NOISE_COUNTS 0.7
+#define BALL_STEP_COUNTS 3.0
+
+// Input high threshold of the presence pins (share of 3V3)
+#define PIN_THRESHOLD 0.65
+
+// Readings in one characterization run
+#define READINGS 2000
+
+static double Noise(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v) * NOISE_COUNTS;
+}
+
+// Panel side charging to <target> with time constant <tau> (us)
+typedef struct {
+    double tau;
+    double target;
+} Panel;
+
+// GetADCValue() starting <t> us after the switch, the sum of TOUCH_SAMPLES samples
+static uint32_t Sequence(const Panel *panel, double t) {
+    double sum = 0;
+    int i;
+    for(i = 0; i < TOUCH_SAMPLES; i++) {
+        double time = t + i * SAMPLE_US;
+        sum += panel->target + (START_COUNTS - panel->target) * exp(-time / panel->tau) + Noise();
+    }
+    return (uint32_t)lround(sum);
+}
+
+// Touch_Read() on the panel, returns the positive side sum that is used
+static uint32_t Read(uint8_t phase, const Panel *panel) {
+    if(Settle_Probing(phase)) {
+        double delay = Settle_ProbeDelay(phase);
+        uint32_t probe = Sequence(panel, delay);
+        uint32_t p = Sequence(panel, delay + TOUCH_SAMPLES * SAMPLE_US + (Settle_MaxUs(phase) - delay));
+        Settle_Add(phase, probe, p);
+        return p;
+    }
+    return Sequence(panel, SettleTimeUs[phase]);
+}
+
+// Pin level of the presence check <t> us after the switch, pull ups charging with <tau>
+static uint8_t Pins(double tau, double t, _Bool touched) {
+    if(touched) return 0;
+    return (1.0 - exp(-t / tau)) > PIN_THRESHOLD ? (TOUCH_XP | TOUCH_XM) : 0;
+}
+
+// Touch_Present() on the panel, probes only after a check without touch like touch.c
+static _Bool lastPresent = false;
+
+static _Bool Present(double tau, _Bool touched) {
+    _Bool probing = Settle_Probing(TOUCH_PHASE_PRESENT) && !lastPresent;
+    uint8_t probe = 0;
+    double t = SettleTimeUs[TOUCH_PHASE_PRESENT];
+    if(probing) {
+        probe = Pins(tau, Settle_ProbeDelay(TOUCH_PHASE_PRESENT), touched);
+        t = Settle_MaxUs(TOUCH_PHASE_PRESENT);
+    }
+    uint8_t read = Pins(tau, t, touched);
+    _Bool output = read != (TOUCH_XP | TOUCH_XM);
+    if(probing && !output) {
+        Settle_Add(TOUCH_PHASE_PRESENT, probe, read);
+    }
+    lastPresent = output;
+    return output;
+}
+
+// First time (us, 0.1 steps) a sequence started at is within <tolerance> of the settled sum, noise free
+static double TrueSettle(double tau, double target, uint32_t tolerance) {
+    double t;
+    for(t = 0; t < 10000; t += 0.1) {
+        double error = 0;
+        int i;
+        for(i = 0; i < TOUCH_SAMPLES; i++) {
+            error += (START_COUNTS - target) * exp(-(t + i * SAMPLE_US) / tau);
+        }
+        if(fabs(error) <= tolerance) return t;
+    }
+    return t;
+}
+
+static void CheckDetection(void) {
+    uint32_t errors[SETTLE_STEPS];
+    int i;
+
+    printf("Convergence detection\n");
+    for(i = 0; i < SETTLE_STEPS; i++) errors[i] = 0;
+    Check(Settle_Converged(errors, SETTLE_STEPS, 5) == 0, "settled from the first probe");
+    for(i = 0; i < SETTLE_STEPS; i++) errors[i] = i < 6 ? 100 - i : 2;
+    Check(Settle_Converged(errors, SETTLE_STEPS, 5) == 6, "first step of the settled run");
+    errors[10] = 9;
+    Check(Settle_Converged(errors, SETTLE_STEPS, 5) == 11, "an outlier inside the run moves it back");
+    errors[SETTLE_STEPS - 1] = 9;
+    Check(Settle_Converged(errors, SETTLE_STEPS, 5) == -1, "not settled at the last probe");
+
+    Check(Settle_Time(-1, 150) == 150, "not settled waits the maximum");
+    Check(Settle_Time(0, 150) == 0, "settled at once doesn't wait");
+    Check(Settle_Time(4, 150) == 40 + 10, "step time plus SETTLE_MARGIN_PERCENT");
+    Check(Settle_Time(SETTLE_STEPS - 1, 150) == 150, "limited to the maximum");
+}
+
+// Characterizes a read phase on a panel with <tau>, returns the settle time found
+static uint16_t RunRead(double tau, double *biasBefore, double *biasAfter) {
+    Panel panel = {tau, 1800};
+    double before = 0, after = 0;
+    int n;
+
+    Settle_Init();
+    for(n = 0; n < READINGS && Settle_Probing(TOUCH_PHASE_READ_X); n++) {
+        panel.target = 1800 + BALL_STEP_COUNTS * (n % 200 - 100);
+        Read(TOUCH_PHASE_READ_X, &panel);
+    }
+
+    // Error of the first sequence after the default and the characterized settle time (noise free)
+    Panel clean = {tau, 1800};
+    for(n = 0; n < TOUCH_SAMPLES; n++) {
+        before += (START_COUNTS - clean.target) * exp(-(SETTLE_DEFAULT_READ_US + n * SAMPLE_US) / tau);
+        after += (START_COUNTS - clean.target) * exp(-(SettleTimeUs[TOUCH_PHASE_READ_X] + n * SAMPLE_US) / tau);
+    }
+    *biasBefore = before / (2 * TOUCH_SAMPLES);
+    *biasAfter = after / (2 * TOUCH_SAMPLES);
+    return SettleTimeUs[TOUCH_PHASE_READ_X];
+}
+
+static void CheckRead(void) {
+    static const double taus[] = {0.5, 2, 5, 10, 15, 20};
+    uint32_t tolerance = SETTLE_TOLERANCE * TOUCH_SAMPLES;
+    double step = (double)SETTLE_READ_MAX_US / (SETTLE_STEPS - 1);
+    unsigned int i;
+    long low = 0, high = 0, biased = 0;
+
+    printf("\nRead phases (tolerance %d counts, probe step %.0f us)\n", SETTLE_TOLERANCE, step);
+    printf("  %8s %10s %10s %18s\n", "tau (us)", "real (us)", "found (us)", "bias before/after");
+    for(i = 0; i < sizeof(taus) / sizeof(taus[0]); i++) {
+        double before, after;
+        double real = TrueSettle(taus[i], 1800, tolerance);
+        uint16_t found = RunRead(taus[i], &before, &after);
+        printf("  %8.1f %10.1f %10u %8.1f / %5.2f counts\n", taus[i], real, found, before, after);
+
+        // At least the real settle time less the noise allowance, at most a step and the margin above it
+        low += found + step < real;
+        high += found > (real + step) * (100 + SETTLE_MARGIN_PERCENT) / 100 + 1;
+        biased += fabs(after) * 2 * TOUCH_SAMPLES > tolerance;
+    }
+    Check(low == 0, "settle times not below the real ones (within a probe step)");
+    Check(high == 0, "settle times at most a probe step and the margin above the real ones");
+    Check(biased == 0, "readings after the settle time within the tolerance");
+
+    double before, after;
+    Check(RunRead(1000, &before, &after) == SETTLE_READ_MAX_US, "a panel that doesn't settle gets the maximum");
+}
+
+static uint16_t RunPresent(double tau, double touchShare) {
+    int n;
+    Settle_Init();
+    lastPresent = false;
+    for(n = 0; n < READINGS && Settle_Probing(TOUCH_PHASE_PRESENT); n++) {
+        Present(tau, rand() < touchShare * RAND_MAX);
+    }
+    return SettleTimeUs[TOUCH_PHASE_PRESENT];
+}
+
+static void CheckPresent(void) {
+    static const double taus[] = {10, 30, 60, 100, 200};
+    double step = (double)SETTLE_PRESENT_MAX_US / (SETTLE_STEPS - 1);
+    unsigned int i;
+    long low = 0, high = 0, touched = 0;
+
+    printf("\nPresence phase (probe step %.0f us, old wait %d us)\n", step, SETTLE_DEFAULT_PRESENT_US);
+    printf("  %8s %10s %10s %14s\n", "tau (us)", "real (us)", "found (us)", "with touches");
+    for(i = 0; i < sizeof(taus) / sizeof(taus[0]); i++) {
+        double real = -taus[i] * log(1.0 - PIN_THRESHOLD);
+        uint16_t found = RunPresent(taus[i], 0);
+        uint16_t foundTouched = RunPresent(taus[i], 0.5);
+        printf("  %8.0f %10.1f %10u %14u\n", taus[i], real, found, foundTouched);
+
+        low += found < real;
+        high += found > (real + step) * (100 + SETTLE_MARGIN_PERCENT) / 100 + 1;
+        touched += foundTouched != found;
+    }
+    Check(low == 0, "pins read high after the settle time");
+    Check(high == 0, "settle times at most a probe step and the margin above the real ones");
+    Check(touched == 0, "checks that found a touch don't count");
+
+    // Pins that never read high look like a touch to the check, nothing to probe
+    Check(RunPresent(5000, 0) == SETTLE_DEFAULT_PRESENT_US && Settle_Probing(TOUCH_PHASE_PRESENT),
+          "pull ups that never charge keep the default, the pass waits");
+}
+
+static void CheckPeriodic(void) {
+    Panel panel = {5, 1800};
+    int n;
+
+    printf("\nPeriodic passes\n");
+    Settle_Init();
+    for(n = 0; n < READINGS; n++) Read(TOUCH_PHASE_READ_X, &panel);
+    uint16_t first = SettleTimeUs[TOUCH_PHASE_READ_X];
+
+    // The panel slows down, the next pass finds it
+    panel.tau = 15;
+    Settle_Update(SETTLE_PERIOD_MS - 1);
+    Check(!Settle_Probing(TOUCH_PHASE_READ_X), "no pass before SETTLE_PERIOD_MS");
+    Settle_Update(SETTLE_PERIOD_MS);
+    Check(Settle_Probing(TOUCH_PHASE_READ_X), "a pass starts after SETTLE_PERIOD_MS");
+    for(n = 0; n < READINGS; n++) Read(TOUCH_PHASE_READ_X, &panel);
+    Check(SettleTimeUs[TOUCH_PHASE_READ_X] > first, "the settle time follows a slower panel");
+
+    SettleEnabled = false;
+    Settle_Init();
+    Check(!Settle_Probing(TOUCH_PHASE_READ_X) && SettleTimeUs[TOUCH_PHASE_PRESENT] == SETTLE_DEFAULT_PRESENT_US,
+          "disabled: defaults, no probes");
+    SettleEnabled = SETTLE_DEFAULT_ENABLE;
+}
+
+int main(void) {
+    srand(1);
+    CheckDetection();
+    CheckRead();
+    CheckPresent();
+    CheckPeriodic();
+
+    return Check_Result();
+}
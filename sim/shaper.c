@@ -0,0 +1,265 @@
+/*
+ * shaper.c
+ *
+ * Servo command shaping check (runs on a PC)
+ *
+ *  Feeds steps and random target sequences through Shaper_Update() (../shaper.c) with
+ *  each stage and checks that the output reaches the target exactly, that limited
+ *  moves don't overshoot and that the rate, acceleration and jerk limits hold. The
+ *  running average is compared with a plain average of the last outputs. Then runs
+ *  the simulated plant with every preset and prints the response next to the servo
+ *  travel and direction reversals (chatter). Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/shaper sim/shaper.c sim/harness.c sim/plant.c controller.c predictor.c lqr.c autotune.c circle.c shaper.c notch.c disturbance.c schedule.c seqlock.c loss.c reference.c boot.c level.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../controller.h"
+#include "../shaper.h"
+#include "harness.h"
+
+// Outputs given to reach a step target
+#define STEP_OUTPUTS 60
+#define RANDOM_OUTPUTS 5000
+
+typedef struct {
+    const char *name;
+    uint8_t filter;
+    int32_t slew;
+    int32_t accel;
+    int32_t jerk;
+} Preset;
+
+static const Preset presets[] = {
+    // name                 filter                  slew  accel jerk
+    {"off",                 SHAPER_FILTER_NONE,     0,    0,    0},
+    {"average",             SHAPER_FILTER_AVERAGE,  0,    0,    0},
+    {"biquad",              SHAPER_FILTER_BIQUAD,   0,    0,    0},
+    {"slew40",              SHAPER_FILTER_NONE,     40,   0,    0},
+    {"accel10",             SHAPER_FILTER_NONE,     0,    10,   0},
+    {"slew40_accel10",      SHAPER_FILTER_NONE,     40,   10,   0},
+    {"slew40_accel10_jerk3",SHAPER_FILTER_NONE,     40,   10,   3},
+    {"biquad_all",          SHAPER_FILTER_BIQUAD,   40,   20,   5},
+};
+
+#define PRESET_COUNT (sizeof(presets) / sizeof(presets[0]))
+
+static void Apply(const Preset *p) {
+    ShaperFilter = p->filter;
+    ShaperSlew = p->slew;
+    ShaperAccel = p->accel;
+    ShaperJerk = p->jerk;
+}
+
+// Worst moves of an output sequence
+typedef struct {
+    int32_t rate, accel, jerk;
+    int32_t last[3];
+    int count;
+} Moves;
+
+static void Moves_Add(Moves *m, int32_t output) {
+    if(m->count >= 1) {
+        int32_t rate = output - m->last[0];
+        if(Abs(rate) > m->rate) m->rate = Abs(rate);
+        if(m->count >= 2) {
+            int32_t accel = rate - (m->last[0] - m->last[1]);
+            if(Abs(accel) > m->accel) m->accel = Abs(accel);
+            if(m->count >= 3) {
+                int32_t jerk = accel - ((m->last[0] - m->last[1]) - (m->last[1] - m->last[2]));
+                if(Abs(jerk) > m->jerk) m->jerk = Abs(jerk);
+            }
+        }
+    }
+    m->last[2] = m->last[1];
+    m->last[1] = m->last[0];
+    m->last[0] = output;
+    m->count++;
+}
+
+// Limits hold within the rounding of the output (the jerk limit is raised to 2 * accel / SHAPER_RAMP_SAMPLES)
+static _Bool Moves_Within(const Moves *m, const Preset *p) {
+    int32_t jerk = p->jerk;
+    if(jerk > 0 && jerk * SHAPER_RAMP_SAMPLES < 2 * p->accel) jerk = (2 * p->accel + SHAPER_RAMP_SAMPLES - 1) / SHAPER_RAMP_SAMPLES;
+
+    if(p->filter != SHAPER_FILTER_NONE && p->slew == 0 && p->accel == 0) return true;
+    if(p->slew > 0 && m->rate > p->slew + 1) return false;
+    if(p->accel > 0 && m->accel > p->accel + 2) return false;
+    if(p->accel > 0 && jerk > 0 && m->jerk > jerk + 4) return false;
+    return true;
+}
+
+static int CheckSteps(const Preset *p) {
+    static const int32_t steps[] = {300, -350, 7, -1, 650};
+    int failures = 0;
+    unsigned int i;
+
+    Apply(p);
+    for(i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        int32_t start = (steps[i] == 650) ? -300 : 0;
+        int32_t target = start + steps[i];
+        ShaperAxis s;
+        Shaper_Reset(&s, start);
+
+        Moves m = {0};
+        Moves_Add(&m, start);
+        int32_t overshoot = 0;
+        int reached = -1;
+        int n;
+        for(n = 0; n < STEP_OUTPUTS; n++) {
+            int32_t output = Shaper_Update(&s, target);
+            Moves_Add(&m, output);
+            int32_t past = (steps[i] > 0) ? output - target : target - output;
+            if(past > overshoot) overshoot = past;
+            if(output == target && reached < 0) reached = n + 1;
+            if(output != target) reached = -1;
+        }
+
+        // Only the filters may ring, the limiter brakes ahead of the target
+        _Bool limited = (p->slew > 0 || p->accel > 0);
+        _Bool ok = (reached > 0) && Moves_Within(&m, p) && (!limited || p->filter != SHAPER_FILTER_NONE || overshoot == 0);
+        printf("  %-4s %-22s step %5d  settled after %3d outputs (%4d ms)  overshoot %3d  max rate %3d accel %3d jerk %3d\n",
+               ok ? "ok" : "FAIL", p->name, steps[i], reached, reached * PID_UPDATE_RATE, overshoot, m.rate, m.accel, m.jerk);
+        if(!ok) failures++;
+    }
+    return failures;
+}
+
+// Targets jump around like a noisy controller output, the limits still hold and the output ends on the last target
+static int CheckRandom(const Preset *p) {
+    ShaperAxis s;
+    Moves m = {0};
+    int32_t window[SHAPER_AVERAGE_SAMPLES] = {0};
+    double averageError = 0;
+    int32_t target = 0;
+    int n;
+
+    Apply(p);
+    Shaper_Reset(&s, 0);
+    Moves_Add(&m, 0);
+    srand(7);
+    for(n = 0; n < RANDOM_OUTPUTS; n++) {
+        if(rand() % 4 == 0) target = rand() % 601 - 300;
+        int32_t input = target + rand() % 21 - 10;
+        int32_t output = Shaper_Update(&s, input);
+        Moves_Add(&m, output);
+
+        window[n % SHAPER_AVERAGE_SAMPLES] = input;
+        if(p->filter == SHAPER_FILTER_AVERAGE && p->slew == 0 && p->accel == 0) {
+            double average = 0;
+            int i;
+            for(i = 0; i < SHAPER_AVERAGE_SAMPLES; i++) average += window[i];
+            average /= SHAPER_AVERAGE_SAMPLES;
+            if(fabs(output - average) > averageError) averageError = fabs(output - average);
+        }
+    }
+
+    int32_t output = 0;
+    for(n = 0; n < STEP_OUTPUTS; n++) {
+        output = Shaper_Update(&s, target);
+        Moves_Add(&m, output);
+    }
+
+    _Bool ok = Moves_Within(&m, p) && output == target && averageError <= 0.5 + 1.0 / (1 << SHAPER_SHIFT);
+    printf("  %-4s %-22s random targets   max rate %3d accel %3d jerk %3d  final %4d (%4d)", ok ? "ok" : "FAIL", p->name,
+           m.rate, m.accel, m.jerk, output, target);
+    if(p->filter == SHAPER_FILTER_AVERAGE && p->slew == 0 && p->accel == 0) printf("  average error %.3f", averageError);
+    printf("\n");
+    return ok ? 0 : 1;
+}
+
+// Servo travel and direction reversals of the latched commands
+static double travel;
+static long reversals;
+static double lastX, lastY, lastMoveX, lastMoveY;
+
+static void Trace(unsigned long timeMs, const Plant *plant, uint32_t setX, uint32_t setY) {
+    (void)setX;
+    (void)setY;
+    if(timeMs == 0) {
+        lastX = plant->latchedX;
+        lastY = plant->latchedY;
+        lastMoveX = lastMoveY = 0;
+        return;
+    }
+
+    double moveX = plant->latchedX - lastX;
+    double moveY = plant->latchedY - lastY;
+    if(moveX != 0) {
+        travel += fabs(moveX);
+        if(moveX * lastMoveX < 0) reversals++;
+        lastMoveX = moveX;
+    }
+    if(moveY != 0) {
+        travel += fabs(moveY);
+        if(moveY * lastMoveY < 0) reversals++;
+        lastMoveY = moveY;
+    }
+    lastX = plant->latchedX;
+    lastY = plant->latchedY;
+}
+
+static void ComparePlant(void) {
+    static const Scenario scenarios[] = {
+        {.name = "center_hold", .kind = SCENARIO_STEP, .startX = 150, .startY = -120, .duration = 8000},
+        {.name = "step_plus600", .kind = SCENARIO_STEP, .mode = 1, .eventTime = 3000, .duration = 10000},
+        {.name = "circle_rate5", .kind = SCENARIO_TRACK, .mode = 3, .circleRate = 5, .eventTime = 2000, .duration = 10000},
+    };
+    PlantParams params;
+    Plant_DefaultParams(&params);
+
+    printf("\nPID on the simulated plant\n");
+    printf("  %-22s %-14s %10s  %12s  %10s  %12s  %14s\n", "preset", "scenario", "settle(ms)", "overshoot(%)", "rms(counts)",
+           "travel(deg/s)", "reversals(1/s)");
+
+    unsigned int i, j;
+    for(i = 0; i < PRESET_COUNT; i++) {
+        for(j = 0; j < sizeof(scenarios) / sizeof(scenarios[0]); j++) {
+            Metrics m;
+            travel = 0;
+            reversals = 0;
+            Apply(&presets[i]);
+            Harness_Run(&scenarios[j], &params, &m, Trace);
+
+            double seconds = scenarios[j].duration / 1000.0;
+            printf("  %-22s %-14s %10.0f  %12.1f  %10.1f  %12.1f  %14.1f\n", (j == 0) ? presets[i].name : "", scenarios[j].name,
+                   m.settleMs, m.overshootPct, m.rmsError, travel / 10.0 / seconds, reversals / seconds);
+        }
+    }
+}
+
+int main(void) {
+    int failures = 0;
+    unsigned int i;
+
+    printf("Command shaping step response\n");
+    for(i = 0; i < PRESET_COUNT; i++) {
+        failures += CheckSteps(&presets[i]);
+    }
+    printf("\nCommand shaping with random targets\n");
+    for(i = 0; i < PRESET_COUNT; i++) {
+        failures += CheckRandom(&presets[i]);
+    }
+
+    ComparePlant();
+
+    ShaperFilter = SHAPER_DEFAULT_FILTER;
+    ShaperSlew = SHAPER_DEFAULT_SLEW;
+    ShaperAccel = SHAPER_DEFAULT_ACCEL;
+    ShaperJerk = SHAPER_DEFAULT_JERK;
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * supervisor.c
+ *
+ * Supervision check (runs on a PC)
+ *
+ *  Captures fault records with ../supervisor.c and checks that they validate,
+ *  that any flipped bit, a power-on RAM pattern and another version don't, and
+ *  the report line. Then runs the restart decisions for each reset cause, a
+ *  fault loop that has to fall back to a cold start, and the restart count that
+ *  is forgotten after a stable run. Last it runs the watchdog feeding on the
+ *  SysTick schedule (PID period every 40 ms, deadline at the servo frame start)
+ *  with a main loop that is on time, late now and then, late in a row and hung,
+ *  and checks when the watchdog times out.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/supervisor sim/supervisor.c supervisor.c controller.c predictor.c shaper.c notch.c disturbance.c schedule.c seqlock.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "../controller.h"
+#include "../supervisor.h"
+
+#define RUN_MS 20000
+
+static const uint32_t frame[SUPERVISOR_REGISTERS] = {
+    0x11, 0x22, 0x33, 0x44, 0x1212, 0x00001A3F, 0x00002B40, 0x21000003
+};
+
+static SupervisorState TestState(void) {
+    SupervisorState state;
+    CenterX = 2010;
+    CenterY = 1985;
+    ServoZeroX = 1230;
+    ServoZeroY = 1190;
+    currentXDegrees = 1250;
+    currentYDegrees = 1170;
+    Supervisor_Save(&state, 3, true);
+    return state;
+}
+
+static int Check(const char *name, _Bool ok) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", name);
+    return ok ? 0 : 1;
+}
+
+static int CheckRecord(void) {
+    int failures = 0;
+    SupervisorRecord record;
+    SupervisorState state = TestState();
+
+    memset(&record, 0, sizeof(record));
+    failures += Check("zeroed RAM is no record", !Supervisor_Valid(&record));
+
+    srand(5);
+    uint8_t *bytes = (uint8_t *)&record;
+    unsigned int i, bit;
+    int accepted = 0;
+    for(i = 0; i < 1000; i++) {
+        unsigned int j;
+        for(j = 0; j < sizeof(record); j++) bytes[j] = rand();
+        if(i & 1) record.magic = SUPERVISOR_MAGIC;
+        if(Supervisor_Valid(&record)) accepted++;
+    }
+    failures += Check("random RAM is no record", accepted == 0);
+
+    memset(&record, 0xA5, sizeof(record));
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_BUS, frame, 0x8200, 0x40000000, 0x4000C018, 1234, &state);
+    failures += Check("captured record is valid", Supervisor_Valid(&record) && record.pending && record.restarts == 0);
+    failures += Check("registers and state kept", memcmp(record.registers, frame, sizeof(frame)) == 0 &&
+                      record.state.centerX == 2010 && record.state.zeroY == 1190 && record.state.px == Px &&
+                      record.state.dy == Dy && record.state.degreesX == 1250 && record.state.mode == 3 && record.state.running);
+
+    int missed = 0;
+    for(i = 0; i < offsetof(SupervisorRecord, check) + sizeof(record.check); i++) {
+        for(bit = 0; bit < 8; bit++) {
+            bytes[i] ^= 1 << bit;
+            if(Supervisor_Valid(&record)) missed++;
+            bytes[i] ^= 1 << bit;
+        }
+    }
+    failures += Check("every flipped bit detected", missed == 0 && Supervisor_Valid(&record));
+
+    SupervisorRecord other = record;
+    other.version = SUPERVISOR_VERSION + 1;
+    other.check = Supervisor_Check(&other);
+    failures += Check("other version rejected", !Supervisor_Valid(&other));
+
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_HARD, 0, 0, 0, 0, 5, &state);
+    failures += Check("unreadable stack gives zeros", Supervisor_Valid(&record) && record.registers[SUPERVISOR_PC] == 0 &&
+                      record.registers[SUPERVISOR_R0] == 0 && record.cause == SUPERVISOR_CAUSE_HARD);
+
+    record.restarts = 2;
+    record.check = Supervisor_Check(&record);
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_USAGE, frame, 0, 0, 0, 9, &state);
+    failures += Check("restart count carried over", record.restarts == 2);
+    return failures;
+}
+
+static int CheckReport(void) {
+    int failures = 0;
+    SupervisorRecord record;
+    SupervisorState state = TestState();
+    char line[SUPERVISOR_REPORT_SIZE + 1];
+    const char *expected = "FAULT,5,W,0,1234,2B40,1A3F,21000003,8200,40000000,4000C018,3\r\n";
+
+    memset(&record, 0, sizeof(record));
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_BUS, frame, 0x8200, 0x40000000, 0x4000C018, 1234, &state);
+    uint8_t length = Supervisor_Report(line, &record, SUPERVISOR_WARM);
+    line[length] = '\0';
+    printf("    %s", line);
+    failures += Check("report line", length == strlen(expected) && strcmp(line, expected) == 0);
+
+    uint32_t all[SUPERVISOR_REGISTERS];
+    memset(all, 0xFF, sizeof(all));
+    state.mode = 255;
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_INTERRUPT, all, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, &state);
+    record.restarts = 255;
+    record.check = Supervisor_Check(&record);
+    length = Supervisor_Report(line, &record, SUPERVISOR_COLD);
+    failures += Check("longest line fits", length > 0 && length <= SUPERVISOR_REPORT_SIZE);
+
+    Supervisor_Restart(&record, SUPERVISOR_COLD);
+    failures += Check("no report once handled", Supervisor_Report(line, &record, SUPERVISOR_COLD) == 0);
+    return failures;
+}
+
+static int CheckDecisions(void) {
+    int failures = 0;
+    SupervisorRecord record;
+    SupervisorState state = TestState();
+
+    memset(&record, 0, sizeof(record));
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_WATCHDOG, frame, 0, 0, 0, 800, &state);
+    failures += Check("watchdog reset restarts warm", Supervisor_Decide(&record, SUPERVISOR_RESET_WATCHDOG) == SUPERVISOR_WARM);
+    failures += Check("fault handler reset restarts warm", Supervisor_Decide(&record, SUPERVISOR_RESET_SOFTWARE) == SUPERVISOR_WARM);
+    failures += Check("power-on starts cold", Supervisor_Decide(&record, SUPERVISOR_RESET_POWER) == SUPERVISOR_COLD);
+    failures += Check("reset button starts cold", Supervisor_Decide(&record, SUPERVISOR_RESET_PIN) == SUPERVISOR_COLD);
+
+    SupervisorRecord broken = record;
+    broken.registers[SUPERVISOR_PC] ^= 4;
+    failures += Check("broken record starts cold", Supervisor_Decide(&broken, SUPERVISOR_RESET_WATCHDOG) == SUPERVISOR_COLD);
+
+    state.running = false;
+    SupervisorRecord setup;
+    memset(&setup, 0, sizeof(setup));
+    Supervisor_Capture(&setup, SUPERVISOR_CAUSE_HARD, frame, 0, 0, 0, 3, &state);
+    failures += Check("fault in Setup() starts cold", Supervisor_Decide(&setup, SUPERVISOR_RESET_SOFTWARE) == SUPERVISOR_COLD);
+
+    // The same fault over and over: warm MAX_RESTARTS times, then cold, then warm again
+    state.running = true;
+    memset(&record, 0, sizeof(record));
+    char decisions[16] = "";
+    int i;
+    for(i = 0; i < SUPERVISOR_MAX_RESTARTS + 3; i++) {
+        Supervisor_Capture(&record, SUPERVISOR_CAUSE_WATCHDOG, frame, 0, 0, 0, 500, &state);
+        uint8_t decision = Supervisor_Decide(&record, SUPERVISOR_RESET_WATCHDOG);
+        decisions[i] = (decision == SUPERVISOR_WARM) ? 'W' : 'C';
+        Supervisor_Restart(&record, decision);
+    }
+    decisions[i] = '\0';
+    printf("    fault loop: %s\n", decisions);
+    failures += Check("fault loop falls back to cold", strcmp(decisions, "WWWCWW") == 0);
+
+    // A warm restart is kept as long as the fault came back before a stable run, then not pending anymore
+    memset(&record, 0, sizeof(record));
+    Supervisor_Capture(&record, SUPERVISOR_CAUSE_WATCHDOG, frame, 0, 0, 0, 500, &state);
+    Supervisor_Restart(&record, SUPERVISOR_WARM);
+    failures += Check("handled record starts cold", Supervisor_Valid(&record) && record.restarts == 1 &&
+                      Supervisor_Decide(&record, SUPERVISOR_RESET_PIN) == SUPERVISOR_COLD &&
+                      Supervisor_Decide(&record, SUPERVISOR_RESET_WATCHDOG) == SUPERVISOR_COLD);
+
+    // Forgotten by the supervision after a stable run, the next fault counts from 0
+    SupervisorFault = record;
+    Supervisor_Start();
+    Supervisor_Period(SUPERVISOR_STABLE - 40);
+    _Bool kept = Supervisor_Valid(&SupervisorFault);
+    Supervisor_Period(SUPERVISOR_STABLE);
+    Supervisor_Capture(&SupervisorFault, SUPERVISOR_CAUSE_HARD, frame, 0, 0, 0, 20000, &state);
+    failures += Check("restarts forgotten after a stable run", kept && SupervisorFault.restarts == 0);
+    return failures;
+}
+
+static int CheckRestore(void) {
+    SupervisorState state = TestState();
+    int32_t px = Px;
+    CenterX = CenterY = 0;
+    ServoZeroX = ServoZeroY = 0;
+    Px = 1;
+    Supervisor_Restore(&state);
+    return Check("state restored", CenterX == 2010 && CenterY == 1985 && ServoZeroX == 1230 && ServoZeroY == 1190 && Px == px);
+}
+
+/* Runs the SysTick schedule for RUN_MS with a main loop that finishes the period k at <finish>(k) ms into it
+ *  (-1 never), or hangs from <hang> ms (0 never). Returns the time the watchdog timed out (0 never),
+ *  the missed periods in <missed>
+ */
+static unsigned long Watchdog(int (*finish)(uint32_t k), unsigned long hang, uint32_t *missed) {
+    unsigned long t;
+    unsigned long expiry = SUPERVISOR_TIMEOUT;
+    unsigned long periodStart = 0;
+    uint32_t token = 0;
+    int due = -1;
+
+    Supervisor_Start();
+    for(t = 1; t <= RUN_MS; t++) {
+        // SysTick, periods 2 ms before the frame starts
+        if(((t + SERVO_UPDATE_LEAD) % PID_UPDATE_RATE) == 0) {
+            if(Supervisor_Period(t)) expiry = t + SUPERVISOR_TIMEOUT;
+            periodStart = t;
+            token = Supervisor_Token();
+            due = finish(token);
+        }
+        if(t >= expiry) {
+            *missed = SupervisorMissed;
+            return t;
+        }
+
+        // Main loop pass of this ms
+        if(hang && t >= hang) continue;
+        if(due >= 0 && t >= periodStart + due) {
+            Supervisor_Done(token, t);
+            due = -1;
+        }
+    }
+    *missed = SupervisorMissed;
+    return 0;
+}
+
+static int OnTime(uint32_t k) { (void)k; return 1; }
+static int AtDeadline(uint32_t k) { (void)k; return SUPERVISOR_DEADLINE; }
+static int LateSometimes(uint32_t k) { return (k % 7 == 0 || k % 7 == 1) ? SUPERVISOR_DEADLINE + 1 : 1; }
+static int LateInARow(uint32_t k) { return (k >= 100 && k < 103) ? SUPERVISOR_DEADLINE + 5 : 1; }
+static int LateTwice(uint32_t k) { return (k >= 100 && k < 102) ? -1 : 1; }
+
+static int CheckWatchdog(void) {
+    int failures = 0;
+    uint32_t missed;
+    unsigned long t;
+    char name[64];
+
+    t = Watchdog(OnTime, 0, &missed);
+    failures += Check("on time, never times out", t == 0 && missed == 0);
+
+    t = Watchdog(AtDeadline, 0, &missed);
+    failures += Check("at the deadline still counts", t == 0 && missed == 0);
+
+    t = Watchdog(LateSometimes, 0, &missed);
+    snprintf(name, sizeof(name), "2 of 7 late, %u missed, no timeout", missed);
+    failures += Check(name, t == 0 && missed > 0);
+
+    t = Watchdog(LateTwice, 0, &missed);
+    failures += Check("2 missing in a row, no timeout", t == 0 && missed == 2);
+
+    t = Watchdog(LateInARow, 0, &missed);
+    unsigned long lateStart = 100 * PID_UPDATE_RATE - SERVO_UPDATE_LEAD;
+    snprintf(name, sizeof(name), "3 late in a row, timeout %lu ms after", t - lateStart);
+    failures += Check(name, t > 0 && t - lateStart <= SUPERVISOR_TIMEOUT + PID_UPDATE_RATE);
+
+    t = Watchdog(OnTime, 5001, &missed);
+    snprintf(name, sizeof(name), "hung main loop, timeout %lu ms after", t - 5001);
+    failures += Check(name, t > 5001 && t - 5001 <= SUPERVISOR_TIMEOUT + PID_UPDATE_RATE);
+
+    // Check-in with the token of the period before doesn't count for the new one
+    Supervisor_Start();
+    Supervisor_Period(38);
+    uint32_t stale = Supervisor_Token();
+    Supervisor_Period(78);
+    Supervisor_Done(stale, 78);
+    _Bool early = !Supervisor_Period(118);
+    Supervisor_Done(Supervisor_Token(), 118 + SUPERVISOR_DEADLINE + 1);
+    _Bool late = !Supervisor_Period(158);
+    failures += Check("stale and late check-ins don't feed", early && late);
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+
+    printf("Fault record\n");
+    failures += CheckRecord();
+    failures += CheckReport();
+
+    printf("\nRestart decisions\n");
+    failures += CheckDecisions();
+    failures += CheckRestore();
+
+    printf("\nWatchdog feeding\n");
+    failures += CheckWatchdog();
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
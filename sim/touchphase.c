@@ -0,0 +1,381 @@
+/*
+ * touchphase.c
+ *
+ * Touch panel phase snapshot check (runs on a PC)
+ *
+ *  Models the port D pad registers (with the hardware rules: setting a drive strength
+ *  clears the other two, pull up and pull down exclude each other, data writes only
+ *  reach output pins) and the driverlib GPIO calls on them as TivaWare implements
+ *  them. Runs the driverlib sequences the touch driver used for every phase change,
+ *  from every phase and with random settings of the other port D pins, and requires
+ *  the writes of ../touchPhase.c to leave all registers the same. Then counts the
+ *  register accesses and calls of both per phase change and per UpdateBallPosition().
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/touchphase sim/touchphase.c touchPhase.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../touchPhase.h"
+#include "check.h"
+
+#define RANDOM_PORTS 1000
+#define RANDOM_CHANGES 100
+
+// driverlib/gpio.h
+#define GPIO_DIR_MODE_IN 0x00000000
+#define GPIO_DIR_MODE_OUT 0x00000001
+#define GPIO_STRENGTH_2MA 0x00000001
+#define GPIO_STRENGTH_6MA 0x00000065
+#define GPIO_PIN_TYPE_STD 0x00000008
+#define GPIO_PIN_TYPE_STD_WPU 0x0000000A
+#define GPIO_PIN_TYPE_ANALOG 0x00000000
+
+/* Cycle estimate for the comparison, a lower bound: a load or store to a peripheral
+ *  (no APB wait states counted), a call with its return and the register saves of a driverlib function
+ */
+#define CYCLES_ACCESS 2
+#define CYCLES_CALL 8
+
+// Registers of the model
+enum {
+    REG_DATA, REG_DIR, REG_AFSEL, REG_DR2R, REG_DR4R, REG_DR8R, REG_ODR, REG_PUR, REG_PDR, REG_SLR, REG_DEN, REG_AMSEL,
+    REG_COUNT
+};
+
+static const char *registerNames[REG_COUNT] = {
+    "DATA", "DIR", "AFSEL", "DR2R", "DR4R", "DR8R", "ODR", "PUR", "PDR", "SLR", "DEN", "AMSEL"
+};
+
+static const uint32_t registerOffsets[REG_COUNT] = {
+    TOUCH_O_DATA, TOUCH_O_DIR, TOUCH_O_AFSEL, TOUCH_O_DR2R, TOUCH_O_DR4R, TOUCH_O_DR8R, TOUCH_O_ODR, TOUCH_O_PUR,
+    TOUCH_O_PDR, TOUCH_O_SLR, TOUCH_O_DEN, TOUCH_O_AMSEL
+};
+
+typedef struct {
+    uint8_t reg[REG_COUNT];
+    long reads;
+    long writes;
+    long calls;
+} Port;
+
+static Port *port;
+
+/*
+ * Register access (HWREG)
+ */
+static uint32_t Read(uint32_t offset) {
+    int r;
+    port->reads++;
+    if(offset < TOUCH_O_DIR) {
+        return port->reg[REG_DATA] & (offset >> 2);
+    }
+    for(r = 1; r < REG_COUNT; r++) {
+        if(registerOffsets[r] == offset) return port->reg[r];
+    }
+    printf("read of unmodelled offset 0x%03X\n", (unsigned int)offset);
+    exit(1);
+}
+
+static void Write(uint32_t offset, uint32_t value) {
+    uint8_t bits = (uint8_t)value;
+    int r;
+    port->writes++;
+    if(offset < TOUCH_O_DIR) {
+        uint8_t mask = (offset >> 2) & port->reg[REG_DIR];
+        port->reg[REG_DATA] = (port->reg[REG_DATA] & ~mask) | (bits & mask);
+        return;
+    }
+    for(r = 1; r < REG_COUNT; r++) {
+        if(registerOffsets[r] == offset) break;
+    }
+    if(r == REG_COUNT) {
+        printf("write of unmodelled offset 0x%03X\n", (unsigned int)offset);
+        exit(1);
+    }
+    port->reg[r] = bits;
+
+    // Set bits of one drive strength or pull clear the others
+    if(r == REG_DR2R || r == REG_DR4R || r == REG_DR8R) {
+        if(r != REG_DR2R) port->reg[REG_DR2R] &= ~bits;
+        if(r != REG_DR4R) port->reg[REG_DR4R] &= ~bits;
+        if(r != REG_DR8R) port->reg[REG_DR8R] &= ~bits;
+    }
+    if(r == REG_PUR) port->reg[REG_PDR] &= ~bits;
+    if(r == REG_PDR) port->reg[REG_PUR] &= ~bits;
+}
+
+static void SetBits(uint32_t offset, uint8_t pins, _Bool set) {
+    uint32_t value = Read(offset);
+    Write(offset, set ? (value | pins) : (value & ~pins));
+}
+
+/*
+ * driverlib GPIO calls (driverlib/gpio.c, TM4C123 paths)
+ */
+static void GPIODirModeSet(uint8_t pins, uint32_t mode) {
+    port->calls++;
+    SetBits(TOUCH_O_DIR, pins, mode & 1);
+    SetBits(TOUCH_O_AFSEL, pins, mode & 2);
+}
+
+static void GPIOPadConfigSet(uint8_t pins, uint32_t strength, uint32_t type) {
+    port->calls++;
+    SetBits(TOUCH_O_DR2R, pins, strength & 1);
+    SetBits(TOUCH_O_DR4R, pins, strength & 2);
+    SetBits(TOUCH_O_DR8R, pins, strength & 4);
+    SetBits(TOUCH_O_SLR, pins, strength & 8);
+    SetBits(TOUCH_O_ODR, pins, type & 1);
+    SetBits(TOUCH_O_PUR, pins, type & 2);
+    SetBits(TOUCH_O_PDR, pins, type & 4);
+    SetBits(TOUCH_O_DEN, pins, type & 8);
+    SetBits(TOUCH_O_AMSEL, pins, type == GPIO_PIN_TYPE_ANALOG);
+}
+
+static void GPIOPinTypeGPIOInput(uint8_t pins) {
+    port->calls++;
+    GPIODirModeSet(pins, GPIO_DIR_MODE_IN);
+    GPIOPadConfigSet(pins, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD);
+}
+
+static void GPIOPinTypeGPIOOutput(uint8_t pins) {
+    port->calls++;
+    GPIOPadConfigSet(pins, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD);
+    GPIODirModeSet(pins, GPIO_DIR_MODE_OUT);
+}
+
+static void GPIOPinTypeADC(uint8_t pins) {
+    port->calls++;
+    GPIODirModeSet(pins, GPIO_DIR_MODE_IN);
+    GPIOPadConfigSet(pins, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_ANALOG);
+}
+
+static void GPIOPinWrite(uint8_t pins, uint8_t value) {
+    port->calls++;
+    Write(TOUCH_O_DATA + (pins << 2), value);
+}
+
+/*
+ * The touch driver's phase changes before touchPhase.c (touch.c)
+ */
+static void Touch_Off(uint8_t ADC_P, uint8_t ADC_M, uint8_t GPIO_P, uint8_t GPIO_M) {
+    port->calls++;
+    GPIOPinTypeGPIOInput(ADC_P | ADC_M | GPIO_P | GPIO_M);
+}
+
+static void Touch_Config(uint8_t ADC_P, uint8_t ADC_M, uint8_t GPIO_P, uint8_t GPIO_M) {
+    port->calls++;
+    GPIOPinWrite(GPIO_P | GPIO_M, GPIO_P);
+    GPIOPadConfigSet(GPIO_P | GPIO_M, GPIO_STRENGTH_6MA, GPIO_PIN_TYPE_STD);
+    GPIOPinTypeGPIOOutput(GPIO_P | GPIO_M);
+    GPIODirModeSet(GPIO_P | GPIO_M, GPIO_DIR_MODE_OUT);
+    GPIOPinWrite(GPIO_P | GPIO_M, GPIO_P);
+
+    GPIOPinTypeADC(ADC_P | ADC_M);
+    GPIOPadConfigSet(ADC_P | ADC_M, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_ANALOG);
+    GPIODirModeSet(ADC_P | ADC_M, GPIO_DIR_MODE_IN);
+}
+
+// Configuration part of Touch_Present()
+static void Touch_PresentConfig(void) {
+    GPIOPinTypeGPIOOutput(TOUCH_YP | TOUCH_YM);
+    GPIODirModeSet(TOUCH_YP | TOUCH_YM, GPIO_DIR_MODE_OUT);
+    GPIOPinWrite(TOUCH_YP | TOUCH_YM, 0x00);
+
+    GPIOPinTypeGPIOInput(TOUCH_XP | TOUCH_XM);
+    GPIODirModeSet(TOUCH_XP | TOUCH_XM, GPIO_DIR_MODE_IN);
+    GPIOPadConfigSet(TOUCH_XP | TOUCH_XM, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+}
+
+static void DriverlibPhase(uint8_t phase) {
+    switch(phase) {
+        case TOUCH_PHASE_OFF:
+            Touch_Off(TOUCH_XP, TOUCH_XM, TOUCH_YP, TOUCH_YM);
+            break;
+        case TOUCH_PHASE_READ_X:
+            Touch_Config(TOUCH_XP, TOUCH_XM, TOUCH_YP, TOUCH_YM);
+            break;
+        case TOUCH_PHASE_READ_Y:
+            Touch_Config(TOUCH_YP, TOUCH_YM, TOUCH_XP, TOUCH_XM);
+            break;
+        case TOUCH_PHASE_PRESENT:
+            Touch_PresentConfig();
+            break;
+    }
+}
+
+/*
+ * The touch driver now (touch.c)
+ */
+static void Touch_Phase(uint8_t phase) {
+    const TouchWrite *writes = TouchPhaseWrites[phase];
+    uint8_t i;
+    port->calls++;
+    for(i = 0; i < TOUCH_PHASE_WRITES; i++) {
+        Write(writes[i].offset, writes[i].value);
+    }
+}
+
+// Touch_Init(): reset, pad setup and table from the port registers
+static void Touch_Init(void) {
+    GPIOPinTypeGPIOInput(TOUCH_PINS);
+    TouchPhase_Build(Read(TOUCH_O_PUR), Read(TOUCH_O_AMSEL), Read(TOUCH_O_DEN), Read(TOUCH_O_DIR));
+}
+
+// Port after reset, the other pins set up at random by other code
+static void RandomPort(Port *p, _Bool random) {
+    int r;
+    memset(p, 0, sizeof(*p));
+    p->reg[REG_DR2R] = 0xFF;
+    if(!random) return;
+    for(r = 0; r < REG_COUNT; r++) {
+        p->reg[r] = (p->reg[r] & TOUCH_PINS) | (rand() & ~TOUCH_PINS & 0xFF);
+    }
+    // Keep the hardware exclusions on the other pins
+    p->reg[REG_DR4R] &= ~p->reg[REG_DR2R];
+    p->reg[REG_DR8R] &= ~(p->reg[REG_DR2R] | p->reg[REG_DR4R]);
+    p->reg[REG_PDR] &= ~p->reg[REG_PUR];
+}
+
+// First register two ports differ in, -1 if none
+static int Differ(const Port *a, const Port *b) {
+    int r;
+    for(r = 0; r < REG_COUNT; r++) {
+        if(a->reg[r] != b->reg[r]) return r;
+    }
+    return -1;
+}
+
+static const char *phaseNames[TOUCH_PHASE_COUNT] = {"off", "read X", "read Y", "present"};
+
+static void CheckSnapshots(void) {
+    Port driverlib, snapshot;
+    long mismatches = 0, changes = 0, others = 0;
+    int n, i, from, to;
+    _Bool shown = false;
+
+    printf("Snapshots against the driverlib sequences\n");
+    for(n = 0; n < RANDOM_PORTS; n++) {
+        RandomPort(&driverlib, n > 0);
+        port = &driverlib;
+        Touch_Init();
+        snapshot = driverlib;
+        uint8_t others0[REG_COUNT];
+        for(i = 0; i < REG_COUNT; i++) others0[i] = driverlib.reg[i] & ~TOUCH_PINS;
+
+        // Every change between two phases, then random sequences
+        for(i = 0; i < TOUCH_PHASE_COUNT * TOUCH_PHASE_COUNT + RANDOM_CHANGES; i++) {
+            if(i < TOUCH_PHASE_COUNT * TOUCH_PHASE_COUNT) {
+                from = i / TOUCH_PHASE_COUNT;
+                to = i % TOUCH_PHASE_COUNT;
+                port = &driverlib;
+                DriverlibPhase(from);
+                snapshot = driverlib;
+            } else {
+                from = -1;
+                to = rand() % TOUCH_PHASE_COUNT;
+            }
+            port = &driverlib;
+            DriverlibPhase(to);
+            port = &snapshot;
+            Touch_Phase(to);
+            changes++;
+
+            int r = Differ(&driverlib, &snapshot);
+            if(r >= 0) {
+                mismatches++;
+                if(!shown) {
+                    printf("  %s -> %s: %s 0x%02X instead of 0x%02X\n", from >= 0 ? phaseNames[from] : "?", phaseNames[to],
+                           registerNames[r], snapshot.reg[r], driverlib.reg[r]);
+                    shown = true;
+                }
+            }
+            for(r = 0; r < REG_COUNT; r++) {
+                others += (snapshot.reg[r] & ~TOUCH_PINS) != others0[r];
+            }
+            snapshot = driverlib;
+        }
+    }
+
+    char text[120];
+    snprintf(text, sizeof(text), "all registers equal after %ld phase changes (%d ports)", changes, RANDOM_PORTS);
+    Check(mismatches == 0, text);
+    Check(others == 0, "other port D pins keep their settings");
+
+    // What the phases are on the pins
+    port = &snapshot;
+    RandomPort(&snapshot, false);
+    Touch_Init();
+    Touch_Phase(TOUCH_PHASE_READ_X);
+    Check(snapshot.reg[REG_DIR] == (TOUCH_YP | TOUCH_YM) && (snapshot.reg[REG_DATA] & TOUCH_PINS) == TOUCH_YP &&
+              snapshot.reg[REG_AMSEL] == (TOUCH_XP | TOUCH_XM), "read X drives YP high and YM low, X pins analog");
+    Touch_Phase(TOUCH_PHASE_PRESENT);
+    Check(snapshot.reg[REG_DIR] == (TOUCH_YP | TOUCH_YM) && (snapshot.reg[REG_DATA] & (TOUCH_YP | TOUCH_YM)) == 0 &&
+              snapshot.reg[REG_PUR] == (TOUCH_XP | TOUCH_XM) && snapshot.reg[REG_AMSEL] == 0,
+          "present drives Y low, X pins pulled up");
+    Check(snapshot.reg[REG_DR2R] == 0xFF && snapshot.reg[REG_DR8R] == 0, "driven pins at 2 mA (the 6 mA setting is undone)");
+}
+
+// Accesses and calls of the driverlib sequence and of the writes for one phase change
+static void Count(uint8_t phase, Port *driverlib, Port *snapshot) {
+    Port p;
+    RandomPort(&p, false);
+    port = &p;
+    Touch_Init();
+    p.reads = p.writes = p.calls = 0;
+    *driverlib = p;
+    *snapshot = p;
+    port = driverlib;
+    DriverlibPhase(phase);
+    port = snapshot;
+    Touch_Phase(phase);
+}
+
+static long Cycles(const Port *p) {
+    return (p->reads + p->writes) * CYCLES_ACCESS + p->calls * CYCLES_CALL;
+}
+
+static void CheckCost(void) {
+    // The phase changes of UpdateBallPosition() (main.c)
+    static const uint8_t update[] = {
+        TOUCH_PHASE_PRESENT, TOUCH_PHASE_READ_X, TOUCH_PHASE_OFF, TOUCH_PHASE_PRESENT, TOUCH_PHASE_READ_Y, TOUCH_PHASE_OFF
+    };
+    long totalDriverlib = 0, totalSnapshot = 0;
+    unsigned int i;
+    Port driverlib, snapshot;
+
+    printf("\nCost per phase change (estimate %d cycles per register access, %d per call)\n", CYCLES_ACCESS, CYCLES_CALL);
+    printf("  %-8s %24s %24s\n", "phase", "driverlib rd/wr/calls", "snapshot rd/wr/calls");
+    for(i = 0; i < TOUCH_PHASE_COUNT; i++) {
+        Count(i, &driverlib, &snapshot);
+        printf("  %-8s %6ld/%3ld/%3ld %5ld cyc %6ld/%3ld/%3ld %5ld cyc\n", phaseNames[i], driverlib.reads, driverlib.writes,
+               driverlib.calls, Cycles(&driverlib), snapshot.reads, snapshot.writes, snapshot.calls, Cycles(&snapshot));
+    }
+    for(i = 0; i < sizeof(update); i++) {
+        Count(update[i], &driverlib, &snapshot);
+        totalDriverlib += Cycles(&driverlib);
+        totalSnapshot += Cycles(&snapshot);
+        char text[80];
+        snprintf(text, sizeof(text), "%s: %d register writes, no reads", phaseNames[update[i]], TOUCH_PHASE_WRITES);
+        Check(snapshot.writes == TOUCH_PHASE_WRITES && snapshot.reads == 0, text);
+    }
+    printf("  UpdateBallPosition(): %ld cycles on driverlib, %ld on the snapshots (%.1f times less)\n", totalDriverlib,
+           totalSnapshot, (double)totalDriverlib / totalSnapshot);
+    Check(totalSnapshot * 4 < totalDriverlib, "snapshots under a quarter of the driverlib cost");
+}
+
+int main(void) {
+    srand(1);
+    CheckSnapshots();
+    CheckCost();
+
+    return Check_Result();
+}
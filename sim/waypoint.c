@@ -0,0 +1,312 @@
+/*
+ * waypoint.c
+ *
+ * Waypoint stream check (runs on a PC)
+ *
+ *  Checks the line parser, the queue and the interpolation of ../waypoint.c, then
+ *  streams a circle through a pair of pipes standing in for the serial link, at the
+ *  byte rate of BAUD_RATE and in simulated milliseconds. The host sends the waypoints
+ *  live with link jitter, stalls, or ahead of time within the flow control of the
+ *  reports (or ignoring it), the device side feeds the bytes to the parser and takes
+ *  setpoints at WAYPOINT_UPDATE_RATE. Tracking error, underruns, held setpoints and
+ *  the reported counts are checked.
+ *  Exits with 1 if a check fails.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o sim/waypoint sim/waypoint.c waypoint.c -lm
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../waypoint.h"
+#include "check.h"
+
+#define PI 3.14159265358979
+
+// Bytes per ms at 115200 baud (10 bits per byte)
+#define SIM_LINK_BYTES 11
+
+// Circle streamed by the host: waypoint spacing (ms), radius (counts), period (ms)
+#define SIM_SPACING 20
+#define SIM_RADIUS 500
+#define SIM_PERIOD 2000
+
+// Largest distance from the circle while streaming (counts): chord error plus rounding
+#define SIM_TRACK_ERROR 1.5
+
+// SysTick time minus host time of the stream (waypoint.c)
+extern uint32_t waypointOffset;
+
+static void Send(const char *text) {
+    while(*text) Waypoint_Char(*text++);
+}
+
+static _Bool At(uint32_t now, int32_t x, int32_t y) {
+    int32_t sx, sy;
+    Waypoint_Setpoint(now, &sx, &sy);
+    return sx == x && sy == y;
+}
+
+static void CheckParser(void) {
+    printf("Parser and queue\n");
+
+    Waypoint_Stop();
+    Send("W,0,10,-20\n");
+    Check(WaypointReceived == 0, "lines are ignored outside the waypoint mode");
+
+    Waypoint_Start(0, 0);
+    Send("W,0,10,-20\r\n");
+    Send("W,10,5,5");
+    Send("\n");
+    Send("W,5,1\n");
+    Send("X\n");
+    Send("W,20,3000,0\n");
+    Send("W,30,1,2,3\n");
+    Send("W,40,1,2,3,4,5,6,7,8,9,10,11,12,13,14\n");
+    Send("W,3,0,0\n");
+    Check(WaypointReceived == 2 && WaypointErrors == 6, "good lines queued, short, unknown, out of range, long and late ones counted");
+
+    Waypoint_Start(0, 0);
+    int i;
+    for(i = 0; i < WAYPOINT_QUEUE_SIZE + 8; i++) Waypoint_Push(i * 10, 0, 0);
+    Check(WaypointReceived == WAYPOINT_QUEUE_SIZE && WaypointRejected == 8, "a full queue rejects and counts");
+
+    char line[WAYPOINT_REPORT_SIZE];
+    Waypoint_Start(0, 0);
+    At(1000, 0, 0);
+    uint8_t length = Waypoint_Report(line);
+    line[length] = '\0';
+    Check(!strcmp(line, "Q,0,0,0,0,0,0,0\r\n") && At(1010, 0, 0) && Waypoint_Report(line) == 0 &&
+          At(1000 + WAYPOINT_REPORT_RATE, 0, 0) && Waypoint_Report(line) > 0, "reports on start, then every WAYPOINT_REPORT_RATE ms");
+
+    // SysTick keeps the report it took until the main loop sent it, the fields don't change under the sender
+    At(1000 + 2 * WAYPOINT_REPORT_RATE, 0, 0);
+    Waypoint_Push(10, 0, 0);
+    At(1000 + 3 * WAYPOINT_REPORT_RATE, 0, 0);
+    length = Waypoint_Report(line);
+    line[length] = '\0';
+    Check(!strcmp(line, "Q,0,0,0,0,0,0,0\r\n") && Waypoint_Report(line) == 0, "a report waits for the sender and isn't overwritten");
+}
+
+static void CheckInterpolation(void) {
+    printf("\nInterpolation\n");
+
+    Waypoint_Start(0, 0);
+    Waypoint_Push(1000, 100, 0);
+    Waypoint_Push(1100, 200, -100);
+    Waypoint_Push(1300, 200, 100);
+
+    // First waypoint WaypointDelay after the stream starts at 5000
+    Check(At(5000, 0, 0) && At(5050, 50, 0) && At(5000 + WaypointDelay, 100, 0), "moves from the held setpoint to the first waypoint");
+    Check(At(5150, 150, -50) && At(5200, 200, -100) && At(5250, 200, -50) && WaypointPlayed == 2 && !WaypointHolding,
+          "linear between waypoints, played on their host times");
+    Check(At(5390, 200, 90) && WaypointUnderruns == 0, "no underrun while a waypoint is queued");
+
+    char line[WAYPOINT_REPORT_SIZE];
+    Waypoint_Report(line);
+    Check(At(5400, 200, 100) && WaypointUnderruns == 1 && WaypointHolding, "underrun at the last waypoint");
+    uint8_t length = Waypoint_Report(line);
+    line[length] = '\0';
+    Check(!strcmp(line, "Q,3,3,0,0,1,0,0\r\n"), "the underrun is reported at once");
+    Check(At(5600, 200, 100) && At(5900, 200, 100) && WaypointUnderruns == 1, "holds the last setpoint, one underrun counted");
+
+    Waypoint_Push(2000, 0, 100);
+    Waypoint_Push(2050, -50, 100);
+    Check(At(6000, 200, 100) && At(6050, 100, 100) && At(6100, 0, 100) && At(6125, -25, 100),
+          "a later waypoint starts a new stream from the held setpoint");
+
+    Send("R\n");
+    Check(At(6150, -25, 100) && WaypointHolding, "R drops the queue and holds");
+    Send("W,100,25,100\n");
+    Check(At(6200, -25, 100) && At(6250, 0, 100) && At(6300, 25, 100), "times restart after R");
+}
+
+typedef struct {
+    const char *name;
+    int jitter;                 // Link delay of each line 0 to jitter ms
+    uint32_t stallAt, stallMs;  // Host stops sending
+    _Bool ahead;                // Sends as fast as the flow control lets it instead of live
+    _Bool greedy;               // Ignores the flow control
+    int count;                  // Waypoints
+    uint32_t underruns;         // Expected, the end of the stream is one
+} Link;
+
+typedef struct {
+    double error;               // Largest distance from the circle while streaming
+    _Bool held;                 // Setpoint unchanged while holding
+    int32_t minLead;            // Smallest reported min lead while the host sends
+    int32_t reported[7];        // Last report
+    int sent;
+    int32_t lastX, lastY;
+} Result;
+
+static void Circle(double time, double *x, double *y) {
+    *x = SIM_RADIUS * cos(2.0 * PI * time / SIM_PERIOD);
+    *y = SIM_RADIUS * sin(2.0 * PI * time / SIM_PERIOD);
+}
+
+// Reads the report lines the device sent, keeps the last one
+static void HostRead(int fd, char *buffer, size_t *length, Result *r, _Bool streaming) {
+    char c;
+    while(read(fd, &c, 1) == 1) {
+        if(c == '\n') {
+            buffer[*length] = '\0';
+            int32_t v[7];
+            if(sscanf(buffer, "Q,%d,%d,%d,%d,%d,%d,%d", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6]) == 7) {
+                memcpy(r->reported, v, sizeof(v));
+                if(streaming && v[1] > 0 && v[3] < r->minLead) r->minLead = v[3];
+            }
+            *length = 0;
+        } else if(c != '\r' && *length < 127) {
+            buffer[(*length)++] = c;
+        }
+    }
+}
+
+static void RunLink(const Link *l, Result *r) {
+    int toDevice[2], toHost[2];
+    char hostLine[128];
+    size_t hostLength = 0;
+    uint32_t now, sendTime = 0;
+    int32_t x = 0, y = 0, prevX = 0, prevY = 0;
+    _Bool wasHolding = true;
+    uint32_t joined = 0;
+    _Bool drawn = false;
+
+    if(pipe(toDevice) || pipe(toHost)) {
+        perror("pipe");
+        exit(2);
+    }
+    fcntl(toDevice[0], F_SETFL, O_NONBLOCK);
+    fcntl(toHost[0], F_SETFL, O_NONBLOCK);
+
+    memset(r, 0, sizeof(*r));
+    r->held = true;
+    r->minLead = INT32_MAX;
+    srand(45);
+
+    Waypoint_Start(0, 0);
+    uint32_t end = l->count * SIM_SPACING + 3000;
+    for(now = 0; now < end; now++) {
+        // Host: the next waypoint once it is due, its link delay passed and the flow control allows it
+        HostRead(toHost[0], hostLine, &hostLength, r, r->sent < l->count);
+        while(r->sent < l->count) {
+            uint32_t time = r->sent * SIM_SPACING;
+            if(!l->ahead && !l->greedy) {
+                // Lines arrive in order, a late one holds up the next
+                if(!drawn) {
+                    uint32_t due = time + (l->jitter ? rand() % (l->jitter + 1) : 0);
+                    if(due > sendTime) sendTime = due;
+                    drawn = true;
+                }
+                if(now < sendTime) break;
+            }
+            if(now >= l->stallAt && now < l->stallAt + l->stallMs) break;
+            if(!l->greedy && r->sent - r->reported[1] >= WAYPOINT_QUEUE_SIZE) break;
+
+            double cx, cy;
+            char line[64];
+            Circle(time, &cx, &cy);
+            int length = snprintf(line, sizeof(line), "W,%u,%ld,%ld\n", time, lround(cx), lround(cy));
+            if(write(toDevice[1], line, length) != length) exit(2);
+            r->sent++;
+            drawn = false;
+            if(!l->greedy) break;
+        }
+
+        // Device: the bytes the link carried in this ms, a setpoint every WAYPOINT_UPDATE_RATE ms, the reports
+        char bytes[SIM_LINK_BYTES];
+        ssize_t count = read(toDevice[0], bytes, SIM_LINK_BYTES), i;
+        for(i = 0; i < count; i++) Waypoint_Char(bytes[i]);
+
+        if(now % WAYPOINT_UPDATE_RATE == 0) {
+            Waypoint_Setpoint(now, &x, &y);
+            if(wasHolding && WaypointHolding && (x != prevX || y != prevY)) r->held = false;
+
+            // A stream joins its first waypoint from the held setpoint, it follows the circle from there
+            if(wasHolding && !WaypointHolding) joined = now + WaypointDelay;
+            if(!WaypointHolding && now >= joined) {
+                double cx, cy;
+                Circle((double)(now - waypointOffset), &cx, &cy);
+                double error = hypot(x - cx, y - cy);
+                if(error > r->error) r->error = error;
+            }
+            wasHolding = WaypointHolding;
+            prevX = x;
+            prevY = y;
+        }
+
+        char report[WAYPOINT_REPORT_SIZE];
+        uint8_t length = Waypoint_Report(report);
+        if(length && write(toHost[1], report, length) != length) exit(2);
+    }
+    HostRead(toHost[0], hostLine, &hostLength, r, false);
+    r->lastX = x;
+    r->lastY = y;
+
+    close(toDevice[0]);
+    close(toDevice[1]);
+    close(toHost[0]);
+    close(toHost[1]);
+}
+
+static void CheckLink(void) {
+    static const Link links[] = {
+        // name             jitter stallAt stallMs ahead  greedy count underruns
+        {"live",            60,    0,      0,      false, false, 300,  1},
+        {"live_late",       180,   0,      0,      false, false, 300,  0},
+        {"stall",           30,    3000,   400,    false, false, 300,  2},
+        {"ahead",           0,     0,      0,      true,  false, 300,  1},
+        {"ahead_greedy",    0,     0,      0,      true,  true,  300,  1},
+    };
+    unsigned int i;
+
+    printf("\nCircle streamed over a pipe at %d bytes/ms, a waypoint every %d ms, WaypointDelay %u ms\n", SIM_LINK_BYTES,
+           SIM_SPACING, WaypointDelay);
+    printf("       %-14s %6s %8s %8s %6s %9s %9s %9s\n", "link", "sent", "played", "rejected", "errors", "underruns",
+           "min lead", "error");
+    for(i = 0; i < sizeof(links) / sizeof(links[0]); i++) {
+        const Link *l = &links[i];
+        Result r;
+        RunLink(l, &r);
+
+        double lastX, lastY;
+        Circle((l->count - 1) * SIM_SPACING, &lastX, &lastY);
+        _Bool reported = (uint32_t)r.reported[0] == WaypointReceived && (uint32_t)r.reported[1] == WaypointPlayed &&
+                         (uint32_t)r.reported[4] == WaypointUnderruns && (uint32_t)r.reported[5] == WaypointRejected;
+        _Bool ends = WaypointHolding && r.lastX == lround(lastX) && r.lastY == lround(lastY);
+        _Bool ok = reported && r.held && WaypointErrors == 0 && WaypointPlayed == WaypointReceived;
+        if(l->greedy) {
+            // The queue overflows, the rest is rejected and the stream is cut short
+            ok = ok && WaypointRejected > 0 && WaypointReceived + WaypointRejected == (uint32_t)r.sent;
+        } else {
+            ok = ok && WaypointRejected == 0 && WaypointReceived == (uint32_t)l->count && ends;
+            if(l->underruns) ok = ok && WaypointUnderruns == l->underruns && r.error <= SIM_TRACK_ERROR &&
+                                     (l->underruns > 1 || r.minLead > 0);
+            else ok = ok && WaypointUnderruns > 1;
+        }
+        char lead[16] = "-";
+        if(r.minLead != INT32_MAX) snprintf(lead, sizeof(lead), "%d", r.minLead);
+        printf("  %-4s %-14s %6d %8u %8u %6u %9u %9s %9.2f\n", ok ? "ok" : "FAIL", l->name, r.sent, WaypointPlayed,
+               WaypointRejected, WaypointErrors, WaypointUnderruns, lead, r.error);
+        if(!ok) failures++;
+    }
+    Waypoint_Stop();
+}
+
+int main(void) {
+    CheckParser();
+    CheckInterpolation();
+    CheckLink();
+
+    return Check_Result();
+}
@@ -0,0 +1,104 @@
+/*
+ * storage.c
+ *
+ * Keeps the PID gains and the levelling result in the internal EEPROM so they survive a reset
+ *  Gains record: magic, Px, Ix, Dx, Py, Iy, Dy, checksum (32 bit words)
+ *  Level record: magic, CenterX, CenterY, ServoZeroX, ServoZeroY, checksum
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+#include "controller.h"
+#include "storage.h"
+
+#define STORAGE_GAINS_WORDS 8
+#define STORAGE_LEVEL_WORDS 6
+
+_Bool storageReady = false;
+
+void Storage_Init(void) {
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+
+    // Wait for the EEPROM module to be ready.
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0)) {}
+
+    storageReady = (EEPROMInit() == EEPROM_INIT_OK);
+}
+
+// Checksum of a record of <words> words, the last word is the checksum
+static uint32_t Checksum(const uint32_t *record, uint8_t words) {
+    uint32_t sum = 0;
+    uint8_t i;
+    for(i = 0; i < words - 1; i++) {
+        sum = (sum << 1 | sum >> 31) ^ record[i];
+    }
+    return ~sum;
+}
+
+// Replaces the gains with the saved ones, returns false (gains unchanged) if there is no valid record
+_Bool Storage_LoadGains(void) {
+    uint32_t record[STORAGE_GAINS_WORDS];
+    if(!storageReady) return false;
+
+    EEPROMRead(record, STORAGE_GAINS_ADDRESS, sizeof(record));
+    if(record[0] != STORAGE_GAINS_MAGIC || record[STORAGE_GAINS_WORDS - 1] != Checksum(record, STORAGE_GAINS_WORDS)) return false;
+
+    Px = (int32_t)record[1];
+    Ix = (int32_t)record[2];
+    Dx = (int32_t)record[3];
+    Py = (int32_t)record[4];
+    Iy = (int32_t)record[5];
+    Dy = (int32_t)record[6];
+    return true;
+}
+
+void Storage_SaveGains(void) {
+    uint32_t record[STORAGE_GAINS_WORDS];
+    if(!storageReady) return;
+
+    record[0] = STORAGE_GAINS_MAGIC;
+    record[1] = (uint32_t)Px;
+    record[2] = (uint32_t)Ix;
+    record[3] = (uint32_t)Dx;
+    record[4] = (uint32_t)Py;
+    record[5] = (uint32_t)Iy;
+    record[6] = (uint32_t)Dy;
+    record[STORAGE_GAINS_WORDS - 1] = Checksum(record, STORAGE_GAINS_WORDS);
+
+    EEPROMProgram(record, STORAGE_GAINS_ADDRESS, sizeof(record));
+}
+
+// Replaces the touch center and servo level positions with the saved ones, false (unchanged) if there is no valid record
+_Bool Storage_LoadLevel(void) {
+    uint32_t record[STORAGE_LEVEL_WORDS];
+    if(!storageReady) return false;
+
+    EEPROMRead(record, STORAGE_LEVEL_ADDRESS, sizeof(record));
+    if(record[0] != STORAGE_LEVEL_MAGIC || record[STORAGE_LEVEL_WORDS - 1] != Checksum(record, STORAGE_LEVEL_WORDS)) return false;
+
+    CenterX = record[1];
+    CenterY = record[2];
+    ServoZeroX = (int32_t)record[3];
+    ServoZeroY = (int32_t)record[4];
+    return true;
+}
+
+void Storage_SaveLevel(void) {
+    uint32_t record[STORAGE_LEVEL_WORDS];
+    if(!storageReady) return;
+
+    record[0] = STORAGE_LEVEL_MAGIC;
+    record[1] = CenterX;
+    record[2] = CenterY;
+    record[3] = (uint32_t)ServoZeroX;
+    record[4] = (uint32_t)ServoZeroY;
+    record[STORAGE_LEVEL_WORDS - 1] = Checksum(record, STORAGE_LEVEL_WORDS);
+
+    EEPROMProgram(record, STORAGE_LEVEL_ADDRESS, sizeof(record));
+}
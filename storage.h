@@ -0,0 +1,25 @@
+/*
+ * storage.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+// EEPROM address of the saved PID gains and the marker of a valid record
+#define STORAGE_GAINS_ADDRESS 0x0000
+#define STORAGE_GAINS_MAGIC 0x50494431
+
+// EEPROM address of the saved levelling result (touch center and servo level positions) and its marker
+#define STORAGE_LEVEL_ADDRESS 0x0040
+#define STORAGE_LEVEL_MAGIC 0x4C564C31
+
+void Storage_Init(void);
+_Bool Storage_LoadGains(void);
+void Storage_SaveGains(void);
+_Bool Storage_LoadLevel(void);
+void Storage_SaveLevel(void);
+
+#endif /* STORAGE_H_ */
@@ -0,0 +1,234 @@
+/*
+ * supervisor.c
+ *
+ * Supervision of the control loop, fault records and restart decisions
+ *  A hung touch read or a fault used to leave the plate at whatever tilt it had
+ *  until a power cycle. The watchdog is now fed by SysTick only for the PID
+ *  periods whose control work the main loop finished within the period start and
+ *  its deadline, check-ins outside that window don't count. The fault handlers
+ *  and the watchdog NMI write the stacked registers, the fault status and the
+ *  control state to a record in RAM that survives the reset, and the restart
+ *  decides from it and the reset cause whether to take the level, center and
+ *  gains back from the record instead of levelling again.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "controller.h"
+#include "supervisor.h"
+
+_Bool SupervisorEnabled = SUPERVISOR_DEFAULT_ENABLE;
+
+// The C startup zeroes .bss and copies .data, .noinit is left as the reset found it (tm4c123gh6pm.cmd)
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(SupervisorFault, ".noinit")
+#endif
+SupervisorRecord SupervisorFault;
+
+volatile uint32_t SupervisorMissed = 0;
+volatile uint32_t SupervisorFeeds = 0;
+
+// PID period in progress (SysTick), its deadline (ms) and the last period the main loop finished in time
+volatile uint32_t supervisorPeriod = 0;
+volatile unsigned long supervisorDeadline = 0;
+volatile uint32_t supervisorMet = 0;
+
+// CRC-32 (reflected, 0xEDB88320) of the record up to its check, bitwise so the fault handlers need no table
+uint32_t Supervisor_Check(const SupervisorRecord *record) {
+    const uint8_t *p = (const uint8_t *)record;
+    uint32_t crc = 0xFFFFFFFF;
+    uint16_t i;
+    uint8_t bit;
+    for(i = 0; i < offsetof(SupervisorRecord, check); i++) {
+        crc ^= p[i];
+        for(bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Record written by a capture of this format, not what the RAM held at power-on
+_Bool Supervisor_Valid(const SupervisorRecord *record) {
+    return record->magic == SUPERVISOR_MAGIC && record->version == SUPERVISOR_VERSION &&
+           record->check == Supervisor_Check(record);
+}
+
+/* Writes the record of a fault of <cause> at <now> (ms), called from the fault handlers
+ *  <frame> is the stack frame of the exception entry (SUPERVISOR_REGISTERS words), 0 if it couldn't be read.
+ *  The count of warm restarts in a row carries over from the record of the fault before.
+ */
+void Supervisor_Capture(SupervisorRecord *record, uint8_t cause, const uint32_t *frame,
+                        uint32_t cfsr, uint32_t hfsr, uint32_t address, unsigned long now, const SupervisorState *state) {
+    uint8_t restarts = Supervisor_Valid(record) ? record->restarts : 0;
+    uint8_t i;
+
+    record->magic = SUPERVISOR_MAGIC;
+    record->version = SUPERVISOR_VERSION;
+    record->cause = cause;
+    record->restarts = restarts;
+    record->pending = 1;
+    record->time = now;
+    for(i = 0; i < SUPERVISOR_REGISTERS; i++) {
+        record->registers[i] = frame ? frame[i] : 0;
+    }
+    record->cfsr = cfsr;
+    record->hfsr = hfsr;
+    record->address = address;
+    record->state = *state;
+    record->check = Supervisor_Check(record);
+}
+
+/* Restart after a reset of <reset> (SUPERVISOR_RESET_), SUPERVISOR_WARM only for a fault taken while the
+ *  control ran that the supervision restarted itself, fewer than SUPERVISOR_MAX_RESTARTS times in a row
+ */
+uint8_t Supervisor_Decide(const SupervisorRecord *record, uint8_t reset) {
+    if(reset == SUPERVISOR_RESET_POWER || !Supervisor_Valid(record) || !record->pending) {
+        return SUPERVISOR_COLD;
+    }
+
+    // The reset button after a fault asks for a fresh start
+    if(reset != SUPERVISOR_RESET_WATCHDOG && reset != SUPERVISOR_RESET_SOFTWARE) {
+        return SUPERVISOR_COLD;
+    }
+
+    // A fault during Setup() would come back with a warm one, the state isn't complete yet
+    if(!record->state.running || record->restarts >= SUPERVISOR_MAX_RESTARTS) {
+        return SUPERVISOR_COLD;
+    }
+    return SUPERVISOR_WARM;
+}
+
+static char *Append(char *p, uint32_t value) {
+    char digits[10];
+    uint8_t count = 0;
+
+    *p++ = ',';
+    do {
+        digits[count++] = (value % 10) + '0';
+        value /= 10;
+    } while(value > 0);
+    while(count > 0) *p++ = digits[--count];
+    return p;
+}
+
+static char *AppendHex(char *p, uint32_t value) {
+    char digits[8];
+    uint8_t count = 0;
+
+    *p++ = ',';
+    do {
+        digits[count++] = "0123456789ABCDEF"[value & 0xF];
+        value >>= 4;
+    } while(value > 0);
+    while(count > 0) *p++ = digits[--count];
+    return p;
+}
+
+// Report line (supervisor.h) of the fault in <record> into <line> (SUPERVISOR_REPORT_SIZE), 0 without a fault to report
+uint8_t Supervisor_Report(char *line, const SupervisorRecord *record, uint8_t decision) {
+    if(!Supervisor_Valid(record) || !record->pending) return 0;
+
+    char *p = line;
+    *p++ = 'F'; *p++ = 'A'; *p++ = 'U'; *p++ = 'L'; *p++ = 'T';
+    p = Append(p, record->cause);
+    *p++ = ',';
+    *p++ = (decision == SUPERVISOR_WARM) ? 'W' : 'C';
+    p = Append(p, record->restarts);
+    p = Append(p, record->time);
+    p = AppendHex(p, record->registers[SUPERVISOR_PC]);
+    p = AppendHex(p, record->registers[SUPERVISOR_LR]);
+    p = AppendHex(p, record->registers[SUPERVISOR_PSR]);
+    p = AppendHex(p, record->cfsr);
+    p = AppendHex(p, record->hfsr);
+    p = AppendHex(p, record->address);
+    p = Append(p, record->state.mode);
+    *p++ = '\r';
+    *p++ = '\n';
+    return p - line;
+}
+
+// Takes the fault as handled by a restart of <decision>, a cold one starts the count over
+void Supervisor_Restart(SupervisorRecord *record, uint8_t decision) {
+    if(decision != SUPERVISOR_WARM) {
+        record->magic = 0;
+        return;
+    }
+    record->restarts++;
+    record->pending = 0;
+    record->check = Supervisor_Check(record);
+}
+
+// Control state for a record, <running> once control started
+void Supervisor_Save(SupervisorState *state, uint8_t mode, _Bool running) {
+    state->mode = mode;
+    state->running = running;
+    state->spare[0] = state->spare[1] = 0;
+    state->centerX = CenterX;
+    state->centerY = CenterY;
+    state->zeroX = ServoZeroX;
+    state->zeroY = ServoZeroY;
+    state->px = Px; state->ix = Ix; state->dx = Dx;
+    state->py = Py; state->iy = Iy; state->dy = Dy;
+    state->degreesX = currentXDegrees;
+    state->degreesY = currentYDegrees;
+}
+
+// Level, center and gains of a warm restart, Controller_Init() starts the servos at the level
+void Supervisor_Restore(const SupervisorState *state) {
+    CenterX = state->centerX;
+    CenterY = state->centerY;
+    ServoZeroX = state->zeroX;
+    ServoZeroY = state->zeroY;
+    Px = state->px; Ix = state->ix; Dx = state->dx;
+    Py = state->py; Iy = state->iy; Dy = state->dy;
+}
+
+// Starts the supervision, the first period is fed
+void Supervisor_Start(void) {
+    supervisorPeriod = 0;
+    supervisorMet = 0;
+    supervisorDeadline = 0;
+    SupervisorMissed = 0;
+    SupervisorFeeds = 0;
+}
+
+/* PID period starting at <now> (ms), called from SysTick, true to feed the watchdog
+ *  Feeds if the main loop finished the period before by its deadline. Also forgets the
+ *  warm restarts once the system ran SUPERVISOR_STABLE ms since the last one.
+ */
+_Bool Supervisor_Period(unsigned long now) {
+    _Bool feed = (supervisorMet == supervisorPeriod);
+    if(feed) {
+        SupervisorFeeds++;
+    } else {
+        SupervisorMissed++;
+    }
+
+    supervisorDeadline = now + SUPERVISOR_DEADLINE;
+    supervisorPeriod++;
+
+    if(now >= SUPERVISOR_STABLE && SupervisorFault.magic == SUPERVISOR_MAGIC && !SupervisorFault.pending) {
+        SupervisorFault.magic = 0;
+    }
+    return feed;
+}
+
+/* Main loop finished the control work of the period at <now> (ms), call with nothing of it waiting
+ *  <period> is SupervisorPeriod read at the start of the pass, a period that started
+ *  during the pass isn't done by it
+ */
+void Supervisor_Done(uint32_t period, unsigned long now) {
+    if(period == supervisorPeriod && now <= supervisorDeadline) {
+        supervisorMet = period;
+    }
+}
+
+// Period in progress, for Supervisor_Done()
+uint32_t Supervisor_Token(void) {
+    return supervisorPeriod;
+}
@@ -0,0 +1,115 @@
+/*
+ * supervisor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SUPERVISOR_H_
+#define SUPERVISOR_H_
+
+// The watchdog runs and the faults restart the system unless disabled here or at runtime (SupervisorEnabled,
+//  before Setup() enables the watchdog). Without it a fault spins in its handler as before
+#define SUPERVISOR_DEFAULT_ENABLE true
+
+/* Watchdog timeout (ms), from the last feed to the capture and reset. SysTick feeds it at a PID period
+ *  start if the main loop finished the control work of the period before within its window, from the
+ *  period start to DEADLINE ms into it (the servo frame start, where the output is latched). Between
+ *  three and four PID periods, so three late or missing periods in a row restart the system.
+ */
+#define SUPERVISOR_TIMEOUT 140
+#define SUPERVISOR_DEADLINE 2
+
+// Faults restart warm (the saved level, center and gains, no levelling) up to MAX_RESTARTS times in a row,
+//  then cold. A restart is forgotten after STABLE ms without a fault
+#define SUPERVISOR_MAX_RESTARTS 3
+#define SUPERVISOR_STABLE 10000
+
+// Fault record, kept in RAM that the C startup doesn't clear (.noinit)
+#define SUPERVISOR_MAGIC 0x544C5546     // "FULT"
+#define SUPERVISOR_VERSION 1
+
+// Cause of a fault, from the active exception
+#define SUPERVISOR_CAUSE_NMI 2
+#define SUPERVISOR_CAUSE_HARD 3
+#define SUPERVISOR_CAUSE_MPU 4
+#define SUPERVISOR_CAUSE_BUS 5
+#define SUPERVISOR_CAUSE_USAGE 6
+#define SUPERVISOR_CAUSE_WATCHDOG 16    // NMI of the watchdog
+#define SUPERVISOR_CAUSE_INTERRUPT 17   // Interrupt without a handler
+
+// Reset cause, from the reset cause register
+#define SUPERVISOR_RESET_POWER 0        // Power-on or brown-out, the RAM isn't kept
+#define SUPERVISOR_RESET_PIN 1
+#define SUPERVISOR_RESET_WATCHDOG 2
+#define SUPERVISOR_RESET_SOFTWARE 3     // Fault handler
+
+// Restart decision
+#define SUPERVISOR_COLD 0               // Full Setup(), levelling and the saved configuration
+#define SUPERVISOR_WARM 1               // Level, center and gains from the record, straight into control
+
+/* Fault report, sent once after the restart (registers in hex, "0" if the stack couldn't be read):
+ *      FAULT,<cause>,<W|C>,<restarts>,<ms>,<pc>,<lr>,<psr>,<cfsr>,<hfsr>,<address>,<mode>
+ */
+#define SUPERVISOR_REPORT_SIZE 96
+
+// Registers the exception entry stacks, in stack order
+#define SUPERVISOR_R0 0
+#define SUPERVISOR_R1 1
+#define SUPERVISOR_R2 2
+#define SUPERVISOR_R3 3
+#define SUPERVISOR_R12 4
+#define SUPERVISOR_LR 5
+#define SUPERVISOR_PC 6
+#define SUPERVISOR_PSR 7
+#define SUPERVISOR_REGISTERS 8
+
+// Control state at the fault, what a warm restart needs to take over
+typedef struct {
+    uint8_t mode;
+    uint8_t running;            // Control had started (boot.c)
+    uint8_t spare[2];
+    uint32_t centerX, centerY;
+    int32_t zeroX, zeroY;
+    int32_t px, ix, dx;
+    int32_t py, iy, dy;
+    uint32_t degreesX, degreesY;
+} SupervisorState;
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t cause;
+    uint8_t restarts;           // Warm restarts in a row before this fault
+    uint8_t pending;            // Not yet taken by a restart
+    uint32_t time;              // ms since the last start
+    uint32_t registers[SUPERVISOR_REGISTERS];
+    uint32_t cfsr, hfsr, address;
+    SupervisorState state;
+    uint32_t check;             // CRC-32 of all the fields above
+} SupervisorRecord;
+
+extern _Bool SupervisorEnabled;
+
+// Record of the last fault, survives the reset
+extern SupervisorRecord SupervisorFault;
+
+// Periods that missed their deadline and feeds since the start
+extern volatile uint32_t SupervisorMissed;
+extern volatile uint32_t SupervisorFeeds;
+
+uint32_t Supervisor_Check(const SupervisorRecord *record);
+_Bool Supervisor_Valid(const SupervisorRecord *record);
+void Supervisor_Capture(SupervisorRecord *record, uint8_t cause, const uint32_t *frame,
+                        uint32_t cfsr, uint32_t hfsr, uint32_t address, unsigned long now, const SupervisorState *state);
+uint8_t Supervisor_Decide(const SupervisorRecord *record, uint8_t reset);
+uint8_t Supervisor_Report(char *line, const SupervisorRecord *record, uint8_t decision);
+void Supervisor_Restart(SupervisorRecord *record, uint8_t decision);
+void Supervisor_Save(SupervisorState *state, uint8_t mode, _Bool running);
+void Supervisor_Restore(const SupervisorState *state);
+void Supervisor_Start(void);
+_Bool Supervisor_Period(unsigned long now);
+uint32_t Supervisor_Token(void);
+void Supervisor_Done(uint32_t period, unsigned long now);
+
+#endif /* SUPERVISOR_H_ */
@@ -0,0 +1,126 @@
+/*
+ * sysid.c
+ *
+ * System identification mode
+ *  Adds a PRBS or a logarithmic chirp on top of the servo zero positions while a
+ *  light PD loop keeps the ball near the set point. The excitation, the total
+ *  command and the ball position are streamed at the touch rate so the plant
+ *  can be identified on a PC (tools/sysid.c).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "sysid.h"
+
+int32_t SysIdExcitationX = 0;
+int32_t SysIdExcitationY = 0;
+int32_t SysIdCommandX = 0;
+int32_t SysIdCommandY = 0;
+uint32_t SysIdSample = 0;
+
+uint8_t sysIdSignal = SYSID_DEFAULT_SIGNAL;
+_Bool sysIdRunning = false;
+
+// PRBS state, Y starts half a period later so both axes are uncorrelated
+uint16_t lfsrX = 0x001;
+uint16_t lfsrY = 0x0F0;
+
+// Chirp phase and phase step (fractions of a turn scaled by 2^32)
+uint32_t chirpPhase = 0;
+uint32_t chirpStep = 0;
+
+// Hold controller memory
+int32_t holdLastX = 0;
+int32_t holdLastY = 0;
+
+// Quarter wave sine table (0 to 90 degrees, 32767 = 1.0)
+const int16_t SineTable[65] = {0,804,1608,2410,3212,4011,4808,5602,6393,7179,7962,8739,9512,10278,11039,11793,12539,13279,14010,14732,15446,16151,16846,17530,18204,18868,19519,20159,20787,21403,22005,22594,23170,23731,24279,24811,25329,25832,26319,26790,27245,27683,28105,28510,28898,29268,29621,29956,30273,30571,30852,31113,31356,31580,31785,31971,32137,32285,32412,32521,32609,32678,32728,32757,32767};
+
+// Sine of <phase> (a full turn is 2^32), returns -32767 to 32767
+int32_t SysId_Sine(uint32_t phase) {
+    uint32_t quadrant = phase >> 30;
+    uint32_t index = (phase >> 24) & 0x3F;     // 64 steps per quadrant
+    int32_t frac = (phase >> 8) & 0xFFFF;       // Interpolation between steps
+
+    if(quadrant & 1) {
+        // Falling quadrants read the table backwards
+        index = 63 - index;
+        frac = 0xFFFF - frac;
+    }
+
+    int32_t a = SineTable[index];
+    int32_t b = SineTable[index + 1];
+    int32_t value = a + (((b - a) * frac) >> 16);
+
+    return (quadrant & 2) ? -value : value;
+}
+
+// 9 bit maximal length LFSR (x^9 + x^5 + 1)
+static uint16_t LFSRNext(uint16_t lfsr) {
+    uint16_t bit = ((lfsr >> 8) ^ (lfsr >> 4)) & 1;
+    return ((lfsr << 1) | bit) & 0x1FF;
+}
+
+void SysId_Start(uint8_t signal) {
+    sysIdSignal = signal;
+    sysIdRunning = true;
+    SysIdSample = 0;
+
+    lfsrX = 0x001;
+    lfsrY = 0x0F0;
+
+    // f / fs turns per sample, multiplied by SYSID_CHIRP_RATIO each sample to reach END after the sweep
+    chirpPhase = 0;
+    chirpStep = (uint32_t)(4294967296.0 * SYSID_CHIRP_START / 1000.0 / SYSID_SAMPLE_RATE);
+
+    holdLastX = 0;
+    holdLastY = 0;
+}
+
+_Bool SysId_Running(void) {
+    return sysIdRunning;
+}
+
+// Calculates the next excitation and servo command from the latest touch sample
+void SysId_Update(uint32_t x, uint32_t y) {
+    uint32_t setX, setY;
+    SeqLock_ReadPair(&Setpoint, &setX, &setY);
+
+    int32_t errorX = setX - (int32_t)(x);
+    int32_t errorY = setY - (int32_t)(y);
+
+    int32_t holdX = (SYSID_HOLD_P * errorX + SYSID_HOLD_D * (errorX - holdLastX)) / 100;
+    int32_t holdY = (SYSID_HOLD_P * errorY + SYSID_HOLD_D * (errorY - holdLastY)) / 100;
+    holdLastX = errorX;
+    holdLastY = errorY;
+
+    if(!sysIdRunning) {
+        SysIdExcitationX = 0;
+        SysIdExcitationY = 0;
+    } else if(sysIdSignal == SYSID_PRBS) {
+        if((SysIdSample % SYSID_PRBS_HOLD) == 0) {
+            lfsrX = LFSRNext(lfsrX);
+            lfsrY = LFSRNext(lfsrY);
+        }
+        SysIdExcitationX = (lfsrX & 1) ? SYSID_AMPLITUDE : -SYSID_AMPLITUDE;
+        SysIdExcitationY = (lfsrY & 1) ? SYSID_AMPLITUDE : -SYSID_AMPLITUDE;
+
+        if(SysIdSample >= (uint32_t)511 * SYSID_PRBS_HOLD * SYSID_PRBS_PERIODS) sysIdRunning = false;
+    } else {
+        // Same chirp on both axes, Y is a quarter turn ahead (cosine)
+        SysIdExcitationX = (SYSID_AMPLITUDE * SysId_Sine(chirpPhase)) / 32767;
+        SysIdExcitationY = (SYSID_AMPLITUDE * SysId_Sine(chirpPhase + 0x40000000)) / 32767;
+        chirpPhase += chirpStep;
+        chirpStep = (uint32_t)(((uint64_t)chirpStep * SYSID_CHIRP_RATIO) >> 30);
+
+        if(SysIdSample >= SYSID_CHIRP_SAMPLES) sysIdRunning = false;
+    }
+
+    SysIdCommandX = Limit(holdX + SysIdExcitationX, -SERVO_X_RANGE, SERVO_X_RANGE);
+    SysIdCommandY = Limit(holdY + SysIdExcitationY, -SERVO_Y_RANGE, SERVO_Y_RANGE);
+    SysIdSample++;
+}
@@ -0,0 +1,52 @@
+/*
+ * sysid.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef SYSID_H_
+#define SYSID_H_
+
+// Excitation signals
+#define SYSID_PRBS 0
+#define SYSID_CHIRP 1
+
+#define SYSID_DEFAULT_SIGNAL SYSID_PRBS
+
+// Excitation amplitude added to the servo command (in 10th of a degree)
+#define SYSID_AMPLITUDE 40
+
+// PRBS from a 9 bit LFSR (511 bits per period), each bit is held for <SYSID_PRBS_HOLD> touch samples
+#define SYSID_PRBS_HOLD 2
+#define SYSID_PRBS_PERIODS 6
+
+// Logarithmic chirp from START to END (in mHz) over <SYSID_CHIRP_SAMPLES> touch samples
+#define SYSID_CHIRP_START 200
+#define SYSID_CHIRP_END 10000
+#define SYSID_CHIRP_SAMPLES 6000
+
+// Frequency ratio per sample of the chirp, 2^30 * (END / START)^(1 / SAMPLES), recompute when the chirp changes
+//  (tools/sysid -v checks it)
+#define SYSID_CHIRP_RATIO 1074442136
+
+// Sample rate of the excitation (the touch update rate)
+#define SYSID_SAMPLE_RATE 100
+
+// Light PD hold that keeps the ball on the plate during the experiment (counts to 10th of a degree, /100)
+#define SYSID_HOLD_P 5
+#define SYSID_HOLD_D 250
+
+// Latest excitation and total servo command offset from SERVO_X/Y_ZERO (10th of a degree)
+extern int32_t SysIdExcitationX;
+extern int32_t SysIdExcitationY;
+extern int32_t SysIdCommandX;
+extern int32_t SysIdCommandY;
+extern uint32_t SysIdSample;
+
+void SysId_Start(uint8_t signal);
+_Bool SysId_Running(void);
+void SysId_Update(uint32_t x, uint32_t y);
+int32_t SysId_Sine(uint32_t phase);
+
+#endif /* SYSID_H_ */
@@ -38,6 +38,7 @@ SECTIONS
     .vtable :   > 0x20000000
     .data   :   > SRAM
     .bss    :   > SRAM
+    .noinit :   > SRAM, type = NOINIT     /* Fault record, kept over a reset (supervisor.c) */
     .sysmem :   > SRAM
     .stack  :   > SRAM
 }
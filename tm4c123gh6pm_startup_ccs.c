@@ -30,9 +30,9 @@
 //
 //*****************************************************************************
 void ResetISR(void);
-static void NmiSR(void);
-static void FaultISR(void);
-static void IntDefaultHandler(void);
+void NmiSR(void);
+void FaultISR(void);
+void IntDefaultHandler(void);
 
 
 //*****************************************************************************
@@ -76,9 +76,9 @@ void (* const g_pfnVectors[])(void) =
     ResetISR,                               // The reset handler
     NmiSR,                                  // The NMI handler
     FaultISR,                               // The hard fault handler
-    IntDefaultHandler,                      // The MPU fault handler
-    IntDefaultHandler,                      // The bus fault handler
-    IntDefaultHandler,                      // The usage fault handler
+    FaultISR,                               // The MPU fault handler
+    FaultISR,                               // The bus fault handler
+    FaultISR,                               // The usage fault handler
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
@@ -252,54 +252,34 @@ ResetISR(void)
 
 //*****************************************************************************
 //
-// This is the code that gets called when the processor receives a NMI.  This
-// simply enters an infinite loop, preserving the system state for examination
-// by a debugger.
+// This is the code that gets called when the processor receives a NMI (the
+// watchdog timeout), a fault interrupt or an unexpected interrupt.  It hands
+// the stack frame of the exception entry to the fault capture (main.c), which
+// records the fault and resets.  The capture enters an infinite loop instead,
+// preserving the system state for examination by a debugger, if the
+// supervision is off.
 //
-//*****************************************************************************
-static void
-NmiSR(void)
-{
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
-}
-
-//*****************************************************************************
-//
-// This is the code that gets called when the processor receives a fault
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
+// The handlers are assembly, not C functions: a compiler prologue (a debug
+// build stacks registers and a frame) would move the stack pointer before it
+// is read and the capture would record the wrong pc, lr and xPSR.  Bit 2 of
+// EXC_RETURN in lr tells which stack the exception entry stacked the frame on.
 //
 //*****************************************************************************
-static void
-FaultISR(void)
-{
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
-}
-
-//*****************************************************************************
-//
-// This is the code that gets called when the processor receives an unexpected
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
-//
-//*****************************************************************************
-static void
-IntDefaultHandler(void)
-{
-    //
-    // Go into an infinite loop.
-    //
-    while(1)
-    {
-    }
-}
+__asm("    .text\n"
+      "    .thumb\n"
+      "    .align  2\n"
+      "    .global NmiSR\n"
+      "    .global FaultISR\n"
+      "    .global IntDefaultHandler\n"
+      "    .global OnFault\n"
+      "    .thumbfunc NmiSR\n"
+      "    .thumbfunc FaultISR\n"
+      "    .thumbfunc IntDefaultHandler\n"
+      "NmiSR:\n"
+      "FaultISR:\n"
+      "IntDefaultHandler:\n"
+      "    tst     lr, #4\n"
+      "    ite     eq\n"
+      "    mrseq   r0, msp\n"
+      "    mrsne   r0, psp\n"
+      "    b.w     OnFault");
@@ -0,0 +1,228 @@
+/*
+ * linkage.c
+ *
+ * Servo linkage table generator (runs on a PC)
+ *
+ *  Solves the linkage geometry for the servo horn angles that give a plate tilt and
+ *  writes the pulse tables of linkageTable.h for ../linkage.c. The plate sits on a
+ *  gimbal at the origin, tiltY turns it about the X axis first, then tiltX about the
+ *  Y axis, so the Y pushrod moves with both tilts. Each servo shaft sits below its
+ *  plate attachment point (distance d from the pivot, on the X or Y axis) with the
+ *  horn (radius r) horizontal and pointing outwards when the plate is level, and a
+ *  pushrod of length L joins the horn tip to the plate.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o tools/linkage tools/linkage.c linkage.c servoScale.c -lm
+ *
+ *  Usage:
+ *      tools/linkage [-d attachment mm] [-r horn mm] [-l rod mm] [-x zero] [-y zero] [-o linkageTable.h]
+ *          Defaults: d = 80, r = 28, L = 60, servo zeros 867 (SERVO_X_ZERO/SERVO_Y_ZERO)
+ *      tools/linkage -v [-d ...]
+ *          Check Linkage_Pulse() (with the current linkageTable.h) against the geometry
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include "../linkage.h"
+#include "../servoScale.h"
+
+#define PI 3.14159265358979
+#define DEG_TO_RAD (PI / 180.0)
+
+// Servo_Set_Degrees() mapping (servoScale.h)
+#define TICKS_PER_DEGREE ((double)(SERVO_DUTYCYCLE_END - SERVO_DUTYCYCLE_START) * 100.0 / SERVO_SCALE_MAX)
+
+// Table layout
+#define GRID 21
+#define STEP_SHIFT 7
+
+// Required accuracy of the table (degrees of horn), well below the servo dead band
+#define ACCURACY 0.1
+
+typedef struct {
+    double d, r, l;
+} Linkage;
+
+typedef struct {
+    double x, y, z;
+} Vec3;
+
+// Plate attachment points of the X and Y pushrods at a tilt (degrees)
+static void Attachments(const Linkage *k, double tiltX, double tiltY, Vec3 *px, Vec3 *py) {
+    double a = tiltX * DEG_TO_RAD;
+    double b = tiltY * DEG_TO_RAD;
+
+    px->x = k->d * cos(a);
+    px->y = 0;
+    px->z = -k->d * sin(a);
+
+    py->x = -k->d * sin(b) * sin(a);
+    py->y = k->d * cos(b);
+    py->z = -k->d * sin(b) * cos(a);
+}
+
+/* Horn angle (degrees, positive moves the horn tip down) that reaches <p>
+ *  <radial> is the offset of p from the shaft along the horn direction, <side> across it
+ *  |p - shaft - r * (cos h, -sin h)| = L  ->  radial * cos h - z * sin h = c
+ */
+static double HornAngle(const Linkage *k, double radial, double side, double z) {
+    double c = (radial * radial + side * side + z * z + k->r * k->r - k->l * k->l) / (2.0 * k->r);
+    double amplitude = sqrt(radial * radial + z * z);
+    double delta = atan2(z, radial);
+    double ratio = c / amplitude;
+    if(ratio > 1.0) ratio = 1.0;
+    if(ratio < -1.0) ratio = -1.0;
+
+    // Two solutions, the horn works around horizontal
+    double h1 = acos(ratio) - delta;
+    double h2 = -acos(ratio) - delta;
+    return ((fabs(h1) < fabs(h2)) ? h1 : h2) / DEG_TO_RAD;
+}
+
+// Exact horn angles of both servos for a tilt (degrees)
+static void Solve(const Linkage *k, double tiltX, double tiltY, double *hornX, double *hornY) {
+    Vec3 px, py;
+    Attachments(k, tiltX, tiltY, &px, &py);
+
+    // Shafts at (d - r, 0, -L) and (0, d - r, -L)
+    *hornX = HornAngle(k, px.x - (k->d - k->r), px.y, px.z + k->l);
+    *hornY = HornAngle(k, py.y - (k->d - k->r), py.x, py.z + k->l);
+}
+
+static long LevelPulse(int zero) {
+    return ServoScale_Ticks(zero * 10);
+}
+
+static int Generate(const Linkage *k, int zeroX, int zeroY, const char *output) {
+    // Tilt per horn angle at level, from a small symmetric step
+    double hx1, hy1, hx2, hy2;
+    Solve(k, 0.01, 0, &hx1, &hy1);
+    Solve(k, -0.01, 0, &hx2, &hy2);
+    double ratio = 0.02 / (hx1 - hx2);
+
+    FILE *f = output ? fopen(output, "w") : stdout;
+    if(!f) {
+        perror(output);
+        return 1;
+    }
+
+    fprintf(f, "/*\n * linkageTable.h\n *\n * Generated by tools/linkage.c, do not edit\n");
+    fprintf(f, " *  Linkage: attachment %g mm, horn %g mm, rod %g mm, servo zeros %d/%d\n", k->d, k->r, k->l, zeroX, zeroY);
+    fprintf(f, " *  Plate tilt per horn angle at level: %.4f\n */\n\n", ratio);
+    fprintf(f, "#ifndef LINKAGETABLE_H_\n#define LINKAGETABLE_H_\n\n");
+    fprintf(f, "// %d x %d grid of plate tilts, 2^LINKAGE_STEP_SHIFT 100th of a degree apart, centered on level\n", GRID, GRID);
+    fprintf(f, "#define LINKAGE_GRID %d\n", GRID);
+    fprintf(f, "#define LINKAGE_STEP_SHIFT %d\n\n", STEP_SHIFT);
+    fprintf(f, "// Plate tilt (100th of a degree) per servo 10th of a degree at level (scaled by 2^16)\n");
+    fprintf(f, "#define LINKAGE_TILT_PER_DEGREE %ld\n\n", lround(ratio * 10.0 * 65536.0));
+    fprintf(f, "// Servo pulses at level (PWM ticks)\n");
+    fprintf(f, "#define LINKAGE_LEVEL_PULSE_X %ld\n", LevelPulse(zeroX));
+    fprintf(f, "#define LINKAGE_LEVEL_PULSE_Y %ld\n\n", LevelPulse(zeroY));
+    fprintf(f, "// Pulse offsets from level (16th of a PWM tick), rows are tiltY, columns tiltX\n");
+
+    int axis;
+    for(axis = 0; axis < 2; axis++) {
+        fprintf(f, "#define LINKAGE_TABLE_%c {", axis ? 'Y' : 'X');
+        int i, j;
+        for(j = 0; j < GRID; j++) {
+            fprintf(f, " \\\n   ");
+            for(i = 0; i < GRID; i++) {
+                double tiltX = (i - (GRID - 1) / 2) * (1 << STEP_SHIFT) / 100.0;
+                double tiltY = (j - (GRID - 1) / 2) * (1 << STEP_SHIFT) / 100.0;
+                double hornX, hornY;
+                Solve(k, tiltX, tiltY, &hornX, &hornY);
+                long value = lround((axis ? hornY : hornX) * TICKS_PER_DEGREE * 16.0);
+                if(value > INT16_MAX || value < INT16_MIN) {
+                    fprintf(stderr, "tilt %.2f/%.2f is out of the pulse table range\n", tiltX, tiltY);
+                    if(f != stdout) fclose(f);
+                    return 1;
+                }
+                fprintf(f, "%s%ld", (i || j) ? "," : "", value);
+            }
+        }
+        fprintf(f, "}\n\n");
+    }
+    fprintf(f, "#endif /* LINKAGETABLE_H_ */\n");
+
+    if(f != stdout) fclose(f);
+    return 0;
+}
+
+// Compares Linkage_Pulse() with the geometry on a dense grid, off the table points
+static int Verify(const Linkage *k, int zeroX, int zeroY) {
+    double worst = 0, worstLinear = 0;
+    double worstX = 0, worstY = 0;
+    double range = LINKAGE_TILT_RANGE / 100.0 - 0.01;
+    int count = 0;
+
+    double tiltX, tiltY;
+    for(tiltY = -range; tiltY <= range; tiltY += 0.37) {
+        for(tiltX = -range; tiltX <= range; tiltX += 0.37) {
+            double hornX, hornY;
+            Solve(k, tiltX, tiltY, &hornX, &hornY);
+            double exactX = LevelPulse(zeroX) + hornX * TICKS_PER_DEGREE;
+            double exactY = LevelPulse(zeroY) + hornY * TICKS_PER_DEGREE;
+
+            uint32_t pulseX, pulseY;
+            Linkage_Pulse(lround(tiltX * 100.0), lround(tiltY * 100.0), zeroX, zeroY, &pulseX, &pulseY);
+
+            double error = fmax(fabs(pulseX - exactX), fabs(pulseY - exactY));
+            if(error > worst) {
+                worst = error;
+                worstX = tiltX;
+                worstY = tiltY;
+            }
+
+            // Linear mapping the controller assumes without the table
+            double linearX = LevelPulse(zeroX) + tiltX * 100.0 / LINKAGE_TILT_PER_DEGREE * 65536.0 / 10.0 * TICKS_PER_DEGREE;
+            double linearY = LevelPulse(zeroY) + tiltY * 100.0 / LINKAGE_TILT_PER_DEGREE * 65536.0 / 10.0 * TICKS_PER_DEGREE;
+            worstLinear = fmax(worstLinear, fmax(fabs(linearX - exactX), fabs(linearY - exactY)));
+            count++;
+        }
+    }
+
+    printf("%d tilts within +/-%.2f deg\n", count, range);
+    printf("  table:  max error %.2f ticks (%.3f deg of horn) at %.2f/%.2f deg\n", worst, worst / TICKS_PER_DEGREE, worstX, worstY);
+    printf("  linear: max error %.2f ticks (%.3f deg of horn)\n", worstLinear, worstLinear / TICKS_PER_DEGREE);
+
+    _Bool ok = worst / TICKS_PER_DEGREE <= ACCURACY;
+    printf("%s\n", ok ? "ok" : "FAIL (regenerate linkageTable.h for this linkage)");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    Linkage k = {80.0, 28.0, 60.0};
+    int zeroX = 867, zeroY = 867;
+    const char *output = NULL;
+    _Bool verify = false;
+
+    int opt;
+    while((opt = getopt(argc, argv, "d:r:l:x:y:o:v")) != -1) {
+        switch(opt) {
+        case 'd': k.d = atof(optarg); break;
+        case 'r': k.r = atof(optarg); break;
+        case 'l': k.l = atof(optarg); break;
+        case 'x': zeroX = atoi(optarg); break;
+        case 'y': zeroY = atoi(optarg); break;
+        case 'o': output = optarg; break;
+        case 'v': verify = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-d attachment mm] [-r horn mm] [-l rod mm] [-x zero] [-y zero] [-o header] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(k.r <= 0 || k.l <= 0 || k.d <= k.r) {
+        fprintf(stderr, "%s: need 0 < horn < attachment distance and a rod length\n", argv[0]);
+        return 2;
+    }
+
+    if(verify) return Verify(&k, zeroX, zeroY);
+    return Generate(&k, zeroX, zeroY, output);
+}
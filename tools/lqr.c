@@ -0,0 +1,245 @@
+/*
+ * lqr.c
+ *
+ * Offline LQR gain synthesis for the state feedback controller (runs on a PC)
+ *
+ *  Each axis is modeled as K / (s * (s + a)) from servo command (10th of a degree) to
+ *  ball position (counts), discretized with a zero order hold at the PID period and
+ *  <delay> extra periods of input dead time. The state is everything the firmware
+ *  already has at the PID update, so no observer is needed:
+ *
+ *      p   position error (ball - set point, counts)
+ *      dp  change in p since the last update (counts/period)
+ *      i   sum of p (counts * periods)
+ *      u1..u(delay+1)   the last delay+1 commands
+ *
+ *  The discrete Riccati equation is iterated to convergence and the gains are written
+ *  as a header with fixed point constants (scaled by 2^LQR_SHIFT).
+ *
+ *  Build:
+ *      gcc -O2 -o tools/lqr tools/lqr.c -lm
+ *
+ *  Usage:
+ *      tools/lqr [-K gain] [-a pole] [-T period ms] [-d delay] [-p qpos] [-v qdif] [-i qint] [-r r] [-o lqrGains.h]
+ *          Defaults: K = 77 (tools/sysid), a = 0.3, T = 40, delay = 1, qpos = 1, qdif = 12, qint = 0.00005, r = 3
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#define MAX_DELAY 4
+#define MAX_STATES (3 + MAX_DELAY + 1)
+#define SHIFT 16
+
+typedef double Matrix[MAX_STATES][MAX_STATES];
+
+static int n;
+
+static void Multiply(Matrix a, Matrix b, Matrix out) {
+    Matrix t;
+    int i, j, k;
+    for(i = 0; i < n; i++) {
+        for(j = 0; j < n; j++) {
+            t[i][j] = 0;
+            for(k = 0; k < n; k++) t[i][j] += a[i][k] * b[k][j];
+        }
+    }
+    memcpy(out, t, sizeof(Matrix));
+}
+
+static void Transpose(Matrix a, Matrix out) {
+    Matrix t;
+    int i, j;
+    for(i = 0; i < n; i++) {
+        for(j = 0; j < n; j++) t[i][j] = a[j][i];
+    }
+    memcpy(out, t, sizeof(Matrix));
+}
+
+/*
+ * Discrete model x(k+1) = A x(k) + B u(k)
+ *  p(k+1)  = p + e*dp + b1*u(k-delay) + b2*u(k-delay-1)
+ *  dp(k+1) = e*dp + b1*u(k-delay) + b2*u(k-delay-1)
+ *  i(k+1)  = i + p
+ */
+static void Model(double k, double a, double t, int delay, Matrix A, double *B) {
+    double e = exp(-a * t);
+    double b1, b2;
+    if(a < 1e-9) {
+        b1 = b2 = k * t * t / 2.0;
+    } else {
+        b1 = k / a * (t - (1.0 - e) / a);
+        b2 = k / a * ((1.0 - e) / a - t * e);
+    }
+
+    memset(A, 0, sizeof(Matrix));
+    memset(B, 0, sizeof(double) * MAX_STATES);
+
+    A[0][0] = 1; A[0][1] = e;
+    A[1][1] = e;
+    A[2][0] = 1; A[2][2] = 1;
+
+    // Past commands: state 3 is u(k-1), state 3+j is u(k-1-j)
+    B[3] = 1;
+    int j;
+    for(j = 1; j <= delay; j++) A[3 + j][3 + j - 1] = 1;
+
+    // Command acting now is u(k-delay) (B when delay is 0), the one before it u(k-delay-1)
+    if(delay == 0) {
+        B[0] += b1;
+        B[1] += b1;
+    } else {
+        A[0][3 + delay - 1] += b1;
+        A[1][3 + delay - 1] += b1;
+    }
+    A[0][3 + delay] += b2;
+    A[1][3 + delay] += b2;
+}
+
+// Iterates P = Q + A'PA - A'PB (R + B'PB)^-1 B'PA, returns the gain row G (u = -G x)
+static int SolveDARE(Matrix A, double *B, Matrix Q, double r, double *G) {
+    Matrix P, At, AtP, AtPA;
+    int i, j, iteration;
+    memcpy(P, Q, sizeof(Matrix));
+    Transpose(A, At);
+
+    for(iteration = 0; iteration < 100000; iteration++) {
+        double PB[MAX_STATES], BtPB = 0;
+        for(i = 0; i < n; i++) {
+            PB[i] = 0;
+            for(j = 0; j < n; j++) PB[i] += P[i][j] * B[j];
+            BtPB += B[i] * PB[i];
+        }
+
+        // G = (r + B'PB)^-1 B'PA
+        double BtPA[MAX_STATES];
+        for(j = 0; j < n; j++) {
+            BtPA[j] = 0;
+            for(i = 0; i < n; i++) BtPA[j] += PB[i] * A[i][j];
+            G[j] = BtPA[j] / (r + BtPB);
+        }
+
+        Multiply(At, P, AtP);
+        Multiply(AtP, A, AtPA);
+
+        double change = 0;
+        for(i = 0; i < n; i++) {
+            for(j = 0; j < n; j++) {
+                double next = Q[i][j] + AtPA[i][j] - BtPA[i] * G[j];
+                double scale = fabs(next) > 1.0 ? fabs(next) : 1.0;
+                if(fabs(next - P[i][j]) / scale > change) change = fabs(next - P[i][j]) / scale;
+                P[i][j] = next;
+            }
+        }
+        if(change < 1e-12) return iteration;
+    }
+    return -1;
+}
+
+// Spectral radius estimate of A - BG by power iteration (closed loop stability check)
+static double ClosedLoopRadius(Matrix A, double *B, double *G) {
+    Matrix C;
+    double v[MAX_STATES], w[MAX_STATES];
+    int i, j, iteration;
+    double radius = 0;
+
+    for(i = 0; i < n; i++) {
+        for(j = 0; j < n; j++) C[i][j] = A[i][j] - B[i] * G[j];
+        v[i] = 1.0 + i;
+    }
+    for(iteration = 0; iteration < 2000; iteration++) {
+        double norm = 0;
+        for(i = 0; i < n; i++) {
+            w[i] = 0;
+            for(j = 0; j < n; j++) w[i] += C[i][j] * v[j];
+            norm += w[i] * w[i];
+        }
+        norm = sqrt(norm);
+        if(norm == 0) return 0;
+        for(i = 0; i < n; i++) v[i] = w[i] / norm;
+        radius = norm;
+    }
+    return radius;
+}
+
+int main(int argc, char **argv) {
+    double k = 77.0, a = 0.3, periodMs = 40;
+    double qPos = 1.0, qDif = 12.0, qInt = 0.00005, r = 3.0;
+    int delay = 1;
+    const char *output = NULL;
+
+    int opt;
+    while((opt = getopt(argc, argv, "K:a:T:d:p:v:i:r:o:")) != -1) {
+        switch(opt) {
+        case 'K': k = atof(optarg); break;
+        case 'a': a = atof(optarg); break;
+        case 'T': periodMs = atof(optarg); break;
+        case 'd': delay = atoi(optarg); break;
+        case 'p': qPos = atof(optarg); break;
+        case 'v': qDif = atof(optarg); break;
+        case 'i': qInt = atof(optarg); break;
+        case 'r': r = atof(optarg); break;
+        case 'o': output = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-K gain] [-a pole] [-T period ms] [-d delay] [-p qpos] [-v qdif] [-i qint] [-r r] [-o header]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(delay < 0 || delay > MAX_DELAY) {
+        fprintf(stderr, "%s: delay must be 0 to %d periods\n", argv[0], MAX_DELAY);
+        return 2;
+    }
+
+    n = 3 + delay + 1;
+    Matrix A, Q;
+    double B[MAX_STATES], G[MAX_STATES];
+    Model(k, a, periodMs / 1000.0, delay, A, B);
+
+    memset(Q, 0, sizeof(Matrix));
+    Q[0][0] = qPos;
+    Q[1][1] = qDif;
+    Q[2][2] = qInt;
+
+    int iterations = SolveDARE(A, B, Q, r, G);
+    if(iterations < 0) {
+        fprintf(stderr, "%s: Riccati iteration did not converge\n", argv[0]);
+        return 1;
+    }
+    double radius = ClosedLoopRadius(A, B, G);
+    fprintf(stderr, "Converged in %d iterations, closed loop spectral radius %.4f\n", iterations, radius);
+    if(radius >= 1.0) {
+        fprintf(stderr, "%s: closed loop is unstable\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = output ? fopen(output, "w") : stdout;
+    if(!f) {
+        perror(output);
+        return 1;
+    }
+
+    int j;
+    fprintf(f, "/*\n * lqrGains.h\n *\n * Generated by tools/lqr.c, do not edit\n");
+    fprintf(f, " *  Model: K = %g counts/s^2 per 0.1 deg, a = %g 1/s, T = %g ms, %d period(s) of dead time\n", k, a, periodMs, delay);
+    fprintf(f, " *  Weights: qpos = %g, qdif = %g, qint = %g, r = %g\n", qPos, qDif, qInt, r);
+    fprintf(f, " *  Closed loop spectral radius: %.4f\n */\n\n", radius);
+    fprintf(f, "#ifndef LQRGAINS_H_\n#define LQRGAINS_H_\n\n");
+    fprintf(f, "// Gains are scaled by 2^LQR_SHIFT, command = -(POS*p + DIF*dp + INT*i + INPUT . past commands)\n");
+    fprintf(f, "#define LQR_SHIFT %d\n", SHIFT);
+    fprintf(f, "#define LQR_DELAY %d\n\n", delay);
+    fprintf(f, "#define LQR_GAIN_POS %ld\n", lround(G[0] * (1 << SHIFT)));
+    fprintf(f, "#define LQR_GAIN_DIF %ld\n", lround(G[1] * (1 << SHIFT)));
+    fprintf(f, "#define LQR_GAIN_INT %ld\n", lround(G[2] * (1 << SHIFT)));
+    fprintf(f, "#define LQR_GAIN_INPUT {");
+    for(j = 0; j <= delay; j++) fprintf(f, "%s%ld", j ? ", " : "", lround(G[3 + j] * (1 << SHIFT)));
+    fprintf(f, "}\n\n#endif /* LQRGAINS_H_ */\n");
+
+    if(f != stdout) fclose(f);
+    return 0;
+}
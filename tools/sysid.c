@@ -0,0 +1,404 @@
+/*
+ * sysid.c
+ *
+ * Frequency response identification from a system identification mode capture (runs on a PC)
+ *
+ *  Reads the "sample,excitationX,commandX,x,excitationY,commandY,y" lines streamed in
+ *  MODE_SYSID, estimates the frequency response of each axis from servo command
+ *  (10th of a degree) to ball position (counts) and fits
+ *
+ *      G(s) = K * e^(-s*Td) / s^2
+ *
+ *  The rolling loss pole a of K * e^(-s*Td) / (s * (s + a)) isn't fitted: it sits
+ *  around 0.05 Hz, below what a capture of a minute excites (the fit of a synthetic
+ *  a = 0.3 1/s came out anywhere from 0 to 1), and it changes the response in the
+ *  fitted band by a few percent at most.
+ *
+ *  The capture is streamed through Welch averaging (Hann windowed segments with 50%
+ *  overlap) so memory use only depends on the segment length. The excitation is used
+ *  as the instrument (H = Sry / Sru) so the light hold loop doesn't bias the estimate.
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o tools/sysid tools/sysid.c sysid.c controller.c predictor.c shaper.c notch.c disturbance.c schedule.c seqlock.c -lm
+ *
+ *  Usage:
+ *      tools/sysid [-n segment] [-f fmin] [-F fmax] [-p] capture.csv   (- for stdin)
+ *          -p  Print the frequency response table
+ *      tools/sysid -g [-c] [-K gain] [-a pole] [-d delay ms] [-s seconds]
+ *          Write a synthetic capture from a known model to stdout (-c for the chirp)
+ *      tools/sysid -v
+ *          Identify synthetic captures of a known model and check the fit
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include "../controller.h"
+#include "../sysid.h"
+
+#define PI 3.14159265358979
+#define MAX_SEGMENT 4096
+#define SAMPLE_TIME (1.0 / SYSID_SAMPLE_RATE)
+
+typedef struct {
+    int n;
+    long count;
+    int head;
+    double r[MAX_SEGMENT], u[MAX_SEGMENT], y[MAX_SEGMENT];
+
+    // Averaged auto and cross spectra
+    double complex sru[MAX_SEGMENT / 2 + 1];
+    double complex sry[MAX_SEGMENT / 2 + 1];
+    double srr[MAX_SEGMENT / 2 + 1];
+    double syy[MAX_SEGMENT / 2 + 1];
+    int segments;
+} Welch;
+
+typedef struct {
+    double k, delay;
+    double cost;
+    int bins;
+} Fit;
+
+static void FFT(double complex *data, int n) {
+    int i, j, len;
+    for(i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for(; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if(i < j) {
+            double complex t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+    }
+    for(len = 2; len <= n; len <<= 1) {
+        double complex w = cexp(-2.0 * I * PI / len);
+        for(i = 0; i < n; i += len) {
+            double complex wn = 1.0;
+            for(j = 0; j < len / 2; j++) {
+                double complex a = data[i + j];
+                double complex b = data[i + j + len / 2] * wn;
+                data[i + j] = a + b;
+                data[i + j + len / 2] = a - b;
+                wn *= w;
+            }
+        }
+    }
+}
+
+static void Welch_Init(Welch *w, int n) {
+    memset(w, 0, sizeof(*w));
+    w->n = n;
+}
+
+// Remove the mean and slope, apply a Hann window and transform
+static void Segment(const double *ring, int head, int n, double complex *out) {
+    double sum = 0, sumT = 0;
+    int i;
+    for(i = 0; i < n; i++) {
+        double v = ring[(head + i) % n];
+        sum += v;
+        sumT += v * (i - (n - 1) / 2.0);
+    }
+    double mean = sum / n;
+    double slope = sumT / ((double)n * (n * n - 1) / 12.0);
+
+    for(i = 0; i < n; i++) {
+        double v = ring[(head + i) % n] - mean - slope * (i - (n - 1) / 2.0);
+        out[i] = v * (0.5 - 0.5 * cos(2.0 * PI * i / n));
+    }
+    FFT(out, n);
+}
+
+static void Welch_Add(Welch *w, double r, double u, double y) {
+    static double complex fr[MAX_SEGMENT], fu[MAX_SEGMENT], fy[MAX_SEGMENT];
+    int n = w->n;
+
+    w->r[w->head] = r;
+    w->u[w->head] = u;
+    w->y[w->head] = y;
+    w->head = (w->head + 1) % n;
+    w->count++;
+
+    if(w->count < n || ((w->count - n) % (n / 2)) != 0) return;
+
+    Segment(w->r, w->head, n, fr);
+    Segment(w->u, w->head, n, fu);
+    Segment(w->y, w->head, n, fy);
+
+    int k;
+    for(k = 0; k <= n / 2; k++) {
+        w->sru[k] += conj(fr[k]) * fu[k];
+        w->sry[k] += conj(fr[k]) * fy[k];
+        w->srr[k] += creal(conj(fr[k]) * fr[k]);
+        w->syy[k] += creal(conj(fy[k]) * fy[k]);
+    }
+    w->segments++;
+}
+
+static double Frequency(const Welch *w, int k) {
+    return (double)k / (w->n * SAMPLE_TIME);
+}
+
+// Frequency response with the zero order hold of the command removed
+static double complex Response(const Welch *w, int k) {
+    double omega = 2.0 * PI * Frequency(w, k);
+    double half = omega * SAMPLE_TIME / 2.0;
+    double complex hold = (sin(half) / half) * cexp(-I * half);
+    return (w->sry[k] / w->sru[k]) / hold;
+}
+
+static double Coherence(const Welch *w, int k) {
+    double denominator = w->srr[k] * w->syy[k];
+    if(denominator <= 0) return 0;
+    return creal(w->sry[k] * conj(w->sry[k])) / denominator;
+}
+
+static double Wrap(double angle) {
+    while(angle > PI) angle -= 2.0 * PI;
+    while(angle < -PI) angle += 2.0 * PI;
+    return angle;
+}
+
+// Log magnitude and phase fit of K*e^(-s*Td)/s^2 over a grid of Td, weighted by coherence
+static Fit FitModel(const Welch *w, double fmin, double fmax) {
+    Fit best = {0, 0, 1e30, 0};
+    double delay;
+    int k;
+
+    for(delay = 0; delay <= 0.25; delay += 0.0005) {
+        double sumW = 0, sumLog = 0;
+        for(k = 1; k <= w->n / 2; k++) {
+            double f = Frequency(w, k);
+            double coh = Coherence(w, k);
+            if(f < fmin || f > fmax || coh < 0.5) continue;
+            double omega = 2.0 * PI * f;
+            double complex b = cexp(-I * omega * delay) / ((I * omega) * (I * omega));
+            sumLog += coh * (log(cabs(Response(w, k))) - log(cabs(b)));
+            sumW += coh;
+        }
+        if(sumW <= 0) return best;
+        double logK = sumLog / sumW;
+
+        double cost = 0;
+        int bins = 0;
+        for(k = 1; k <= w->n / 2; k++) {
+            double f = Frequency(w, k);
+            double coh = Coherence(w, k);
+            if(f < fmin || f > fmax || coh < 0.5) continue;
+            double omega = 2.0 * PI * f;
+            double complex h = Response(w, k);
+            double complex b = cexp(-I * omega * delay) / ((I * omega) * (I * omega));
+            double magnitude = log(cabs(h)) - log(cabs(b)) - logK;
+            double phase = Wrap(carg(h) - carg(b));
+            cost += coh * (magnitude * magnitude + phase * phase);
+            bins++;
+        }
+        cost /= sumW;
+        if(cost < best.cost) {
+            best.k = exp(logK);
+            best.delay = delay;
+            best.cost = cost;
+            best.bins = bins;
+        }
+    }
+    return best;
+}
+
+static void PrintResponse(const char *axis, const Welch *w, double fmin, double fmax) {
+    int k;
+    printf("# %s axis frequency response\n# f(Hz) gain(dB) phase(deg) coherence\n", axis);
+    for(k = 1; k <= w->n / 2; k++) {
+        double f = Frequency(w, k);
+        if(f < fmin || f > fmax) continue;
+        double complex h = Response(w, k);
+        printf("%.4f %.2f %.1f %.3f\n", f, 20.0 * log10(cabs(h)), carg(h) * 180.0 / PI, Coherence(w, k));
+    }
+}
+
+static void PrintFit(const char *axis, const Fit *fit) {
+    printf("%s: K = %.3f counts/s^2 per 0.1 deg, Td = %.0f ms (%d bins, cost %.4f)\n",
+           axis, fit->k, fit->delay * 1000.0, fit->bins, fit->cost);
+}
+
+/*
+ * Synthetic data
+ *  Simulates both axes as K*e^(-s*Td)/(s*(s+a)) at 1 ms in closed loop with the
+ *  firmware's hold controller and excitation (../sysid.c), sampled at the touch rate.
+ */
+typedef void (*SampleFunction)(void *context, long sample, int32_t rx, int32_t ux, int32_t x, int32_t ry, int32_t uy, int32_t y);
+
+#define SYNTH_MAX_DELAY 1000
+
+static void Synthesize(uint8_t signal, double k, double a, double delay, double seconds, int noise,
+                       SampleFunction output, void *context) {
+    double pos[2] = {0, 0}, vel[2] = {0, 0};
+    int32_t history[2][SYNTH_MAX_DELAY] = {{0}};
+    int delayMs = (int)(delay * 1000.0 + 0.5);
+    long steps = (long)(seconds * 1000.0);
+    long t;
+    uint32_t seed = 1;
+
+    if(delayMs >= SYNTH_MAX_DELAY) delayMs = SYNTH_MAX_DELAY - 1;
+
+    SeqLock_WritePair(&Setpoint, CENTER_X, CENTER_Y);
+    SysId_Start(signal);
+
+    for(t = 0; t < steps; t++) {
+        if((t % (1000 / SYSID_SAMPLE_RATE)) == 0) {
+            int32_t measured[2];
+            int axis;
+            for(axis = 0; axis < 2; axis++) {
+                seed = seed * 1103515245u + 12345u;
+                int n = noise ? (int)((seed >> 16) % (2 * noise + 1)) - noise : 0;
+                measured[axis] = (int32_t)lround(CENTER_X + pos[axis]) + n;
+            }
+            if(!SysId_Running()) break;
+            SysId_Update(measured[0], measured[1]);
+            output(context, SysIdSample - 1, SysIdExcitationX, SysIdCommandX, measured[0],
+                   SysIdExcitationY, SysIdCommandY, measured[1]);
+        }
+
+        int axis;
+        for(axis = 0; axis < 2; axis++) {
+            int32_t *h = history[axis];
+            h[t % SYNTH_MAX_DELAY] = axis ? SysIdCommandY : SysIdCommandX;
+            double u = (t >= delayMs) ? h[(t - delayMs) % SYNTH_MAX_DELAY] : 0;
+            vel[axis] += (k * u - a * vel[axis]) * 0.001;
+            pos[axis] += vel[axis] * 0.001;
+        }
+    }
+}
+
+static void WriteSample(void *context, long sample, int32_t rx, int32_t ux, int32_t x, int32_t ry, int32_t uy, int32_t y) {
+    (void)context;
+    printf("%ld,%d,%d,%d,%d,%d,%d\n", sample, rx, ux, x, ry, uy, y);
+}
+
+static void AddSample(void *context, long sample, int32_t rx, int32_t ux, int32_t x, int32_t ry, int32_t uy, int32_t y) {
+    Welch *axes = (Welch *)context;
+    (void)sample;
+    Welch_Add(&axes[0], rx, ux, x);
+    Welch_Add(&axes[1], ry, uy, y);
+}
+
+static int Validate(void) {
+    static Welch axes[2];
+    const double k = 77.0, a = 0.3, delay = 0.045;
+    int failures = 0;
+    uint8_t signal;
+
+    double ratio = 1073741824.0 * pow((double)SYSID_CHIRP_END / SYSID_CHIRP_START, 1.0 / SYSID_CHIRP_SAMPLES);
+    _Bool ratioOk = fabs(ratio - SYSID_CHIRP_RATIO) <= 1.0;
+    printf("SYSID_CHIRP_RATIO %d (%.0f)  %s\n", SYSID_CHIRP_RATIO, ratio, ratioOk ? "ok" : "FAIL");
+    if(!ratioOk) failures++;
+
+    for(signal = SYSID_PRBS; signal <= SYSID_CHIRP; signal++) {
+        Welch_Init(&axes[0], 512);
+        Welch_Init(&axes[1], 512);
+        Synthesize(signal, k, a, delay, 120.0, 3, AddSample, axes);
+
+        int axis;
+        for(axis = 0; axis < 2; axis++) {
+            Fit fit = FitModel(&axes[axis], 0.2, 8.0);
+            // The synthetic plant has the rolling loss the fit leaves out
+            _Bool ok = fabs(fit.k - k) < 0.1 * k && fabs(fit.delay - delay) < 0.005;
+            printf("%-6s %s: K = %.3f (%.3f)  Td = %.1f ms (%.0f)  %s\n",
+                   signal == SYSID_PRBS ? "PRBS" : "chirp", axis ? "Y" : "X",
+                   fit.k, k, fit.delay * 1000.0, delay * 1000.0, ok ? "ok" : "FAIL");
+            if(!ok) failures++;
+        }
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    static Welch axes[2];
+    int segment = 512;
+    double fmin = 0.2, fmax = 8.0;
+    double k = 77.0, a = 0.3, delayMs = 45, seconds = 120;
+    _Bool generate = false, print = false;
+    uint8_t signal = SYSID_PRBS;
+
+    int opt;
+    while((opt = getopt(argc, argv, "n:f:F:pgcK:a:d:s:v")) != -1) {
+        switch(opt) {
+        case 'n': segment = atoi(optarg); break;
+        case 'f': fmin = atof(optarg); break;
+        case 'F': fmax = atof(optarg); break;
+        case 'p': print = true; break;
+        case 'g': generate = true; break;
+        case 'c': signal = SYSID_CHIRP; break;
+        case 'K': k = atof(optarg); break;
+        case 'a': a = atof(optarg); break;
+        case 'd': delayMs = atof(optarg); break;
+        case 's': seconds = atof(optarg); break;
+        case 'v': return Validate();
+        default:
+            fprintf(stderr, "usage: %s [-n segment] [-f fmin] [-F fmax] [-p] capture.csv\n"
+                            "       %s -g [-c] [-K gain] [-a pole] [-d delay ms] [-s seconds]\n"
+                            "       %s -v\n", argv[0], argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if(generate) {
+        Synthesize(signal, k, a, delayMs / 1000.0, seconds, 3, WriteSample, NULL);
+        return 0;
+    }
+
+    if(optind >= argc) {
+        fprintf(stderr, "%s: no capture file\n", argv[0]);
+        return 2;
+    }
+    if(segment < 16 || segment > MAX_SEGMENT || (segment & (segment - 1))) {
+        fprintf(stderr, "%s: segment must be a power of 2 from 16 to %d\n", argv[0], MAX_SEGMENT);
+        return 2;
+    }
+
+    FILE *f = strcmp(argv[optind], "-") ? fopen(argv[optind], "r") : stdin;
+    if(!f) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    Welch_Init(&axes[0], segment);
+    Welch_Init(&axes[1], segment);
+
+    // Lines that aren't samples (START, echoed characters) are skipped
+    char line[256];
+    long sample;
+    int rx, ux, x, ry, uy, y;
+    while(fgets(line, sizeof(line), f)) {
+        if(sscanf(line, "%ld,%d,%d,%d,%d,%d,%d", &sample, &rx, &ux, &x, &ry, &uy, &y) != 7) continue;
+        Welch_Add(&axes[0], rx, ux, x);
+        Welch_Add(&axes[1], ry, uy, y);
+    }
+    if(f != stdin) fclose(f);
+
+    if(axes[0].segments == 0) {
+        fprintf(stderr, "%s: capture is shorter than one segment (%d samples)\n", argv[0], segment);
+        return 1;
+    }
+
+    if(print) {
+        PrintResponse("X", &axes[0], fmin, fmax);
+        PrintResponse("Y", &axes[1], fmin, fmax);
+    }
+
+    Fit fitX = FitModel(&axes[0], fmin, fmax);
+    Fit fitY = FitModel(&axes[1], fmin, fmax);
+    printf("%ld samples, %d segments of %d\n", axes[0].count, axes[0].segments, segment);
+    PrintFit("X", &fitX);
+    PrintFit("Y", &fitY);
+    return 0;
+}
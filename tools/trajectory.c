@@ -0,0 +1,848 @@
+/*
+ * trajectory.c
+ *
+ * Trajectory compiler (runs on a PC)
+ *
+ *  Turns parametric curves and SVG polylines into setpoint streams for MODE_TRAJECTORY
+ *  and writes them to trajectoryTable.h for ../trajectory.c. Each path is resampled
+ *  by arc length (corners of polylines rounded to arcs of the corner radius), its
+ *  speed limited along the path by the acceleration its curvature takes
+ *  (speed^2 * curvature) and by the speed limit, then by the tangential acceleration left of the acceleration limit in a
+ *  forward and a backward pass (zero speed at the ends of an open path). The timed
+ *  path is sampled at the setpoint period (a loop stretched to a whole number of
+ *  setpoints) and the integer positions stored as second differences (trajectory.h).
+ *
+ *  Build (from the repository root):
+ *      gcc -O2 -o tools/trajectory tools/trajectory.c trajectory.c -lm
+ *
+ *  Usage:
+ *      tools/trajectory [-V speed] [-A accel] [-t period] [-r radius] [-o trajectoryTable.h] [shape...]
+ *          Shapes: circle:r, ellipse:rx,ry, eight:a,b (a figure eight), star:R,r[,points] and
+ *          file.svg[:scale] (first polyline, polygon or path of M/L/H/V/Z commands, Y up,
+ *          centered, scale in counts per SVG unit)
+ *          Defaults: speed 1500 counts/s, accel 3000 counts/s^2, period 5 ms, corner radius
+ *          10 counts, shapes circle:250 ellipse:700,350 eight:600,300 star:700,300
+ *      tools/trajectory -v
+ *          Round trips the default shapes, a few SVG paths and random entries through
+ *          Trajectory_Next() and checks the path, the limits and the size
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <unistd.h>
+#include "../trajectory.h"
+
+#define PI 3.14159265358979
+
+#define DEFAULT_SPEED 1500.0
+#define DEFAULT_ACCEL 3000.0
+#define DEFAULT_PERIOD 5
+#define DEFAULT_RADIUS 10.0
+
+// Points of a parametric curve before resampling
+#define CURVE_POINTS 4000
+
+// Path resampled every RESAMPLE counts, curvature taken over CURVATURE_SPAN counts each side
+#define RESAMPLE 0.25
+#define CURVATURE_SPAN 3.0
+
+// Largest path, setpoints of a trajectory and trajectories
+#define MAX_PATH 100000
+#define MAX_POINTS 20000
+#define MAX_TRAJECTORIES 16
+#define MAX_DATA 65536
+
+// Setpoints must stay this close to the center (counts), inside the frame on both axes
+#define MAX_OFFSET 1500
+
+// Largest second difference of an escaped entry (3 byte zigzag varint)
+#define MAX_DIFFERENCE ((1 << 21) - 1)
+
+typedef struct {
+    char name[64];
+    double x[MAX_PATH], y[MAX_PATH];
+    int count;
+    _Bool closed;
+    _Bool corners;          // Polyline, corners are rounded
+} Path;
+
+typedef struct {
+    double speed, accel;    // Limits (counts/s, counts/s^2)
+    uint16_t period;        // Setpoint period (ms)
+    double radius;          // Corner radius of polylines (counts)
+} Limits;
+
+typedef struct {
+    Trajectory t;
+    int32_t x[MAX_POINTS], y[MAX_POINTS];      // Setpoints (counts from the center)
+    double exactX[MAX_POINTS], exactY[MAX_POINTS];
+    double time;            // Time of one pass (s)
+    uint32_t bytes;
+    uint8_t longest;        // Longest entry (bytes)
+    uint32_t escapes;
+} Compiled;
+
+static uint8_t data[MAX_DATA];
+static uint32_t dataBytes = 0;
+
+/*
+ * Paths
+ */
+
+static int Parametric(Path *p, const char *shape, const double *a, int count) {
+    int i;
+    p->closed = true;
+    p->corners = false;
+    p->count = CURVE_POINTS;
+
+    if(!strcmp(shape, "circle") && count == 1) {
+        for(i = 0; i < CURVE_POINTS; i++) {
+            double t = 2.0 * PI * i / CURVE_POINTS;
+            p->x[i] = a[0] * cos(t);
+            p->y[i] = a[0] * sin(t);
+        }
+    } else if(!strcmp(shape, "ellipse") && count == 2) {
+        for(i = 0; i < CURVE_POINTS; i++) {
+            double t = 2.0 * PI * i / CURVE_POINTS;
+            p->x[i] = a[0] * cos(t);
+            p->y[i] = a[1] * sin(t);
+        }
+    } else if(!strcmp(shape, "eight") && count == 2) {
+        for(i = 0; i < CURVE_POINTS; i++) {
+            double t = 2.0 * PI * i / CURVE_POINTS;
+            p->x[i] = a[0] * sin(t);
+            p->y[i] = a[1] * sin(2.0 * t);
+        }
+    } else if(!strcmp(shape, "star") && (count == 2 || count == 3)) {
+        int points = (count == 3) ? (int)a[2] : 5;
+        if(points < 2 || points > 50) return 0;
+        p->count = 2 * points;
+        p->corners = true;
+        for(i = 0; i < 2 * points; i++) {
+            double t = PI * i / points;
+            double r = (i % 2) ? a[1] : a[0];
+            p->x[i] = r * cos(t);
+            p->y[i] = r * sin(t);
+        }
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// Numbers of an SVG attribute, returns the count
+static int SvgNumbers(const char *text, double *values, int max) {
+    int count = 0;
+    while(*text && count < max) {
+        while(*text && !(isdigit((unsigned char)*text) || *text == '-' || *text == '+' || *text == '.')) text++;
+        if(!*text) break;
+        char *end;
+        values[count++] = strtod(text, &end);
+        if(end == text) break;
+        text = end;
+    }
+    return count;
+}
+
+// Value of attribute <name> of the element at <element>, up to the closing quote
+static const char *SvgAttribute(const char *element, const char *name, char *value, size_t size) {
+    const char *close = strchr(element, '>');
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), " %s=", name);
+    const char *a = strstr(element, pattern);
+    if(!a || (close && a > close)) return NULL;
+    a += strlen(pattern);
+    char quote = *a++;
+    const char *end = strchr(a, quote);
+    if(!end || end - a >= (long)size) return NULL;
+    memcpy(value, a, end - a);
+    value[end - a] = '\0';
+    return value;
+}
+
+// Path data with absolute and relative M, L, H, V and Z, returns 0 on other commands
+static int SvgPathData(Path *p, const char *d) {
+    double x = 0, y = 0, startX = 0, startY = 0;
+    char command = 0;
+    p->count = 0;
+    p->closed = false;
+
+    while(*d) {
+        if(*d == ' ' || *d == ',' || *d == '\n' || *d == '\t' || *d == '\r') {
+            d++;
+            continue;
+        }
+        if(strchr("MmLlHhVvZz", *d)) {
+            command = *d++;
+            if(command == 'Z' || command == 'z') {
+                p->closed = true;
+                x = startX;
+                y = startY;
+            }
+            continue;
+        }
+        if(!strchr("0123456789+-.", *d) || !command || command == 'Z' || command == 'z') return 0;
+
+        char *end;
+        double a = strtod(d, &end), b = 0;
+        d = end;
+        _Bool relative = (command >= 'a');
+        switch(command) {
+        case 'M': case 'm': case 'L': case 'l':
+            while(*d == ' ' || *d == ',') d++;
+            b = strtod(d, &end);
+            if(end == d) return 0;
+            d = end;
+            x = relative ? x + a : a;
+            y = relative ? y + b : b;
+            if(command == 'M' || command == 'm') {
+                // A second subpath isn't supported, later pairs are lines
+                if(p->count > 0) return 0;
+                startX = x;
+                startY = y;
+                command = relative ? 'l' : 'L';
+            }
+            break;
+        case 'H': case 'h':
+            x = relative ? x + a : a;
+            break;
+        case 'V': case 'v':
+            y = relative ? y + a : a;
+            break;
+        }
+        if(p->count >= MAX_PATH) return 0;
+        p->x[p->count] = x;
+        p->y[p->count] = y;
+        p->count++;
+    }
+    return 1;
+}
+
+// First polyline, polygon or path of <svg>, centered, Y up and scaled to counts
+static int SvgPath(Path *p, const char *svg, double scale) {
+    char *value = malloc(MAX_DATA * 4);
+    const char *polyline = strstr(svg, "<polyline");
+    const char *polygon = strstr(svg, "<polygon");
+    const char *path = strstr(svg, "<path");
+    const char *first = NULL;
+    int ok = 0;
+
+    if(polyline) first = polyline;
+    if(polygon && (!first || polygon < first)) first = polygon;
+    if(path && (!first || path < first)) first = path;
+
+    if(first && first == path) {
+        if(SvgAttribute(first, "d", value, MAX_DATA * 4)) ok = SvgPathData(p, value);
+    } else if(first && SvgAttribute(first, "points", value, MAX_DATA * 4)) {
+        static double numbers[2 * MAX_PATH];
+        int count = SvgNumbers(value, numbers, 2 * MAX_PATH) / 2, i;
+        for(i = 0; i < count; i++) {
+            p->x[i] = numbers[2 * i];
+            p->y[i] = numbers[2 * i + 1];
+        }
+        p->count = count;
+        p->closed = (first == polygon);
+        ok = 1;
+    }
+    free(value);
+    if(!ok || p->count < 2) return 0;
+
+    // A closed path ends where it starts, once
+    if(p->closed && p->x[p->count - 1] == p->x[0] && p->y[p->count - 1] == p->y[0]) p->count--;
+
+    double minX = p->x[0], maxX = p->x[0], minY = p->y[0], maxY = p->y[0];
+    int i;
+    for(i = 1; i < p->count; i++) {
+        minX = fmin(minX, p->x[i]);
+        maxX = fmax(maxX, p->x[i]);
+        minY = fmin(minY, p->y[i]);
+        maxY = fmax(maxY, p->y[i]);
+    }
+    for(i = 0; i < p->count; i++) {
+        p->x[i] = (p->x[i] - (minX + maxX) / 2.0) * scale;
+        p->y[i] = -(p->y[i] - (minY + maxY) / 2.0) * scale;
+    }
+    p->corners = true;
+    return 1;
+}
+
+static int ReadShape(Path *p, const char *spec) {
+    char shape[64];
+    double a[4];
+    int count = 0;
+
+    snprintf(p->name, sizeof(p->name), "%s", spec);
+    const char *colon = strchr(spec, ':');
+    size_t length = colon ? (size_t)(colon - spec) : strlen(spec);
+    if(length >= sizeof(shape)) return 0;
+    memcpy(shape, spec, length);
+    shape[length] = '\0';
+    if(colon) count = SvgNumbers(colon + 1, a, 4);
+
+    if(length > 4 && !strcmp(shape + length - 4, ".svg")) {
+        FILE *f = fopen(shape, "rb");
+        if(!f) return 0;
+        char *svg = calloc(1, MAX_DATA * 16);
+        size_t read = fread(svg, 1, MAX_DATA * 16 - 1, f);
+        fclose(f);
+        svg[read] = '\0';
+        int ok = SvgPath(p, svg, count ? a[0] : 1.0);
+        free(svg);
+        return ok;
+    }
+    return Parametric(p, shape, a, count);
+}
+
+// Distance of a point along the path
+static double Length(const Path *p, double *at) {
+    double length = 0;
+    int i, segments = p->closed ? p->count : p->count - 1;
+    for(i = 0; i < segments; i++) {
+        int j = (i + 1) % p->count;
+        at[i] = length;
+        length += hypot(p->x[j] - p->x[i], p->y[j] - p->y[i]);
+    }
+    at[segments] = length;
+    return length;
+}
+
+// Points every <spacing> counts along <in>, the last one short of the start on a loop
+static void Resample(const Path *in, Path *out, double spacing) {
+    static double at[MAX_PATH + 1];
+    double length = Length(in, at);
+    int n = (int)lround(length / spacing), i, segment = 0;
+    if(n < (in->closed ? 3 : 1)) n = in->closed ? 3 : 1;
+    if(n >= MAX_PATH) n = MAX_PATH - 1;
+    double ds = length / n;
+    int segments = in->closed ? in->count : in->count - 1;
+
+    *out = *in;
+    out->count = in->closed ? n : n + 1;
+    for(i = 0; i < out->count; i++) {
+        double s = i * ds;
+        while(segment < segments - 1 && at[segment + 1] <= s) segment++;
+        double span = at[segment + 1] - at[segment];
+        double f = span > 0 ? (s - at[segment]) / span : 0;
+        if(f > 1) f = 1;
+        int j = (segment + 1) % in->count;
+        out->x[i] = in->x[segment] + f * (in->x[j] - in->x[segment]);
+        out->y[i] = in->y[segment] + f * (in->y[j] - in->y[segment]);
+    }
+    if(!in->closed) {
+        out->x[out->count - 1] = in->x[in->count - 1];
+        out->y[out->count - 1] = in->y[in->count - 1];
+    }
+}
+
+static void Add(Path *p, double x, double y) {
+    if(p->count < MAX_PATH) {
+        p->x[p->count] = x;
+        p->y[p->count] = y;
+        p->count++;
+    }
+}
+
+/* Replaces the corners of a polyline with arcs of <radius> counts, tangent to both sides
+ *  An arc takes at most half of each side, on short sides the radius is smaller
+ */
+static void Fillet(const Path *in, Path *out, double radius) {
+    int n = in->count, i, k;
+    *out = *in;
+    out->count = 0;
+    for(i = 0; i < n; i++) {
+        if(!in->closed && (i == 0 || i == n - 1)) {
+            Add(out, in->x[i], in->y[i]);
+            continue;
+        }
+        int prev = (i - 1 + n) % n, next = (i + 1) % n;
+        double ax = in->x[i] - in->x[prev], ay = in->y[i] - in->y[prev];
+        double bx = in->x[next] - in->x[i], by = in->y[next] - in->y[i];
+        double la = hypot(ax, ay), lb = hypot(bx, by);
+        if(la <= 0 || lb <= 0) {
+            Add(out, in->x[i], in->y[i]);
+            continue;
+        }
+        ax /= la;
+        ay /= la;
+        bx /= lb;
+        by /= lb;
+        double cross = ax * by - ay * bx;
+        double turn = atan2(fabs(cross), ax * bx + ay * by);
+        if(turn < 1e-6) {
+            Add(out, in->x[i], in->y[i]);
+            continue;
+        }
+
+        double d = fmin(radius * tan(turn / 2.0), 0.5 * fmin(la, lb));
+        double r = d / tan(turn / 2.0);
+        double side = cross > 0 ? 1.0 : -1.0;
+        double sx = in->x[i] - ax * d, sy = in->y[i] - ay * d;
+        double cx = sx - side * ay * r, cy = sy + side * ax * r;
+        double start = atan2(sy - cy, sx - cx);
+        int steps = (int)ceil(r * turn / RESAMPLE);
+        if(steps < 1) steps = 1;
+        for(k = 0; k <= steps; k++) {
+            double angle = start + side * turn * k / steps;
+            Add(out, cx + r * cos(angle), cy + r * sin(angle));
+        }
+    }
+}
+
+// Path the setpoints follow, resampled with the corners of a polyline rounded
+static void Prepare(const Path *path, const Limits *l, Path *out) {
+    static Path rounded;
+    if(path->corners && l->radius > 0) {
+        Fillet(path, &rounded, l->radius);
+        Resample(&rounded, out, RESAMPLE);
+    } else {
+        Resample(path, out, RESAMPLE);
+    }
+}
+
+/*
+ * Time parameterization
+ */
+
+// Tangential acceleration left at speed <v> on curvature <k>
+static double Tangential(const Limits *l, double v, double k) {
+    double lateral = v * v * k;
+    return sqrt(fmax(l->accel * l->accel - lateral * lateral, 0));
+}
+
+// Speed at each point of a resampled path, returns the time of one pass
+static double Profile(const Path *p, const Limits *l, double ds, double *v, double *t) {
+    static double k[MAX_PATH], raw[MAX_PATH];
+    int n = p->count, segments = p->closed ? n : n - 1;
+    int span = (int)lround(CURVATURE_SPAN / ds), i, j;
+    if(span < 1) span = 1;
+
+    // Curvature through the points <span> either side, the largest around each point
+    for(i = 0; i < n; i++) {
+        int a = i - span, c = i + span;
+        if(p->closed) {
+            a = (a + n) % n;
+            c %= n;
+        } else {
+            if(a < 0) a = 0;
+            if(c > n - 1) c = n - 1;
+        }
+        double abx = p->x[i] - p->x[a], aby = p->y[i] - p->y[a];
+        double bcx = p->x[c] - p->x[i], bcy = p->y[c] - p->y[i];
+        double acx = p->x[c] - p->x[a], acy = p->y[c] - p->y[a];
+        double d = hypot(abx, aby) * hypot(bcx, bcy) * hypot(acx, acy);
+        raw[i] = d > 1e-12 ? 2.0 * fabs(abx * bcy - aby * bcx) / d : 0;
+    }
+    for(i = 0; i < n; i++) {
+        k[i] = 0;
+        for(j = -span; j <= span; j++) {
+            int m = i + j;
+            if(p->closed) m = (m + n) % n;
+            else if(m < 0 || m > n - 1) continue;
+            k[i] = fmax(k[i], raw[m]);
+        }
+        v[i] = k[i] > 0 ? fmin(l->speed, sqrt(l->accel / k[i])) : l->speed;
+    }
+
+    if(p->closed) {
+        // Both passes start at the slowest point, twice around so they wrap
+        int slowest = 0;
+        for(i = 1; i < n; i++) if(v[i] < v[slowest]) slowest = i;
+        for(i = 0; i < 2 * n; i++) {
+            int a = (slowest + i) % n, b = (a + 1) % n;
+            v[b] = fmin(v[b], sqrt(v[a] * v[a] + 2.0 * Tangential(l, v[a], k[a]) * ds));
+        }
+        for(i = 0; i < 2 * n; i++) {
+            int b = (slowest - i + 2 * n) % n, a = (b - 1 + n) % n;
+            v[a] = fmin(v[a], sqrt(v[b] * v[b] + 2.0 * Tangential(l, v[b], k[b]) * ds));
+        }
+    } else {
+        v[0] = 0;
+        v[n - 1] = 0;
+        for(i = 0; i < n - 1; i++) v[i + 1] = fmin(v[i + 1], sqrt(v[i] * v[i] + 2.0 * Tangential(l, v[i], k[i]) * ds));
+        for(i = n - 1; i > 0; i--) v[i - 1] = fmin(v[i - 1], sqrt(v[i] * v[i] + 2.0 * Tangential(l, v[i], k[i]) * ds));
+    }
+
+    t[0] = 0;
+    for(i = 0; i < segments; i++) {
+        double sum = v[i] + v[(i + 1) % n];
+        t[i + 1] = t[i] + (sum > 0 ? 2.0 * ds / sum : 0);
+    }
+    return t[segments];
+}
+
+// Position at time <time> along the timed path, constant acceleration between points
+static void Position(const Path *p, const double *v, const double *t, double ds, double time, double *x, double *y) {
+    int segments = p->closed ? p->count : p->count - 1;
+    int low = 0, high = segments;
+    while(high - low > 1) {
+        int mid = (low + high) / 2;
+        if(t[mid] <= time) low = mid;
+        else high = mid;
+    }
+    int j = (low + 1) % p->count;
+    double tau = time - t[low], v0 = v[low], v1 = v[j];
+    double a = (v1 * v1 - v0 * v0) / (2.0 * ds);
+    double s = v0 * tau + 0.5 * a * tau * tau;
+    double f = fmin(fmax(s / ds, 0), 1);
+    *x = p->x[low] + f * (p->x[j] - p->x[low]);
+    *y = p->y[low] + f * (p->y[j] - p->y[low]);
+}
+
+/*
+ * Encoding
+ */
+
+static int Varint(uint8_t *out, int32_t value) {
+    uint32_t z = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    out[0] = (z & 0x7F) | (z >= (1u << 7) ? 0x80 : 0);
+    if(z < (1u << 7)) return 1;
+    out[1] = ((z >> 7) & 0x7F) | (z >= (1u << 14) ? 0x80 : 0);
+    if(z < (1u << 14)) return 2;
+    out[2] = z >> 14;
+    return 3;
+}
+
+// Entry of a pair of second differences, returns the bytes or 0 out of range
+static int Encode(uint8_t *out, int32_t ddx, int32_t ddy) {
+    if(ddx >= -8 && ddx <= 7 && ddy >= -8 && ddy <= 7 && !(ddx == -8 && ddy == -8)) {
+        out[0] = (uint8_t)(((ddx & 0x0F) << 4) | (ddy & 0x0F));
+        return 1;
+    }
+    if(abs(ddx) > MAX_DIFFERENCE || abs(ddy) > MAX_DIFFERENCE) return 0;
+    out[0] = TRAJECTORY_ESCAPE;
+    int length = 1 + Varint(out + 1, ddx);
+    return length + Varint(out + length, ddy);
+}
+
+// Times, samples and encodes <path> into the data, returns 0 if it doesn't fit
+static int Compile(const Path *path, const Limits *l, Compiled *c, const char **error) {
+    static Path p;
+    static double v[MAX_PATH], t[MAX_PATH + 1];
+    int i;
+
+    Prepare(path, l, &p);
+    static double at[MAX_PATH + 1];
+    double ds = Length(&p, at) / (p.closed ? p.count : p.count - 1);
+    double time = Profile(&p, l, ds, v, t);
+    double period = l->period / 1000.0;
+
+    int points = p.closed ? (int)ceil(time / period - 1e-9) : (int)ceil(time / period - 1e-9) + 1;
+    if(points < 2) points = 2;
+    if(points > MAX_POINTS) {
+        *error = "too many setpoints (longer period?)";
+        return 0;
+    }
+    for(i = 0; i < points; i++) {
+        double at = p.closed ? time * i / points : time * i / (points - 1);
+        Position(&p, v, t, ds, at, &c->exactX[i], &c->exactY[i]);
+        c->x[i] = lround(c->exactX[i]);
+        c->y[i] = lround(c->exactY[i]);
+        if(abs(c->x[i]) > MAX_OFFSET || abs(c->y[i]) > MAX_OFFSET) {
+            *error = "setpoint outside MAX_OFFSET of the center (scale?)";
+            return 0;
+        }
+    }
+    c->time = p.closed ? points * period : (points - 1) * period;
+
+    Trajectory *tr = &c->t;
+    tr->offset = dataBytes;
+    tr->points = points;
+    tr->period = l->period;
+    tr->startX = c->x[0];
+    tr->startY = c->y[0];
+    tr->loop = p.closed;
+    tr->stepX = p.closed ? c->x[0] - c->x[points - 1] : 0;
+    tr->stepY = p.closed ? c->y[0] - c->y[points - 1] : 0;
+
+    int32_t stepX = tr->stepX, stepY = tr->stepY;
+    int entries = p.closed ? points : points - 1;
+    c->longest = 0;
+    c->escapes = 0;
+    for(i = 1; i <= entries; i++) {
+        int32_t x = c->x[i % points], y = c->y[i % points];
+        int32_t nextX = x - c->x[i - 1], nextY = y - c->y[i - 1];
+        if(dataBytes + TRAJECTORY_MAX_ENTRY > MAX_DATA) {
+            *error = "out of data space";
+            return 0;
+        }
+        int length = Encode(data + dataBytes, nextX - stepX, nextY - stepY);
+        if(!length) {
+            *error = "second difference out of range";
+            return 0;
+        }
+        dataBytes += length;
+        if(length > c->longest) c->longest = length;
+        if(length > 1) c->escapes++;
+        stepX = nextX;
+        stepY = nextY;
+    }
+    c->bytes = dataBytes - tr->offset;
+    return 1;
+}
+
+static int Generate(Path **paths, int count, const Limits *l, const char *output) {
+    static Compiled compiled[MAX_TRAJECTORIES];
+    int i;
+    uint32_t j;
+
+    for(i = 0; i < count; i++) {
+        const char *error = NULL;
+        if(!Compile(paths[i], l, &compiled[i], &error)) {
+            fprintf(stderr, "%s: %s\n", paths[i]->name, error);
+            return 1;
+        }
+        const Compiled *c = &compiled[i];
+        fprintf(stderr, "%-24s %5u setpoints %6.2f s %5u bytes (int16_t tables %u)%s\n", paths[i]->name, c->t.points,
+                c->time, c->bytes, 4u * c->t.points, c->t.loop ? "" : " open");
+    }
+
+    FILE *f = stdout;
+    if(output) {
+        f = fopen(output, "w");
+        if(!f) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    fprintf(f, "/*\n * trajectoryTable.h\n *\n * Generated by tools/trajectory.c, do not edit\n");
+    fprintf(f, " *  Limits: %.0f counts/s, %.0f counts/s^2, setpoints every %u ms, corner radius %.0f counts\n",
+            l->speed, l->accel, l->period, l->radius);
+    fprintf(f, " */\n\n#ifndef TRAJECTORYTABLE_H_\n#define TRAJECTORYTABLE_H_\n\n");
+    fprintf(f, "#define TRAJECTORY_COUNT %d\n", count);
+    fprintf(f, "#define TRAJECTORY_BYTES %u\n\n", dataBytes);
+    fprintf(f, "// Entries of all trajectories (trajectory.h)\n#define TRAJECTORY_DATA {");
+    for(j = 0; j < dataBytes; j++) {
+        if(j % 32 == 0) fprintf(f, " \\\n   ");
+        fprintf(f, "%s0x%02X", j ? "," : "", data[j]);
+    }
+    fprintf(f, "}\n\n");
+    fprintf(f, "// offset, points, period, startX, startY, stepX, stepY, loop\n#define TRAJECTORY_TABLE {");
+    for(i = 0; i < count; i++) {
+        const Trajectory *t = &compiled[i].t;
+        fprintf(f, " \\\n   %s{%u, %u, %u, %d, %d, %d, %d, %s} /* %s */", i ? "," : "", t->offset, t->points, t->period,
+                t->startX, t->startY, t->stepX, t->stepY, t->loop ? "true" : "false", paths[i]->name);
+    }
+    fprintf(f, "}\n\n#endif /* TRAJECTORYTABLE_H_ */\n");
+
+    if(f != stdout) fclose(f);
+    return 0;
+}
+
+/*
+ * Verification
+ */
+
+static int failures = 0;
+
+static void Check(_Bool ok, const char *text) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", text);
+    if(!ok) failures++;
+}
+
+// Distance from (x, y) to the resampled path
+static double Distance(const Path *p, double x, double y) {
+    double best = 1e9;
+    int i, segments = p->closed ? p->count : p->count - 1;
+    for(i = 0; i < segments; i++) {
+        int j = (i + 1) % p->count;
+        double dx = p->x[j] - p->x[i], dy = p->y[j] - p->y[i];
+        double d2 = dx * dx + dy * dy;
+        double f = d2 > 0 ? ((x - p->x[i]) * dx + (y - p->y[i]) * dy) / d2 : 0;
+        f = fmin(fmax(f, 0), 1);
+        best = fmin(best, hypot(x - p->x[i] - f * dx, y - p->y[i] - f * dy));
+    }
+    return best;
+}
+
+// Compiles <path>, plays it back with the firmware decoder and checks it, returns 0 on a failure
+static int VerifyPath(const Path *path, const Limits *l) {
+    static Compiled c;
+    static Path p;
+    const char *error = NULL;
+    int i;
+
+    dataBytes = 0;
+    if(!Compile(path, l, &c, &error)) {
+        printf("  FAIL %-24s %s\n", path->name, error);
+        return 0;
+    }
+
+    // Three passes of a loop, an open path to its end and once more
+    TrajectoryPlayer player;
+    Trajectory_Start(&player, &c.t, data);
+    _Bool exact = (player.x == c.x[0] && player.y == c.y[0]);
+    int steps = c.t.loop ? 3 * c.t.points : c.t.points - 1;
+    for(i = 1; i <= steps; i++) {
+        _Bool more = Trajectory_Next(&player);
+        exact = exact && more && player.x == c.x[i % c.t.points] && player.y == c.y[i % c.t.points];
+    }
+    if(!c.t.loop) exact = exact && !Trajectory_Next(&player) && player.x == c.x[c.t.points - 1];
+
+    // Distance of the setpoints to the path they were timed on
+    Prepare(path, l, &p);
+    double distance = 0, cut = 0;
+    for(i = 0; i < c.t.points; i++) distance = fmax(distance, Distance(&p, c.x[i], c.y[i]));
+
+    // Corners cut against the input polyline (shown only, sharp corners are cut more than the radius)
+    if(path->corners) {
+        static Path input;
+        Resample(path, &input, RESAMPLE);
+        for(i = 0; i < c.t.points; i++) cut = fmax(cut, Distance(&input, c.exactX[i], c.exactY[i]));
+    }
+
+    // Speed and acceleration between the setpoints
+    double period = l->period / 1000.0, speed = 0, accel = 0;
+    int n = c.t.points;
+    for(i = 0; i < n; i++) {
+        int a = i - 1, b = i + 1;
+        if(c.t.loop) {
+            a = (a + n) % n;
+            b %= n;
+        } else if(a < 0 || b > n - 1) {
+            continue;
+        }
+        speed = fmax(speed, hypot(c.exactX[b] - c.exactX[i], c.exactY[b] - c.exactY[i]) / period);
+        accel = fmax(accel, hypot(c.exactX[b] - 2.0 * c.exactX[i] + c.exactX[a], c.exactY[b] - 2.0 * c.exactY[i] + c.exactY[a]) /
+                            (period * period));
+    }
+
+    _Bool ok = exact && distance <= 1.0 && speed <= l->speed * 1.01 && accel <= l->accel * 1.05 &&
+               c.longest <= TRAJECTORY_MAX_ENTRY;
+    printf("  %-4s %-24s %5u %7.2f %6s %8.2f %8.2f %7.0f %7.0f %6u %7.2f %6u\n", ok ? "ok" : "FAIL", path->name, c.t.points,
+           c.time, exact ? "yes" : "no", distance, cut, speed, accel, c.bytes, (double)c.bytes / c.t.points, 4u * c.t.points);
+    return ok;
+}
+
+// Entries of random second differences of every size through Trajectory_Decode()
+static void VerifyEntries(void) {
+    uint8_t entry[TRAJECTORY_MAX_ENTRY];
+    int i, wrong = 0, longest = 0;
+    srand(44);
+    for(i = 0; i < 200000; i++) {
+        int bits = rand() % 22;
+        int32_t x = (rand() % (2 << bits)) - (1 << bits), y = (rand() % (2 << bits)) - (1 << bits);
+        if(abs(x) > MAX_DIFFERENCE) x = MAX_DIFFERENCE;
+        if(abs(y) > MAX_DIFFERENCE) y = -MAX_DIFFERENCE;
+        int length = Encode(entry, x, y);
+        int32_t dx, dy;
+        if(!length || Trajectory_Decode(entry, &dx, &dy) != length || dx != x || dy != y) wrong++;
+        if(length > longest) longest = length;
+    }
+    int32_t dx, dy;
+    Encode(entry, -8, -8);
+    Trajectory_Decode(entry, &dx, &dy);
+    Check(wrong == 0 && longest == TRAJECTORY_MAX_ENTRY && dx == -8 && dy == -8,
+          "random entries up to +/-MAX_DIFFERENCE decode exactly, TRAJECTORY_MAX_ENTRY bytes at most");
+}
+
+static int Verify(const Limits *l) {
+    static const char *shapes[] = {"circle:250", "ellipse:700,350", "eight:600,300", "star:700,300", "star:300,120,7"};
+    static const char *svgs[][2] = {
+        {"svg_polygon", "<svg><polygon points=\"0,0 100,0 100,60 40,90 0,60\"/></svg>"},
+        {"svg_path", "<svg><path d=\"M 10 10 h 80 v 50 l -40 30 L 10 60 z\" fill=\"none\"/></svg>"},
+        {"svg_open_polyline", "<svg><polyline points=\"0,0 60,40 120,0 180,40\"/></svg>"},
+    };
+    static Path path;
+    unsigned int i;
+    int passed = 0, total = 0;
+
+    printf("Entries\n");
+    VerifyEntries();
+
+    printf("\nTrajectories at %.0f counts/s, %.0f counts/s^2, every %u ms (bytes against two int16_t tables)\n",
+           l->speed, l->accel, l->period);
+    printf("       %-24s %5s %7s %6s %8s %8s %7s %7s %6s %7s %6s\n", "shape", "points", "time s", "exact", "path",
+           "corner", "speed", "accel", "bytes", "/point", "int16");
+    for(i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        ReadShape(&path, shapes[i]);
+        passed += VerifyPath(&path, l);
+        total++;
+    }
+    for(i = 0; i < sizeof(svgs) / sizeof(svgs[0]); i++) {
+        snprintf(path.name, sizeof(path.name), "%s", svgs[i][0]);
+        if(!SvgPath(&path, svgs[i][1], 10.0)) {
+            printf("  FAIL %-24s not parsed\n", svgs[i][0]);
+            total++;
+            continue;
+        }
+        passed += VerifyPath(&path, l);
+        total++;
+    }
+    failures += total - passed;
+
+    // Other limits and periods on the circle
+    Limits fast = *l;
+    fast.speed *= 2;
+    fast.accel *= 4;
+    fast.period = 10;
+    printf("\nAt %.0f counts/s, %.0f counts/s^2, every %u ms\n", fast.speed, fast.accel, fast.period);
+    ReadShape(&path, "ellipse:700,350");
+    failures += !VerifyPath(&path, &fast);
+
+    Check(!ReadShape(&path, "spiral:3") && !SvgPath(&path, "<svg><path d=\"M 0 0 C 1 1 2 2 3 3\"/></svg>", 1.0),
+          "unknown shapes and curve commands are rejected");
+
+    if(failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static const char *defaults[] = {"circle:250", "ellipse:700,350", "eight:600,300", "star:700,300"};
+    static Path paths[MAX_TRAJECTORIES];
+    Path *list[MAX_TRAJECTORIES];
+    Limits l = {DEFAULT_SPEED, DEFAULT_ACCEL, DEFAULT_PERIOD, DEFAULT_RADIUS};
+    const char *output = NULL;
+    _Bool verify = false;
+
+    int opt;
+    while((opt = getopt(argc, argv, "V:A:t:r:o:v")) != -1) {
+        switch(opt) {
+        case 'V': l.speed = atof(optarg); break;
+        case 'A': l.accel = atof(optarg); break;
+        case 't': l.period = atoi(optarg); break;
+        case 'r': l.radius = atof(optarg); break;
+        case 'o': output = optarg; break;
+        case 'v': verify = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-V speed] [-A accel] [-t period] [-r radius] [-o header] [-v] [shape...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(l.speed <= 0 || l.accel <= 0 || l.period < 1 || l.radius < 0) {
+        fprintf(stderr, "%s: need positive limits and period\n", argv[0]);
+        return 2;
+    }
+    if(verify) return Verify(&l);
+
+    int count = argc - optind, i;
+    const char **shapes = (const char **)argv + optind;
+    if(count == 0) {
+        count = sizeof(defaults) / sizeof(defaults[0]);
+        shapes = defaults;
+    }
+    if(count > MAX_TRAJECTORIES) {
+        fprintf(stderr, "%s: at most %d shapes\n", argv[0], MAX_TRAJECTORIES);
+        return 2;
+    }
+    for(i = 0; i < count; i++) {
+        if(!ReadShape(&paths[i], shapes[i])) {
+            fprintf(stderr, "%s: can't read shape %s\n", argv[0], shapes[i]);
+            return 2;
+        }
+        list[i] = &paths[i];
+    }
+    return Generate(list, count, &l, output);
+}
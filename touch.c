@@ -18,7 +18,13 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/gpio.h"
 #include "driverlib/adc.h"
+#include "touchPhase.h"
 #include "touch.h"
+#include "touchConvert.h"
+#include "settle.h"
+
+// Last presence check found a touch, the presence phase is only probed on an untouched panel
+_Bool touchLastPresent = false;
 
 /*
  * Base: ADC0_BASE, ADC1_BASE
@@ -71,29 +77,32 @@ void Touch_Init(void) {
     //Configure Y Axis ADCs
     ADC_Init(ADCY_BASE, 1, ADC_CTL_CH7);    //PD0 ADC YP
     ADC_Init(ADCY_BASE, 2, ADC_CTL_CH5);    //PD2 ADC YM
-}
 
-// Sets the Touch screen pins to inputs/high impedance
-void Touch_Off(uint32_t base, uint32_t ADC_P, uint32_t ADC_M, uint32_t GPIO_P, uint32_t GPIO_M) {
-    GPIOPinTypeGPIOInput(base, ADC_P | ADC_M | GPIO_P | GPIO_M);
+    // The pad settings all phases share (2 mA, no pull down, open drain or alternate function), then
+    // the phase writes around the current settings of the other port D pins
+    GPIOPinTypeGPIOInput(TOUCH_BASE, TOUCH_PINS);
+    TouchPhase_Build(HWREG(TOUCH_BASE + GPIO_O_PUR), HWREG(TOUCH_BASE + GPIO_O_AMSEL),
+                     HWREG(TOUCH_BASE + GPIO_O_DEN), HWREG(TOUCH_BASE + GPIO_O_DIR));
+
+    // Default settle times, the first characterization pass starts with the first readings
+    Settle_Init();
 }
 
-/* Configure the Touchscreen related pins according to the parameters
- *  <ADC_> pins will be set as ADCs, <GPIO_> will be set to 3V3 and GND
- */
-void Touch_Config(uint32_t base, uint32_t ADC_P, uint32_t ADC_M, uint32_t GPIO_P, uint32_t GPIO_M) {
-    //Configure the +/- pins of the touch screen and write + to 3.3V
-    GPIOPinWrite(base, GPIO_P | GPIO_M, GPIO_P);
-    GPIOPadConfigSet(base, GPIO_P | GPIO_M, GPIO_STRENGTH_6MA, GPIO_PIN_TYPE_STD);
-    GPIOPinTypeGPIOOutput(base, GPIO_P | GPIO_M);
-    GPIODirModeSet(base, GPIO_P | GPIO_M, GPIO_DIR_MODE_OUT);
-    GPIOPinWrite(base, GPIO_P | GPIO_M, GPIO_P);
-
-    //Configure ADC Inputs
-    GPIOPinTypeADC(base, ADC_P | ADC_M);
-    GPIOPadConfigSet(base, ADC_P | ADC_M, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_ANALOG);
-    GPIODirModeSet(base, ADC_P | ADC_M, GPIO_DIR_MODE_IN);
+// Switches the touch pins to <phase> (TOUCH_PHASE_x) with the precomputed register writes
+void Touch_Phase(uint8_t phase) {
+    const TouchWrite *writes = TouchPhaseWrites[phase];
+    uint8_t i;
+    for(i = 0; i < TOUCH_PHASE_WRITES; i++) {
+        HWREG(TOUCH_BASE + writes[i].offset) = writes[i].value;
+    }
+}
 
+// Waits <us> microseconds (SysCtlDelay() loops take 3 cycles at 80 MHz, 0 loops would wrap)
+void Touch_Delay(uint16_t us) {
+    uint32_t loops = ((uint32_t)us * 80) / 3;
+    if(loops > 0) {
+        SysCtlDelay(loops);
+    }
 }
 
 uint32_t GetADCValue(uint32_t base, uint32_t sequencer) {
@@ -107,8 +116,8 @@ uint32_t GetADCValue(uint32_t base, uint32_t sequencer) {
     while(!ADCIntStatus(base, sequencer, false)) {}
     ADCSequenceDataGet(base, sequencer, ui32ADCValue);
 
-    // Average the 4 samples from the sequencer
-    return (ui32ADCValue[0] + ui32ADCValue[1] + ui32ADCValue[2] + ui32ADCValue[3] + 2)/4;
+    // Sum of the 4 samples from the sequencer, Touch_Convert() averages them
+    return ui32ADCValue[0] + ui32ADCValue[1] + ui32ADCValue[2] + ui32ADCValue[3];
 }
 
 /*
@@ -117,45 +126,66 @@ uint32_t GetADCValue(uint32_t base, uint32_t sequencer) {
  *  Checks if input pins are LOW (Connected to first surface)
  */
 _Bool Touch_Present() {
-    //Set Y Surface to LOW
-    GPIOPinTypeGPIOOutput(TOUCH_BASE, TOUCH_YP | TOUCH_YM);
-    GPIODirModeSet(TOUCH_BASE, TOUCH_YP | TOUCH_YM, GPIO_DIR_MODE_OUT);
-    GPIOPinWrite(TOUCH_BASE, TOUCH_YP | TOUCH_YM, 0x00);
-
-    //Set X Surface to PULL UP
-    GPIOPinTypeGPIOInput(TOUCH_BASE, TOUCH_XP | TOUCH_XM);
-    GPIODirModeSet(TOUCH_BASE, TOUCH_XP | TOUCH_XM, GPIO_DIR_MODE_IN);
-    GPIOPadConfigSet(TOUCH_BASE, TOUCH_XP | TOUCH_XM, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
-
-    //Wait a short time for pullups
-    SysCtlDelay(8000);
+    //Set Y Surface to LOW, X Surface to PULL UP
+    Touch_Phase(TOUCH_PHASE_PRESENT);
+
+    //Wait for pullups, a probed check samples the pins early too (settle.c)
+    uint8_t probe = 0;
+    _Bool probing = Settle_Probing(TOUCH_PHASE_PRESENT) && !touchLastPresent;
+    if(probing) {
+        uint16_t delay = Settle_ProbeDelay(TOUCH_PHASE_PRESENT);
+        Touch_Delay(delay);
+        probe = GPIOPinRead(TOUCH_BASE, TOUCH_XP | TOUCH_XM);
+        Touch_Delay(Settle_MaxUs(TOUCH_PHASE_PRESENT) - delay);
+    } else {
+        Touch_Delay(SettleTimeUs[TOUCH_PHASE_PRESENT]);
+    }
 
     //Check if a pin is LOW (connected to Y Surface)
     uint8_t read = GPIOPinRead(TOUCH_BASE, TOUCH_XP | TOUCH_XM);
     _Bool output = !(read == (TOUCH_XP | TOUCH_XM));
+
+    // Only the pull ups of an untouched panel settle to a known level
+    if(probing && !output) {
+        Settle_Add(TOUCH_PHASE_PRESENT, probe, read);
+    }
+    touchLastPresent = output;
     return output;
 }
 
-uint32_t Touch_Read_Y() {
-    Touch_Config(TOUCH_BASE, TOUCH_YP, TOUCH_YM, TOUCH_XP, TOUCH_XM);
+/* Reads a touch axis in <phase> from the ADCs of <base>
+ *  A probed reading also converts the positive side after the probe delay (settle.c)
+ */
+uint32_t Touch_Read(uint8_t phase, uint32_t base) {
+    Touch_Phase(phase);
+
+    uint32_t probe = 0;
+    _Bool probing = Settle_Probing(phase);
+    if(probing) {
+        uint16_t delay = Settle_ProbeDelay(phase);
+        Touch_Delay(delay);
+        probe = GetADCValue(base, 1);
+        Touch_Delay(Settle_MaxUs(phase) - delay);
+    } else {
+        Touch_Delay(SettleTimeUs[phase]);
+    }
 
     // Read the positive and negative ADCs for additional filter
-    uint32_t p = GetADCValue(ADCY_BASE, 1);
-    uint32_t m = GetADCValue(ADCY_BASE, 2);
+    uint32_t p = GetADCValue(base, 1);
+    uint32_t m = GetADCValue(base, 2);
 
-    Touch_Off(TOUCH_BASE, TOUCH_YP, TOUCH_YM, TOUCH_XP, TOUCH_XM);
+    Touch_Phase(TOUCH_PHASE_OFF);
+    if(probing) {
+        Settle_Add(phase, probe, p);
+    }
     // Put additional filtering/conversion code here
-    return (p + m + 1)/2;
+    return Touch_Convert(p, m);
 }
 
-uint32_t Touch_Read_X() {
-    Touch_Config(TOUCH_BASE, TOUCH_XP, TOUCH_XM, TOUCH_YP, TOUCH_YM);
-
-    // Read the positive and negative ADCs for additional filter
-    uint32_t p = GetADCValue(ADCX_BASE, 1);
-    uint32_t m = GetADCValue(ADCX_BASE, 2);
+uint32_t Touch_Read_Y() {
+    return Touch_Read(TOUCH_PHASE_READ_Y, ADCY_BASE);
+}
 
-    Touch_Off(TOUCH_BASE, TOUCH_XP, TOUCH_XM, TOUCH_YP, TOUCH_YM);
-    // Put additional filtering/conversion code here
-    return (p + m + 1)/2;
+uint32_t Touch_Read_X() {
+    return Touch_Read(TOUCH_PHASE_READ_X, ADCX_BASE);
 }
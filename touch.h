@@ -14,11 +14,7 @@
 #define ADCX_BASE ADC0_BASE
 #define ADCY_BASE ADC1_BASE
 
-#define TOUCH_XP GPIO_PIN_3
-#define TOUCH_XM GPIO_PIN_1
-
-#define TOUCH_YP GPIO_PIN_0
-#define TOUCH_YM GPIO_PIN_2
+// Pins and drive phases in touchPhase.h
 
 #define ADC_HARDWARE_OVERSAMPLE 8
 
@@ -28,7 +24,9 @@ uint32_t Touch_Read_X();
 uint32_t Touch_Read_Y();
 
 /* Internal Functions
- * void Touch_Config(uint32_t base, uint32_t ADC_P, uint32_t ADC_M, uint32_t GPIO_P, uint32_t GPIO_M);
+ * void Touch_Phase(uint8_t phase);
+ * void Touch_Delay(uint16_t us);
+ * uint32_t Touch_Read(uint8_t phase, uint32_t base);
  * uint32_t GetADCValue(uint32_t base, uint32_t sequencer);
  * void ADC_Init(uint32_t base, uint32_t sequencer, uint32_t inputChannel);
  */
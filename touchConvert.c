@@ -0,0 +1,33 @@
+/*
+ * touchConvert.c
+ *
+ * Conversion of the touch ADC samples to a position (counts)
+ *  A reading is the mean of TOUCH_SAMPLES samples from each side of the touch
+ *  surface. The mean is rounded once from the raw sums, averaging the two rounded
+ *  side averages rounded twice and was a count high in about 3 of 10 readings (sim/fpu).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+#include "touchConvert.h"
+
+// Position from the sums of the TOUCH_SAMPLES samples of both sides, in the arithmetic selected by CONTROLLER_FLOAT
+uint32_t Touch_Convert(uint32_t sumP, uint32_t sumM) {
+    if(CONTROLLER_FLOAT) {
+        return Touch_ConvertFloat(sumP, sumM);
+    }
+    return Touch_ConvertFixed(sumP, sumM);
+}
+
+uint32_t Touch_ConvertFixed(uint32_t sumP, uint32_t sumM) {
+    return (sumP + sumM + TOUCH_SAMPLES) / (2 * TOUCH_SAMPLES);
+}
+
+// The sums are below 2^24, exact in a float
+uint32_t Touch_ConvertFloat(uint32_t sumP, uint32_t sumM) {
+    return (uint32_t)((float)(sumP + sumM) * (1.0f / (2 * TOUCH_SAMPLES)) + 0.5f);
+}
@@ -0,0 +1,18 @@
+/*
+ * touchConvert.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef TOUCHCONVERT_H_
+#define TOUCHCONVERT_H_
+
+// ADC samples per touch side (sample sequencer depth used by GetADCValue())
+#define TOUCH_SAMPLES 4
+
+uint32_t Touch_Convert(uint32_t sumP, uint32_t sumM);
+uint32_t Touch_ConvertFixed(uint32_t sumP, uint32_t sumM);
+uint32_t Touch_ConvertFloat(uint32_t sumP, uint32_t sumM);
+
+#endif /* TOUCHCONVERT_H_ */
@@ -0,0 +1,71 @@
+/*
+ * touchPhase.c
+ *
+ * Register snapshots of the touch panel drive phases
+ *  The driverlib calls that used to switch the panel pins read-modify-write every
+ *  pad register for each call. Of those registers only PUR, AMSEL, DEN, DIR and the
+ *  output levels differ between the phases: every phase leaves the touch pins at
+ *  2 mA drive, no slew rate control, open drain, pull down or alternate function.
+ *  Touch_Init() sets those once, then a phase change is a fixed sequence of
+ *  TOUCH_PHASE_WRITES stores of whole registers, the bits of the other port D pins
+ *  taken from the port when the table is built.
+ *
+ *  The write order is the one of the driverlib sequences: the pad settings first,
+ *  then the direction of all four pins in one store, the output levels last
+ *  (writes to the data of input pins are ignored). sim/touchphase.c checks that
+ *  every phase change gives the registers the driverlib sequence gave them.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "touchPhase.h"
+
+// Settings of the touch pins in a phase (bits of TOUCH_PINS)
+typedef struct {
+    uint8_t pur;
+    uint8_t amsel;
+    uint8_t den;
+    uint8_t dir;
+    uint8_t data;       // Levels of the outputs
+} TouchPins;
+
+// From Touch_Off(), Touch_Config() and Touch_Present() as they were on driverlib
+static const TouchPins phasePins[TOUCH_PHASE_COUNT] = {
+    // TOUCH_PHASE_OFF: GPIOPinTypeGPIOInput() on all pins
+    {0, 0, TOUCH_PINS, 0, 0},
+    // TOUCH_PHASE_READ_X: X pins GPIOPinTypeADC(), Y pins GPIOPinTypeGPIOOutput()
+    {0, TOUCH_XP | TOUCH_XM, TOUCH_YP | TOUCH_YM, TOUCH_YP | TOUCH_YM, TOUCH_YP},
+    // TOUCH_PHASE_READ_Y
+    {0, TOUCH_YP | TOUCH_YM, TOUCH_XP | TOUCH_XM, TOUCH_XP | TOUCH_XM, TOUCH_XP},
+    // TOUCH_PHASE_PRESENT: X pins GPIO_PIN_TYPE_STD_WPU inputs, Y pins outputs at GND
+    {TOUCH_XP | TOUCH_XM, 0, TOUCH_PINS, TOUCH_YP | TOUCH_YM, 0},
+};
+
+TouchWrite TouchPhaseWrites[TOUCH_PHASE_COUNT][TOUCH_PHASE_WRITES];
+
+static TouchWrite Write(uint32_t offset, uint32_t port, uint8_t pins) {
+    TouchWrite write = {offset, (port & ~TOUCH_PINS) | pins};
+    return write;
+}
+
+/* Builds the writes of every phase from the current port D registers <pur>, <amsel>, <den> and <dir>
+ *  Only their bits of the other pins are used, call again if those pins are reconfigured
+ */
+void TouchPhase_Build(uint32_t pur, uint32_t amsel, uint32_t den, uint32_t dir) {
+    uint8_t phase;
+    for(phase = 0; phase < TOUCH_PHASE_COUNT; phase++) {
+        const TouchPins *pins = &phasePins[phase];
+        TouchWrite *writes = TouchPhaseWrites[phase];
+        writes[0] = Write(TOUCH_O_PUR, pur, pins->pur);
+        writes[1] = Write(TOUCH_O_AMSEL, amsel, pins->amsel);
+        writes[2] = Write(TOUCH_O_DEN, den, pins->den);
+        writes[3] = Write(TOUCH_O_DIR, dir, pins->dir);
+
+        // Masked data write, only the outputs of the phase
+        writes[4].offset = TOUCH_O_DATA + (pins->dir << 2);
+        writes[4].value = pins->data;
+    }
+}
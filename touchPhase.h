@@ -0,0 +1,54 @@
+/*
+ * touchPhase.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef TOUCHPHASE_H_
+#define TOUCHPHASE_H_
+
+// Touch panel pins on TOUCH_BASE (port D), same as GPIO_PIN_x
+#define TOUCH_XP 0x08       // PD3
+#define TOUCH_XM 0x02       // PD1
+
+#define TOUCH_YP 0x01       // PD0
+#define TOUCH_YM 0x04       // PD2
+
+#define TOUCH_PINS (TOUCH_XP | TOUCH_XM | TOUCH_YP | TOUCH_YM)
+
+// Drive phases of the panel
+#define TOUCH_PHASE_OFF 0           // All pins digital inputs, panel unpowered
+#define TOUCH_PHASE_READ_X 1        // Y surface driven (YP 3V3, YM GND), X pins to the ADCs
+#define TOUCH_PHASE_READ_Y 2        // X surface driven (XP 3V3, XM GND), Y pins to the ADCs
+#define TOUCH_PHASE_PRESENT 3       // Y surface GND, X pins inputs with pull ups
+#define TOUCH_PHASE_COUNT 4
+
+// GPIO register offsets, same as GPIO_O_x in inc/hw_gpio.h
+#define TOUCH_O_DATA 0x000          // Masked by address bits 9:2
+#define TOUCH_O_DIR 0x400
+#define TOUCH_O_AFSEL 0x420
+#define TOUCH_O_DR2R 0x500
+#define TOUCH_O_DR4R 0x504
+#define TOUCH_O_DR8R 0x508
+#define TOUCH_O_ODR 0x50C
+#define TOUCH_O_PUR 0x510
+#define TOUCH_O_PDR 0x514
+#define TOUCH_O_SLR 0x518
+#define TOUCH_O_DEN 0x51C
+#define TOUCH_O_AMSEL 0x528
+
+// Register writes of a phase change
+#define TOUCH_PHASE_WRITES 5
+
+typedef struct {
+    uint32_t offset;
+    uint32_t value;
+} TouchWrite;
+
+// Writes that switch the panel to each phase, filled by TouchPhase_Build()
+extern TouchWrite TouchPhaseWrites[TOUCH_PHASE_COUNT][TOUCH_PHASE_WRITES];
+
+void TouchPhase_Build(uint32_t pur, uint32_t amsel, uint32_t den, uint32_t dir);
+
+#endif /* TOUCHPHASE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * trajectory.c
+ *
+ * Streaming decoder of the compiled setpoint trajectories (MODE_TRAJECTORY)
+ *  The trajectories are time parameterized on the PC (tools/trajectory.c) and
+ *  stored as second differences, mostly one byte per setpoint for both axes instead
+ *  of two int16_t tables. Each setpoint decodes one entry of at most
+ *  TRAJECTORY_MAX_ENTRY bytes without loops, so the cost is the same for every setpoint.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "trajectory.h"
+
+const uint8_t TrajectoryData[TRAJECTORY_BYTES] = TRAJECTORY_DATA;
+const Trajectory Trajectories[TRAJECTORY_COUNT] = TRAJECTORY_TABLE;
+
+// Zigzag varint of up to 3 bytes (7, 7 and 8 bits), returns the bytes read
+static uint8_t Varint(const uint8_t *data, int32_t *value) {
+    uint32_t v = data[0] & 0x7F;
+    uint8_t length = 1;
+    if(data[0] & 0x80) {
+        v |= (uint32_t)(data[1] & 0x7F) << 7;
+        length = 2;
+        if(data[1] & 0x80) {
+            v |= (uint32_t)data[2] << 14;
+            length = 3;
+        }
+    }
+    *value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+    return length;
+}
+
+// Second differences of the setpoint of <entry>, returns the bytes of the entry
+uint8_t Trajectory_Decode(const uint8_t *entry, int32_t *ddx, int32_t *ddy) {
+    if(entry[0] != TRAJECTORY_ESCAPE) {
+        *ddx = ((int32_t)(entry[0] >> 4) ^ 8) - 8;
+        *ddy = ((int32_t)(entry[0] & 0x0F) ^ 8) - 8;
+        return 1;
+    }
+    uint8_t length = 1 + Varint(entry + 1, ddx);
+    return length + Varint(entry + length, ddy);
+}
+
+// Player on the first setpoint of <trajectory>, its entries start at <data>
+void Trajectory_Start(TrajectoryPlayer *p, const Trajectory *trajectory, const uint8_t *data) {
+    p->trajectory = trajectory;
+    p->data = data + trajectory->offset;
+    p->next = p->data;
+    p->index = 0;
+    p->x = trajectory->startX;
+    p->y = trajectory->startY;
+    p->stepX = trajectory->stepX;
+    p->stepY = trajectory->stepY;
+}
+
+/* Moves the player to the next setpoint, returns false at the end of an open trajectory
+ *  A loop returns to its start after the last setpoint, the last entry leads there exactly
+ */
+_Bool Trajectory_Next(TrajectoryPlayer *p) {
+    const Trajectory *t = p->trajectory;
+    if(!t->loop && p->index + 1 >= t->points) return false;
+
+    int32_t ddx, ddy;
+    p->next += Trajectory_Decode(p->next, &ddx, &ddy);
+    p->stepX += ddx;
+    p->stepY += ddy;
+    p->x += p->stepX;
+    p->y += p->stepY;
+
+    if(++p->index >= t->points) {
+        p->index = 0;
+        p->next = p->data;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * trajectory.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+#include "trajectoryTable.h"
+
+/* Setpoint streams (generated by tools/trajectory.c into trajectoryTable.h)
+ *  Each setpoint is stored as the second difference of the positions (counts) of both axes:
+ *  one byte with the X difference in the high and the Y difference in the low nibble
+ *  (-8 to 7), or TRAJECTORY_ESCAPE followed by the two differences as zigzag varints
+ *  of up to 3 bytes. A loop has one entry per setpoint, the last one leads back to the
+ *  start, an open trajectory one less and stops on its last setpoint.
+ */
+#define TRAJECTORY_ESCAPE 0x88
+#define TRAJECTORY_MAX_ENTRY 7
+
+typedef struct {
+    uint32_t offset;            // First entry in the data
+    uint16_t points;            // Setpoints of one pass
+    uint16_t period;            // Time between setpoints (ms)
+    int16_t startX, startY;     // First setpoint (counts from the center)
+    int16_t stepX, stepY;       // Step from the last setpoint to the first (loop) or 0
+    _Bool loop;
+} Trajectory;
+
+typedef struct {
+    const Trajectory *trajectory;
+    const uint8_t *data;
+    const uint8_t *next;        // Next entry
+    uint16_t index;             // Setpoint of the current position
+    int32_t x, y;               // Current setpoint (counts from the center)
+    int32_t stepX, stepY;       // Step into the current setpoint
+} TrajectoryPlayer;
+
+// Trajectories of trajectoryTable.h
+extern const uint8_t TrajectoryData[TRAJECTORY_BYTES];
+extern const Trajectory Trajectories[TRAJECTORY_COUNT];
+
+void Trajectory_Start(TrajectoryPlayer *p, const Trajectory *trajectory, const uint8_t *data);
+_Bool Trajectory_Next(TrajectoryPlayer *p);
+uint8_t Trajectory_Decode(const uint8_t *entry, int32_t *ddx, int32_t *ddy);
+
+#endif /* TRAJECTORY_H_ */
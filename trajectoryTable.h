@@ -0,0 +1,128 @@
+/*
+ * trajectoryTable.h
+ *
+ * Generated by tools/trajectory.c, do not edit
+ *  Limits: 1500 counts/s, 3000 counts/s^2, setpoints every 5 ms, corner radius 10 counts
+ */
+
+#ifndef TRAJECTORYTABLE_H_
+#define TRAJECTORYTABLE_H_
+
+#define TRAJECTORY_COUNT 4
+#define TRAJECTORY_BYTES 3298
+
+// Entries of all trajectories (trajectory.h)
+#define TRAJECTORY_DATA { \
+   0x00,0x01,0x0F,0xF0,0x11,0x0F,0xF0,0x10,0xF1,0x0F,0x10,0xF0,0x01,0x0F,0x00,0x00,0xF0,0x10,0x01,0xFF,0x10,0xF0,0x10,0xF0,0x00,0x0F,0x01,0x00,0x00,0x00,0x0F,0x01 \
+   ,0x00,0xFF,0x11,0xF0,0x1F,0xF0,0x01,0x1F,0xF1,0x0F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0x1F,0xF1,0x10,0x0F,0xF1,0x0F,0x11,0xFF,0x00,0x10,0xF0,0x00,0x00 \
+   ,0x00,0x10,0xF0,0x00,0x0F,0x01,0x0F,0x01,0xFF,0x10,0x01,0x0F,0x00,0x00,0xF0,0x10,0x0F,0x01,0xF0,0x1F,0x01,0x0F,0xF0,0x11,0x0F,0xF0,0x10,0x00,0xF0,0x10,0x0F,0xF1 \
+   ,0x10,0x0F,0x01,0xFF,0x10,0x01,0x0F,0xF0,0x10,0x00,0x00,0x0F,0x01,0xF0,0x1F,0x01,0x0F,0x01,0x0F,0x00,0x10,0xF0,0x00,0x00,0x00,0x10,0xF0,0x00,0x1F,0xF1,0x0F,0x11 \
+   ,0x0F,0xF0,0x11,0xFF,0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0F,0x11,0xFF,0x01,0x10,0xFF,0x10,0xF1,0x1F,0x00,0x01,0x0F,0x00,0x00,0x00,0x01,0x0F,0x00,0x10 \
+   ,0xF0,0x10,0xF0,0x1F,0x01,0xF0,0x10,0x00,0x00,0x0F,0x01,0x10,0xF0,0x0F,0x11,0xF0,0x10,0x0F,0xF1,0x10,0x0F,0x01,0x00,0x0F,0x01,0x10,0xFF,0x01,0x10,0xF0,0x1F,0x01 \
+   ,0xF0,0x10,0x0F,0x01,0x00,0x00,0x10,0xF0,0x0F,0x11,0xF0,0x10,0xF0,0x10,0x00,0x01,0x0F,0x00,0x00,0x00,0x01,0x0F,0x00,0x11,0xFF,0x10,0xF1,0x10,0x0F,0xF1,0x1F,0x01 \
+   ,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0xF1,0x1F,0xF0,0x01,0x1F,0x01,0xFF,0x11,0x00,0xF0,0x10,0x00,0x00,0x00,0xF0,0x10,0x00,0x01,0x0F,0x01,0x0F,0x11,0xF0 \
+   ,0x0F,0x01,0x00,0x00,0x10,0xF0,0x01,0x0F,0x10,0xF1,0x0F,0x01,0x10,0xFF,0x01,0x10,0xF0,0x00,0x10,0xF0,0x01,0x1F,0xF0,0x01,0x0F,0x11,0xF0,0x0F,0x01,0x10,0xF0,0x00 \
+   ,0x00,0x01,0x0F,0x10,0xF1,0x0F,0x01,0x0F,0x01,0x00,0xF0,0x10,0x00,0x00,0x00,0xF0,0x10,0x00,0xF1,0x1F,0x01,0xFF,0x01,0x10,0xFF,0x11,0xF0,0x00,0x00,0x00,0x00,0x00 \
+   ,0x00,0x00,0x00,0x01,0xFF,0x11,0x0F,0xF0,0x11,0xF0,0x1F,0xF1,0x00,0x0F,0x01,0x00,0x00,0x00,0x0F,0x01,0x00,0xF0,0x10,0xF0,0x10,0xF1,0x0F,0x10,0xF0,0x00,0x00,0x01 \
+   ,0x0F,0xF0,0x10,0x01,0xFF,0x10,0xF0,0x01,0x1F,0xF0,0x01,0x0F,0x00,0x0F,0x01,0xFF,0x11,0x00,0xFF,0x11,0xFF,0x01,0x10,0xFF,0x01,0x0F,0x01,0x0F,0xF1,0x1F,0x01,0xF0 \
+   ,0x1F,0xF1,0x0F,0x11,0xFF,0x01,0x0F,0x01,0x0F,0x01,0x0F,0xF0,0x11,0xFF,0x11,0xFF,0x10,0xF1,0x0F,0x01,0x0F,0x00,0x01,0x0F,0xF0,0x10,0x01,0xFF,0x10,0xF0,0x01,0x1F \
+   ,0xF0,0x00,0x00,0x00,0x00,0xF1,0x1F,0x00,0xF0,0x10,0xF0,0x10,0xF0,0x00,0x0F,0x11,0xF0,0xF0,0x10,0x00,0x0F,0x01,0xF0,0x10,0xFF,0x11,0xF0,0x0F,0x01,0x0F,0x01,0x0F \
+   ,0x01,0x0F,0x01,0x0F,0xF0,0x11,0xFF,0x10,0xF0,0x00,0x11,0xFF,0x00,0x00,0x00,0x00,0x00,0xF0,0x10,0x0F,0x01,0xF0,0x1F,0x01,0xF0,0x1F,0x01,0xFF,0x10,0x01,0xFF,0x10 \
+   ,0x00,0xF1,0x1F,0xF0,0x10,0xF0,0x10,0x00,0xF0,0x1F,0xF1,0x10,0xF0,0x1F,0xF1,0x1F,0x01,0xFF,0x11,0xFF,0x11,0xFF,0x10,0xF0,0x11,0xFF,0x10,0xF0,0x10,0xF0,0x10,0xF0 \
+   ,0x10,0xF0,0x1F,0xF1,0x10,0xF0,0x1F,0xF1,0x1F,0xF1,0x1F,0x01,0xFF,0x11,0xFF,0x10,0xF0,0x11,0xFF,0x10,0x00,0xF0,0x10,0xF0,0x10,0xFF,0x11,0x00,0xF0,0x1F,0x01,0xF0 \
+   ,0x1F,0x01,0xFF,0x10,0x01,0xFF,0x10,0x01,0x0F,0xF0,0x10,0x00,0x00,0x00,0x00,0x00,0x1F,0xF1,0x00,0x10,0xF0,0x1F,0xF1,0x10,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x01 \
+   ,0x0F,0x10,0xF1,0x1F,0xF0,0x10,0x01,0x0F,0x00,0xF0,0x10,0x10,0xF1,0x0F,0x00,0x10,0xF0,0x10,0xF0,0x10,0x00,0xFF,0x11,0x00,0x00,0x00,0x00,0x10,0xFF,0x01,0x10,0xF0 \
+   ,0x1F,0x01,0xF0,0x10,0x0F,0x01,0x00,0x0F,0x01,0x0F,0x11,0xF0,0x1F,0xF1,0x1F,0xF1,0x10,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x1F,0xF1,0x0F,0x11,0xFF,0x10,0x01,0xFF,0x11 \
+   ,0x0F,0x01,0x0F,0x01,0x1F,0xF0,0x01,0x1F,0xF1,0x1F,0x00,0xF1,0x1F,0x01,0x0F,0x00,0x01,0x0F,0x11,0xFF,0x00,0x11,0xFF,0x11,0x0F,0xF0,0x11,0x0F,0x01,0x0F,0x01,0x1F \
+   ,0xF1,0x0F,0x10,0xF1,0x1F,0x01,0xFF,0x11,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x10,0xFF,0x11,0xFF,0x11,0xF0,0x1F,0x01,0x0F,0x01,0x00,0x0F,0x01,0x10,0xF0,0x0F,0x11,0xF0 \
+   ,0x10,0x0F,0xF1,0x10,0x00,0x00,0x00,0x00,0x1F,0xF1,0x00,0x10,0xF0,0x10,0xF0,0x10,0x00,0x01,0xFF,0x10,0x10,0xF0,0x00,0x01,0x0F,0x10,0xF0,0x11,0xFF,0x10,0x01,0x0F \
+   ,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x10,0xFF,0x11,0xF0,0x10,0x00,0xFF,0x11,0x00,0x00,0x00,0x00,0x00,0x10,0xF0,0x01,0x0F,0x10,0xF1,0x0F,0x10,0xF1,0x0F,0x11,0xF0 \
+   ,0x0F,0x11,0xF0,0x00,0x1F,0xF1,0x10,0xF0,0x10,0xF0,0x00,0x10,0xF1,0x1F,0xF0,0x10,0xF1,0x1F,0xF1,0x0F,0x11,0xFF,0x11,0xFF,0x11,0xF0,0x10,0xFF,0x11,0xF0,0x10,0xF0 \
+   ,0x10,0xF0,0x10,0xF0,0x10,0xF1,0x1F,0xF0,0x10,0xF1,0x1F,0xF1,0x1F,0xF1,0x0F,0x11,0xFF,0x11,0xF0,0x10,0xFF,0x11,0xF0,0x00,0x10,0xF0,0x10,0xF0,0x11,0xFF,0x00,0x10 \
+   ,0xF1,0x0F,0x10,0xF1,0x0F,0x11,0xF0,0x0F,0x11,0xF0,0x0F,0x01,0x10,0xF0,0x00,0x00,0x00,0x00,0x00,0xF1,0x1F,0x00,0xF0,0x10,0xF1,0x1F,0xF0,0x01,0x0F,0x01,0x0F,0x01 \
+   ,0x0F,0x01,0x0F,0x01,0xF0,0x1F,0xF1,0x10,0xF0,0x0F,0x01,0x00,0x10,0xF0,0xF0,0x1F,0x01,0x00,0xF0,0x10,0xF0,0x10,0xF0,0x00,0x11,0xFF,0x00,0x00,0x00,0x00,0xF0,0x11 \
+   ,0x0F,0xF0,0x10,0xF1,0x0F,0x10,0xF0,0x01,0x0F,0x00,0x01,0x0F,0x01,0xFF,0x10,0xF1,0x1F,0xF1,0x1F,0xF0,0x01,0x0F,0x01,0x0F,0x01,0x0F,0xF1,0x1F,0x01,0xFF,0x11,0xF0 \
+   ,0x0F,0x11,0xFF,0x01,0x0F,0x01,0x0F,0xF1,0x10,0x0F,0xF1,0x1F,0xF1,0x00,0x1F,0xF1,0x0F,0x01,0x00,0x11,0xFF,0x00,0x00,0x11,0xFF,0x00,0x11,0xFF,0x00,0x10,0xF1,0x0F \
+   ,0x10,0xF0,0x11,0xFF,0x00,0x10,0xF0,0x00,0x10,0xF0,0x00,0x00,0x0F,0x11,0xF0,0x0F,0x00,0x01,0x0F,0xF0,0x11,0x0F,0x00,0x00,0xF0,0x1F,0x01,0xF0,0x10,0x0F,0xF1,0x1F \
+   ,0xF0,0x11,0xFF,0x00,0x10,0xF0,0x10,0xF0,0x00,0x00,0x1F,0xF1,0x0F,0x01,0x0F,0x01,0x0F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0x11,0x0F,0x01,0xFF,0x10,0x01 \
+   ,0xFF,0x10,0xF0,0x10,0x00,0xF0,0x1F,0xF1,0x00,0x1F,0xF1,0x1F,0xF0,0x01,0x1F,0xF0,0x00,0x00,0x00,0x10,0xF0,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x00,0x00,0x01,0x0F \
+   ,0x00,0x0F,0xF1,0x10,0x00,0x0F,0xF1,0x1F,0x01,0xFF,0x10,0xF0,0x10,0xF1,0x1F,0xFF,0x11,0xF0,0x10,0xFF,0x01,0x10,0xFF,0x00,0x01,0x0F,0x10,0xF0,0x00,0x00,0x00,0x00 \
+   ,0x00,0x0F,0x01,0x00,0xFF,0x11,0x0F,0x00,0x01,0xFF,0x10,0xF0,0x10,0x00,0xF0,0x1F,0xF1,0x00,0x1F,0xF1,0x0F,0x11,0xFF,0x00,0x01,0x0F,0x00,0x10,0xE0,0x10,0x00,0x0F \
+   ,0x01,0x00,0xFF,0x11,0x0F,0xF1,0x1F,0xF1,0x1F,0xF0,0x00,0x10,0xF0,0x01,0x0F,0x0F,0x01,0x00,0x01,0xFF,0x10,0x00,0xF0,0x11,0x0F,0xF0,0x01,0x1F,0xF1,0x00,0x1F,0xF1 \
+   ,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xF1,0x1F,0x00,0x01,0xFF,0x11,0xF0,0x10,0xFF,0x11,0xF0,0x10,0xF0,0x00,0x11,0xFF,0x00,0x01,0x1F,0xF1,0x0F,0x01,0x00,0x0F \
+   ,0x01,0x00,0x00,0x00,0x00,0xF1,0x1F,0x00,0x01,0xFF,0x11,0x0F,0xF1,0x10,0x00,0xF0,0x1F,0xF1,0x11,0xFF,0x10,0xF0,0x01,0x1F,0xF1,0x0F,0x11,0xFF,0x01,0x00,0x00,0x00 \
+   ,0x00,0x10,0xF0,0x01,0x0F,0x00,0x01,0x0F,0xF1,0x10,0x0F,0x01,0x00,0x00,0xF0,0x10,0x00,0x01,0xFF,0x10,0x01,0xFF,0x11,0xFF,0x11,0xF0,0x10,0xF0,0x10,0xF0,0x00,0x10 \
+   ,0xF0,0x01,0x1F,0xF1,0x0F,0x01,0x1F,0xF1,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x0F,0x00,0x01,0x0F,0xF1,0x10,0x00,0x0F,0xF1,0x10,0x00,0xF1,0x1F,0xF0,0x10,0xF1 \
+   ,0x1F,0xF1,0x1F,0xF1,0x00,0x10,0xFF,0x01,0x10,0xF0,0x01,0x0F,0x00,0x00,0x01,0x0F,0x01,0x0F,0x01,0x00,0x00,0xFF,0x11,0x00,0xF0,0x11,0x0F,0xF0,0x10,0xF0,0x11,0x0F \
+   ,0xF0,0x10,0x01,0xFF,0x10,0x00,0xF1,0x1F,0x00,0x00,0xF1,0x1F,0x00,0xF1,0x1F,0x00,0xF1,0x1F,0x00,0x00,0xF1,0x1F,0x00,0xF0,0x11,0x0F,0xF0,0x10,0x01,0xFF,0x10,0xF0 \
+   ,0x10,0x01,0xFF,0x10,0x00,0xFF,0x11,0x00,0x00,0x0F,0x01,0x0F,0x01,0x0F,0x00,0x00,0x01,0x0F,0x10,0xF0,0x0F,0x11,0xF0,0x00,0x1F,0xF1,0x1F,0xF1,0x1F,0xF0,0x10,0xF1 \
+   ,0x1F,0x00,0xF0,0x1F,0x01,0x00,0xF0,0x1F,0x01,0x0F,0x00,0x01,0x0F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0xF1,0x0F,0x01,0x1F,0xF1,0x0F,0x10,0xF0,0x00,0x10,0xF0 \
+   ,0x10,0xF0,0x10,0xFF,0x11,0xFF,0x11,0x0F,0xF0,0x11,0x0F,0x00,0xF0,0x10,0x00,0x00,0x0F,0x01,0xF0,0x1F,0x01,0x0F,0x00,0x01,0x0F,0x10,0xF0,0x00,0x00,0x00,0x00,0x0F \
+   ,0x11,0xFF,0x01,0x1F,0xF1,0x0F,0x10,0xF0,0x11,0xFF,0x1F,0xF1,0x10,0x00,0xF0,0x1F,0x01,0xFF,0x11,0x0F,0x00,0xF1,0x1F,0x00,0x00,0x00,0x00,0x0F,0x01,0x00,0x0F,0x01 \
+   ,0x1F,0xF1,0x0F,0x00,0x11,0xFF,0x00,0x10,0xF0,0x10,0xFF,0x11,0xF0,0x10,0xFF,0x11,0x0F,0x00,0xF1,0x1F,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x1F,0xF1,0x00,0x1F \
+   ,0xF1,0x0F,0x10,0x01,0xFF,0x10,0x00,0xF0,0x11,0x0F,0x00,0x0F,0x01,0x01,0x0F,0x10,0xF0,0x00,0x10,0xF1,0x1F,0xF1,0x1F,0x01,0xFF,0x11,0x00,0x0F,0x01,0x00,0xF0,0x20 \
+   ,0xF0,0x00,0x01,0x0F,0x00,0x11,0xFF,0x01,0x1F,0xF1,0x00,0x1F,0xF1,0x10,0x00,0xF0,0x10,0xF0,0x11,0x0F,0x00,0x01,0xFF,0x11,0x00,0x0F,0x01,0x00,0x00,0x00,0x00,0x00 \
+   ,0x10,0xF0,0x01,0x0F,0x00,0x11,0xF0,0x0F,0x11,0xF0,0x10,0xFF,0x11,0xF1,0x1F,0xF0,0x10,0xF0,0x11,0x0F,0xF1,0x1F,0x01,0x00,0xF0,0x1F,0x01,0x00,0x01,0x0F,0x00,0x00 \
+   ,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x10,0xF0,0x00,0x00,0x00,0x10,0xF1,0x0F,0x10,0xF1,0x1F,0xF1,0x00,0x1F,0xF1,0x10,0x00,0xF0,0x10,0xF0,0x11,0x0F,0xF0,0x11,0x0F \
+   ,0x01,0xFF,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x0F,0x01,0x0F,0x01,0x1F,0xF1,0x00,0x00,0x10,0xF0,0x10,0xF0,0x00,0x11,0xFF,0x10,0xF1,0x1F,0x01,0xF0 \
+   ,0x10,0x0F,0xF1,0x10,0x00,0x00,0x01,0xFF,0x10,0x01,0x0F,0x00,0x01,0x10,0xFF,0x01,0x00,0x00,0x10,0xF0,0x00,0x10,0xF0,0x00,0x11,0xFF,0x10,0xF0,0x01,0x1F,0xF0,0x00 \
+   ,0x11,0xFF,0x00,0x11,0xFF,0x00,0x00,0x11,0xFF,0x0F,0xF0,0x11,0x0F,0xF1,0x10,0xFF,0x11,0xF0,0x10,0xF0,0x0F,0x01,0x00,0x00,0x00,0x00,0x0F,0xF1,0x10,0xF0,0x1F,0xF1 \
+   ,0x10,0xFF,0x01,0x0F,0x10,0xF1,0x0F,0x00,0x01,0x0F,0x00,0x01,0x0F,0x01,0xFF,0x11,0xFF,0x11,0xF0,0x1F,0xF1,0x00,0x0F,0x01,0x00,0x00,0x00,0x0F,0xF1,0x10,0x00,0xF0 \
+   ,0x00,0x10,0xF0,0x00,0x00,0x01,0x0F,0x00,0x00,0x00,0x01,0xFF,0x10,0xF1,0x1F,0xF0,0x11,0xFF,0x01,0x0F,0x01,0x0F,0x01,0x00,0xFF,0x11,0x00,0xFF,0x11,0xF0,0x00,0x1F \
+   ,0xF1,0x00,0x00,0x00,0x00,0x00,0xF0,0x10,0x00,0xF0,0x10,0xF1,0x1F,0x00,0x00,0xF0,0x10,0x0F,0x01,0x10,0xF0,0x00,0x00,0x1F,0xF1,0x10,0x00,0xFF,0x11,0x0F,0x01,0x00 \
+   ,0x0F,0x01,0x0F,0x10,0xF1,0x0F,0x11,0xFF,0x10,0x01,0xFF,0x10,0x00,0x00,0x01,0x0F,0x00,0x10,0xF0,0x00,0x10,0xF0,0x10,0x00,0xFF,0x11,0x00,0x00,0x00,0x0F,0x01,0x10 \
+   ,0xFF,0x01,0x10,0xFF,0x11,0xFF,0x11,0x0F,0x01,0x0F,0x00,0x01,0x0F,0x01,0x0F,0x00,0x11,0xFF,0x00,0x11,0xF0,0x0F,0x11,0xF0,0x10,0x0F,0x01,0xF0,0x10,0x00,0x00,0x00 \
+   ,0x00,0x00,0x00,0x00,0x00,0x01,0x0F,0x00,0x01,0x00,0xFF,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0xFF,0x11,0x0F,0x01,0x00,0x0F,0x01,0xF0,0x10,0x00,0x00,0x00,0x01 \
+   ,0xFF,0x11,0x0F,0x01,0x0F,0xF1,0x10,0x00,0x00,0x00,0xF0,0x10,0x00,0x01,0xFF,0x11,0x0F,0x01,0xFF,0x11,0x00,0x00,0xF0,0x10,0x00,0x00,0xF1,0x1F,0x01,0xFF,0x11,0x0F \
+   ,0xF1,0x10,0x00,0xF0,0x1F,0x01,0x00,0xFF,0x11,0x0F,0xF0,0x10,0x00,0x01,0xFE,0x11,0x00,0x00,0xF0,0x1F,0x01,0x0F,0xF1,0x1F,0x00,0x00,0xF0,0x10,0x00,0x00,0x00,0xFF \
+   ,0x11,0x00,0x0F,0x00,0xF1,0x1F,0x00,0x00,0x00,0x00,0xF0,0x10,0x00,0x0F,0x01,0x0F,0x01,0xFF,0x10,0x01,0x0F,0x00,0x00,0x00,0x0F,0x01,0x00,0xF0,0x1F,0x00,0x01,0x0F \
+   ,0x00,0x01,0x0F,0x00,0x00,0x0F,0x01,0x00,0x00,0xF0,0x10,0x00,0xFF,0x11,0xF0,0x1F,0xF1,0x1F,0xF1,0x0F,0x01,0x0F,0x10,0xF0,0x00,0x00,0x00,0x00,0x00,0x1F,0xF1,0x00 \
+   ,0x0F,0x10,0xF1,0x1F,0xF1,0x1F,0xF0,0x00,0x10,0xF1,0x0F,0x00,0x00,0x0F,0x11,0xF0,0xF0,0x1F,0x01,0x0F,0x01,0xFF,0x11,0x0F,0xF0,0x10,0xF0,0x11,0xFF,0x0F,0x11,0xF0 \
+   ,0x00,0x00,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x00,0xF0,0x11,0x0F,0xF0,0x10,0xFF,0x11,0xF0,0x00,0x1F,0xF1,0x00,0x0F,0x01,0x0F,0x00,0x00,0x01,0x0F,0x00,0x00,0xF0 \
+   ,0x10,0x00,0xFF,0x11,0xF0,0x1F,0xF1,0x10,0xFF,0x00,0x11,0xF0,0x0F,0x11,0xF0,0x1F,0x01,0xF0,0x10,0x00,0x00,0x01,0x0F,0x00,0x00,0x01,0x0F,0x01,0x0F,0x01,0x10,0xFF \
+   ,0x01,0x10,0xF0,0x10,0x00,0xF0,0x10,0x00,0xF1,0x1F,0x00,0x01,0x0F,0x01,0x00,0x0F,0x01,0x10,0xF0,0x00,0x00,0x10,0xF0,0x10,0xF0,0x10,0x01,0xFF,0x10,0x01,0x0F,0xF1 \
+   ,0x10,0x0F,0x01,0x00,0x10,0xF0,0x00,0x00,0x00,0x10,0xF1,0x1F,0xF0,0x00,0x11,0xFF,0x11,0xFF,0x01,0x0F,0x11,0xF0,0x00,0x00,0x00,0x00,0x00,0x10,0xF0,0x01,0x0F,0x00 \
+   ,0x00,0x01,0x0F,0xF0,0x11,0x0F,0xF0,0x11,0xFF,0x01,0x1F,0xF1,0x0F,0x01,0x0F,0x01,0xFF,0x11,0x00,0xFF,0x11,0xF0,0x1F,0xF1,0x00,0x00,0x1F,0xF1,0xF0,0x10,0x00,0x0F \
+   ,0xF1,0x10,0x00,0xF0,0x00,0x10,0xF0,0x00,0x00,0x00,0x00,0x00,0x01,0xFF,0x10,0xF0,0x10,0xF1,0x1F,0xF0,0x00,0x01,0x0F,0x00,0x01,0x0F,0x00,0x01,0xFF,0x11,0xFF,0x11 \
+   ,0xFF,0x01,0x1F,0xF1,0x1F,0xF0,0x11,0x0F,0x01,0x0F,0x00,0x01,0x0F,0x00,0x00,0x11,0xFF,0x10,0xF0,0x10,0x01,0xFF,0x10,0x00,0x00,0x00,0x10,0xF0,0x00,0x00,0x10,0xF0 \
+   ,0x10,0x00,0xFF,0x11,0x00,0x00,0x00,0x00,0x0F,0x11,0xF0,0x0F,0x11,0xF0,0x1F,0x01,0xF0,0x1F,0x01,0x0F,0x01,0x0F,0x11,0xFF,0x01,0x1F,0xF0,0x11,0xFF,0x11,0x0F,0x00 \
+   ,0xF1,0x1F,0x10,0xF0,0x01,0x0F,0x00,0x00,0x00,0x00,0x10,0xF0,0x00,0x0F,0x01,0x1F,0xF1,0x0F,0x11,0xFF,0x10,0xF1,0x1F,0x00,0xF0,0x10,0x00,0x01,0x0F,0x00,0x10,0xF0 \
+   ,0x00,0x11,0xFF,0x10,0xF0,0x11,0xFF,0x10,0x00,0xF0,0x10,0x0F,0x01,0xF0,0x10,0x0F,0x01,0x0F,0x00,0x01,0x0F,0x10,0xF0,0x00,0x00,0x10,0xF0,0x10,0xF0,0x0F,0x11,0x00 \
+   ,0xFF,0x11,0x0F,0xF0,0x11,0x0F,0x00,0x00,0x00,0x00,0x00,0x0F,0x01,0x00,0x0F,0x01,0x10,0xFF,0x00,0x11,0xFF,0x10,0xF0,0x10,0xF0,0x10,0x00,0xF0,0x10,0x0F,0x01,0x0F \
+   ,0x01,0x0F,0x01,0x0F,0x00,0x00,0x00,0x00,0x01,0x0F,0x00,0x10,0xF1,0xFF,0x11,0x0F,0x01,0x00,0x0F,0xF1,0x10,0x00,0xF0,0x10,0xF0,0x10,0xF1,0x1F,0xF0,0x01,0x0F,0x11 \
+   ,0xFF,0x01,0x00,0x00,0x00,0x0F,0x01,0x01,0x0F,0x00,0xF0,0x10,0x01,0xFF,0x11,0x0F,0xF1,0x10,0xF0,0x1F,0xF1,0x00,0x10,0xF0,0x00,0x01,0x0F,0x00,0x01,0x0F,0x01,0x0F \
+   ,0x01,0x00,0x0F,0xF1,0x10,0x00,0xF0,0x10,0x00,0xF0,0x11,0xFF,0x10,0xF1,0x0F,0x10,0xF0,0x00,0x00,0x00,0x01,0x0F,0x00,0xF0,0x10,0xF1,0x1F,0x00,0xF0,0x11,0xFF,0x00 \
+   ,0x10,0xF0,0x00,0x1F,0xF1,0x00,0x00,0x0F,0x01,0x0F,0x00,0x01,0x0F,0x00,0xF0,0x10,0x00,0x00,0xF0,0x10,0xF0,0x1F,0xF1,0x10,0xFF,0x01,0x1F,0xF0,0x01,0x0F,0x10,0xF0 \
+   ,0x00,0x00,0x00,0x0F,0x01,0xF0,0x10,0x0F,0x01,0xFF,0x10,0x01,0xFF,0x10,0xF0,0x10,0xF0,0x00,0x10,0xF0,0x00,0x0F,0x11,0xFF,0x01,0x0F,0x01,0x0F,0x00,0x00,0xF0,0x11 \
+   ,0x0F,0x00,0x00,0x00,0x01,0x0F,0x01,0x0F,0x01,0x10,0xFF,0x01,0x00,0x10,0xF0,0x10,0xF0,0x10,0xF1,0x1F,0xF0,0x11,0x0F,0x01,0xFF,0x11,0x00,0x00,0x00,0x0F,0x02,0x0F \
+   ,0x10,0xF0,0x00,0x00,0x01,0x1F,0xF1,0x1F,0xF1,0x10,0xF0,0x1F,0xF1,0x10,0x00,0x00,0xF0,0x11,0x0F,0x00,0x01,0x0F,0x01,0x0F,0x01,0x0F,0x11,0xF0,0x00,0x00,0x10,0xF0 \
+   ,0x10,0xF0,0x11,0xFF,0x10,0xF0,0x11,0x0F,0xF0,0x10,0x00,0x00,0x01,0x0F,0x10,0xF0,0x00,0x11,0xFF,0x10,0xF1,0x1F,0x00,0x01,0xF0,0x1F,0x01,0x00,0x00,0x00,0xF0,0x10 \
+   ,0x00,0x01,0x0F,0x00,0x00,0x01,0x0F,0x00,0x00,0x11,0xFF,0x01,0x1F,0x00,0xF1,0x1F,0x01,0x0F,0x01,0x0F,0x01,0x00,0x0F,0x11,0xFF,0x01,0x10,0x0F,0xF1,0x10,0x00,0x0F \
+   ,0x01,0x00,0x00,0x00,0x00,0x1F,0xF1,0x10,0xF0,0x10,0x00,0xF0,0x10,0x00,0x00,0x00,0x01,0x1F,0xF0,0x00,0x10,0xF0,0x11,0xFF,0x10,0x00,0x01,0x0F,0x00,0x01,0x0F,0x00 \
+   ,0x01,0x1F,0xF1,0x1F,0xF1,0x1F,0x01,0xFF,0x11,0xFF,0x11,0xFF,0x00,0x01,0x0F,0x00,0x01,0x0F,0x00,0x01,0xFF,0x10,0xF0,0x10,0xF1,0x0F,0x10,0xF0,0x00,0x00,0x00,0x00 \
+   ,0xF0,0x10,0x00,0xF0,0x10,0xF0,0x10,0xF0,0x0F,0x01,0x00,0x00,0x00,0x0F,0x01,0xF0,0x10,0x0F,0xF1,0x00,0x1F,0xF1,0x0F,0x01,0x0F,0x01,0x0F,0x01,0x0F,0xF1,0x1F,0x01 \
+   ,0xFF,0x00,0x11,0xFF,0x00,0x01,0x0F,0x00,0x00,0x01,0x0F,0x00,0xF0,0x10,0x00,0x00,0x00,0x00,0x00,0xFF,0x11,0x0F,0xF1,0x1F,0x00,0xF1,0x1F,0xF0,0x11,0x0F,0xF0,0x10 \
+   ,0x00,0x00,0x00,0x00,0x0F,0x01,0x00,0x0F,0x01,0x0F,0x11,0xFF,0x00,0x11,0xFF,0x10,0xF0,0x10,0x00,0xF0,0x10,0x00,0x0F,0x01,0xF0,0x1F,0x01,0x1F,0xF0,0x01,0x0F,0x00 \
+   ,0x10,0xF0,0x10,0xF0,0x00,0x10,0x00,0xF0,0x1F,0x01,0x00,0xFF,0x10,0x01,0x0F,0x00,0x01,0x0F,0x10,0xF0,0x00,0x00,0x10,0xFF,0x11,0xF0,0x10,0xFF,0x11,0x0F,0xF1,0x1F \
+   ,0x01,0xFF,0x11,0xF0,0x1F,0xF1,0x00,0x00,0x10,0xF0,0x00,0x01,0x0F,0x00,0x01,0x0F,0x01,0x0F,0xF1,0x1F,0x01,0xF0,0x10,0xF0,0x10,0xF0,0x10,0xF0,0x00,0x00,0x11,0xFF \
+   ,0x01,0x0F,0x01,0x0F,0x01,0x00,0xFF,0x11,0x00,0xF0,0x10,0x00,0xF0,0x10,0xF1,0x0F,0x10,0xF1,0x0F,0x01,0x1F,0xF1,0x00,0x00,0x0F,0x01,0xF0,0x10,0x00,0x00,0xF1,0x1F \
+   ,0x00,0xF0,0x11,0xFF,0x10,0x01,0xFF,0x11,0x0F,0x01,0xF0,0x10,0x00,0x00,0x00,0x00,0x00,0xF0,0x11,0x0F,0x01,0xFF,0x11,0x0F,0xF1,0x00,0x10,0xFF,0x01,0x10,0xF0,0x00 \
+   ,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x0F,0x01,0x1F,0xF1,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x11,0xFF,0x01,0x0F,0x01,0x00,0x0F,0x11,0xF0,0x00,0x00 \
+   ,0x01,0x0F,0x10,0xF1,0x0F,0x01,0x0F,0x11,0xF0,0x00,0x00,0x00,0x10,0xF0,0x00,0x00,0x11,0xFF,0x01,0x0F,0x11,0xF0,0x00,0x00,0x10,0xF0,0x00,0x00,0x10,0xF1,0x0F,0x11 \
+   ,0xFF,0x01,0x10,0xFF,0x01,0x00,0x10,0xFF,0x01,0x10,0xFF,0x00,0x11,0xFF,0x00,0x00,0x10,0xF0,0x00,0x00,0x1F,0xF1,0x0F,0x01,0x1F,0xF1,0x0F,0x00,0x10,0xF0,0x00,0x00 \
+   ,0x00,0x10,0xFF,0x01,0x0F,0x01,0x1F,0xF0,0x00,0x01,0x0F,0x00,0x10,0xFF,0x01,0x00,0x0F,0x01,0x0F,0x11,0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0xFF,0x01,0x0F \
+   ,0x01,0x0F,0x00,0x00,0x01,0x0F,0x00,0x0F,0x01,0x00,0x00,0x10,0xF0,0x00,0x1F,0xF1,0x00,0x1F,0x01,0xF0,0x1F,0x01,0x0F,0xF0,0x11,0x0F,0x00,0x01,0x0F,0x00,0x01,0x0F \
+   ,0x11,0xFF,0x01,0x1F,0x01,0xF0,0x1F,0x01,0x00,0xF0,0x1F,0x11,0xF0,0x00,0x00,0x00,0x1F,0xF1,0x10,0x00,0xF0,0x11,0x0F,0x00,0x00,0x00,0x00,0x01,0x0F,0x10,0xF0,0x11 \
+   ,0xFF,0x10,0xF1,0x1F,0x01,0x0F,0x01,0x0F,0x01,0x00,0x0F,0x11,0xF0,0x0F,0x11,0xF0,0x10,0x0F,0x01,0x00,0xF0,0x10,0x10,0xF0,0x00,0x00,0x10,0xF0,0x00,0x10,0xF0,0x10 \
+   ,0xF0,0x00,0x00,0x00,0x00,0x00,0x00,0xF0,0x10,0x0F,0xF1,0x10,0xFF,0x01,0x10,0xFF,0x01,0x00,0x0F,0x01,0x0F,0xF0,0x11,0x0F,0xF1,0x1F,0xF0,0x01,0x1F,0xF0,0x00,0x01 \
+   ,0x0F,0x00,0x00,0x00,0xF0,0x10,0x00,0xF0,0x10,0xF0,0x00,0x00,0x1F,0xF1,0x00,0x00,0xFF,0x11,0x00,0x0F,0xF1,0x10,0xFF,0x11,0xFF,0x01,0x0F,0x01,0x0F,0x00,0x01,0x0F \
+   ,0x00,0x01}
+
+// offset, points, period, startX, startY, stepX, stepY, loop
+#define TRAJECTORY_TABLE { \
+   {0, 364, 5, 250, 0, 0, 4, true} /* circle:250 */ \
+   ,{364, 582, 5, 700, 0, 0, 4, true} /* ellipse:700,350 */ \
+   ,{946, 759, 5, 0, 0, 5, 5, true} /* eight:600,300 */ \
+   ,{1705, 1593, 5, 676, -9, 1, 1, true} /* star:700,300 */}
+
+#endif /* TRAJECTORYTABLE_H_ */
@@ -0,0 +1,290 @@
+/*
+ * waypoint.c
+ *
+ * Setpoints streamed by a host over the UART (MODE_WAYPOINT)
+ *  The UART interrupt parses the lines into a bounded queue, SysTick takes the
+ *  setpoint interpolated between the queued waypoints at the update rate. The host
+ *  times are mapped to SysTick time when a stream starts, WaypointDelay ms late, so
+ *  waypoints arriving up to that late are still played on time. When the queue runs
+ *  dry the last setpoint is held and the underrun reported, the next waypoint starts
+ *  a new stream from there. Flow control is left to the host from the counts of the
+ *  reports (waypoint.h).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "waypoint.h"
+
+uint16_t WaypointDelay = WAYPOINT_DEFAULT_DELAY;
+
+volatile uint32_t WaypointReceived = 0;
+volatile uint32_t WaypointPlayed = 0;
+volatile uint32_t WaypointRejected = 0;
+volatile uint32_t WaypointErrors = 0;
+volatile uint32_t WaypointUnderruns = 0;
+volatile _Bool WaypointHolding = true;
+
+// Queue, the UART interrupt moves the head and SysTick the tail. Both run at priority 2 like the
+//  debounce timer (com.c, main.c, button.c), none of them preempts another
+Waypoint waypointQueue[WAYPOINT_QUEUE_SIZE];
+volatile uint8_t waypointHead = 0;
+volatile uint8_t waypointTail = 0;
+_Bool waypointActive = false;
+
+// Host time of the last queued waypoint, the next one must be later unless it starts a stream
+uint32_t waypointLastTime = 0;
+_Bool waypointFirst = true;
+
+// Line being received
+char waypointLine[WAYPOINT_LINE];
+uint8_t waypointLength = 0;
+_Bool waypointOverlong = false;
+
+// Playback: SysTick time minus host time, the waypoint (or held setpoint) the interpolation starts from
+_Bool waypointAnchored = false;
+uint32_t waypointOffset = 0;
+uint32_t waypointFromTime = 0;
+int32_t waypointFromX = 0;
+int32_t waypointFromY = 0;
+int32_t waypointLastX = 0;
+int32_t waypointLastY = 0;
+
+// Lead of the last queued waypoint over playback (ms), the smallest since the last report
+int32_t waypointLead = 0;
+int32_t waypointMinLead = 0;
+uint32_t waypointReportTime = 0;
+_Bool waypointReportNow = false;
+
+// Report fields in line order, taken by SysTick when a report is due and sent by the main loop, which
+//  clears Ready. SysTick doesn't touch them while Ready is set, so the main loop reads a complete report
+int32_t waypointReport[WAYPOINT_REPORT_FIELDS];
+volatile _Bool waypointReportReady = false;
+
+static uint8_t Count(void) {
+    return (uint8_t)(waypointHead - waypointTail);
+}
+
+// Holds <x>, <y> (counts from the center) until the first waypoint
+void Waypoint_Start(int32_t x, int32_t y) {
+    waypointHead = 0;
+    waypointTail = 0;
+    waypointFirst = true;
+    waypointLength = 0;
+    waypointOverlong = false;
+    waypointAnchored = false;
+    waypointLastX = x;
+    waypointLastY = y;
+    waypointLead = 0;
+    waypointMinLead = 0;
+    waypointReportNow = true;
+    waypointReportReady = false;
+
+    WaypointReceived = 0;
+    WaypointPlayed = 0;
+    WaypointRejected = 0;
+    WaypointErrors = 0;
+    WaypointUnderruns = 0;
+    WaypointHolding = true;
+    waypointActive = true;
+}
+
+// Lines are ignored outside the waypoint mode
+void Waypoint_Stop(void) {
+    waypointActive = false;
+}
+
+// Between Waypoint_Start() and Waypoint_Stop(), the stream owns the UART lines
+_Bool Waypoint_Active(void) {
+    return waypointActive;
+}
+
+// Queues a waypoint, false (and counted) if the queue is full or the time isn't later than the last one
+_Bool Waypoint_Push(uint32_t time, int32_t x, int32_t y) {
+    if(!waypointFirst && (int32_t)(time - waypointLastTime) <= 0) {
+        WaypointErrors++;
+        return false;
+    }
+    if(Count() >= WAYPOINT_QUEUE_SIZE) {
+        WaypointRejected++;
+        return false;
+    }
+    Waypoint *w = &waypointQueue[waypointHead % WAYPOINT_QUEUE_SIZE];
+    w->time = time;
+    w->x = x;
+    w->y = y;
+    waypointHead++;
+    waypointLastTime = time;
+    waypointFirst = false;
+    WaypointReceived++;
+    return true;
+}
+
+// Decimal number after a ',' at <text>, moves <text> past it
+static _Bool Field(const char **text, int32_t *value) {
+    const char *p = *text;
+    _Bool negative = false;
+    uint32_t v = 0;
+    if(*p++ != ',') return false;
+    if(*p == '-') {
+        negative = true;
+        p++;
+    }
+    if(*p < '0' || *p > '9') return false;
+    while(*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    *value = negative ? -(int32_t)v : (int32_t)v;
+    *text = p;
+    return true;
+}
+
+static void Waypoint_Line(void) {
+    const char *p = waypointLine + 1;
+    int32_t time, x, y;
+
+    waypointLine[waypointLength] = '\0';
+    if(waypointLine[0] == 'R' && waypointLength == 1) {
+        // New stream from the setpoint reached so far
+        waypointTail = waypointHead;
+        waypointAnchored = false;
+        waypointFirst = true;
+        WaypointHolding = true;
+    } else if(waypointLine[0] == 'W' && Field(&p, &time) && Field(&p, &x) && Field(&p, &y) && *p == '\0' &&
+              x >= -2047 && x <= 2047 && y >= -2047 && y <= 2047) {
+        Waypoint_Push((uint32_t)time, x, y);
+    } else if(waypointLine[0] == 'G') {
+        // Gain table line (schedule.c)
+    } else {
+        WaypointErrors++;
+    }
+}
+
+// Character received by the UART interrupt
+void Waypoint_Char(char c) {
+    if(!waypointActive) return;
+
+    if(c == '\n' || c == '\r') {
+        if(waypointOverlong) WaypointErrors++;
+        else if(waypointLength > 0) Waypoint_Line();
+        waypointLength = 0;
+        waypointOverlong = false;
+    } else if(waypointLength < WAYPOINT_LINE - 1) {
+        waypointLine[waypointLength++] = c;
+    } else {
+        waypointOverlong = true;
+    }
+}
+
+static int32_t Lerp(int32_t from, int32_t to, uint32_t elapsed, uint32_t span) {
+    int64_t delta = (int64_t)(to - from) * elapsed;
+    return from + (int32_t)((delta >= 0 ? delta + span / 2 : delta - (int64_t)(span / 2)) / (int64_t)span);
+}
+
+// Takes the report fields at <now> if a report is due and the last one was sent
+static void TakeReport(uint32_t now) {
+    if(waypointReportReady || (!waypointReportNow && (now - waypointReportTime) < WAYPOINT_REPORT_RATE)) return;
+    waypointReportNow = false;
+    waypointReportTime = now;
+
+    waypointReport[0] = WaypointReceived;
+    waypointReport[1] = WaypointPlayed;
+    waypointReport[2] = WaypointHolding ? 0 : waypointLead;
+    waypointReport[3] = waypointMinLead;
+    waypointReport[4] = WaypointUnderruns;
+    waypointReport[5] = WaypointRejected;
+    waypointReport[6] = WaypointErrors;
+    waypointMinLead = WaypointHolding ? 0 : waypointLead;
+    waypointReportReady = true;
+}
+
+/* Setpoint (counts from the center) at SysTick time <now>, called with increasing times
+ *  Waypoints that were reached are played and leave the queue, a due report is taken
+ */
+void Waypoint_Setpoint(uint32_t now, int32_t *x, int32_t *y) {
+    _Bool started = false;
+    if(!waypointAnchored) {
+        if(Count() == 0) {
+            *x = waypointLastX;
+            *y = waypointLastY;
+            TakeReport(now);
+            return;
+        }
+        // A stream starts from the held setpoint, its first waypoint WaypointDelay ms later
+        waypointOffset = now + WaypointDelay - waypointQueue[waypointTail % WAYPOINT_QUEUE_SIZE].time;
+        waypointFromTime = now;
+        waypointFromX = waypointLastX;
+        waypointFromY = waypointLastY;
+        waypointAnchored = true;
+        WaypointHolding = false;
+        started = true;
+    }
+
+    while(Count() > 0) {
+        const Waypoint *w = &waypointQueue[waypointTail % WAYPOINT_QUEUE_SIZE];
+        uint32_t at = w->time + waypointOffset;
+        if((int32_t)(at - now) > 0) break;
+        waypointFromTime = at;
+        waypointFromX = w->x;
+        waypointFromY = w->y;
+        waypointTail++;
+        WaypointPlayed++;
+    }
+
+    waypointLead = (int32_t)(waypointLastTime + waypointOffset - now);
+    if(started || waypointLead < waypointMinLead) waypointMinLead = waypointLead;
+
+    if(Count() == 0) {
+        // Underrun, the last waypoint is held
+        waypointAnchored = false;
+        WaypointHolding = true;
+        WaypointUnderruns++;
+        waypointReportNow = true;
+        *x = waypointFromX;
+        *y = waypointFromY;
+    } else {
+        const Waypoint *w = &waypointQueue[waypointTail % WAYPOINT_QUEUE_SIZE];
+        uint32_t span = w->time + waypointOffset - waypointFromTime;
+        *x = Lerp(waypointFromX, w->x, now - waypointFromTime, span);
+        *y = Lerp(waypointFromY, w->y, now - waypointFromTime, span);
+    }
+    waypointLastX = *x;
+    waypointLastY = *y;
+    TakeReport(now);
+}
+
+static char *Append(char *p, int32_t value) {
+    char digits[10];
+    uint8_t count = 0;
+    uint32_t v = value;
+
+    *p++ = ',';
+    if(value < 0) {
+        *p++ = '-';
+        v = -value;
+    }
+    do {
+        digits[count++] = (v % 10) + '0';
+        v /= 10;
+    } while(v > 0);
+    while(count > 0) *p++ = digits[--count];
+    return p;
+}
+
+/* Report line (waypoint.h) into <line> (WAYPOINT_REPORT_SIZE) if SysTick took one, returns its length or 0
+ *  Called from the main loop, only formats the fields SysTick took
+ */
+uint8_t Waypoint_Report(char *line) {
+    if(!waypointActive || !waypointReportReady) return 0;
+
+    char *p = line;
+    uint8_t i;
+    *p++ = 'Q';
+    for(i = 0; i < WAYPOINT_REPORT_FIELDS; i++) {
+        p = Append(p, waypointReport[i]);
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    waypointReportReady = false;
+    return p - line;
+}
@@ -0,0 +1,61 @@
+/*
+ * waypoint.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Michael Graves
+ */
+
+#ifndef WAYPOINT_H_
+#define WAYPOINT_H_
+
+/* Waypoint stream (MODE_WAYPOINT), one line per waypoint from the host:
+ *      W,<time ms>,<x>,<y>     setpoint (counts from the center) at a host time, times must increase
+ *      R                       drops the queue, the next waypoint starts a new stream
+ *  The first waypoint of a stream is played WaypointDelay ms after it is taken, the later ones at the
+ *  same offset from their host times, so the queue absorbs up to WaypointDelay ms of link jitter.
+ */
+#define WAYPOINT_DEFAULT_DELAY 100
+
+// Queue entries (a power of two) and longest line
+#define WAYPOINT_QUEUE_SIZE 32
+#define WAYPOINT_LINE 32
+
+// Setpoint interpolated every UPDATE_RATE ms, report sent every REPORT_RATE ms and on an underrun
+#define WAYPOINT_UPDATE_RATE 10
+#define WAYPOINT_REPORT_RATE 50
+
+/* Report to the host, one line:
+ *      Q,<received>,<played>,<lead ms>,<min lead ms>,<underruns>,<rejected>,<errors>
+ *  The host may have WAYPOINT_QUEUE_SIZE - (sent - played) more waypoints in flight. The lead is how far
+ *  the last queued waypoint is ahead of playback, the min lead the smallest lead since the last report.
+ *  After an underrun the last setpoint is held until the next waypoint starts a new stream.
+ */
+#define WAYPOINT_REPORT_SIZE 96
+#define WAYPOINT_REPORT_FIELDS 7
+
+typedef struct {
+    uint32_t time;              // Host time (ms)
+    int16_t x, y;
+} Waypoint;
+
+extern uint16_t WaypointDelay;
+
+// Counts since Waypoint_Start()
+extern volatile uint32_t WaypointReceived;
+extern volatile uint32_t WaypointPlayed;
+extern volatile uint32_t WaypointRejected;
+extern volatile uint32_t WaypointErrors;
+extern volatile uint32_t WaypointUnderruns;
+
+// Setpoint held (no stream or after an underrun)
+extern volatile _Bool WaypointHolding;
+
+void Waypoint_Start(int32_t x, int32_t y);
+void Waypoint_Stop(void);
+_Bool Waypoint_Active(void);
+void Waypoint_Char(char c);
+_Bool Waypoint_Push(uint32_t time, int32_t x, int32_t y);
+void Waypoint_Setpoint(uint32_t now, int32_t *x, int32_t *y);
+uint8_t Waypoint_Report(char *line);
+
+#endif /* WAYPOINT_H_ */